@@ -0,0 +1,63 @@
+/**
+ * Tests the background compaction service. It only runs when enabled, it compacts files with
+ * enough free space, it keeps compacting in slices while the storage engine times out, and it does
+ * not hold up shutdown.
+ *
+ * @tags: [requires_wiredtiger, requires_persistence]
+ */
+(function() {
+"use strict";
+
+load("jstests/libs/fail_point_util.js");
+
+const conn = MongoRunner.runMongod({
+    setParameter: {
+        backgroundCompactionSleepSecs: 1,
+        backgroundCompactionMinFreeSpaceMB: 0,
+        backgroundCompactionIOBudgetPercent: 100,
+    }
+});
+const db = conn.getDB("test");
+const coll = db.getCollection(jsTest.name());
+
+function getMetrics() {
+    return assert.commandWorked(db.serverStatus()).metrics.backgroundCompaction;
+}
+
+// Leaves most of the collection's file as free space once checkpointed.
+function fragmentCollection() {
+    const padding = "x".repeat(1024);
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 10000; i++) {
+        bulk.insert({_id: i, padding: padding});
+    }
+    assert.commandWorked(bulk.execute());
+    assert.commandWorked(coll.deleteMany({_id: {$gte: 1000}}));
+    assert.commandWorked(db.adminCommand({fsync: 1}));
+}
+
+fragmentCollection();
+
+// The service is disabled by default.
+sleep(3000);
+assert.eq(0, getMetrics().passes);
+
+// Once enabled, a pass picks the collection and compacts it.
+assert.commandWorked(db.adminCommand({setParameter: 1, backgroundCompactionEnabled: true}));
+checkLog.containsJson(conn, 5904009, {namespace: coll.getFullName()});
+assert.gt(getMetrics().slices, 0);
+
+// A slice that times out leaves compaction to the next slice rather than failing it.
+assert.commandWorked(db.adminCommand({clearLog: "global"}));
+assert.commandWorked(coll.remove({}));
+fragmentCollection();
+configureFailPoint(conn, "WTCompactRecordStoreETIMEDOUT");
+const slicesBefore = getMetrics().slices;
+checkLog.containsJson(conn, 5904006, {namespace: coll.getFullName()});
+assert.soon(() => getMetrics().slices >= slicesBefore + 10);
+assert(!checkLog.checkContainsOnceJson(conn, 5904008, {namespace: coll.getFullName()}));
+assert(!checkLog.checkContainsOnceJson(conn, 5904009, {namespace: coll.getFullName()}));
+
+// Shutting down does not wait for the compaction in progress to complete.
+MongoRunner.stopMongod(conn);
+}());
@@ -31,7 +31,8 @@ let nodes = replTest.startSet({
     setParameter: {
         featureFlagRetryableFindAndModify: true,
         storeFindAndModifyImagesInSideCollection: true,
-        replBatchLimitOperations: 1
+        replBatchLimitOperations: 1,
+        recoveryOplogApplicationBatchLimitOperations: 1
     }
 });
 replTest.initiate();
@@ -24,12 +24,14 @@ const kLoggingIntervalSeconds = 3;
 
 const testDB = "test";
 
-// Force oplog sampling to occur on start up for small numbers of oplog inserts.
+// Force oplog sampling to occur on start up for small numbers of oplog inserts, rather than
+// reloading the truncation points persisted on shutdown.
 const replSet = new ReplSetTest({
     nodes: 1,
     nodeOptions: {
         setParameter: {
             "maxOplogTruncationPointsDuringStartup": 10,
+            "persistOplogTruncationPoints": false,
             "oplogSamplingLogIntervalSeconds": kLoggingIntervalSeconds,
             "failpoint.slowOplogSamplingReads":
                 tojson({mode: "alwaysOn", data: {"delay": kOplogSampleReadDelay}})
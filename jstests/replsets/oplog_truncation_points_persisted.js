@@ -0,0 +1,39 @@
+/**
+ * Ensure that the oplog truncation points persisted on shutdown are reloaded on start up, rather
+ * than recalculated by scanning or sampling the oplog.
+ * @tags: [
+ *   requires_persistence,
+ *   requires_wiredtiger,
+ * ]
+ */
+(function() {
+"use strict";
+
+// Keep the truncation points small enough for the inserts below to create some.
+const replSet = new ReplSetTest({nodes: 1, nodeOptions: {oplogSize: 10}});
+replSet.startSet();
+replSet.initiate();
+
+let coll = replSet.getPrimary().getDB("test").getCollection("testcoll");
+
+let res = replSet.getPrimary().getDB("test").serverStatus();
+assert.commandWorked(res);
+assert.eq(res.oplogTruncation.processingMethod, "scanning");
+
+const largeString = "x".repeat(100 * 1024);
+for (let i = 0; i < 200; i++) {
+    assert.commandWorked(coll.insert({_id: i, s: largeString}));
+}
+
+// A clean shutdown stores the truncation points along with the size information of the oplog.
+replSet.stopSet(null /* signal */, true /* forRestart */);
+replSet.startSet({restart: true});
+
+res = replSet.getPrimary().getDB("test").serverStatus();
+assert.commandWorked(res);
+assert.gt(res.oplogTruncation.totalTimeProcessingMicros, 0);
+assert.eq(res.oplogTruncation.processingMethod, "persisted");
+checkLog.containsJson(replSet.getPrimary(), 5905003);
+
+replSet.stopSet();
+})();
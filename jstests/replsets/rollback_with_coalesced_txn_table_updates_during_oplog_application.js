@@ -23,7 +23,13 @@ function runTest(crashAfterRollbackTruncation) {
             // Set the 'syncdelay' to 1s to speed up checkpointing. Also explicitly set the batch
             // size for oplog application to ensure the number of retryable write statements being
             // made majority committed isn't a multiple of it.
-            n1: {syncdelay: 1, setParameter: {replBatchLimitOperations: oplogApplierBatchSize}},
+            n1: {
+                syncdelay: 1,
+                setParameter: {
+                    replBatchLimitOperations: oplogApplierBatchSize,
+                    recoveryOplogApplicationBatchLimitOperations: oplogApplierBatchSize
+                }
+            },
             // Set the bgSyncOplogFetcherBatchSize to 1 oplog entry to guarantee replication
             // progress with the stopReplProducerOnDocument failpoint.
             n2: {setParameter: {bgSyncOplogFetcherBatchSize: 1}},
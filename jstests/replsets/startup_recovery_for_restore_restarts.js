@@ -25,7 +25,8 @@ const rst = new ReplSetTest({
 
 const startParams = {
     logComponentVerbosity: logLevel,
-    replBatchLimitOperations: 100
+    replBatchLimitOperations: 100,
+    recoveryOplogApplicationBatchLimitOperations: 100
 };
 const nodes = rst.startSet({setParameter: startParams});
 let restoreNode = nodes[1];
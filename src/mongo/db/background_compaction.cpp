@@ -0,0 +1,402 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/background_compaction.h"
+
+#include <algorithm>
+
+#include "mongo/base/counter.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/background_compaction_gen.h"
+#include "mongo/db/catalog/collection_catalog.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands/fsync_locked.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/curop.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/background.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/progress_meter.h"
+
+namespace mongo {
+
+class BackgroundCompaction;
+
+namespace {
+
+const auto getBackgroundCompaction =
+    ServiceContext::declareDecoration<std::unique_ptr<BackgroundCompaction>>();
+
+Counter64 compactionPasses;
+Counter64 compactionSlices;
+Counter64 compactionBytesReclaimed;
+
+ServerStatusMetricField<Counter64> compactionPassesDisplay("backgroundCompaction.passes",
+                                                           &compactionPasses);
+ServerStatusMetricField<Counter64> compactionSlicesDisplay("backgroundCompaction.slices",
+                                                           &compactionSlices);
+ServerStatusMetricField<Counter64> compactionBytesReclaimedDisplay(
+    "backgroundCompaction.bytesReclaimed", &compactionBytesReclaimed);
+
+/**
+ * A file that a pass of the background compaction service has chosen to compact: either the record
+ * store of a collection, or one of its ready indexes when 'indexName' is set.
+ */
+struct CompactionTarget {
+    UUID uuid;
+    NamespaceString nss;
+    boost::optional<std::string> indexName;
+    int64_t freeBytes;
+    int64_t totalBytes;
+};
+
+/**
+ * Returns whether a file of 'totalBytes' of which 'freeBytes' are free is worth compacting.
+ */
+bool shouldCompact(int64_t freeBytes, int64_t totalBytes) {
+    if (totalBytes <= 0 || freeBytes < backgroundCompactionMinFreeSpaceMB.load() * 1024 * 1024) {
+        return false;
+    }
+    return static_cast<double>(freeBytes) / totalBytes >=
+        backgroundCompactionMinFreeSpaceRatio.load();
+}
+
+}  // namespace
+
+class BackgroundCompaction : public BackgroundJob {
+public:
+    BackgroundCompaction() : BackgroundJob(false /* selfDelete */) {}
+
+    static BackgroundCompaction* get(ServiceContext* serviceCtx) {
+        return getBackgroundCompaction(serviceCtx).get();
+    }
+
+    static void set(ServiceContext* serviceCtx, std::unique_ptr<BackgroundCompaction> service) {
+        auto& compaction = getBackgroundCompaction(serviceCtx);
+        if (compaction) {
+            invariant(!compaction->running(),
+                      "Tried to reset the BackgroundCompaction without shutting down the original "
+                      "instance.");
+        }
+
+        invariant(service);
+        compaction = std::move(service);
+    }
+
+    std::string name() const {
+        return "BackgroundCompaction";
+    }
+
+    void run() {
+        ThreadClient tc(name(), getGlobalServiceContext());
+        AuthorizationSession::get(cc())->grantInternalAuthorization(&cc());
+
+        {
+            stdx::lock_guard<Client> lk(*tc.get());
+            tc.get()->setSystemOperationKillableByStepdown(lk);
+        }
+
+        while (_sleepFor(Seconds(backgroundCompactionSleepSecs.load()))) {
+            if (!backgroundCompactionEnabled.load()) {
+                LOGV2_DEBUG(5904000, 2, "Background compaction is disabled");
+                continue;
+            }
+
+            if (lockedForWriting()) {
+                LOGV2_DEBUG(5904001, 2, "Skipping background compaction while fsync locked");
+                continue;
+            }
+
+            try {
+                _doPass();
+            } catch (const ExceptionForCat<ErrorCategory::Interruption>& interruption) {
+                LOGV2_DEBUG(5904002,
+                            1,
+                            "Background compaction was interrupted",
+                            "interruption"_attr = interruption);
+            } catch (const DBException& ex) {
+                LOGV2_WARNING(5904003, "Background compaction pass failed", "error"_attr = ex);
+            }
+        }
+    }
+
+    /**
+     * Signals the thread to quit and then waits until it does. A compaction slice in progress is
+     * allowed to finish, which takes at most 'backgroundCompactionSliceSecs'.
+     */
+    void shutdown() {
+        LOGV2(5904004, "Shutting down background compaction thread");
+        {
+            stdx::lock_guard<Latch> lk(_stateMutex);
+            _shuttingDown = true;
+            _shuttingDownCV.notify_one();
+        }
+        wait();
+        LOGV2(5904005, "Finished shutting down background compaction thread");
+    }
+
+private:
+    /**
+     * Waits for 'duration' to pass. Returns false if a shutdown was requested in the meantime.
+     */
+    bool _sleepFor(Milliseconds duration) {
+        auto deadline = Date_t::now() + duration;
+        stdx::unique_lock<Latch> lk(_stateMutex);
+
+        MONGO_IDLE_THREAD_BLOCK;
+        _shuttingDownCV.wait_until(
+            lk, deadline.toSystemTimePoint(), [&] { return _shuttingDown; });
+        return !_shuttingDown;
+    }
+
+    /**
+     * Finds the files that are worth compacting and compacts them, most free space first.
+     */
+    void _doPass() {
+        const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
+        OperationContext* opCtx = opCtxPtr.get();
+
+        // Compaction competes with initial sync and recovery for I/O, so wait until this node is
+        // in a readable state.
+        auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+        if (replCoord->getReplicationMode() == repl::ReplicationCoordinator::modeReplSet &&
+            !replCoord->getMemberState().readable()) {
+            return;
+        }
+
+        ON_BLOCK_EXIT([&] { compactionPasses.increment(); });
+
+        auto targets = _findTargets(opCtx);
+        if (targets.empty()) {
+            return;
+        }
+
+        std::sort(targets.begin(), targets.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.freeBytes > rhs.freeBytes;
+        });
+
+        ProgressMeterHolder progress;
+        {
+            stdx::lock_guard<Client> lk(*opCtx->getClient());
+            progress.set(CurOp::get(opCtx)->setProgress_inlock("Background compaction",
+                                                               targets.size()));
+        }
+
+        for (const auto& target : targets) {
+            if (!_compactTarget(opCtx, target)) {
+                return;
+            }
+            progress.hit();
+        }
+    }
+
+    std::vector<CompactionTarget> _findTargets(OperationContext* opCtx) {
+        std::vector<CompactionTarget> targets;
+
+        auto catalog = CollectionCatalog::get(opCtx);
+        for (const auto& dbName : catalog->getAllDbNames()) {
+            for (const auto& uuid : catalog->getAllCollectionUUIDsFromDb(dbName)) {
+                opCtx->checkForInterrupt();
+
+                AutoGetCollection coll(opCtx, NamespaceStringOrUUID(dbName, uuid), MODE_IS);
+                if (!coll || coll->ns().isOplog() || coll->ns().isDropPendingNamespace()) {
+                    continue;
+                }
+
+                auto rs = coll->getRecordStore();
+                if (!rs->compactSupported() || !rs->supportsOnlineCompaction()) {
+                    continue;
+                }
+
+                int64_t freeBytes = rs->freeStorageSize(opCtx);
+                int64_t totalBytes = rs->storageSize(opCtx);
+                if (shouldCompact(freeBytes, totalBytes)) {
+                    targets.push_back({uuid, coll->ns(), boost::none, freeBytes, totalBytes});
+                }
+
+                auto it = coll->getIndexCatalog()->getIndexIterator(opCtx, false);
+                while (it->more()) {
+                    const IndexCatalogEntry* entry = it->next();
+                    auto iam = entry->accessMethod();
+                    freeBytes = iam->getFreeStorageBytes(opCtx);
+                    totalBytes = iam->getSpaceUsedBytes(opCtx);
+                    if (shouldCompact(freeBytes, totalBytes)) {
+                        targets.push_back({uuid,
+                                           coll->ns(),
+                                           entry->descriptor()->indexName(),
+                                           freeBytes,
+                                           totalBytes});
+                    }
+                }
+            }
+        }
+
+        return targets;
+    }
+
+    /**
+     * Compacts 'target' one time slice at a time, releasing all locks and sleeping between slices
+     * to stay within the I/O budget. Returns false if the rest of the pass should be skipped.
+     */
+    bool _compactTarget(OperationContext* opCtx, const CompactionTarget& target) {
+        LOGV2(5904006,
+              "Starting background compaction",
+              "namespace"_attr = target.nss,
+              "uuid"_attr = target.uuid,
+              "index"_attr = target.indexName,
+              "freeBytes"_attr = target.freeBytes,
+              "totalBytes"_attr = target.totalBytes);
+
+        {
+            stdx::lock_guard<Client> lk(*opCtx->getClient());
+            CurOp::get(opCtx)->setNS_inlock(target.nss.ns());
+        }
+
+        auto startSize = target.totalBytes;
+        auto endSize = startSize;
+        while (true) {
+            if (!backgroundCompactionEnabled.load()) {
+                return false;
+            }
+            opCtx->checkForInterrupt();
+
+            auto sliceStart = Date_t::now();
+            Status status = Status::OK();
+            {
+                AutoGetCollection coll(
+                    opCtx, NamespaceStringOrUUID(target.nss.db().toString(), target.uuid), MODE_IX);
+                if (!coll) {
+                    return true;
+                }
+
+                auto sliceLimit = Seconds(backgroundCompactionSliceSecs.load());
+                if (!target.indexName) {
+                    auto rs = coll->getRecordStore();
+                    status = rs->compact(opCtx, sliceLimit);
+                    endSize = rs->storageSize(opCtx);
+                } else {
+                    auto indexCatalog = coll->getIndexCatalog();
+                    auto desc = indexCatalog->findIndexByName(opCtx, *target.indexName);
+                    if (!desc) {
+                        return true;
+                    }
+                    auto iam = indexCatalog->getEntry(desc)->accessMethod();
+                    status = iam->compact(opCtx, sliceLimit);
+                    endSize = iam->getSpaceUsedBytes(opCtx);
+                }
+            }
+            auto sliceDuration = Date_t::now() - sliceStart;
+            compactionSlices.increment();
+
+            if (status.isOK()) {
+                break;
+            }
+
+            if (status == ErrorCodes::Interrupted) {
+                // The storage engine gave up because of cache pressure. Back off until the next
+                // pass rather than adding to the load.
+                LOGV2(5904007,
+                      "Background compaction stopped by the storage engine",
+                      "namespace"_attr = target.nss,
+                      "index"_attr = target.indexName,
+                      "error"_attr = status);
+                _recordReclaimed(startSize, endSize);
+                return false;
+            }
+
+            if (status != ErrorCodes::ExceededTimeLimit) {
+                LOGV2_WARNING(5904008,
+                              "Background compaction failed",
+                              "namespace"_attr = target.nss,
+                              "index"_attr = target.indexName,
+                              "error"_attr = status);
+                _recordReclaimed(startSize, endSize);
+                return true;
+            }
+
+            // Stay within the I/O budget by sleeping in proportion to the time spent compacting.
+            auto budgetPercent = backgroundCompactionIOBudgetPercent.load();
+            if (!_sleepFor(sliceDuration * (100 - budgetPercent) / budgetPercent)) {
+                return false;
+            }
+        }
+
+        _recordReclaimed(startSize, endSize);
+        LOGV2(5904009,
+              "Finished background compaction",
+              "namespace"_attr = target.nss,
+              "uuid"_attr = target.uuid,
+              "index"_attr = target.indexName,
+              "bytesReclaimed"_attr = std::max<int64_t>(startSize - endSize, 0));
+        return true;
+    }
+
+    void _recordReclaimed(int64_t startSize, int64_t endSize) {
+        if (startSize > endSize) {
+            compactionBytesReclaimed.increment(startSize - endSize);
+        }
+    }
+
+    // Protects the state below.
+    mutable Mutex _stateMutex = MONGO_MAKE_LATCH("BackgroundCompaction::_stateMutex");
+
+    // Signaled to wake up the thread, if the thread is waiting. The thread will check whether
+    // _shuttingDown is set and stop accordingly.
+    mutable stdx::condition_variable _shuttingDownCV;
+
+    bool _shuttingDown = false;
+};
+
+void startBackgroundCompaction(ServiceContext* serviceContext) {
+    LOGV2(5904010, "Starting background compaction thread");
+    auto service = std::make_unique<BackgroundCompaction>();
+    service->go();
+    BackgroundCompaction::set(serviceContext, std::move(service));
+}
+
+void shutdownBackgroundCompaction(ServiceContext* serviceContext) {
+    BackgroundCompaction* service = BackgroundCompaction::get(serviceContext);
+    // We allow the BackgroundCompaction not to be set in case shutdown occurs before the thread
+    // has been initialized.
+    if (service) {
+        service->shutdown();
+    }
+}
+
+}  // namespace mongo
@@ -112,7 +112,7 @@ StatusWith<int64_t> compactCollection(OperationContext* opCtx,
     auto oldTotalSize = recordStore->storageSize(opCtx) + collection->getIndexSize(opCtx);
     auto indexCatalog = collection->getIndexCatalog();
 
-    Status status = recordStore->compact(opCtx);
+    Status status = recordStore->compact(opCtx, boost::none);
     if (!status.isOK())
         return status;
 
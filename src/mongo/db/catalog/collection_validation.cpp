@@ -33,19 +33,27 @@
 
 #include "mongo/db/catalog/collection_validation.h"
 
+#include <algorithm>
 #include <fmt/format.h>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/index_consistency.h"
 #include "mongo/db/catalog/validate_adaptor.h"
+#include "mongo/db/catalog/validate_gen.h"
+#include "mongo/db/client.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/views/view_catalog.h"
 #include "mongo/logv2/log.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -53,6 +61,8 @@ using logv2::LogComponent;
 using std::string;
 
 MONGO_FAIL_POINT_DEFINE(pauseCollectionValidationWithLock);
+// Adds the warning given by the 'msg' data to the results of every concurrent index traversal.
+MONGO_FAIL_POINT_DEFINE(warnOnConcurrentIndexTraversal);
 
 namespace CollectionValidation {
 
@@ -61,6 +71,17 @@ namespace {
 // Indicates whether the failpoint turned on by testing has been reached.
 AtomicWord<bool> _validationIsPausedForTest{false};
 
+/**
+ * The outcome of traversing an index concurrently with the record store.
+ */
+struct ConcurrentIndexTraversal {
+    Status status = Status::OK();
+    int64_t numTraversedKeys = 0;
+    ValidateResults results;
+};
+
+using ConcurrentIndexTraversals = StringMap<ConcurrentIndexTraversal>;
+
 /**
  * Validates the internal structure of each index in the Index Catalog 'indexCatalog', ensuring that
  * the index files have not been corrupted or compromised.
@@ -105,7 +126,9 @@ void _validateIndexesInternalStructure(OperationContext* opCtx,
 }
 
 /**
- * Validates each index in the Index Catalog using the cursors in 'indexCursors'.
+ * Validates each index in the Index Catalog using the cursors in 'indexCursors'. Indexes found in
+ * 'concurrentTraversals' were already traversed along with the record store, and only have their
+ * results recorded.
  *
  * If 'level' is kValidateFull, then we will compare new index entry counts with a previously taken
  * count saved in 'numIndexKeysPerIndex'.
@@ -113,6 +136,7 @@ void _validateIndexesInternalStructure(OperationContext* opCtx,
 void _validateIndexes(OperationContext* opCtx,
                       ValidateState* validateState,
                       ValidateAdaptor* indexValidator,
+                      ConcurrentIndexTraversals* concurrentTraversals,
                       ValidateResults* results) {
     // Validate Indexes, checking for mismatch between index entries and collection records.
     for (const auto& index : validateState->getIndexes()) {
@@ -120,14 +144,31 @@ void _validateIndexes(OperationContext* opCtx,
 
         const IndexDescriptor* descriptor = index->descriptor();
 
-        LOGV2_OPTIONS(20296,
-                      {LogComponent::kIndex},
-                      "Validating index consistency",
-                      "index"_attr = descriptor->indexName(),
-                      "namespace"_attr = validateState->nss());
-
         int64_t numTraversedKeys;
-        indexValidator->traverseIndex(opCtx, index.get(), &numTraversedKeys, results);
+        auto traversalIt = concurrentTraversals->find(descriptor->indexName());
+        if (traversalIt != concurrentTraversals->end()) {
+            auto& traversal = traversalIt->second;
+            numTraversedKeys = traversal.numTraversedKeys;
+            results->indexResultsMap[descriptor->indexName()] =
+                std::move(traversal.results.indexResultsMap[descriptor->indexName()]);
+            results->errors.insert(results->errors.end(),
+                                   traversal.results.errors.begin(),
+                                   traversal.results.errors.end());
+            results->warnings.insert(results->warnings.end(),
+                                     traversal.results.warnings.begin(),
+                                     traversal.results.warnings.end());
+            if (!traversal.results.valid) {
+                results->valid = false;
+            }
+        } else {
+            LOGV2_OPTIONS(20296,
+                          {LogComponent::kIndex},
+                          "Validating index consistency",
+                          "index"_attr = descriptor->indexName(),
+                          "namespace"_attr = validateState->nss());
+
+            indexValidator->traverseIndex(opCtx, index.get(), &numTraversedKeys, results);
+        }
 
         auto& curIndexResults = (results->indexResultsMap)[descriptor->indexName()];
         curIndexResults.keysTraversed = numTraversedKeys;
@@ -165,6 +206,147 @@ void _validateIndexes(OperationContext* opCtx,
     }
 }
 
+/**
+ * Traverses the record store on this thread while traversing the indexes on threads of their own,
+ * up to 'maxValidateParallelIndexTraversals' at a time, which all share the I/O throttle of this
+ * validation. Wildcard indexes are left to _validateIndexes(), as their multikey metadata keys can
+ * only be checked once all the documents have been seen. Returns the outcome of each index
+ * traversal, by index name.
+ */
+ConcurrentIndexTraversals _traverseRecordStoreAndIndexes(OperationContext* opCtx,
+                                                         ValidateState* validateState,
+                                                         ValidateAdaptor* indexValidator,
+                                                         ValidateResults* results,
+                                                         BSONObjBuilder* output) {
+    ConcurrentIndexTraversals traversals;
+    for (const auto& index : validateState->getIndexes()) {
+        if (index->descriptor()->getIndexType() != IndexType::INDEX_WILDCARD) {
+            traversals.try_emplace(index->descriptor()->indexName());
+        }
+    }
+    if (traversals.empty()) {
+        indexValidator->traverseRecordStore(opCtx, results, output);
+        return traversals;
+    }
+
+    ThreadPool::Options options;
+    options.poolName = "ValidateIndexTraversal";
+    options.minThreads = 0;
+    options.maxThreads = gMaxValidateParallelIndexTraversals.load();
+    options.onCreateThread = [](const std::string& name) { Client::initThread(name); };
+    ThreadPool pool(options);
+    pool.startup();
+
+    // Stops the index traversals still running once this thread is done, whether it completed
+    // the record store traversal or not. They are killed rather than waited for, as one waiting
+    // for its locks behind a DDL operation would otherwise wait for the locks this thread holds.
+    AtomicWord<bool> stopped{false};
+    Mutex mutex = MONGO_MAKE_LATCH("ValidateIndexTraversal::mutex");
+    stdx::condition_variable pendingCV;
+    size_t numPending = traversals.size();
+    std::vector<OperationContext*> indexOpCtxs;
+    ON_BLOCK_EXIT([&] {
+        {
+            stdx::lock_guard<Latch> lk(mutex);
+            stopped.store(true);
+            for (auto indexOpCtx : indexOpCtxs) {
+                stdx::lock_guard<Client> clientLock(*indexOpCtx->getClient());
+                indexOpCtx->getServiceContext()->killOperation(
+                    clientLock, indexOpCtx, ErrorCodes::Interrupted);
+            }
+        }
+        pool.shutdown();
+        pool.join();
+    });
+
+    const NamespaceString nss = validateState->nss();
+    for (const auto& index : validateState->getIndexes()) {
+        auto traversalIt = traversals.find(index->descriptor()->indexName());
+        if (traversalIt == traversals.end()) {
+            continue;
+        }
+
+        ConcurrentIndexTraversal* traversal = &traversalIt->second;
+        const IndexCatalogEntry* entry = index.get();
+        pool.schedule([&, traversal, entry](Status status) {
+            ON_BLOCK_EXIT([&] {
+                stdx::lock_guard<Latch> lk(mutex);
+                if (--numPending == 0) {
+                    pendingCV.notify_all();
+                }
+            });
+
+            auto checkNotStopped = [&] {
+                uassert(ErrorCodes::Interrupted,
+                        str::stream() << "Interrupted due to: validation of " << nss
+                                      << " stopped before traversing index "
+                                      << entry->descriptor()->indexName(),
+                        !stopped.load());
+            };
+
+            try {
+                uassertStatusOK(status);
+                checkNotStopped();
+
+                LOGV2_OPTIONS(5903900,
+                              {LogComponent::kIndex},
+                              "Validating index consistency concurrently with the collection",
+                              "index"_attr = entry->descriptor()->indexName(),
+                              "namespace"_attr = nss);
+
+                auto indexOpCtx = cc().makeOperationContext();
+                {
+                    stdx::lock_guard<Latch> lk(mutex);
+                    checkNotStopped();
+                    indexOpCtxs.push_back(indexOpCtx.get());
+                }
+                ON_BLOCK_EXIT([&] {
+                    stdx::lock_guard<Latch> lk(mutex);
+                    indexOpCtxs.erase(
+                        std::find(indexOpCtxs.begin(), indexOpCtxs.end(), indexOpCtx.get()));
+                });
+
+                ParallelIndexTraversal indexTraversal(indexOpCtx.get(), validateState, nss, entry);
+                indexValidator->traverseIndexConcurrently(
+                    indexOpCtx.get(),
+                    entry,
+                    indexTraversal.getCursor(),
+                    [&](OperationContext* indexOpCtx) {
+                        checkNotStopped();
+                        indexTraversal.yield(indexOpCtx);
+                    },
+                    &traversal->numTraversedKeys,
+                    &traversal->results);
+
+                warnOnConcurrentIndexTraversal.execute([&](const BSONObj& data) {
+                    traversal->results.warnings.push_back(data["msg"].str());
+                });
+            } catch (const DBException& ex) {
+                traversal->status = ex.toStatus();
+                stopped.store(true);
+            }
+        });
+    }
+
+    indexValidator->traverseRecordStore(opCtx, results, output);
+
+    // Yield periodically while waiting, as the index traversals could otherwise wait for their
+    // locks behind a DDL operation that waits for ours.
+    stdx::unique_lock<Latch> lk(mutex);
+    while (!opCtx->waitForConditionOrInterruptFor(
+        pendingCV, lk, Milliseconds(100), [&] { return numPending == 0; })) {
+        lk.unlock();
+        validateState->yield(opCtx);
+        lk.lock();
+    }
+    lk.unlock();
+
+    for (const auto& [indexName, traversal] : traversals) {
+        uassertStatusOK(traversal.status);
+    }
+    return traversals;
+}
+
 /**
  * Executes the second phase of validation for improved error reporting. This is only done if
  * any index inconsistencies are found during the first phase of validation.
@@ -517,8 +699,14 @@ Status validate(OperationContext* opCtx,
 
         // In traverseRecordStore(), the index validator keeps track the records in the record
         // store so that _validateIndexes() can confirm that the index entries match the records in
-        // the collection.
-        indexValidator.traverseRecordStore(opCtx, results, output);
+        // the collection. When allowed, the indexes are traversed at the same time.
+        ConcurrentIndexTraversals concurrentIndexTraversals;
+        if (validateState.canTraverseIndexesInParallel()) {
+            concurrentIndexTraversals = _traverseRecordStoreAndIndexes(
+                opCtx, &validateState, &indexValidator, results, output);
+        } else {
+            indexValidator.traverseRecordStore(opCtx, results, output);
+        }
 
         // Pause collection validation while a lock is held and between collection and index data
         // validation.
@@ -544,7 +732,8 @@ Status validate(OperationContext* opCtx,
         }
 
         // Validate indexes and check for mismatches.
-        _validateIndexes(opCtx, &validateState, &indexValidator, results);
+        _validateIndexes(
+            opCtx, &validateState, &indexValidator, &concurrentIndexTraversals, results);
 
         if (indexConsistency.haveEntryMismatch()) {
             LOGV2_OPTIONS(20305,
@@ -34,6 +34,8 @@
 #include "mongo/db/catalog/catalog_test_fixture.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/idl/server_parameter_test_util.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/fail_point.h"
@@ -58,7 +60,6 @@ protected:
      */
     explicit CollectionValidationTest(std::string engine) : CatalogTestFixture(std::move(engine)) {}
 
-private:
     void setUp() override {
         CatalogTestFixture::setUp();
 
@@ -87,6 +88,24 @@ public:
     BackgroundCollectionValidationTest() : CollectionValidationTest("wiredTiger") {}
 };
 
+/**
+ * Test fixture for background collection validation on a replica set member, which reads at a
+ * timestamp and can therefore traverse the indexes on threads of their own.
+ */
+class ReplicaSetBackgroundCollectionValidationTest : public BackgroundCollectionValidationTest {
+protected:
+    void setUp() override {
+        BackgroundCollectionValidationTest::setUp();
+
+        repl::ReplSettings settings;
+        settings.setReplSetString("mySet/node1:12345");
+        auto service = getServiceContext();
+        auto replCoord = std::make_unique<repl::ReplicationCoordinatorMock>(service, settings);
+        ASSERT_OK(replCoord->setFollowerMode(repl::MemberState::RS_PRIMARY));
+        repl::ReplicationCoordinator::set(service, std::move(replCoord));
+    }
+};
+
 /**
  * Calls validate on collection kNss with both kValidateFull and kValidateNormal validation levels
  * and verifies the results.
@@ -316,5 +335,55 @@ TEST_F(BackgroundCollectionValidationTest, BackgroundValidateRunsConcurrentlyWit
                        0);
 }
 
+TEST_F(ReplicaSetBackgroundCollectionValidationTest, BackgroundValidateTraversesIndexesInParallel) {
+    auto opCtx = operationContext();
+    ASSERT_OK(storageInterface()->createIndexesOnEmptyCollection(
+        opCtx,
+        kNss,
+        {BSON("v" << 2 << "key" << BSON("a" << 1) << "name"
+                  << "a_1")}));
+    int numRecords = insertDataRange(opCtx, 0, 20);
+
+    RAIIServerParameterControllerForTest controller("maxValidateParallelIndexTraversals", 2);
+    startCapturingLogMessages();
+    backgroundValidate(opCtx, true, numRecords, 0, 0, /*runForegroundAsWell*/ false);
+    stopCapturingLogMessages();
+
+    // Both the _id and the a_1 index were traversed concurrently with the collection.
+    ASSERT_EQ(2,
+              countTextFormatLogLinesContaining(
+                  "Validating index consistency concurrently with the collection"));
+}
+
+TEST_F(ReplicaSetBackgroundCollectionValidationTest,
+       BackgroundValidateReportsWarningsOfParallelIndexTraversals) {
+    auto opCtx = operationContext();
+    int numRecords = insertDataRange(opCtx, 0, 20);
+    opCtx->recoveryUnit()->waitUntilUnjournaledWritesDurable(opCtx, /*stableTimestamp*/ false);
+
+    RAIIServerParameterControllerForTest controller("maxValidateParallelIndexTraversals", 2);
+    FailPointEnableBlock warn("warnOnConcurrentIndexTraversal",
+                              BSON("msg"
+                                   << "index traversal warning"));
+
+    ValidateResults validateResults;
+    BSONObjBuilder output;
+    ASSERT_OK(CollectionValidation::validate(opCtx,
+                                             kNss,
+                                             CollectionValidation::ValidateMode::kBackground,
+                                             CollectionValidation::RepairMode::kNone,
+                                             &validateResults,
+                                             &output));
+
+    // The warning of the _id index traversal is reported, without making the collection invalid.
+    ASSERT(validateResults.valid);
+    ASSERT_EQ(0U, validateResults.errors.size());
+    ASSERT_EQ(1,
+              std::count(validateResults.warnings.begin(),
+                         validateResults.warnings.end(),
+                         "index traversal warning"));
+    ASSERT_EQ(output.obj().getIntField("nrecords"), numRecords);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -1665,7 +1665,7 @@ Status IndexCatalogImpl::compactIndexes(OperationContext* opCtx) const {
                     1,
                     "compacting index: {entry_descriptor}",
                     "entry_descriptor"_attr = *(entry->descriptor()));
-        Status status = entry->accessMethod()->compact(opCtx);
+        Status status = entry->accessMethod()->compact(opCtx, boost::none);
         if (!status.isOK()) {
             LOGV2_ERROR(20377,
                         "Failed to compact index",
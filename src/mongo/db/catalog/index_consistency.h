@@ -32,6 +32,7 @@
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/catalog/validate_state.h"
 #include "mongo/db/storage/key_string.h"
+#include "mongo/platform/atomic_word.h"
 
 namespace mongo {
 
@@ -91,6 +92,10 @@ struct IndexEntryInfo {
  * document to ensure there is a one-to-one mapping for each key.
  * In addition, an IndexObserver class can be hooked into the IndexAccessMethod to inform
  * this class about changes to the indexes during a validation and compensate for them.
+ *
+ * During the first phase of validation, document keys and the keys of different indexes may be
+ * added concurrently from different threads, as long as each IndexInfo is only updated by one of
+ * them.
  */
 class IndexConsistency final {
     using IndexInfoMap = std::map<std::string, IndexInfo>;
@@ -179,8 +184,8 @@ public:
 
 private:
     struct IndexKeyBucket {
-        uint32_t indexKeyCount;
-        uint32_t bucketSizeBytes;
+        AtomicWord<uint32_t> indexKeyCount;
+        AtomicWord<uint32_t> bucketSizeBytes;
     };
 
     IndexConsistency() = delete;
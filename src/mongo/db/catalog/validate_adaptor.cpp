@@ -257,10 +257,12 @@ void _validateKeyOrder(OperationContext* opCtx,
 }
 }  // namespace
 
-void ValidateAdaptor::traverseIndex(OperationContext* opCtx,
-                                    const IndexCatalogEntry* index,
-                                    int64_t* numTraversedKeys,
-                                    ValidateResults* results) {
+int64_t ValidateAdaptor::_traverseIndexKeys(OperationContext* opCtx,
+                                            const IndexCatalogEntry* index,
+                                            SortedDataInterfaceThrottleCursor* indexCursor,
+                                            const std::function<void(OperationContext*)>& yield,
+                                            bool reportProgress,
+                                            ValidateResults* results) {
     const IndexDescriptor* descriptor = index->descriptor();
     auto indexName = descriptor->indexName();
     auto& indexResults = results->indexResultsMap[indexName];
@@ -269,14 +271,6 @@ void ValidateAdaptor::traverseIndex(OperationContext* opCtx,
 
     bool isFirstEntry = true;
 
-    // The progress meter will be inactive after traversing the record store to allow the message
-    // and the total to be set to different values.
-    if (!_progress->isActive()) {
-        const char* curopMessage = "Validate: scanning index entries";
-        stdx::unique_lock<Client> lk(*opCtx->getClient());
-        _progress.set(CurOp::get(opCtx)->setProgress_inlock(curopMessage, _totalIndexKeys));
-    }
-
     const KeyString::Version version =
         index->accessMethod()->getSortedDataInterface()->getKeyStringVersion();
 
@@ -289,12 +283,6 @@ void ValidateAdaptor::traverseIndex(OperationContext* opCtx,
     KeyString::Value firstKeyString = firstKeyStringBuilder.release();
     KeyString::Value prevIndexKeyStringValue;
 
-    // Ensure that this index has an open index cursor.
-    const auto indexCursorIt = _validateState->getIndexCursors().find(indexName);
-    invariant(indexCursorIt != _validateState->getIndexCursors().end());
-
-    const std::unique_ptr<SortedDataInterfaceThrottleCursor>& indexCursor = indexCursorIt->second;
-
     boost::optional<KeyStringEntry> indexEntry;
     try {
         indexEntry = indexCursor->seekForKeyString(opCtx, firstKeyString);
@@ -334,7 +322,9 @@ void ValidateAdaptor::traverseIndex(OperationContext* opCtx,
             }
         }
 
-        _progress->hit();
+        if (reportProgress) {
+            _progress->hit();
+        }
         numKeys++;
         isFirstEntry = false;
         prevIndexKeyStringValue = indexEntry->keyString;
@@ -342,7 +332,7 @@ void ValidateAdaptor::traverseIndex(OperationContext* opCtx,
         if (numKeys % kInterruptIntervalNumRecords == 0) {
             // Periodically checks for interrupts and yields.
             opCtx->checkForInterrupt();
-            _validateState->yield(opCtx);
+            yield(opCtx);
         }
 
         try {
@@ -359,6 +349,53 @@ void ValidateAdaptor::traverseIndex(OperationContext* opCtx,
         }
     }
 
+    return numKeys;
+}
+
+void ValidateAdaptor::traverseIndexConcurrently(OperationContext* opCtx,
+                                                const IndexCatalogEntry* index,
+                                                SortedDataInterfaceThrottleCursor* indexCursor,
+                                                const std::function<void(OperationContext*)>& yield,
+                                                int64_t* numTraversedKeys,
+                                                ValidateResults* results) {
+    invariant(index->descriptor()->getIndexType() != IndexType::INDEX_WILDCARD);
+    invariant(!_validateState->adjustMultikey());
+
+    const int64_t numKeys = _traverseIndexKeys(
+        opCtx, index, indexCursor, yield, /*reportProgress=*/false, results);
+    if (numTraversedKeys) {
+        *numTraversedKeys = numKeys;
+    }
+}
+
+void ValidateAdaptor::traverseIndex(OperationContext* opCtx,
+                                    const IndexCatalogEntry* index,
+                                    int64_t* numTraversedKeys,
+                                    ValidateResults* results) {
+    const IndexDescriptor* descriptor = index->descriptor();
+    auto indexName = descriptor->indexName();
+    IndexInfo& indexInfo = _indexConsistency->getIndexInfo(indexName);
+
+    // The progress meter will be inactive after traversing the record store to allow the message
+    // and the total to be set to different values.
+    if (!_progress->isActive()) {
+        const char* curopMessage = "Validate: scanning index entries";
+        stdx::unique_lock<Client> lk(*opCtx->getClient());
+        _progress.set(CurOp::get(opCtx)->setProgress_inlock(curopMessage, _totalIndexKeys));
+    }
+
+    // Ensure that this index has an open index cursor.
+    const auto indexCursorIt = _validateState->getIndexCursors().find(indexName);
+    invariant(indexCursorIt != _validateState->getIndexCursors().end());
+
+    const int64_t numKeys = _traverseIndexKeys(
+        opCtx,
+        index,
+        indexCursorIt->second.get(),
+        [this](OperationContext* opCtx) { _validateState->yield(opCtx); },
+        /*reportProgress=*/true,
+        results);
+
     if (results && _indexConsistency->getMultikeyMetadataPathCount(&indexInfo) > 0) {
         results->errors.push_back(str::stream()
                                   << "Index '" << descriptor->indexName()
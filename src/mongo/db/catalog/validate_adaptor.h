@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include "mongo/db/catalog/validate_state.h"
 #include "mongo/util/progress_meter.h"
 
@@ -68,6 +70,20 @@ public:
                        int64_t* numTraversedKeys,
                        ValidateResults* results);
 
+    /**
+     * Traverses the index like the first phase of traverseIndex(), but on a thread other than the
+     * one validating the collection, concurrently with traverseRecordStore(). 'indexCursor' must
+     * belong to 'opCtx', and 'yield' is periodically called instead of ValidateState::yield().
+     * Neither reports progress nor checks multikey metadata, so this cannot be used for wildcard
+     * indexes or when adjusting multikey metadata.
+     */
+    void traverseIndexConcurrently(OperationContext* opCtx,
+                                   const IndexCatalogEntry* index,
+                                   SortedDataInterfaceThrottleCursor* indexCursor,
+                                   const std::function<void(OperationContext*)>& yield,
+                                   int64_t* numTraversedKeys,
+                                   ValidateResults* results);
+
     /**
      * Traverses the record store to retrieve every record and go through its document key
      * set to keep track of the index consistency during a validation.
@@ -85,6 +101,17 @@ public:
                                IndexValidateResults& results);
 
 private:
+    /**
+     * Feeds every entry of the index read through 'indexCursor' to the IndexConsistency and
+     * returns how many there were.
+     */
+    int64_t _traverseIndexKeys(OperationContext* opCtx,
+                               const IndexCatalogEntry* index,
+                               SortedDataInterfaceThrottleCursor* indexCursor,
+                               const std::function<void(OperationContext*)>& yield,
+                               bool reportProgress,
+                               ValidateResults* results);
+
     IndexConsistency* _indexConsistency;
     CollectionValidation::ValidateState* _validateState;
 
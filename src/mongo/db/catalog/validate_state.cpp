@@ -37,6 +37,7 @@
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/index_consistency.h"
 #include "mongo/db/catalog/validate_adaptor.h"
+#include "mongo/db/catalog/validate_gen.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/operation_context.h"
@@ -270,6 +271,10 @@ void ValidateState::initializeCursors(OperationContext* opCtx) {
     _firstRecordId = record ? record->id : RecordId();
 }
 
+bool ValidateState::canTraverseIndexesInParallel() const {
+    return isBackground() && _validateTs && gMaxValidateParallelIndexTraversals.load() > 0;
+}
+
 void ValidateState::_relockDatabaseAndCollection(OperationContext* opCtx) {
     invariant(isBackground());
 
@@ -307,5 +312,65 @@ void ValidateState::_relockDatabaseAndCollection(OperationContext* opCtx) {
     _nss = _collection->ns();
 }
 
+ParallelIndexTraversal::ParallelIndexTraversal(OperationContext* opCtx,
+                                               ValidateState* validateState,
+                                               const NamespaceString& nss,
+                                               const IndexCatalogEntry* index)
+    : _validateState(validateState),
+      _nss(nss),
+      _index(index),
+      _noPBWM(opCtx->lockState()),
+      _globalLock(opCtx, MODE_IS) {
+    invariant(_validateState->canTraverseIndexesInParallel());
+
+    _lockDatabaseAndCollection(opCtx);
+
+    opCtx->recoveryUnit()->setTimestampReadSource(RecoveryUnit::ReadSource::kProvided,
+                                                  _validateState->_validateTs);
+    _cursor = std::make_unique<SortedDataInterfaceThrottleCursor>(
+        opCtx, _index->accessMethod(), &_validateState->_dataThrottle);
+}
+
+void ParallelIndexTraversal::yield(OperationContext* opCtx) {
+    _cursor->save();
+
+    _collectionLock.reset();
+    _databaseLock.reset();
+    _lockDatabaseAndCollection(opCtx);
+
+    // Refresh the snapshot at the same timestamp to ameliorate WiredTiger cache pressure, like the
+    // thread running the validation does.
+    _cursor->detachFromOperationContext();
+    opCtx->recoveryUnit()->refreshSnapshot();
+    _cursor->reattachToOperationContext(opCtx);
+
+    _cursor->restore();
+}
+
+void ParallelIndexTraversal::_lockDatabaseAndCollection(OperationContext* opCtx) {
+    const UUID uuid = _validateState->uuid();
+
+    _databaseLock.emplace(opCtx, _nss.db(), MODE_IS);
+    try {
+        _collectionLock.emplace(
+            opCtx, NamespaceStringOrUUID(std::string(_nss.db()), uuid), MODE_IS);
+    } catch (const ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
+        uasserted(ErrorCodes::Interrupted,
+                  str::stream() << "Interrupted due to: collection drop: " << _nss << " (" << uuid
+                                << ") while validating the collection");
+    }
+
+    uassert(ErrorCodes::Interrupted,
+            str::stream() << "Interrupted due to: catalog restart: " << _nss << " (" << uuid
+                          << ") while validating the collection",
+            _validateState->_catalogGeneration ==
+                opCtx->getServiceContext()->getCatalogGeneration());
+    uassert(ErrorCodes::Interrupted,
+            str::stream() << "Interrupted due to: index being validated was dropped from "
+                          << "collection: " << _nss << " (" << uuid
+                          << "), index: " << _index->descriptor()->indexName(),
+            !_index->isDropped());
+}
+
 }  // namespace CollectionValidation
 }  // namespace mongo
@@ -169,7 +169,18 @@ public:
         return _validateTs;
     }
 
+    /**
+     * Returns whether indexes may be traversed on threads of their own, concurrently with the
+     * record store traversal, as allowed by the 'maxValidateParallelIndexTraversals' server
+     * parameter. Only background validation reading at a timestamp may do so: every thread can
+     * then read the same snapshot while only holding intent locks, which it yields periodically.
+     * Must be called after initializeCursors().
+     */
+    bool canTraverseIndexesInParallel() const;
+
 private:
+    friend class ParallelIndexTraversal;
+
     ValidateState() = delete;
 
     /**
@@ -244,5 +255,55 @@ private:
     boost::optional<Timestamp> _validateTs = boost::none;
 };
 
+/**
+ * Holds the locks, storage snapshot and cursor used to traverse one index of a background
+ * validation on a thread other than the one running the validation. Like the validation itself,
+ * takes the same intent locks and reads at the same timestamp, see
+ * ValidateState::canTraverseIndexesInParallel().
+ */
+class ParallelIndexTraversal {
+    ParallelIndexTraversal(const ParallelIndexTraversal&) = delete;
+    ParallelIndexTraversal& operator=(const ParallelIndexTraversal&) = delete;
+
+public:
+    /**
+     * 'nss' is the namespace of the collection when the traversal was scheduled, as the thread
+     * running the validation updates ValidateState::nss() on renames. Throws Interrupted if the
+     * collection or 'index' was dropped since the validation started.
+     */
+    ParallelIndexTraversal(OperationContext* opCtx,
+                           ValidateState* validateState,
+                           const NamespaceString& nss,
+                           const IndexCatalogEntry* index);
+
+    SortedDataInterfaceThrottleCursor* getCursor() const {
+        return _cursor.get();
+    }
+
+    /**
+     * Yields the locks and refreshes the snapshot, like ValidateState::yield() does for
+     * background validation. Throws Interrupted if validation cannot continue.
+     */
+    void yield(OperationContext* opCtx);
+
+private:
+    /**
+     * Acquires the database and collection locks, and checks that neither the collection nor the
+     * index being traversed are gone.
+     */
+    void _lockDatabaseAndCollection(OperationContext* opCtx);
+
+    ValidateState* const _validateState;
+    const NamespaceString _nss;
+    const IndexCatalogEntry* const _index;
+
+    ShouldNotConflictWithSecondaryBatchApplicationBlock _noPBWM;
+    Lock::GlobalLock _globalLock;
+    boost::optional<Lock::DBLock> _databaseLock;
+    boost::optional<Lock::CollectionLock> _collectionLock;
+
+    std::unique_ptr<SortedDataInterfaceThrottleCursor> _cursor;
+};
+
 }  // namespace CollectionValidation
 }  // namespace mongo
@@ -42,6 +42,7 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/storage/snapshot_manager.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
+#include "mongo/idl/server_parameter_test_util.h"
 #include "mongo/util/fail_point.h"
 
 namespace mongo {
@@ -310,5 +311,24 @@ TEST_F(ValidateStateTest, CursorsAreNotOpenedAgainstCheckpointedIndexesThatWereL
     ASSERT_EQ(validateState.getIndexes().size(), 3);
 }
 
+// Indexes are only traversed in parallel by background validation reading at a timestamp, which
+// standalones do not have.
+TEST_F(ValidateStateTest, IndexesAreNotTraversedInParallelWithoutValidateTimestamp) {
+    auto opCtx = operationContext();
+    createCollectionAndPopulateIt(opCtx, kNss);
+    createIndex(opCtx, kNss, BSON("a" << 1));
+
+    RAIIServerParameterControllerForTest controller("maxValidateParallelIndexTraversals", 4);
+
+    for (auto mode : {CollectionValidation::ValidateMode::kForeground,
+                      CollectionValidation::ValidateMode::kBackground}) {
+        CollectionValidation::ValidateState validateState(
+            opCtx, kNss, mode, CollectionValidation::RepairMode::kNone);
+        validateState.initializeCursors(opCtx);
+        ASSERT_FALSE(validateState.getValidateTimestamp());
+        ASSERT_FALSE(validateState.canTraverseIndexesInParallel());
+    }
+}
+
 }  // namespace
 }  // namespace mongo
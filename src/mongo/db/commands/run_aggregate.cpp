@@ -818,6 +818,12 @@ Status runAggregate(OperationContext* opCtx,
                                                           std::move(attachExecutorCallback.second),
                                                           pipeline.get());
 
+            // An exchange already splits the pipeline between several cursors, each of which is
+            // driven by its own client.
+            if (!request.getExchange()) {
+                PipelineD::parallelizeGroupIfEligible(pipeline.get());
+            }
+
             auto pipelines =
                 createExchangePipelinesIfNeeded(opCtx, expCtx, request, std::move(pipeline), uuid);
             for (auto&& pipelineIt : pipelines) {
@@ -126,6 +126,8 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
             }
 
             _cursor = collection()->getCursor(opCtx(), forward);
+            // Tailable scans mostly wait at the end of the collection for new records to appear.
+            _cursor->setReadAhead(!_params.tailable);
 
             if (!_lastSeenId.isNull()) {
                 invariant(_params.tailable);
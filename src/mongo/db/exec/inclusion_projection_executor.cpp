@@ -149,6 +149,7 @@ std::pair<BSONObj, bool> InclusionNode::extractComputedProjectionsInProject(
     }
 
     if (!addFieldsExpressions.empty()) {
+        makeOptimizationsStale();
         BSONObjBuilder bb;
         for (const auto& expressionSpec : addFieldsExpressions) {
             auto&& fieldName = std::get<0>(expressionSpec).toString();
@@ -217,6 +218,7 @@ std::pair<BSONObj, bool> InclusionNode::extractComputedProjectionsInAddFields(
     }
 
     if (!addFieldsExpressions.empty()) {
+        makeOptimizationsStale();
         BSONObjBuilder bb;
         for (const auto& expressionSpec : addFieldsExpressions) {
             auto&& fieldName = expressionSpec.first.toString();
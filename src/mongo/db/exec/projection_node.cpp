@@ -188,6 +188,20 @@ void ProjectionNode::outputProjectedField(StringData field, Value val, MutableDo
 }
 
 void ProjectionNode::applyExpressions(const Document& root, MutableDocument* outputDoc) const {
+    if (_compiledAdditionsAndChildren) {
+        for (auto&& addition : *_compiledAdditionsAndChildren) {
+            if (addition.child) {
+                outputDoc->setField(addition.field,
+                                    addition.child->applyExpressionsToValue(
+                                        root, outputDoc->peek()[addition.field]));
+            } else {
+                outputDoc->setField(addition.field,
+                                    addition.expression->evaluate(root, addition.variables));
+            }
+        }
+        return;
+    }
+
     for (auto&& field : _orderToProcessAdditionsAndChildren) {
         auto childIt = _children.find(field);
         if (childIt != _children.end()) {
@@ -266,6 +280,22 @@ void ProjectionNode::optimize() {
     }
 
     _maxFieldsToProject = maxFieldsToProject();
+
+    std::vector<CompiledAddition> compiled;
+    for (auto&& field : _orderToProcessAdditionsAndChildren) {
+        if (auto child = getChild(field)) {
+            compiled.push_back({field, child, boost::none, nullptr});
+        } else {
+            auto expressionIt = _expressions.find(field);
+            invariant(expressionIt != _expressions.end());
+            auto&& expr = expressionIt->second;
+            compiled.push_back({field,
+                                nullptr,
+                                CompiledExpression::compile(expr),
+                                &expr->getExpressionContext()->variables});
+        }
+    }
+    _compiledAdditionsAndChildren = std::move(compiled);
 }
 
 Document ProjectionNode::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
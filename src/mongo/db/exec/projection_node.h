@@ -31,6 +31,7 @@
 
 #include "mongo/db/exec/projection_executor.h"
 
+#include "mongo/db/pipeline/compiled_expression.h"
 #include "mongo/db/query/projection_policies.h"
 
 namespace mongo::projection_executor {
@@ -160,6 +161,16 @@ protected:
     // Writes the given value to the output doc, replacing the existing value of 'field' if present.
     virtual void outputProjectedField(StringData field, Value val, MutableDocument* outDoc) const;
 
+    /**
+     * Indicates that metadata computed by previous calls to optimize() is now stale and must be
+     * recomputed. This must be called any time the tree is updated (an expression added, removed
+     * or replaced, or child node added).
+     */
+    void makeOptimizationsStale() {
+        _maxFieldsToProject = boost::none;
+        _compiledAdditionsAndChildren = boost::none;
+    }
+
     StringMap<std::unique_ptr<ProjectionNode>> _children;
     StringMap<boost::intrusive_ptr<Expression>> _expressions;
     StringSet _projectedFields;
@@ -203,15 +214,6 @@ private:
     // Returns nullptr if no such child exists.
     ProjectionNode* getChild(const std::string& field) const;
 
-    /**
-     * Indicates that metadata computed by previous calls to optimize() is now stale and must be
-     * recomputed. This must be called any time the tree is updated (an expression added or child
-     * node added).
-     */
-    void makeOptimizationsStale() {
-        _maxFieldsToProject = boost::none;
-    }
-
     /**
      * Internal helper function for addExpressionForPath().
      */
@@ -226,5 +228,16 @@ private:
     // optimization which means we don't have to iterate over an entire document. The value is
     // stored here to avoid re-computation for each document.
     boost::optional<size_t> _maxFieldsToProject;
+
+    // One entry per field of '_orderToProcessAdditionsAndChildren', holding either the child node
+    // or the compiled expression for that field. Built by optimize() so that applying expressions
+    // to a document does not need to look every field up in '_children' and '_expressions'.
+    struct CompiledAddition {
+        std::string field;
+        ProjectionNode* child;
+        boost::optional<CompiledExpression> expression;
+        Variables* variables;
+    };
+    boost::optional<std::vector<CompiledAddition>> _compiledAdditionsAndChildren;
 };
 }  // namespace mongo::projection_executor
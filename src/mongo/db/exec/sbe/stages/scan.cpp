@@ -260,6 +260,8 @@ void ScanStage::open(bool reOpen) {
 
         if (!_cursor || !_seekKeyAccessor) {
             _cursor = _coll->getCursor(_opCtx, _forward);
+            // Without a seek key, this stage scans the collection rather than fetching records.
+            _cursor->setReadAhead(!_seekKeyAccessor);
         }
     } else {
         _cursor.reset();
@@ -707,6 +709,7 @@ void ParallelScanStage::open(bool reOpen) {
         }
 
         _cursor = _coll->getCursor(_opCtx);
+        _cursor->setReadAhead(true);
     }
 
     _open = true;
@@ -479,8 +479,9 @@ Status AbstractIndexAccessMethod::update(OperationContext* opCtx,
     return Status::OK();
 }
 
-Status AbstractIndexAccessMethod::compact(OperationContext* opCtx) {
-    return this->_newInterface->compact(opCtx);
+Status AbstractIndexAccessMethod::compact(OperationContext* opCtx,
+                                          boost::optional<Seconds> timeLimit) {
+    return this->_newInterface->compact(opCtx, timeLimit);
 }
 
 class AbstractIndexAccessMethod::BulkBuilderImpl : public IndexAccessMethod::BulkBuilder {
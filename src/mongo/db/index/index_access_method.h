@@ -217,9 +217,9 @@ public:
 
     /**
      * Attempt compaction to regain disk space if the indexed record store supports
-     * compaction-in-place.
+     * compaction-in-place. See RecordStore::compact() for the meaning of 'timeLimit'.
      */
-    virtual Status compact(OperationContext* opCtx) = 0;
+    virtual Status compact(OperationContext* opCtx, boost::optional<Seconds> timeLimit) = 0;
 
     /**
      * Sets this index as multikey with the provided paths.
@@ -532,7 +532,7 @@ public:
                         const CollectionPtr& collection,
                         const BSONObj& key) const final;
 
-    Status compact(OperationContext* opCtx) final;
+    Status compact(OperationContext* opCtx, boost::optional<Seconds> timeLimit) final;
 
     void setIndexIsMultikey(OperationContext* opCtx,
                             const CollectionPtr& collection,
@@ -52,6 +52,7 @@
 #include "mongo/db/auth/auth_op_observer.h"
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/sasl_options.h"
+#include "mongo/db/background_compaction.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/catalog/collection_impl.h"
@@ -111,6 +112,7 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/read_write_concern_defaults_cache_lookup_mongod.h"
 #include "mongo/db/repl/drop_pending_collection_reaper.h"
+#include "mongo/db/repl/file_copy_based_initial_syncer.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/primary_only_service.h"
 #include "mongo/db/repl/primary_only_service_op_observer.h"
@@ -405,6 +407,21 @@ ExitCode _initAndListen(ServiceContext* serviceContext, int listenPort) {
     // initialized, a noop recovery unit is used until the initialization is complete.
     auto startupOpCtx = serviceContext->makeOperationContext(&cc());
 
+    // A file copy based initial sync leaves the files it copied from the sync source next to the
+    // data files, to be swapped in before the storage engine opens them.
+    if (!storageGlobalParams.readOnly && !storageGlobalParams.repair) {
+        auto moved =
+            repl::FileCopyBasedInitialSyncer::moveStagedFilesIntoPlace(storageGlobalParams.dbpath);
+        if (!moved.isOK()) {
+            LOGV2_FATAL_NOTRACE(5904525,
+                                "Failed to move the files copied by file copy based initial sync "
+                                "into the dbpath. The data files are incomplete until the move "
+                                "is done; fix the error and restart the server to resume it",
+                                "dbpath"_attr = storageGlobalParams.dbpath,
+                                "error"_attr = moved.getStatus());
+        }
+    }
+
     auto lastShutdownState = initializeStorageEngine(startupOpCtx.get(), StorageEngineInitFlags{});
     StorageControl::startStorageControls(serviceContext);
 
@@ -707,6 +724,8 @@ ExitCode _initAndListen(ServiceContext* serviceContext, int listenPort) {
             startTTLMonitor(serviceContext);
         }
 
+        startBackgroundCompaction(serviceContext);
+
         if (replSettings.usingReplSets() || !gInternalValidateFeaturesAsPrimary) {
             serverGlobalParams.validateFeaturesAsPrimary.store(false);
         }
@@ -1354,6 +1373,9 @@ void shutdownTask(const ShutdownTaskArgs& shutdownArgs) {
     LOGV2(4784928, "Shutting down the TTL monitor");
     shutdownTTLMonitor(serviceContext);
 
+    LOGV2(5904011, "Shutting down background compaction");
+    shutdownBackgroundCompaction(serviceContext);
+
     // We should always be able to acquire the global lock at shutdown.
     // An OperationContext is not necessary to call lockGlobal() during shutdown, as it's only used
     // to check that lockGlobal() is not called after a transaction timestamp has been set.
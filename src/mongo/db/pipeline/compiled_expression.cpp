@@ -0,0 +1,199 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/compiled_expression.h"
+
+namespace mongo {
+
+namespace {
+struct CompiledNode {
+    CompiledExpression::EvaluateFn fn;
+
+    // Whether 'fn' does anything other than call the interpreter on the node.
+    bool specialized;
+
+    // Whether evaluating the node is deterministic and has no side effects other than possibly
+    // throwing, so that it can be evaluated a second time by the interpreter if a fast path turns
+    // out not to apply.
+    bool pure;
+};
+
+CompiledNode compileNode(const boost::intrusive_ptr<Expression>& expr);
+
+CompiledNode interpret(const boost::intrusive_ptr<Expression>& expr, bool pure) {
+    return {[expr](const Document& root, Variables* variables) {
+                return expr->evaluate(root, variables);
+            },
+            false,
+            pure};
+}
+
+CompiledNode compileConstant(const ExpressionConstant& constant) {
+    return {[value = constant.getValue()](const Document&, Variables*) { return value; },
+            true,
+            true};
+}
+
+CompiledNode compileFieldPath(const boost::intrusive_ptr<ExpressionFieldPath>& fieldPath) {
+    const auto& path = fieldPath->getFieldPath();
+    if (fieldPath->getVariableId() != Variables::kRootId || path.getPathLength() == 1) {
+        return interpret(fieldPath, true);
+    }
+
+    // The first component of the path names the variable.
+    std::vector<std::string> fields;
+    for (size_t i = 1; i < path.getPathLength(); ++i) {
+        fields.push_back(path.getFieldName(i).toString());
+    }
+
+    return {[fieldPath, fields = std::move(fields)](const Document& root, Variables* variables) {
+                Value value = root[fields[0]];
+                for (size_t i = 1; i < fields.size(); ++i) {
+                    if (value.getType() == BSONType::Object) {
+                        value = value.getDocument()[fields[i]];
+                    } else if (value.getType() == BSONType::Array) {
+                        // Traversing arrays implicitly collects the path from every element, which
+                        // is rare enough to be left to the interpreter.
+                        return fieldPath->evaluate(root, variables);
+                    } else {
+                        return Value();
+                    }
+                }
+                return value;
+            },
+            true,
+            true};
+}
+
+CompiledNode compileAdd(const boost::intrusive_ptr<Expression>& expr) {
+    auto lhs = compileNode(expr->getChildren()[0]);
+    auto rhs = compileNode(expr->getChildren()[1]);
+    if (!lhs.pure || !rhs.pure) {
+        return interpret(expr, false);
+    }
+
+    return {[expr, lhs = std::move(lhs.fn), rhs = std::move(rhs.fn)](const Document& root,
+                                                                     Variables* variables) {
+                // The interpreter stops at a non-numeric first operand without evaluating the
+                // second one, so only evaluate it here once we know we may take a fast path.
+                Value left = lhs(root, variables);
+                if (left.getType() == NumberInt) {
+                    Value right = rhs(root, variables);
+                    if (right.getType() == NumberInt) {
+                        return Value::createIntOrLong(static_cast<long long>(left.getInt()) +
+                                                      right.getInt());
+                    }
+                } else if (left.getType() == NumberDouble) {
+                    Value right = rhs(root, variables);
+                    if (right.getType() == NumberDouble) {
+                        // The interpreter sums starting from 0.0, which turns (-0.0 + -0.0) into
+                        // 0.0; do the same.
+                        return Value((0.0 + left.getDouble()) + right.getDouble());
+                    }
+                }
+
+                // Dates, longs, decimals and mixed types need the interpreter's compensated sum.
+                // The operands are pure, so evaluating them again yields the same values.
+                return expr->evaluate(root, variables);
+            },
+            true,
+            true};
+}
+
+CompiledNode compileSubtract(const boost::intrusive_ptr<Expression>& expr) {
+    auto lhs = compileNode(expr->getChildren()[0]);
+    auto rhs = compileNode(expr->getChildren()[1]);
+
+    return {[lhs = std::move(lhs.fn), rhs = std::move(rhs.fn)](const Document& root,
+                                                               Variables* variables) {
+                Value left = lhs(root, variables);
+                Value right = rhs(root, variables);
+                if (left.getType() == NumberInt && right.getType() == NumberInt) {
+                    return Value::createIntOrLong(static_cast<long long>(left.getInt()) -
+                                                  right.getInt());
+                } else if (left.getType() == NumberDouble && right.getType() == NumberDouble) {
+                    return Value(left.getDouble() - right.getDouble());
+                }
+                return uassertStatusOK(ExpressionSubtract::apply(left, right));
+            },
+            true,
+            lhs.pure && rhs.pure};
+}
+
+CompiledNode compileMultiply(const boost::intrusive_ptr<Expression>& expr) {
+    auto lhs = compileNode(expr->getChildren()[0]);
+    auto rhs = compileNode(expr->getChildren()[1]);
+
+    return {[lhs = std::move(lhs.fn), rhs = std::move(rhs.fn)](const Document& root,
+                                                               Variables* variables) {
+                Value left = lhs(root, variables);
+                if (!left.numeric()) {
+                    // The interpreter returns null or throws here without evaluating the second
+                    // operand, and so does apply() when only given a non-numeric first operand.
+                    return uassertStatusOK(ExpressionMultiply::apply(left, Value()));
+                }
+
+                Value right = rhs(root, variables);
+                if (left.getType() == NumberInt && right.getType() == NumberInt) {
+                    // The product of two ints always fits in a long.
+                    return Value::createIntOrLong(static_cast<long long>(left.getInt()) *
+                                                  right.getInt());
+                } else if (left.getType() == NumberDouble && right.getType() == NumberDouble) {
+                    return Value(left.getDouble() * right.getDouble());
+                }
+                return uassertStatusOK(ExpressionMultiply::apply(left, right));
+            },
+            true,
+            lhs.pure && rhs.pure};
+}
+
+CompiledNode compileNode(const boost::intrusive_ptr<Expression>& expr) {
+    if (auto constant = dynamic_cast<ExpressionConstant*>(expr.get())) {
+        return compileConstant(*constant);
+    } else if (auto fieldPath = dynamic_cast<ExpressionFieldPath*>(expr.get())) {
+        return compileFieldPath(fieldPath);
+    } else if (dynamic_cast<ExpressionAdd*>(expr.get()) && expr->getChildren().size() == 2) {
+        return compileAdd(expr);
+    } else if (dynamic_cast<ExpressionSubtract*>(expr.get())) {
+        return compileSubtract(expr);
+    } else if (dynamic_cast<ExpressionMultiply*>(expr.get()) && expr->getChildren().size() == 2) {
+        return compileMultiply(expr);
+    }
+    return interpret(expr, false);
+}
+}  // namespace
+
+CompiledExpression CompiledExpression::compile(boost::intrusive_ptr<Expression> expr) {
+    auto node = compileNode(expr);
+    return {std::move(expr), node.specialized ? std::move(node.fn) : EvaluateFn{}};
+}
+
+}  // namespace mongo
@@ -0,0 +1,88 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <functional>
+
+#include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/document_value/value.h"
+#include "mongo/db/pipeline/expression.h"
+
+namespace mongo {
+
+/**
+ * An Expression tree flattened into a chain of closures, each of which is specialized for the node
+ * it was built from. Evaluating a compiled expression returns exactly what evaluating the original
+ * tree would have returned, but skips the virtual dispatch at the nodes it knows about and the
+ * generic accumulation state of the arithmetic operators:
+ *
+ *   - Field paths rooted at $$ROOT (or an unbound $$CURRENT) walk a pre-split list of field names.
+ *   - $add, $subtract and $multiply with two operands have inline paths for the case where both
+ *     operands are ints or both are doubles, and defer to the interpreter otherwise.
+ *
+ * Any other node is evaluated by the interpreter. Constant subtrees are expected to have already
+ * been folded by Expression::optimize(), so compile() should be called on an optimized tree.
+ *
+ * A CompiledExpression keeps a reference to the tree it was built from, which must not be modified
+ * afterwards.
+ */
+class CompiledExpression {
+public:
+    using EvaluateFn = std::function<Value(const Document& root, Variables* variables)>;
+
+    static CompiledExpression compile(boost::intrusive_ptr<Expression> expr);
+
+    Value evaluate(const Document& root, Variables* variables) const {
+        return _fn ? _fn(root, variables) : _expr->evaluate(root, variables);
+    }
+
+    const boost::intrusive_ptr<Expression>& getExpression() const {
+        return _expr;
+    }
+
+    /**
+     * Returns true if compiling produced a specialized closure, as opposed to deferring the whole
+     * tree to the interpreter.
+     */
+    bool isSpecialized() const {
+        return static_cast<bool>(_fn);
+    }
+
+private:
+    CompiledExpression(boost::intrusive_ptr<Expression> expr, EvaluateFn fn)
+        : _expr(std::move(expr)), _fn(std::move(fn)) {}
+
+    boost::intrusive_ptr<Expression> _expr;
+
+    // Empty when nothing in the tree could be specialized.
+    EvaluateFn _fn;
+};
+
+}  // namespace mongo
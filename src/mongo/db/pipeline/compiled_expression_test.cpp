@@ -0,0 +1,164 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <cmath>
+#include <limits>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/exec/document_value/document_value_test_util.h"
+#include "mongo/db/json.h"
+#include "mongo/db/pipeline/compiled_expression.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Returns the result of 'evaluator', or the error it raised.
+ */
+template <typename Evaluator>
+StatusWith<Value> evaluateCatchingErrors(const Evaluator& evaluator) {
+    try {
+        return evaluator();
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+}
+
+/**
+ * Parses and optimizes 'spec', then asserts that the compiled expression returns exactly what the
+ * interpreter returns for 'doc', down to the numeric type and the sign of zero.
+ */
+void assertCompiledMatchesInterpreted(BSONObj spec, Document doc, bool expectSpecialized = true) {
+    auto expCtx = make_intrusive<ExpressionContextForTest>();
+    auto expr =
+        Expression::parseOperand(expCtx.get(), spec.firstElement(), expCtx->variablesParseState)
+            ->optimize();
+    auto compiled = CompiledExpression::compile(expr);
+    ASSERT_EQ(compiled.isSpecialized(), expectSpecialized) << spec;
+
+    auto* variables = &expCtx->variables;
+    auto interpreted = evaluateCatchingErrors([&] { return expr->evaluate(doc, variables); });
+    auto result = evaluateCatchingErrors([&] { return compiled.evaluate(doc, variables); });
+
+    ASSERT_EQ(interpreted.isOK(), result.isOK()) << spec;
+    if (!interpreted.isOK()) {
+        ASSERT_EQ(interpreted.getStatus().code(), result.getStatus().code()) << spec;
+        return;
+    }
+    ASSERT_EQ(interpreted.getValue().getType(), result.getValue().getType()) << spec;
+    ASSERT_VALUE_EQ(interpreted.getValue(), result.getValue());
+    if (result.getValue().getType() == NumberDouble) {
+        ASSERT_EQ(std::signbit(interpreted.getValue().getDouble()),
+                  std::signbit(result.getValue().getDouble()))
+            << spec;
+    }
+}
+
+TEST(CompiledExpressionTest, FieldPathsMatchInterpreter) {
+    Document doc{{"a", 1}, {"b", Document{{"c", 2}}}, {"d", BSON_ARRAY(BSON("c" << 3) << 4)}};
+    for (auto path : {"$a", "$b", "$b.c", "$b.c.d", "$d.c", "$d.c.e", "$missing", "$a.b"}) {
+        assertCompiledMatchesInterpreted(BSON("" << path), doc);
+    }
+}
+
+TEST(CompiledExpressionTest, VariablesAndOtherExpressionsDeferToInterpreter) {
+    Document doc{{"a", 1}, {"s", "str"_sd}};
+    assertCompiledMatchesInterpreted(BSON("" << "$$ROOT"), doc, false);
+    assertCompiledMatchesInterpreted(BSON("" << BSON("$concat" << BSON_ARRAY("$s" << "$s"))),
+                                     doc,
+                                     false);
+    assertCompiledMatchesInterpreted(
+        BSON("" << BSON("$let" << BSON("vars" << BSON("x" << "$a") << "in"
+                                              << BSON("$add" << BSON_ARRAY("$$x" << 1))))),
+        doc,
+        false);
+}
+
+TEST(CompiledExpressionTest, ArithmeticMatchesInterpreterAcrossTypes) {
+    const auto maxInt = std::numeric_limits<int>::max();
+    const auto maxLong = std::numeric_limits<long long>::max();
+    const auto inf = std::numeric_limits<double>::infinity();
+    std::vector<Value> operands{Value(2),
+                                Value(-3),
+                                Value(maxInt),
+                                Value(std::numeric_limits<int>::min()),
+                                Value(5LL),
+                                Value(maxLong),
+                                Value(1.5),
+                                Value(0.0),
+                                Value(-0.0),
+                                Value(inf),
+                                Value(-inf),
+                                Value(std::numeric_limits<double>::quiet_NaN()),
+                                Value(Decimal128("2.5")),
+                                Value(Date_t::fromMillisSinceEpoch(1000)),
+                                Value(BSONNULL),
+                                Value(),
+                                Value("str"_sd)};
+
+    for (auto op : {"$add", "$subtract", "$multiply"}) {
+        for (auto&& lhs : operands) {
+            for (auto&& rhs : operands) {
+                Document doc{{"l", lhs}, {"r", rhs}};
+                assertCompiledMatchesInterpreted(BSON("" << BSON(op << BSON_ARRAY("$l"
+                                                                                   << "$r"))),
+                                                 doc);
+            }
+        }
+    }
+}
+
+TEST(CompiledExpressionTest, NestedArithmeticMatchesInterpreter) {
+    Document doc{{"a", 3}, {"b", Document{{"c", 2.5}}}, {"n", BSONNULL}};
+    assertCompiledMatchesInterpreted(
+        fromjson("{'': {$add: [{$multiply: ['$a', 2]}, {$subtract: ['$b.c', '$a']}]}}"), doc);
+    assertCompiledMatchesInterpreted(fromjson("{'': {$multiply: ['$n', {$add: ['$a', 's']}]}}"),
+                                     doc);
+    assertCompiledMatchesInterpreted(fromjson("{'': {$add: ['$n', {$multiply: ['$a', 's']}]}}"),
+                                     doc);
+    assertCompiledMatchesInterpreted(fromjson("{'': {$add: ['$a', {$multiply: ['$a', 's']}]}}"),
+                                     doc);
+}
+
+TEST(CompiledExpressionTest, ArithmeticOverNonPureOperandsMatchesInterpreter) {
+    Document doc{{"a", 3}, {"s", "str"_sd}};
+    assertCompiledMatchesInterpreted(
+        fromjson("{'': {$subtract: [{$strLenBytes: '$s'}, {$multiply: ['$a', 2]}]}}"), doc);
+    // $add falls back to re-evaluating its operands, so it is only specialized over pure ones.
+    assertCompiledMatchesInterpreted(fromjson("{'': {$add: [{$strLenBytes: '$s'}, '$a']}}"),
+                                     doc,
+                                     false);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -309,6 +309,47 @@ public:
         return next;
     }
 
+    /**
+     * The number of results a consumer of getNextBatch() requests at a time, unless it has a
+     * reason to pick another size.
+     */
+    static constexpr size_t kDefaultBatchSize = 128;
+
+    /**
+     * Batched version of getNext(). Appends up to 'maxBatchSize' results to 'batch' and returns the
+     * status which ended the batch: kAdvanced if 'maxBatchSize' results were appended, otherwise
+     * kEOF or kPauseExecution, in which case some results may still have been appended before it.
+     *
+     * Stages which can produce several results more cheaply than through repeated calls to
+     * getNext() override doGetNextBatch(). For all other stages, the default implementation calls
+     * doGetNext() in a loop, so the two APIs can be used interchangeably on any stage.
+     */
+    GetNextResult::ReturnStatus getNextBatch(std::vector<Document>* batch, size_t maxBatchSize) {
+        invariant(maxBatchSize > 0);
+        pExpCtx->checkForInterrupt();
+
+        if (MONGO_likely(!pExpCtx->shouldCollectDocumentSourceExecStats())) {
+            return doGetNextBatch(batch, maxBatchSize);
+        }
+
+        auto serviceCtx = pExpCtx->opCtx->getServiceContext();
+        invariant(serviceCtx);
+        auto fcs = serviceCtx->getFastClockSource();
+        invariant(fcs);
+
+        invariant(_commonStats.executionTimeMillis);
+        ScopedTimer timer(fcs, _commonStats.executionTimeMillis.get_ptr());
+
+        // Account for the batch as if it had been produced by as many calls to getNext().
+        const auto sizeBefore = batch->size();
+        auto status = doGetNextBatch(batch, maxBatchSize);
+        const auto nAdvanced = batch->size() - sizeBefore;
+        const bool ended = status != GetNextResult::ReturnStatus::kAdvanced;
+        _commonStats.works += nAdvanced + (ended ? 1 : 0);
+        _commonStats.advanced += nAdvanced;
+        return status;
+    }
+
     /**
      * Returns a struct containing information about any special constraints imposed on using this
      * stage. Input parameter Pipeline::SplitState is used by stages whose requirements change
@@ -612,6 +653,21 @@ protected:
      */
     virtual GetNextResult doGetNext() = 0;
 
+    /**
+     * The batched execution API of a DocumentSource. See comment at getNextBatch().
+     */
+    virtual GetNextResult::ReturnStatus doGetNextBatch(std::vector<Document>* batch,
+                                                       size_t maxBatchSize) {
+        for (size_t i = 0; i < maxBatchSize; ++i) {
+            auto next = doGetNext();
+            if (!next.isAdvanced()) {
+                return next.getStatus();
+            }
+            batch->push_back(next.releaseDocument());
+        }
+        return GetNextResult::ReturnStatus::kAdvanced;
+    }
+
     /**
      * Attempt to perform an optimization with the following source in the pipeline. 'container'
      * refers to the entire pipeline, and 'itr' points to this stage within the pipeline.
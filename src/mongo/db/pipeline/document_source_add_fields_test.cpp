@@ -142,6 +142,29 @@ TEST_F(AddFieldsTest, ShouldBeAbleToProcessMultipleDocuments) {
     ASSERT_TRUE(addFields->getNext().isEOF());
 }
 
+TEST_F(AddFieldsTest, GetNextBatchShouldTransformEveryDocumentInTheBatch) {
+    auto addFields = DocumentSourceAddFields::create(BSON("a" << 10), getExpCtx());
+    auto mock = DocumentSourceMock::createForTest(
+        {Document{{"a", 1}, {"b", 2}},
+         Document{{"c", 3}},
+         DocumentSource::GetNextResult::makePauseExecution(),
+         Document{{"d", 4}}},
+        getExpCtx());
+    addFields->setSource(mock.get());
+
+    using ReturnStatus = DocumentSource::GetNextResult::ReturnStatus;
+    std::vector<Document> batch;
+    ASSERT(addFields->getNextBatch(&batch, 10) == ReturnStatus::kPauseExecution);
+    ASSERT_EQ(batch.size(), 2U);
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"a", 10}, {"b", 2}}));
+    ASSERT_DOCUMENT_EQ(batch[1], (Document{{"c", 3}, {"a", 10}}));
+
+    batch.clear();
+    ASSERT(addFields->getNextBatch(&batch, 10) == ReturnStatus::kEOF);
+    ASSERT_EQ(batch.size(), 1U);
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"d", 4}, {"a", 10}}));
+}
+
 TEST_F(AddFieldsTest, ShouldAddReferencedFieldsToDependencies) {
     auto addFields = DocumentSourceAddFields::create(
         fromjson("{a: true, x: '$b', y: {$and: ['$c','$d']}, z: {$meta: 'textScore'}}"),
@@ -0,0 +1,160 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_backup_file.h"
+
+#include <vector>
+
+#include "mongo/db/exec/document_value/document.h"
+
+namespace mongo {
+
+namespace {
+static constexpr StringData kBackupIdFieldName = "backupId"_sd;
+static constexpr StringData kFileFieldName = "file"_sd;
+static constexpr StringData kByteOffsetFieldName = "byteOffset"_sd;
+static constexpr StringData kDataFieldName = "data"_sd;
+static constexpr StringData kEndOfFileFieldName = "endOfFile"_sd;
+}  // namespace
+
+REGISTER_DOCUMENT_SOURCE(_backupFile,
+                         DocumentSourceBackupFile::LiteParsed::parse,
+                         DocumentSourceBackupFile::createFromBson,
+                         AllowedWithApiStrict::kInternal);
+
+constexpr StringData DocumentSourceBackupFile::kStageName;
+
+boost::intrusive_ptr<DocumentSource> DocumentSourceBackupFile::createFromBson(
+    BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& pExpCtx) {
+    const NamespaceString& nss = pExpCtx->ns;
+    uassert(ErrorCodes::InvalidNamespace,
+            str::stream() << kStageName
+                          << " must be run against the 'admin' database with {aggregate: 1}",
+            nss.db() == NamespaceString::kAdminDb && nss.isCollectionlessAggregateNS());
+
+    uassert(ErrorCodes::FailedToParse,
+            str::stream() << kStageName << " must take a nested object but found: " << elem,
+            elem.type() == BSONType::Object);
+
+    boost::optional<UUID> backupId;
+    boost::optional<std::string> filePath;
+    long long byteOffset = 0;
+    for (auto&& spec : elem.embeddedObject()) {
+        auto fieldName = spec.fieldNameStringData();
+        if (fieldName == kBackupIdFieldName) {
+            backupId = uassertStatusOK(UUID::parse(spec));
+        } else if (fieldName == kFileFieldName) {
+            uassert(ErrorCodes::FailedToParse,
+                    str::stream() << kStageName << " '" << kFileFieldName
+                                  << "' must be a string but found: " << spec,
+                    spec.type() == BSONType::String);
+            filePath = spec.str();
+        } else if (fieldName == kByteOffsetFieldName) {
+            uassert(ErrorCodes::FailedToParse,
+                    str::stream() << kStageName << " '" << kByteOffsetFieldName
+                                  << "' must be a non-negative number but found: " << spec,
+                    spec.isNumber() && spec.safeNumberLong() >= 0);
+            byteOffset = spec.safeNumberLong();
+        } else {
+            uasserted(ErrorCodes::FailedToParse,
+                      str::stream() << "Unrecognized option to " << kStageName << ": " << spec);
+        }
+    }
+    uassert(ErrorCodes::FailedToParse,
+            str::stream() << kStageName << " requires '" << kBackupIdFieldName << "' and '"
+                          << kFileFieldName << "'",
+            backupId && filePath);
+
+    // Only files that are part of the backup are guaranteed to be consistent with it, and no
+    // other file may be read through this stage.
+    uassert(ErrorCodes::IllegalOperation,
+            str::stream() << "File '" << *filePath << "' is not part of backup "
+                          << backupId->toString(),
+            pExpCtx->mongoProcessInterface->isFileReturnedByBackupCursor(
+                pExpCtx->opCtx, *backupId, *filePath));
+
+    return new DocumentSourceBackupFile(pExpCtx, *backupId, *filePath, byteOffset);
+}
+
+DocumentSourceBackupFile::DocumentSourceBackupFile(
+    const boost::intrusive_ptr<ExpressionContext>& pExpCtx,
+    UUID backupId,
+    std::string filePath,
+    long long byteOffset)
+    : DocumentSource(kStageName, pExpCtx),
+      _backupId(std::move(backupId)),
+      _filePath(std::move(filePath)),
+      _startByteOffset(byteOffset),
+      _file(_filePath, std::ios::binary),
+      _byteOffset(byteOffset) {
+    uassert(ErrorCodes::FileOpenFailed,
+            str::stream() << "Failed to open file '" << _filePath << "' of backup "
+                          << _backupId.toString(),
+            _file.is_open());
+    _file.seekg(_byteOffset);
+    uassert(ErrorCodes::FileStreamFailed,
+            str::stream() << "Failed to seek to byte offset " << _byteOffset << " of file '"
+                          << _filePath << "'",
+            !_file.fail());
+}
+
+DocumentSource::GetNextResult DocumentSourceBackupFile::doGetNext() {
+    if (_eof) {
+        return GetNextResult::makeEOF();
+    }
+
+    std::vector<char> buffer(kBlockSizeBytes);
+    _file.read(buffer.data(), kBlockSizeBytes);
+    const auto bytesRead = _file.gcount();
+    uassert(ErrorCodes::FileStreamFailed,
+            str::stream() << "Failed to read file '" << _filePath << "' at byte offset "
+                          << _byteOffset,
+            !_file.bad());
+    // A short read means the end of the file was reached.
+    _eof = bytesRead < kBlockSizeBytes || _file.peek() == std::ifstream::traits_type::eof();
+
+    BSONObjBuilder builder;
+    builder.append(kByteOffsetFieldName, _byteOffset);
+    builder.appendBinData(kDataFieldName, bytesRead, BinDataGeneral, buffer.data());
+    builder.append(kEndOfFileFieldName, _eof);
+    _byteOffset += bytesRead;
+    return Document(builder.obj());
+}
+
+Value DocumentSourceBackupFile::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    return Value(Document{{getSourceName(),
+                           Document{{kBackupIdFieldName, _backupId},
+                                    {kFileFieldName, _filePath},
+                                    {kByteOffsetFieldName, _startByteOffset}}}});
+}
+
+}  // namespace mongo
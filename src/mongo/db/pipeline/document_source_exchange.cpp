@@ -86,6 +86,7 @@ public:
 
 constexpr size_t Exchange::kMaxBufferSize;
 constexpr size_t Exchange::kMaxNumberConsumers;
+constexpr size_t Exchange::kLocalLoadingConsumerId;
 
 const char* DocumentSourceExchange::getSourceName() const {
     return kStageName.rawData();
@@ -110,6 +111,11 @@ DocumentSource::GetNextResult DocumentSourceExchange::doGetNext() {
 }
 
 Exchange::Exchange(ExchangeSpec spec, std::unique_ptr<Pipeline, PipelineDeleter> pipeline)
+    : Exchange(std::move(spec), std::move(pipeline), Partitioner{}) {}
+
+Exchange::Exchange(ExchangeSpec spec,
+                   std::unique_ptr<Pipeline, PipelineDeleter> pipeline,
+                   Partitioner partitioner)
     : _spec(std::move(spec)),
       _keyPattern(_spec.getKey().getOwned()),
       _ordering(extractOrdering(_keyPattern)),
@@ -119,6 +125,7 @@ Exchange::Exchange(ExchangeSpec spec, std::unique_ptr<Pipeline, PipelineDeleter>
       _policy(_spec.getPolicy()),
       _orderPreserving(_spec.getOrderPreserving()),
       _maxBufferSize(_spec.getBufferSize()),
+      _partitioner(std::move(partitioner)),
       _pipeline(std::move(pipeline)) {
     uassert(50901, "Exchange must have at least one consumer", _spec.getConsumers() > 0);
 
@@ -142,9 +149,16 @@ Exchange::Exchange(ExchangeSpec spec, std::unique_ptr<Pipeline, PipelineDeleter>
         uassert(50899, "Exchange boundaries must not be specified.", _boundaries.empty());
     }
 
+    uassert(5902600,
+            "The 'localPartition' exchange policy can only be used internally",
+            (_policy == ExchangePolicyEnum::kLocalPartition) == isLocal());
+
     // We will manually detach and reattach when iterating '_pipeline', we expect it to start in the
-    // detached state.
-    _pipeline->detachFromOperationContext();
+    // detached state. The input of a local exchange is only ever iterated by consumer 0, whose
+    // owner takes care of attaching it to the right OperationContext.
+    if (!isLocal()) {
+        _pipeline->detachFromOperationContext();
+    }
 }
 
 std::vector<std::string> Exchange::extractBoundaries(
@@ -292,8 +306,11 @@ DocumentSource::GetNextResult Exchange::getNext(OperationContext* opCtx,
                       "Exchange failed due to an error on different thread.");
         }
 
-        // Check if we have a document.
-        if (!_consumers[consumerId]->isEmpty()) {
+        // Check if we have a document. The loading consumer of a local exchange is the only one
+        // that can make progress for everybody else, so it tops up the other buffers first rather
+        // than draining its own while the workers are starved.
+        if (!_consumers[consumerId]->isEmpty() &&
+            !(isLocal() && canLoad(consumerId) && !_inputExhausted)) {
             auto doc = _consumers[consumerId]->getNext();
             unblockLoading(consumerId);
 
@@ -301,7 +318,7 @@ DocumentSource::GetNextResult Exchange::getNext(OperationContext* opCtx,
         }
 
         // There is not any document so try to load more from the source.
-        if (_loadingThreadId == kInvalidThreadId) {
+        if (canLoad(consumerId)) {
             LOGV2_DEBUG(
                 20896, 3, "A consumer {consumerId} begins loading", "consumerId"_attr = consumerId);
 
@@ -309,7 +326,9 @@ DocumentSource::GetNextResult Exchange::getNext(OperationContext* opCtx,
                 // This consumer won the race and will fill the buffers.
                 _loadingThreadId = consumerId;
 
-                _pipeline->reattachToOperationContext(opCtx);
+                if (!isLocal()) {
+                    _pipeline->reattachToOperationContext(opCtx);
+                }
 
                 // This will return when some exchange buffer is full and we cannot make any forward
                 // progress anymore.
@@ -322,7 +341,9 @@ DocumentSource::GetNextResult Exchange::getNext(OperationContext* opCtx,
                               "Asserting on loading the next batch due to failpoint.");
                 }
 
-                _pipeline->detachFromOperationContext();
+                if (!isLocal()) {
+                    _pipeline->detachFromOperationContext();
+                }
 
                 // The loading cannot continue until the consumer with the full buffer consumes some
                 // documents.
@@ -385,6 +406,13 @@ size_t Exchange::loadNextBatch() {
                 if (full)
                     return target;
             } break;
+            case ExchangePolicyEnum::kLocalPartition: {
+                size_t target = _partitioner(input.getDocument());
+                invariant(target < _consumers.size());
+
+                if (_consumers[target]->appendDocument(std::move(input), _maxBufferSize))
+                    return target;
+            } break;
             default:
                 MONGO_UNREACHABLE;
         }
@@ -396,6 +424,7 @@ size_t Exchange::loadNextBatch() {
     for (auto& c : _consumers) {
         [[maybe_unused]] auto full = c->appendDocument(input, _maxBufferSize);
     }
+    _inputExhausted = true;
 
     return kInvalidThreadId;
 }
@@ -445,9 +474,14 @@ void Exchange::dispose(OperationContext* opCtx, size_t consumerId) {
 
     ++_disposeRunDown;
 
-    // If _errorInLoadNextBatch status is not OK then an exception was thrown. In that case the
-    // throwing thread will do the dispose.
-    if (!_errorInLoadNextBatch.isOK()) {
+    // The input of a local exchange is attached to consumer 0's OperationContext, so nobody else
+    // may dispose of it. Otherwise, if _errorInLoadNextBatch status is not OK then an exception was
+    // thrown. In that case the throwing thread will do the dispose.
+    if (isLocal()) {
+        if (consumerId == kLocalLoadingConsumerId) {
+            _pipeline->dispose(opCtx);
+        }
+    } else if (!_errorInLoadNextBatch.isOK()) {
         if (_loadingThreadId == consumerId) {
             _pipeline->dispose(opCtx);
         }
@@ -459,6 +493,16 @@ void Exchange::dispose(OperationContext* opCtx, size_t consumerId) {
     unblockLoading(consumerId);
 }
 
+void Exchange::abort(Status status) {
+    invariant(!status.isOK());
+    stdx::lock_guard<Latch> lk(_mutex);
+
+    if (_errorInLoadNextBatch.isOK()) {
+        _errorInLoadNextBatch = std::move(status);
+    }
+    _haveBufferSpace.notify_all();
+}
+
 DocumentSource::GetNextResult Exchange::ExchangeBuffer::getNext() {
     invariant(!_buffer.empty());
 
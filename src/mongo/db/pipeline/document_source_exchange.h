@@ -30,6 +30,7 @@
 #pragma once
 
 #include <deque>
+#include <functional>
 #include <vector>
 
 #include "mongo/bson/ordering.h"
@@ -46,6 +47,9 @@ class Exchange : public RefCountable {
     static constexpr size_t kMaxBufferSize = 100 * 1024 * 1024;  // 100 MB
     static constexpr size_t kMaxNumberConsumers = 100;
 
+    // The only consumer allowed to load documents from the input pipeline of a local exchange.
+    static constexpr size_t kLocalLoadingConsumerId = 0;
+
     /**
      * Convert the BSON representation of boundaries (as deserialized off the wire) to the internal
      * format (KeyString).
@@ -71,12 +75,28 @@ class Exchange : public RefCountable {
     static std::vector<FieldPath> extractKeyPaths(const BSONObj& keyPattern);
 
 public:
+    /**
+     * Maps an input document to the id of the consumer that must process it. Used by the
+     * 'localPartition' policy.
+     */
+    using Partitioner = std::function<size_t(const Document&)>;
+
     /**
      * Create an exchange. 'pipeline' represents the input to the exchange operator and must not be
      * nullptr.
      **/
     Exchange(ExchangeSpec spec, std::unique_ptr<Pipeline, PipelineDeleter> pipeline);
 
+    /**
+     * Create an in-process exchange using the 'localPartition' policy: every input document is
+     * sent to the consumer chosen by 'partitioner'. The input 'pipeline' stays attached to the
+     * OperationContext of consumer 0, which is the only consumer that ever loads from it; the
+     * other consumers may run on worker threads and only ever read their own buffers.
+     */
+    Exchange(ExchangeSpec spec,
+             std::unique_ptr<Pipeline, PipelineDeleter> pipeline,
+             Partitioner partitioner);
+
     /**
      * Interface for retrieving the next document. 'resourceYielder' is optional, and if provided,
      * will be used to give up resources while waiting for other threads to empty their buffers.
@@ -95,6 +115,21 @@ public:
 
     void dispose(OperationContext* opCtx, size_t consumerId);
 
+    /**
+     * Puts the exchange into the failed state with 'status' and wakes up every waiting consumer,
+     * which will then fail too. Used to tear down a local exchange when one of its consumers fails
+     * outside of the loading code.
+     */
+    void abort(Status status);
+
+    /**
+     * Returns the input pipeline. Only the owner of a local exchange may use this, in order to
+     * propagate OperationContext changes to the input.
+     */
+    Pipeline* getInputPipeline() const {
+        return _pipeline.get();
+    }
+
     /**
      * Unblocks the loading thread (a producer) if the loading is blocked by a consumer identified
      * by consumerId. Note that there is no such thing as being blocked by multiple consumers. It is
@@ -107,6 +142,18 @@ public:
 private:
     size_t loadNextBatch();
 
+    bool isLocal() const {
+        return static_cast<bool>(_partitioner);
+    }
+
+    /**
+     * Returns true if 'consumerId' may start loading the next batch right now.
+     */
+    bool canLoad(size_t consumerId) const {
+        return _loadingThreadId == kInvalidThreadId &&
+            (!isLocal() || consumerId == kLocalLoadingConsumerId);
+    }
+
     size_t getTargetConsumer(const Document& input);
 
     class ExchangeBuffer {
@@ -166,6 +213,9 @@ private:
     // A maximum size of buffer per consumer.
     const size_t _maxBufferSize;
 
+    // Routes documents for the 'localPartition' policy. Empty for all other policies.
+    const Partitioner _partitioner;
+
     // An input to the exchange operator
     std::unique_ptr<Pipeline, PipelineDeleter> _pipeline;
 
@@ -182,6 +232,9 @@ private:
 
     size_t _roundRobinCounter{0};
 
+    // Set once the input pipeline has returned EOF and the EOF has been sent to all consumers.
+    bool _inputExhausted{false};
+
     // A rundown counter of consumers disposing of the pipelines. Only the last consumer will
     // dispose of the 'inner' exchange pipeline.
     size_t _disposeRunDown{0};
@@ -240,7 +293,12 @@ public:
     }
 
     void doDispose() final {
-        _exchange->dispose(pExpCtx->opCtx, _consumerId);
+        // A $group reading from this stage disposes of it once it runs out of results, so we may
+        // be disposed of again when the whole pipeline goes away.
+        if (!_disposed) {
+            _disposed = true;
+            _exchange->dispose(pExpCtx->opCtx, _consumerId);
+        }
     }
 
     auto getConsumerId() const {
@@ -254,6 +312,8 @@ private:
 
     const size_t _consumerId;
 
+    bool _disposed{false};
+
     // While waiting for another thread to make room in its buffer, we may want to yield certain
     // resources (such as the Session). Through this interface we can do that.
     std::unique_ptr<ResourceYielder> _resourceYielder;
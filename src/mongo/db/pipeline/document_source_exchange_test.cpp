@@ -737,6 +737,64 @@ TEST_F(DocumentSourceExchangeTest, RejectInvalidConsumerIds) {
         Exchange(parseSpec(spec), Pipeline::create({}, getExpCtx())), AssertionException, 50894);
 }
 
+TEST_F(DocumentSourceExchangeTest, RejectLocalPartitionWithoutPartitioner) {
+    BSONObj spec = BSON("policy"
+                        << "localPartition"
+                        << "consumers" << 2);
+    ASSERT_THROWS_CODE(Exchange(parseSpec(spec), Pipeline::create({}, getExpCtx())),
+                       AssertionException,
+                       5902600);
+}
+
+TEST_F(DocumentSourceExchangeTest, LocalPartitionExchangeNConsumer) {
+    const size_t nDocs = 500;
+    const size_t nConsumers = 5;
+    auto source = getMockSource(nDocs);
+
+    ExchangeSpec spec;
+    spec.setPolicy(ExchangePolicyEnum::kLocalPartition);
+    spec.setConsumers(nConsumers);
+    spec.setBufferSize(1024);
+
+    // The input of a local exchange stays attached to the operation context of consumer 0.
+    auto opCtx = getOpCtx();
+    boost::intrusive_ptr<Exchange> ex =
+        new Exchange(spec, Pipeline::create({source}, getExpCtx()), [&](const Document& doc) {
+            return static_cast<size_t>(doc["a"].getInt()) % nConsumers;
+        });
+
+    std::vector<ThreadInfo> threads = createNProducers(nConsumers, ex);
+    std::vector<executor::TaskExecutor::CallbackHandle> handles;
+
+    for (size_t id = 1; id < nConsumers; ++id) {
+        DocumentSourceExchange* docSourceExchange = threads[id].documentSourceExchange.get();
+        auto handle = _executor->scheduleWork(
+            [docSourceExchange, id, nDocs, nConsumers](
+                const executor::TaskExecutor::CallbackArgs& cb) {
+                size_t docs = 0;
+                for (auto input = docSourceExchange->getNext(); input.isAdvanced();
+                     input = docSourceExchange->getNext()) {
+                    ASSERT_EQ(input.getDocument()["a"].getInt() % nConsumers, id);
+                    ++docs;
+                }
+                ASSERT_EQ(docs, nDocs / nConsumers);
+            });
+
+        handles.emplace_back(std::move(handle.getValue()));
+    }
+
+    size_t docs = 0;
+    for (auto input = ex->getNext(opCtx, 0, nullptr); input.isAdvanced();
+         input = ex->getNext(opCtx, 0, nullptr)) {
+        ASSERT_EQ(input.getDocument()["a"].getInt() % nConsumers, 0u);
+        ++docs;
+    }
+    ASSERT_EQ(docs, nDocs / nConsumers);
+
+    for (auto& h : handles)
+        _executor->wait(h);
+}
+
 TEST_F(DocumentSourceExchangeTest, RejectInvalidMissingKeys) {
     BSONObj spec = BSON("policy"
                         << "keyRange"
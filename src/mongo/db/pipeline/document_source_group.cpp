@@ -62,6 +62,25 @@ std::string nextFileName() {
     return "extsort-doc-group." + std::to_string(documentSourceGroupFileCounter.fetchAndAdd(1));
 }
 
+// A partition which still does not fit in memory is partitioned again, up to this many times. Past
+// that point, its keys are most likely too few to be split any further.
+const size_t kMaxSpillPartitionDepth = 4;
+
+/**
+ * Maps the hash of a group key to a spill partition. Every level of partitioning must use a
+ * different function, otherwise the keys of a partition would all land in the same partition again
+ * when it is split, so the hash is seeded with 'depth' and mixed with the MurmurHash3 finalizer.
+ */
+size_t spillPartitionOf(size_t hash, size_t depth, size_t numPartitions) {
+    uint64_t h = static_cast<uint64_t>(hash) ^ (depth * 0x9e3779b97f4a7c15ULL);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h % numPartitions;
+}
+
 }  // namespace
 
 using boost::intrusive_ptr;
@@ -182,7 +201,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::doGetNext() {
     }
 
     if (_spilled) {
-        return getNextSpilled();
+        return _numSpillPartitions > 0 ? getNextFromPartitions() : getNextSpilled();
     } else {
         return getNextStandard();
     }
@@ -246,10 +265,30 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
     return out;
 }
 
+DocumentSource::GetNextResult DocumentSourceGroup::getNextFromPartitions() {
+    // We aren't streaming, and we have spilled to hash partitions.
+    while (groupsIterator == _groups->end()) {
+        if (_spillPartitions.empty()) {
+            dispose();
+            return GetNextResult::makeEOF();
+        }
+
+        auto partition = std::move(_spillPartitions.back());
+        _spillPartitions.pop_back();
+        loadSpillPartition(std::move(partition));
+        groupsIterator = _groups->begin();
+    }
+
+    Document out = makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->needsMerge);
+    ++groupsIterator;
+    return out;
+}
+
 void DocumentSourceGroup::doDispose() {
     // Free our resources.
     _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
     _sorterIterator.reset();
+    _spillPartitions.clear();
 
     // Make us look done.
     groupsIterator = _groups->end();
@@ -402,7 +441,9 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
                          : static_cast<size_t>(internalDocumentSourceGroupMaxMemoryBytes.load())},
       _initialized(false),
       _groups(expCtx->getValueComparator().makeUnorderedValueMap<Accumulators>()),
-      _spilled(false) {
+      _spilled(false),
+      _numSpillPartitions(
+          static_cast<size_t>(internalDocumentSourceGroupSpillPartitions.load())) {
     if (!expCtx->inMongos && (expCtx->allowDiskUse || kDebugBuild)) {
         // We spill to disk in debug mode, regardless of allowDiskUse, to stress the system.
         _fileName = expCtx->tempDir + "/" + nextFileName();
@@ -470,9 +511,17 @@ void DocumentSourceGroup::setIdExpression(const boost::intrusive_ptr<Expression>
 
 intrusive_ptr<DocumentSource> DocumentSourceGroup::createFromBson(
     BSONElement elem, const intrusive_ptr<ExpressionContext>& expCtx) {
+    return createFromBsonWithMaxMemoryUsage(elem, expCtx, boost::none);
+}
+
+intrusive_ptr<DocumentSourceGroup> DocumentSourceGroup::createFromBsonWithMaxMemoryUsage(
+    BSONElement elem,
+    const intrusive_ptr<ExpressionContext>& expCtx,
+    boost::optional<size_t> maxMemoryUsageBytes) {
     uassert(15947, "a group's fields must be specified in an object", elem.type() == Object);
 
-    intrusive_ptr<DocumentSourceGroup> groupStage(new DocumentSourceGroup(expCtx));
+    intrusive_ptr<DocumentSourceGroup> groupStage(
+        new DocumentSourceGroup(expCtx, maxMemoryUsageBytes));
 
     BSONObj groupObj(elem.Obj());
     BSONObjIterator groupIterator(groupObj);
@@ -537,91 +586,111 @@ private:
 DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
     const size_t numAccumulators = _accumulatedFields.size();
 
-    // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
-    GetNextResult input = pSource->getNext();
-
-    for (; input.isAdvanced(); input = pSource->getNext()) {
-        if (shouldSpillWithAttemptToSaveMemory()) {
-            _sortedFiles.push_back(spill());
-        }
-
-        // We release the result document here so that it does not outlive the end of this loop
-        // iteration. Not releasing could lead to an array copy when this group follows an unwind.
-        auto rootDocument = input.releaseDocument();
-        Value id = computeId(rootDocument);
-
-        // Look for the _id value in the map. If it's not there, add a new entry with a blank
-        // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
-        // looking it up in '_groups' multiple times.
-        const size_t oldSize = _groups->size();
-        vector<intrusive_ptr<AccumulatorState>>& group = (*_groups)[id];
-        const bool inserted = _groups->size() != oldSize;
-
-        vector<uint64_t> oldAccumMemUsage(numAccumulators, 0);
-        if (inserted) {
-            _memoryTracker.set(_memoryTracker.currentMemoryBytes() + id.getApproximateSize());
-
-            // Initialize and add the accumulators
-            Value expandedId = expandId(id);
-            Document idDoc =
-                expandedId.getType() == BSONType::Object ? expandedId.getDocument() : Document();
-            group.reserve(numAccumulators);
-            for (auto&& accumulatedField : _accumulatedFields) {
-                auto accum = accumulatedField.makeAccumulator();
-                Value initializerValue =
-                    accumulatedField.expr.initializer->evaluate(idDoc, &pExpCtx->variables);
-                accum->startNewGroup(initializerValue);
-                group.push_back(accum);
+    // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'. The input is
+    // requested in batches, which saves a call through every preceding stage per document.
+    std::vector<Document> batch;
+    batch.reserve(kDefaultBatchSize);
+    auto inputStatus = GetNextResult::ReturnStatus::kAdvanced;
+    while (inputStatus == GetNextResult::ReturnStatus::kAdvanced) {
+        batch.clear();
+        inputStatus = pSource->getNextBatch(&batch, kDefaultBatchSize);
+
+        for (auto&& input : batch) {
+            if (shouldSpillWithAttemptToSaveMemory()) {
+                spillToDisk();
             }
-        } else {
-            for (size_t i = 0; i < group.size(); i++) {
-                // subtract old mem usage. New usage added back after processing.
-                _memoryTracker.update(_accumulatedFields[i].fieldName,
-                                      -1 * group[i]->getMemUsage());
+
+            // We move the document out of the batch here so that it does not outlive the end of
+            // this loop iteration. Not releasing could lead to an array copy when this group
+            // follows an unwind.
+            auto rootDocument = std::move(input);
+            Value id = computeId(rootDocument);
+
+            // Look for the _id value in the map. If it's not there, add a new entry with a blank
+            // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
+            // looking it up in '_groups' multiple times.
+            const size_t oldSize = _groups->size();
+            vector<intrusive_ptr<AccumulatorState>>& group = (*_groups)[id];
+            const bool inserted = _groups->size() != oldSize;
+
+            vector<uint64_t> oldAccumMemUsage(numAccumulators, 0);
+            if (inserted) {
+                _memoryTracker.set(_memoryTracker.currentMemoryBytes() + id.getApproximateSize());
+
+                // Initialize and add the accumulators
+                Value expandedId = expandId(id);
+                Document idDoc = expandedId.getType() == BSONType::Object
+                    ? expandedId.getDocument()
+                    : Document();
+                group.reserve(numAccumulators);
+                for (auto&& accumulatedField : _accumulatedFields) {
+                    auto accum = accumulatedField.makeAccumulator();
+                    Value initializerValue =
+                        accumulatedField.expr.initializer->evaluate(idDoc, &pExpCtx->variables);
+                    accum->startNewGroup(initializerValue);
+                    group.push_back(accum);
+                }
+            } else {
+                for (size_t i = 0; i < group.size(); i++) {
+                    // subtract old mem usage. New usage added back after processing.
+                    _memoryTracker.update(_accumulatedFields[i].fieldName,
+                                          -1 * group[i]->getMemUsage());
+                }
             }
-        }
 
-        /* tickle all the accumulators for the group we found */
-        dassert(numAccumulators == group.size());
+            /* tickle all the accumulators for the group we found */
+            dassert(numAccumulators == group.size());
 
-        for (size_t i = 0; i < numAccumulators; i++) {
-            group[i]->process(
-                _accumulatedFields[i].expr.argument->evaluate(rootDocument, &pExpCtx->variables),
-                _doingMerge);
-            _memoryTracker.update(_accumulatedFields[i].fieldName, group[i]->getMemUsage());
-        }
+            for (size_t i = 0; i < numAccumulators; i++) {
+                group[i]->process(_accumulatedFields[i].expr.argument->evaluate(
+                                      rootDocument, &pExpCtx->variables),
+                                  _doingMerge);
+                _memoryTracker.update(_accumulatedFields[i].fieldName, group[i]->getMemUsage());
+            }
 
-        if (kDebugBuild && !storageGlobalParams.readOnly) {
-            // In debug mode, spill every time we have a duplicate id to stress merge logic.
-            if (!inserted &&           // is a dup
-                !pExpCtx->inMongos &&  // can't spill to disk in mongos
-                !_memoryTracker
-                     ._allowDiskUse &&       // don't change behavior when testing external sort
-                _sortedFiles.size() < 20) {  // don't open too many FDs
+            if (kDebugBuild && !storageGlobalParams.readOnly) {
+                // In debug mode, spill every time we have a duplicate id to stress merge logic.
+                if (!inserted &&           // is a dup
+                    !pExpCtx->inMongos &&  // can't spill to disk in mongos
+                    !_memoryTracker
+                         ._allowDiskUse &&  // don't change behavior when testing external sort
+                    _stats.spills < 20) {   // don't open too many FDs
 
-                _sortedFiles.push_back(spill());
+                    spillToDisk();
+                }
             }
         }
     }
 
-    switch (input.getStatus()) {
+    switch (inputStatus) {
         case DocumentSource::GetNextResult::ReturnStatus::kAdvanced: {
             MONGO_UNREACHABLE;  // We consumed all advances above.
         }
         case DocumentSource::GetNextResult::ReturnStatus::kPauseExecution: {
-            return input;  // Propagate pause.
+            return GetNextResult::makePauseExecution();  // Propagate pause.
         }
         case DocumentSource::GetNextResult::ReturnStatus::kEOF: {
             // Do any final steps necessary to prepare to output results.
-            if (!_sortedFiles.empty()) {
+            if (_stats.spills > 0) {
                 _spilled = true;
                 if (!_groups->empty()) {
-                    _sortedFiles.push_back(spill());
+                    spillToDisk();
                 }
 
                 // We won't be using groups again so free its memory.
                 _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+            }
 
+            if (_spilled && _numSpillPartitions > 0) {
+                // Partitions are loaded back one at a time as results are requested. Skip the
+                // ones which no spilled group hashed into.
+                _spillPartitions.erase(
+                    std::remove_if(_spillPartitions.begin(),
+                                   _spillPartitions.end(),
+                                   [](const SpillPartition& p) { return p.runs.empty(); }),
+                    _spillPartitions.end());
+                groupsIterator = _groups->end();
+            } else if (_spilled) {
                 _sorterIterator.reset(Sorter<Value, Value>::Iterator::merge(
                     _sortedFiles, SortOptions(), SorterComparator(pExpCtx->getValueComparator())));
                 _ownsFileDeletion = false;
@@ -642,7 +711,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
             // This must happen last so that, unless control gets here, we will re-enter
             // initialization after getting a GetNextResult::ResultState::kPauseExecution.
             _initialized = true;
-            return input;
+            return GetNextResult::makeEOF();
         }
     }
     MONGO_UNREACHABLE;
@@ -702,6 +771,159 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
     return shared_ptr<Sorter<Value, Value>::Iterator>(iteratorPtr);
 }
 
+void DocumentSourceGroup::spillToDisk() {
+    if (_numSpillPartitions > 0) {
+        spillToPartitions(&_spillPartitions, 0);
+    } else {
+        _sortedFiles.push_back(spill());
+    }
+}
+
+void DocumentSourceGroup::spillToPartitions(std::vector<SpillPartition>* partitions,
+                                            size_t depth) {
+    _stats.spills++;
+
+    if (partitions->empty()) {
+        partitions->resize(_numSpillPartitions);
+        for (auto&& partition : *partitions) {
+            partition.depth = depth;
+        }
+    }
+    invariant(partitions->size() == _numSpillPartitions);
+
+    // Each partition is re-aggregated in a hash table when it is read back, so unlike spill() there
+    // is no need to sort the groups; they only need to be bucketed by partition.
+    const auto& comparator = pExpCtx->getValueComparator();
+    vector<vector<const GroupsMap::value_type*>> buckets(_numSpillPartitions);
+    for (auto&& group : *_groups) {
+        buckets[spillPartitionOf(comparator.hash(group.first), depth, _numSpillPartitions)]
+            .push_back(&group);
+    }
+
+    for (size_t p = 0; p < _numSpillPartitions; ++p) {
+        if (buckets[p].empty()) {
+            continue;
+        }
+
+        SortedFileWriter<Value, Value> writer(
+            SortOptions().TempDir(pExpCtx->tempDir), _fileName, _nextSortedFileWriterOffset);
+        for (auto&& group : buckets[p]) {
+            switch (_accumulatedFields.size()) {  // mirrors switch in spill()
+                case 0:
+                    writer.addAlreadySorted(group->first, Value());
+                    break;
+                case 1:
+                    writer.addAlreadySorted(group->first,
+                                            group->second[0]->getValue(/*toBeMerged=*/true));
+                    break;
+                default: {
+                    vector<Value> accums;
+                    accums.reserve(group->second.size());
+                    for (auto&& accum : group->second) {
+                        accums.push_back(accum->getValue(/*toBeMerged=*/true));
+                    }
+                    writer.addAlreadySorted(group->first, Value(std::move(accums)));
+                }
+            }
+        }
+
+        (*partitions)[p].runs.emplace_back(writer.done());
+        _nextSortedFileWriterOffset = writer.getFileEndOffset();
+    }
+
+    auto& metricsCollector = ResourceConsumption::MetricsCollector::get(pExpCtx->opCtx);
+    metricsCollector.incrementSorterSpills(1);
+
+    _groups->clear();
+    for (auto accum : _accumulatedFields) {
+        _memoryTracker.set(accum.fieldName, 0);
+    }
+}
+
+void DocumentSourceGroup::loadSpillPartition(SpillPartition partition) {
+    const size_t numAccumulators = _accumulatedFields.size();
+
+    _groups->clear();
+    _memoryTracker.resetCurrent();
+
+    // Only populated if this partition does not fit in memory, in which case it is split by
+    // partitioning its keys again, one level deeper.
+    std::vector<SpillPartition> subPartitions;
+
+    for (auto&& run : partition.runs) {
+        run->openSource();
+        while (run->more()) {
+            auto spilled = run->next();
+            const Value& id = spilled.first;
+
+            const size_t oldSize = _groups->size();
+            Accumulators& group = (*_groups)[id];
+            if (_groups->size() != oldSize) {
+                _memoryTracker.set(_memoryTracker.currentMemoryBytes() + id.getApproximateSize());
+
+                Value expandedId = expandId(id);
+                Document idDoc = expandedId.getType() == BSONType::Object
+                    ? expandedId.getDocument()
+                    : Document();
+                group.reserve(numAccumulators);
+                for (auto&& accumulatedField : _accumulatedFields) {
+                    auto accum = accumulatedField.makeAccumulator();
+                    Value initializerValue =
+                        accumulatedField.expr.initializer->evaluate(idDoc, &pExpCtx->variables);
+                    accum->startNewGroup(initializerValue);
+                    group.push_back(accum);
+                }
+            } else {
+                for (size_t i = 0; i < numAccumulators; i++) {
+                    _memoryTracker.update(_accumulatedFields[i].fieldName,
+                                          -1 * group[i]->getMemUsage());
+                }
+            }
+
+            switch (numAccumulators) {  // mirrors switch in spill()
+                case 1:
+                    group[0]->process(spilled.second, true);
+                case 0:
+                    break;
+                default: {
+                    const vector<Value>& accumulatorStates = spilled.second.getArray();
+                    for (size_t i = 0; i < numAccumulators; i++) {
+                        group[i]->process(accumulatorStates[i], true);
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < numAccumulators; i++) {
+                _memoryTracker.update(_accumulatedFields[i].fieldName, group[i]->getMemUsage());
+            }
+
+            // A single group cannot be split, and past a certain depth the keys of a partition are
+            // unlikely to be split either, so in both cases the partition is aggregated in memory
+            // just like the merge of sorted runs would.
+            if (_memoryTracker._allowDiskUse &&
+                _memoryTracker.currentMemoryBytes() >
+                    static_cast<long long>(_memoryTracker._maxAllowedMemoryUsageBytes) &&
+                _groups->size() > 1 && partition.depth + 1 < kMaxSpillPartitionDepth) {
+                spillToPartitions(&subPartitions, partition.depth + 1);
+                _memoryTracker.resetCurrent();
+            }
+        }
+        run->closeSource();
+    }
+
+    if (!subPartitions.empty()) {
+        if (!_groups->empty()) {
+            spillToPartitions(&subPartitions, partition.depth + 1);
+            _memoryTracker.resetCurrent();
+        }
+        for (auto&& subPartition : subPartitions) {
+            if (!subPartition.runs.empty()) {
+                _spillPartitions.push_back(std::move(subPartition));
+            }
+        }
+    }
+}
+
 Value DocumentSourceGroup::computeId(const Document& root) {
     // If only one expression, return result directly
     if (_idExpressions.size() == 1) {
@@ -119,6 +119,15 @@ public:
     static boost::intrusive_ptr<DocumentSource> createFromBson(
         BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
+    /**
+     * Like createFromBson(), but limits the in-memory footprint of the new stage to
+     * 'maxMemoryUsageBytes' rather than internalDocumentSourceGroupMaxMemoryBytes when set.
+     */
+    static boost::intrusive_ptr<DocumentSourceGroup> createFromBsonWithMaxMemoryUsage(
+        BSONElement elem,
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        boost::optional<size_t> maxMemoryUsageBytes);
+
     StageConstraints constraints(Pipeline::SplitState pipeState) const final {
         StageConstraints constraints(StreamType::kBlocking,
                                      PositionRequirement::kNone,
@@ -189,6 +198,12 @@ public:
      */
     size_t getMaxMemoryUsageBytes() const;
 
+    /**
+     * Computes the internal representation of the group key. Documents belonging to the same group
+     * always produce keys which compare and hash equal under the stage's ValueComparator.
+     */
+    Value computeId(const Document& root);
+
 protected:
     GetNextResult doGetNext() final;
     void doDispose() final;
@@ -226,6 +241,42 @@ private:
      */
     std::shared_ptr<Sorter<Value, Value>::Iterator> spill();
 
+    /**
+     * The spilled groups whose keys hash to the same partition. Each run holds partial aggregates
+     * in no particular order, and a key may appear in several runs.
+     */
+    struct SpillPartition {
+        std::vector<std::shared_ptr<Sorter<Value, Value>::Iterator>> runs;
+
+        // How many times the keys in this partition have been partitioned.
+        size_t depth = 0;
+    };
+
+    /**
+     * Spills the groups map to disk, either as a sorted run or partitioned by hash depending on
+     * '_numSpillPartitions'.
+     */
+    void spillToDisk();
+
+    /**
+     * Writes the partial aggregates in the groups map to one unsorted run per partition of
+     * 'partitions', which are all at the given 'depth', and clears the map.
+     */
+    void spillToPartitions(std::vector<SpillPartition>* partitions, size_t depth);
+
+    /**
+     * Re-aggregates the runs of 'partition' into the groups map. If the partition does not fit in
+     * memory, its groups are partitioned again and added to '_spillPartitions', in which case the
+     * groups map is left empty.
+     */
+    void loadSpillPartition(SpillPartition partition);
+
+    /**
+     * Returns the groups of one hash partition at a time, loading the next one once the groups
+     * map is exhausted.
+     */
+    GetNextResult getNextFromPartitions();
+
     /**
      * If we ran out of memory, finish all the pending operations so that some memory
      * can be freed.
@@ -234,11 +285,6 @@ private:
 
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
-    /**
-     * Computes the internal representation of the group key.
-     */
-    Value computeId(const Document& root);
-
     /**
      * Converts the internal representation of the group key to the _id shape specified by the
      * user.
@@ -286,7 +332,14 @@ private:
     std::vector<std::shared_ptr<Sorter<Value, Value>::Iterator>> _sortedFiles;
     bool _spilled;
 
-    // Only used when '_spilled' is false.
+    // Number of partitions groups are hashed into when spilling, or 0 to spill sorted runs.
+    const size_t _numSpillPartitions;
+
+    // Used only when '_numSpillPartitions' is non-zero: the partitions which have yet to be
+    // returned. While loading the input, there is exactly one entry per partition.
+    std::vector<SpillPartition> _spillPartitions;
+
+    // Only used when '_spilled' is false, or when spilling to hash partitions.
     GroupsMap::iterator groupsIterator;
 
     // Only used when '_spilled' is true.
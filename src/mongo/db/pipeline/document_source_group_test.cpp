@@ -52,6 +52,7 @@
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/dbtests/dbtests.h"
+#include "mongo/idl/server_parameter_test_util.h"
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
@@ -148,6 +149,83 @@ TEST_F(DocumentSourceGroupTest, ShouldBeAbleToPauseLoadingWhileSpilled) {
     ASSERT_EQ(idSet.count(2), 1UL);
 }
 
+TEST_F(DocumentSourceGroupTest, ShouldReaggregateEveryGroupWhenSpillingToHashPartitions) {
+    RAIIServerParameterControllerForTest controller("internalDocumentSourceGroupSpillPartitions",
+                                                    4);
+    auto expCtx = getExpCtx();
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    // Small enough that the input spills several times, and that some partitions still do not fit
+    // in memory when they are read back and have to be partitioned again.
+    const size_t maxMemoryUsageBytes = 1000;
+    auto spec = BSON("$group" << BSON("_id"
+                                      << "$k"
+                                      << "count" << BSON("$sum" << 1)));
+    auto group = DocumentSourceGroup::createFromBsonWithMaxMemoryUsage(
+        spec.firstElement(), expCtx, maxMemoryUsageBytes);
+
+    const int nGroups = 200;
+    const int nDocsPerGroup = 3;
+    std::deque<DocumentSource::GetNextResult> docs;
+    for (int i = 0; i < nGroups * nDocsPerGroup; ++i) {
+        docs.push_back(Document{{"k", i % nGroups}});
+    }
+    auto mock = DocumentSourceMock::createForTest(std::move(docs), expCtx);
+    group->setSource(mock.get());
+
+    stdx::unordered_set<int> idSet;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        ASSERT_EQ(doc["count"].coerceToInt(), nDocsPerGroup);
+        ASSERT_TRUE(idSet.insert(doc["_id"].coerceToInt()).second);
+    }
+    ASSERT_TRUE(group->getNext().isEOF());
+    ASSERT_EQ(idSet.size(), static_cast<size_t>(nGroups));
+    ASSERT_TRUE(group->usedDisk());
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldMergeMultipleAccumulatorsWhenSpillingToHashPartitions) {
+    RAIIServerParameterControllerForTest controller("internalDocumentSourceGroupSpillPartitions",
+                                                    2);
+    auto expCtx = getExpCtx();
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    const size_t maxMemoryUsageBytes = 1000;
+    auto spec = BSON("$group" << BSON("_id"
+                                      << "$k"
+                                      << "total" << BSON("$sum"
+                                                         << "$v")
+                                      << "top"
+                                      << BSON("$max"
+                                              << "$v")));
+    auto group = DocumentSourceGroup::createFromBsonWithMaxMemoryUsage(
+        spec.firstElement(), expCtx, maxMemoryUsageBytes);
+
+    const int nGroups = 50;
+    std::deque<DocumentSource::GetNextResult> docs;
+    for (int v = 1; v <= 4; ++v) {
+        for (int k = 0; k < nGroups; ++k) {
+            docs.push_back(Document{{"k", k}, {"v", v}});
+        }
+    }
+    auto mock = DocumentSourceMock::createForTest(std::move(docs), expCtx);
+    group->setSource(mock.get());
+
+    size_t nResults = 0;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        ASSERT_EQ(doc["total"].coerceToInt(), 10);
+        ASSERT_EQ(doc["top"].coerceToInt(), 4);
+        ++nResults;
+    }
+    ASSERT_EQ(nResults, static_cast<size_t>(nGroups));
+    ASSERT_TRUE(group->usedDisk());
+}
+
 TEST_F(DocumentSourceGroupTest, ShouldErrorIfNotAllowedToSpillToDiskAndResultSetIsTooLarge) {
     auto expCtx = getExpCtx();
     const size_t maxMemoryUsageBytes = 1000;
@@ -0,0 +1,355 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_internal_parallel_group.h"
+
+#include <algorithm>
+
+#include "mongo/base/init.h"
+#include "mongo/db/client.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/logv2/log.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/future.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+namespace {
+// Runs the consumers of every parallel $group other than consumer 0, which always runs on the
+// thread executing the aggregation.
+std::unique_ptr<ThreadPool> parallelGroupThreadPool;
+
+MONGO_INITIALIZER(ParallelGroupThreadPool)(InitializerContext* context) {
+    ThreadPool::Options options;
+    options.poolName = "parallel $group pool";
+    options.threadNamePrefix = "ParallelGroup";
+    options.minThreads = 0;
+    options.maxThreads = 128;
+    options.onCreateThread = [](const std::string& name) { Client::initThread(name); };
+    parallelGroupThreadPool = std::make_unique<ThreadPool>(options);
+    parallelGroupThreadPool->startup();
+}
+
+/**
+ * Tracks the OperationContexts of the workers of one parallel $group, so that they are killed when
+ * the operation running the $group is interrupted or fails.
+ */
+class WorkerOperations {
+public:
+    void add(OperationContext* opCtx) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _opCtxs.push_back(opCtx);
+        if (!_killStatus.isOK()) {
+            _kill(lk, opCtx);
+        }
+    }
+
+    void remove(OperationContext* opCtx) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _opCtxs.erase(std::find(_opCtxs.begin(), _opCtxs.end(), opCtx));
+    }
+
+    void killAll(Status status) {
+        invariant(!status.isOK());
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (!_killStatus.isOK()) {
+            return;
+        }
+        _killStatus = std::move(status);
+        for (auto opCtx : _opCtxs) {
+            _kill(lk, opCtx);
+        }
+    }
+
+private:
+    void _kill(WithLock, OperationContext* opCtx) {
+        const auto killCode = ErrorCodes::isInterruption(_killStatus.code())
+            ? _killStatus.code()
+            : ErrorCodes::Interrupted;
+        stdx::lock_guard<Client> clientLock(*opCtx->getClient());
+        opCtx->getServiceContext()->killOperation(clientLock, opCtx, killCode);
+    }
+
+    Mutex _mutex = MONGO_MAKE_LATCH("WorkerOperations::_mutex");
+    std::vector<OperationContext*> _opCtxs;
+    Status _killStatus = Status::OK();
+};
+}  // namespace
+
+constexpr StringData DocumentSourceInternalParallelGroup::kStageName;
+
+boost::intrusive_ptr<DocumentSourceInternalParallelGroup>
+DocumentSourceInternalParallelGroup::create(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                            std::unique_ptr<Pipeline, PipelineDeleter> input,
+                                            const boost::intrusive_ptr<DocumentSourceGroup>& group,
+                                            size_t nConsumers) {
+    invariant(nConsumers > 1);
+    invariant(input->getContext() == expCtx);
+
+    ExchangeSpec spec;
+    spec.setPolicy(ExchangePolicyEnum::kLocalPartition);
+    spec.setConsumers(nConsumers);
+
+    // The partitioner runs on the loading thread only, so it may use the original $group and its
+    // ExpressionContext. Hashing with the comparator the $group uses for its own hash table keeps
+    // every document of a group, collation included, in the same partition.
+    auto partitioner = [group, nConsumers](const Document& doc) {
+        const auto& comparator = group->getContext()->getValueComparator();
+        return comparator.hash(group->computeId(doc)) % nConsumers;
+    };
+
+    boost::intrusive_ptr<Exchange> exchange =
+        new Exchange(std::move(spec), std::move(input), std::move(partitioner));
+
+    return new DocumentSourceInternalParallelGroup(expCtx, std::move(exchange), group);
+}
+
+DocumentSourceInternalParallelGroup::DocumentSourceInternalParallelGroup(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    boost::intrusive_ptr<Exchange> exchange,
+    boost::intrusive_ptr<DocumentSourceGroup> group)
+    : DocumentSource(kStageName, expCtx), _exchange(std::move(exchange)), _group(std::move(group)) {
+    const auto nConsumers = _exchange->getConsumers();
+    const auto groupSpec = _group->serialize().getDocument().toBson();
+
+    // Split the memory budget of the original $group between the partitions, so that running in
+    // parallel does not multiply the memory footprint of the stage.
+    const auto maxMemoryUsageBytes = _group->getMaxMemoryUsageBytes() / nConsumers;
+
+    for (size_t idx = 0; idx < nConsumers; ++idx) {
+        // Every consumer gets its own ExpressionContext and its own copy of the $group's
+        // expressions, as neither can be shared between threads.
+        auto consumerExpCtx = pExpCtx->copyWith(pExpCtx->ns, pExpCtx->uuid);
+        auto consumerGroup = DocumentSourceGroup::createFromBsonWithMaxMemoryUsage(
+            groupSpec.firstElement(), consumerExpCtx, maxMemoryUsageBytes);
+        consumerGroup->optimize();
+
+        boost::intrusive_ptr<DocumentSource> consumer =
+            new DocumentSourceExchange(consumerExpCtx, _exchange, idx, nullptr);
+        _consumers.emplace_back(Pipeline::create({consumer, consumerGroup}, consumerExpCtx));
+    }
+}
+
+DocumentSource::GetNextResult DocumentSourceInternalParallelGroup::doGetNext() {
+    if (!_initialized) {
+        runConsumers();
+        _initialized = true;
+    }
+
+    while (_currentConsumer < _consumers.size()) {
+        if (auto& firstResult = _firstResults[_currentConsumer]) {
+            GetNextResult result(std::move(*firstResult));
+            firstResult = boost::none;
+            return result;
+        }
+
+        auto next = _consumers[_currentConsumer]->getSources().back()->getNext();
+        if (next.isAdvanced()) {
+            return next;
+        }
+        invariant(next.isEOF());
+        ++_currentConsumer;
+    }
+
+    return GetNextResult::makeEOF();
+}
+
+void DocumentSourceInternalParallelGroup::runConsumers() {
+    const auto nConsumers = _consumers.size();
+    auto opCtx = pExpCtx->opCtx;
+
+    // The workers follow the deadline of the operation, and are killed along with it.
+    auto workerOperations = std::make_shared<WorkerOperations>();
+    const auto deadline = opCtx->getDeadline();
+    const auto timeoutError = opCtx->getTimeoutError();
+
+    std::vector<Future<GetNextResult>> workers;
+    for (size_t idx = 1; idx < nConsumers; ++idx) {
+        auto pf = makePromiseFuture<GetNextResult>();
+        auto consumer = _consumers[idx].get();
+        consumer->detachFromOperationContext();
+
+        parallelGroupThreadPool->schedule([consumer,
+                                           exchange = _exchange,
+                                           workerOperations,
+                                           deadline,
+                                           timeoutError,
+                                           promise = std::move(pf.promise)](auto status) mutable {
+            auto result = [&]() -> StatusWith<GetNextResult> {
+                if (!status.isOK()) {
+                    return status;
+                }
+
+                auto workerOpCtx = cc().makeOperationContext();
+                if (deadline != Date_t::max()) {
+                    workerOpCtx->setDeadlineByDate(deadline, timeoutError);
+                }
+                workerOperations->add(workerOpCtx.get());
+                ON_BLOCK_EXIT([&] { workerOperations->remove(workerOpCtx.get()); });
+
+                consumer->reattachToOperationContext(workerOpCtx.get());
+                ON_BLOCK_EXIT([&] { consumer->detachFromOperationContext(); });
+
+                try {
+                    // The first getNext() of a $group consumes its entire input, which is where
+                    // all of the work of aggregating a partition happens.
+                    return consumer->getSources().back()->getNext();
+                } catch (const DBException& ex) {
+                    return ex.toStatus();
+                }
+            }();
+
+            // A failed partition no longer drains its buffer, so make sure the loading consumer
+            // does not wait for it forever.
+            if (!result.isOK()) {
+                exchange->abort(result.getStatus());
+            }
+            promise.setFrom(std::move(result));
+        });
+        workers.emplace_back(std::move(pf.future));
+    }
+
+    // Consumer 0 runs here, under the operation's own OperationContext, since it is the one loading
+    // the input pipeline.
+    Status firstError = Status::OK();
+    _firstResults.resize(nConsumers);
+    try {
+        auto result = _consumers[0]->getSources().back()->getNext();
+        if (result.isAdvanced()) {
+            _firstResults[0] = result.releaseDocument();
+        }
+    } catch (const DBException& ex) {
+        firstError = ex.toStatus();
+        _exchange->abort(firstError);
+        workerOperations->killAll(firstError);
+    }
+
+    // Wait for every worker, even after a failure, as they reference the consumer pipelines. While
+    // waiting, an interruption of the operation kills the workers, which are then still waited for.
+    // An error raised by a worker is more useful than the ExchangePassthrough error it caused here.
+    for (size_t idx = 1; idx < nConsumers; ++idx) {
+        auto swResult = workers[idx - 1].getNoThrow(opCtx);
+        if (!workers[idx - 1].isReady()) {
+            auto interruptStatus = swResult.getStatus();
+            if (firstError.isOK()) {
+                firstError = interruptStatus;
+            }
+            _exchange->abort(interruptStatus);
+            workerOperations->killAll(interruptStatus);
+            swResult = workers[idx - 1].getNoThrow();
+        }
+        if (!swResult.isOK()) {
+            if (firstError.isOK() || firstError.code() == ErrorCodes::ExchangePassthrough) {
+                firstError = swResult.getStatus();
+            }
+        } else if (swResult.getValue().isAdvanced()) {
+            _firstResults[idx] = swResult.getValue().releaseDocument();
+        }
+        _consumers[idx]->reattachToOperationContext(opCtx);
+    }
+
+    uassertStatusOK(firstError);
+    LOGV2_DEBUG(5902601,
+                3,
+                "Parallel $group aggregated all partitions",
+                "consumers"_attr = nConsumers);
+}
+
+void DocumentSourceInternalParallelGroup::doDispose() {
+    // Consumer 0 goes last, as disposing of it also disposes of the input pipeline.
+    for (auto it = _consumers.rbegin(); it != _consumers.rend(); ++it) {
+        (*it).get_deleter().dismissDisposal();
+        (*it)->dispose(pExpCtx->opCtx);
+    }
+}
+
+void DocumentSourceInternalParallelGroup::detachFromOperationContext() {
+    getInputPipeline()->detachFromOperationContext();
+    for (auto&& consumer : _consumers) {
+        consumer->detachFromOperationContext();
+    }
+}
+
+void DocumentSourceInternalParallelGroup::reattachToOperationContext(OperationContext* opCtx) {
+    getInputPipeline()->reattachToOperationContext(opCtx);
+    for (auto&& consumer : _consumers) {
+        consumer->reattachToOperationContext(opCtx);
+    }
+}
+
+bool DocumentSourceInternalParallelGroup::usedDisk() {
+    return std::any_of(_consumers.begin(), _consumers.end(), [](auto&& consumer) {
+        return consumer->getSources().back()->usedDisk();
+    });
+}
+
+Value DocumentSourceInternalParallelGroup::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    if (!explain) {
+        return _group->serialize();
+    }
+
+    MutableDocument spec;
+    spec["consumers"] = Value(static_cast<long long>(_consumers.size()));
+    spec["group"] = _group->serialize(explain);
+
+    MutableDocument out;
+    out[getSourceName()] = spec.freezeToValue();
+
+    if (*explain >= ExplainOptions::Verbosity::kExecStats) {
+        out["usedDisk"] = Value(std::any_of(
+            _consumers.begin(), _consumers.end(), [](auto&& consumer) {
+                return consumer->getSources().back()->usedDisk();
+            }));
+    }
+
+    return out.freezeToValue();
+}
+
+void DocumentSourceInternalParallelGroup::serializeToArray(
+    std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
+    // Our input is logically the part of the pipeline that precedes us.
+    for (auto&& source : getInputPipeline()->getSources()) {
+        source->serializeToArray(array, explain);
+    }
+
+    auto entry = serialize(explain);
+    if (!entry.missing()) {
+        array.push_back(std::move(entry));
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,154 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/document_source_exchange.h"
+#include "mongo/db/pipeline/document_source_group.h"
+
+namespace mongo {
+
+/**
+ * Executes a $group on several threads. The input of the $group is hash-partitioned on the group
+ * key by a local Exchange, and each partition is aggregated by its own copy of the $group. Consumer
+ * 0 runs on the thread executing this stage and is also the only one pulling from the input
+ * pipeline; the other consumers run on worker threads. Every document of a given group lands in
+ * the same partition, in input order, so the union of the partitions' results is the result of
+ * the original $group.
+ *
+ * This stage is never parsed from a user request. It is created by PipelineD once the pipeline has
+ * been optimized and its $cursor stage has been attached.
+ */
+class DocumentSourceInternalParallelGroup final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$_internalParallelGroup"_sd;
+
+    /**
+     * Creates a stage which runs 'group' over 'input' using 'nConsumers' partitions. 'input' must
+     * be built on 'expCtx'.
+     */
+    static boost::intrusive_ptr<DocumentSourceInternalParallelGroup> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        std::unique_ptr<Pipeline, PipelineDeleter> input,
+        const boost::intrusive_ptr<DocumentSourceGroup>& group,
+        size_t nConsumers);
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kBlocking,
+                                     PositionRequirement::kFirst,
+                                     HostTypeRequirement::kNone,
+                                     DiskUseRequirement::kWritesTmpData,
+                                     FacetRequirement::kNotAllowed,
+                                     TransactionRequirement::kAllowed,
+                                     LookupRequirement::kNotAllowed,
+                                     UnionRequirement::kNotAllowed);
+        constraints.requiresInputDocSource = false;
+        return constraints;
+    }
+
+    boost::optional<DistributedPlanLogic> distributedPlanLogic() final {
+        return boost::none;
+    }
+
+    /**
+     * Serializes as the original $group so the pipeline can be re-parsed; explain additionally
+     * reports the number of partitions and the input pipeline.
+     */
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    void serializeToArray(
+        std::vector<Value>& array,
+        boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    DepsTracker::State getDependencies(DepsTracker* deps) const final {
+        return _group->getDependencies(deps);
+    }
+
+    GetModPathsReturn getModifiedPaths() const final {
+        return _group->getModifiedPaths();
+    }
+
+    void detachFromOperationContext() final;
+
+    void reattachToOperationContext(OperationContext* opCtx) final;
+
+    bool usedDisk() final;
+
+    size_t getConsumers() const {
+        return _consumers.size();
+    }
+
+    /**
+     * Returns the pipeline producing the input of the $group.
+     */
+    Pipeline* getInputPipeline() const {
+        return _exchange->getInputPipeline();
+    }
+
+protected:
+    GetNextResult doGetNext() final;
+    void doDispose() final;
+
+private:
+    DocumentSourceInternalParallelGroup(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                        boost::intrusive_ptr<Exchange> exchange,
+                                        boost::intrusive_ptr<DocumentSourceGroup> group);
+
+    /**
+     * Aggregates every partition, running consumer 0 on this thread and the others on worker
+     * threads, and stores the first result of each partition in '_firstResults'.
+     */
+    void runConsumers();
+
+    // The exchange partitioning the input between consumers; owns the input pipeline.
+    boost::intrusive_ptr<Exchange> _exchange;
+
+    // The original $group, kept for serialization and for computing group keys when partitioning.
+    boost::intrusive_ptr<DocumentSourceGroup> _group;
+
+    // One [$_internalExchange, $group] pipeline per partition, each with its own ExpressionContext.
+    std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> _consumers;
+
+    // The first result returned by each partition's $group, until it has been handed out.
+    std::vector<boost::optional<Document>> _firstResults;
+
+    bool _initialized = false;
+
+    // The partition we are currently returning results from.
+    size_t _currentConsumer = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,191 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/json.h"
+#include "mongo/db/exec/document_value/document_value_test_util.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_source_internal_parallel_group.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/service_context.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class DocumentSourceInternalParallelGroupTest : public AggregationContextFixture {
+public:
+    DocumentSourceInternalParallelGroupTest() {
+        // Debug builds make $group spill eagerly, so give the partitions somewhere to spill to.
+        getExpCtx()->tempDir = _tempDir.path();
+    }
+
+private:
+    unittest::TempDir _tempDir{"DocumentSourceInternalParallelGroupTest"};
+};
+
+auto makeParallelGroup(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                       boost::intrusive_ptr<DocumentSourceMock> input,
+                       const BSONObj& groupSpec,
+                       size_t nConsumers) {
+    auto group = DocumentSourceGroup::createFromBsonWithMaxMemoryUsage(
+        groupSpec.firstElement(), expCtx, boost::none);
+    return DocumentSourceInternalParallelGroup::create(
+        expCtx, Pipeline::create({input}, expCtx), group, nConsumers);
+}
+
+/**
+ * A mock input which kills the operation once it has returned 'killAfter' documents, as killOp
+ * would while the input is being loaded.
+ */
+class InterruptingMock final : public DocumentSourceMock {
+public:
+    InterruptingMock(std::deque<GetNextResult> results,
+                     const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                     size_t killAfter)
+        : DocumentSourceMock(std::move(results), expCtx), _killAfter(killAfter) {}
+
+protected:
+    GetNextResult doGetNext() final {
+        auto opCtx = pExpCtx->opCtx;
+        if (_returned++ == _killAfter) {
+            stdx::lock_guard<Client> lk(*opCtx->getClient());
+            opCtx->getServiceContext()->killOperation(lk, opCtx, ErrorCodes::Interrupted);
+        }
+        opCtx->checkForInterrupt();
+        return DocumentSourceMock::doGetNext();
+    }
+
+private:
+    const size_t _killAfter;
+    size_t _returned = 0;
+};
+
+TEST_F(DocumentSourceInternalParallelGroupTest, ProducesEveryGroupExactlyOnce) {
+    const int nDocs = 10000;
+    const int nGroups = 37;
+
+    auto input = DocumentSourceMock::createForTest(getExpCtx());
+    for (int i = 0; i < nDocs; ++i) {
+        input->emplace_back(Document{{"a", i % nGroups}, {"b", i}});
+    }
+
+    auto parallelGroup = makeParallelGroup(
+        getExpCtx(),
+        input,
+        fromjson("{$group: {_id: '$a', count: {$sum: 1}, first: {$first: '$b'}}}"),
+        4);
+    ASSERT_EQ(parallelGroup->getConsumers(), 4u);
+
+    std::map<int, Document> results;
+    for (auto next = parallelGroup->getNext(); next.isAdvanced(); next = parallelGroup->getNext()) {
+        auto doc = next.releaseDocument();
+        ASSERT_TRUE(results.emplace(doc["_id"].getInt(), doc).second);
+    }
+
+    // Every document of a group is routed to the same partition in input order, so $first still
+    // sees the first document of its group.
+    ASSERT_EQ(results.size(), static_cast<size_t>(nGroups));
+    for (int id = 0; id < nGroups; ++id) {
+        const int expectedCount = nDocs / nGroups + (id < nDocs % nGroups ? 1 : 0);
+        ASSERT_DOCUMENT_EQ(results[id],
+                           (Document{{"_id", id}, {"count", expectedCount}, {"first", id}}));
+    }
+
+    parallelGroup->dispose();
+}
+
+TEST_F(DocumentSourceInternalParallelGroupTest, GroupsMissingAndNullKeysTogether) {
+    auto input = DocumentSourceMock::createForTest({Document{{"a", BSONNULL}},
+                                                    Document{{"b", 1}},
+                                                    Document{{"a", 1}},
+                                                    Document{{"a", 1.0}},
+                                                    Document{{"a", 1LL}}},
+                                                   getExpCtx());
+
+    auto parallelGroup = makeParallelGroup(
+        getExpCtx(), input, fromjson("{$group: {_id: '$a', count: {$sum: 1}}}"), 8);
+
+    std::vector<Document> results;
+    for (auto next = parallelGroup->getNext(); next.isAdvanced(); next = parallelGroup->getNext()) {
+        results.push_back(next.releaseDocument());
+    }
+
+    ASSERT_EQ(results.size(), 2u);
+    for (auto&& doc : results) {
+        ASSERT_VALUE_EQ(doc["count"], Value(doc["_id"].nullish() ? 2 : 3));
+    }
+
+    parallelGroup->dispose();
+}
+
+TEST_F(DocumentSourceInternalParallelGroupTest, HandlesEmptyInput) {
+    auto input = DocumentSourceMock::createForTest(getExpCtx());
+
+    auto parallelGroup = makeParallelGroup(
+        getExpCtx(), input, fromjson("{$group: {_id: '$a', count: {$sum: 1}}}"), 3);
+
+    ASSERT_TRUE(parallelGroup->getNext().isEOF());
+    ASSERT_TRUE(parallelGroup->getNext().isEOF());
+
+    parallelGroup->dispose();
+}
+
+TEST_F(DocumentSourceInternalParallelGroupTest, KillingTheOperationStopsEveryPartition) {
+    std::deque<DocumentSource::GetNextResult> docs;
+    for (int i = 0; i < 10000; ++i) {
+        docs.emplace_back(Document{{"a", i % 37}});
+    }
+    auto input = make_intrusive<InterruptingMock>(std::move(docs), getExpCtx(), 5000);
+
+    auto parallelGroup = makeParallelGroup(
+        getExpCtx(), input, fromjson("{$group: {_id: '$a', count: {$sum: 1}}}"), 4);
+
+    // The operation's own error is reported rather than the errors it caused in the workers.
+    ASSERT_THROWS_CODE(parallelGroup->getNext(), AssertionException, ErrorCodes::Interrupted);
+
+    parallelGroup->dispose();
+}
+
+TEST_F(DocumentSourceInternalParallelGroupTest, SerializesAsTheOriginalGroup) {
+    auto input = DocumentSourceMock::createForTest(getExpCtx());
+    const auto groupSpec = fromjson("{$group: {_id: '$a', count: {$sum: {$const: 1}}}}");
+
+    auto parallelGroup = makeParallelGroup(getExpCtx(), input, groupSpec, 2);
+
+    std::vector<Value> serialized;
+    parallelGroup->serializeToArray(serialized);
+    ASSERT_EQ(serialized.size(), 2u);
+    ASSERT_BSONOBJ_EQ(serialized[1].getDocument().toBson(), groupSpec);
+}
+
+}  // namespace
+}  // namespace mongo
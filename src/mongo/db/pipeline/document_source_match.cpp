@@ -89,14 +89,7 @@ DocumentSource::GetNextResult DocumentSourceMatch::doGetNext() {
 
     auto nextInput = pSource->getNext();
     for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
-        // MatchExpression only takes BSON documents, so we have to make one. As an optimization,
-        // only serialize the fields we need to do the match.
-        BSONObj toMatch = _dependencies.needWholeDocument
-            ? nextInput.getDocument().toBson()
-            : document_path_support::documentToBsonWithPaths(nextInput.getDocument(),
-                                                             _dependencies.fields);
-
-        if (_expression->matchesBSON(toMatch)) {
+        if (documentMatches(nextInput.getDocument())) {
             return nextInput;
         }
 
@@ -111,6 +104,52 @@ DocumentSource::GetNextResult DocumentSourceMatch::doGetNext() {
     return nextInput;
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSourceMatch::doGetNextBatch(
+    std::vector<Document>* batch, size_t maxBatchSize) {
+    massert(5902800,
+            "Should never call getNextBatch on a $match stage with $text clause",
+            !_isTextQuery);
+
+    // Matching documents are compacted in place, right after those already in 'batch'. We keep
+    // asking our source for more until the batch is full or the source cannot fill it.
+    const size_t batchStart = batch->size();
+    size_t batchEnd = batchStart;
+    while (true) {
+        auto status = pSource->getNextBatch(batch, maxBatchSize - (batchEnd - batchStart));
+
+        for (size_t i = batchEnd; i < batch->size(); ++i) {
+            if (documentMatches((*batch)[i])) {
+                if (i != batchEnd) {
+                    (*batch)[batchEnd] = std::move((*batch)[i]);
+                }
+                ++batchEnd;
+            }
+        }
+        batch->erase(batch->begin() + batchEnd, batch->end());
+
+        if (status != GetNextResult::ReturnStatus::kAdvanced ||
+            batchEnd - batchStart == maxBatchSize) {
+            return status;
+        }
+    }
+}
+
+bool DocumentSourceMatch::documentMatches(const Document& doc) {
+    // A document which has not been modified since it was read, typically one coming straight from
+    // a cursor, can be matched against its backing BSON as is. The predicate only depends on the
+    // fields in '_dependencies', so the other fields do not change the result.
+    if (auto bson = doc.toBsonIfTriviallyConvertible()) {
+        return _expression->matchesBSON(*bson);
+    }
+
+    // MatchExpression only takes BSON documents, so we have to make one. As an optimization, only
+    // serialize the fields we need to do the match.
+    BSONObj toMatch = _dependencies.needWholeDocument
+        ? doc.toBson()
+        : document_path_support::documentToBsonWithPaths(doc, _dependencies.fields);
+    return _expression->matchesBSON(toMatch);
+}
+
 Pipeline::SourceContainer::iterator DocumentSourceMatch::doOptimizeAt(
     Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
     invariant(*itr == this);
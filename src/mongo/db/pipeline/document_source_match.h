@@ -218,6 +218,8 @@ protected:
               other.pExpCtx) {}
 
     GetNextResult doGetNext() override;
+    GetNextResult::ReturnStatus doGetNextBatch(std::vector<Document>* batch,
+                                               size_t maxBatchSize) override;
     DocumentSourceMatch(const BSONObj& query,
                         const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
@@ -229,6 +231,11 @@ private:
                       const StringMap<std::string>& renames,
                       expression::ShouldSplitExprFunc func) &&;
 
+    /**
+     * Returns true if 'doc' satisfies this stage's predicate.
+     */
+    bool documentMatches(const Document& doc);
+
     std::unique_ptr<MatchExpression> _expression;
 
     bool _isTextQuery;
@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/pipeline/document_source_add_fields.h"
+#include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/query_test_service_context.h"
+
+namespace mongo {
+namespace {
+
+const int kNumDocuments = 1000;
+
+/**
+ * Builds 'kNumDocuments' BSON documents of 'numFields' integer fields each, named "f0", "f1"...
+ * Every other document matches {f0: 0}.
+ */
+std::vector<BSONObj> makeInput(int numFields) {
+    std::vector<BSONObj> input;
+    input.reserve(kNumDocuments);
+    for (int i = 0; i < kNumDocuments; ++i) {
+        BSONObjBuilder builder;
+        for (int f = 0; f < numFields; ++f) {
+            builder.append("f" + std::to_string(f), f == 0 ? i % 2 : i);
+        }
+        input.push_back(builder.obj());
+    }
+    return input;
+}
+
+/**
+ * Runs a $match on {f0: 0} over documents of 'numFields' fields, optionally preceded by an
+ * $addFields. Documents produced by the mock source are backed by unmodified BSON, just like the
+ * ones produced by a cursor, while the output of $addFields is not.
+ */
+void runMatch(bool withAddFields, int numFields, benchmark::State& state) {
+    QueryTestServiceContext testServiceContext;
+    auto opContext = testServiceContext.makeOperationContext();
+    NamespaceString nss("test.bm");
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx =
+        new ExpressionContextForTest(opContext.get(), nss);
+
+    const auto input = makeInput(numFields);
+
+    for (auto keepRunning : state) {
+        std::deque<DocumentSource::GetNextResult> docs;
+        for (auto&& obj : input) {
+            docs.emplace_back(Document(obj));
+        }
+        auto mock = DocumentSourceMock::createForTest(std::move(docs), expCtx);
+
+        auto match = DocumentSourceMatch::create(BSON("f0" << 0), expCtx);
+        boost::intrusive_ptr<DocumentSource> addFields;
+        if (withAddFields) {
+            addFields = DocumentSourceAddFields::create(BSON("added" << 1), expCtx);
+            addFields->setSource(mock.get());
+            match->setSource(addFields.get());
+        } else {
+            match->setSource(mock.get());
+        }
+
+        for (auto next = match->getNext(); next.isAdvanced(); next = match->getNext()) {
+            benchmark::DoNotOptimize(next.releaseDocument());
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kNumDocuments);
+}
+
+void BM_MatchOnUnmodifiedDocuments(benchmark::State& state) {
+    runMatch(false, state.range(0), state);
+}
+
+void BM_MatchAfterAddFields(benchmark::State& state) {
+    runMatch(true, state.range(0), state);
+}
+
+BENCHMARK(BM_MatchOnUnmodifiedDocuments)->Arg(2)->Arg(20)->Arg(200);
+BENCHMARK(BM_MatchAfterAddFields)->Arg(2)->Arg(20)->Arg(200);
+
+}  // namespace
+}  // namespace mongo
@@ -535,6 +535,68 @@ TEST_F(DocumentSourceMatchTest, ShouldPropagatePauses) {
     ASSERT_TRUE(match->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceMatchTest, ShouldMatchBothUnmodifiedAndModifiedDocuments) {
+    auto match = DocumentSourceMatch::create(fromjson("{'b.c': 2}"), getExpCtx());
+
+    // Documents read straight from BSON are matched against that BSON, while modified documents
+    // are serialized first; both must give the same answers.
+    Document matching(fromjson("{a: 1, b: {c: 2}}"));
+    Document notMatching(fromjson("{a: 1, b: {c: 3}}"));
+    ASSERT_FALSE(matching.isModified());
+
+    MutableDocument modified(notMatching);
+    modified.setNestedField("b.c", Value(2));
+
+    auto mock = DocumentSourceMock::createForTest({matching, notMatching, modified.freeze()},
+                                                  getExpCtx());
+    match->setSource(mock.get());
+
+    auto next = match->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), matching);
+
+    next = match->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"a", 1}, {"b", Document{{"c", 2}}}}));
+
+    ASSERT_TRUE(match->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceMatchTest, GetNextBatchShouldOnlyReturnMatchingDocuments) {
+    auto match = DocumentSourceMatch::create(BSON("a" << 1), getExpCtx());
+    auto mock = DocumentSourceMock::createForTest(
+        {Document{{"a", 1}, {"b", 0}},
+         Document{{"a", 2}},
+         Document{{"a", 1}, {"b", 1}},
+         DocumentSource::GetNextResult::makePauseExecution(),
+         Document{{"a", 2}},
+         Document{{"a", 1}, {"b", 2}},
+         Document{{"a", 1}, {"b", 3}}},
+        getExpCtx());
+    match->setSource(mock.get());
+
+    using ReturnStatus = DocumentSource::GetNextResult::ReturnStatus;
+    std::vector<Document> batch;
+
+    // The batch ends early at the pause, with the matching documents which preceded it.
+    ASSERT(match->getNextBatch(&batch, 10) == ReturnStatus::kPauseExecution);
+    ASSERT_EQ(batch.size(), 2U);
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"a", 1}, {"b", 0}}));
+    ASSERT_DOCUMENT_EQ(batch[1], (Document{{"a", 1}, {"b", 1}}));
+
+    // A full batch is appended to what 'batch' already holds.
+    ASSERT(match->getNextBatch(&batch, 1) == ReturnStatus::kAdvanced);
+    ASSERT_EQ(batch.size(), 3U);
+    ASSERT_DOCUMENT_EQ(batch[2], (Document{{"a", 1}, {"b", 2}}));
+
+    ASSERT(match->getNextBatch(&batch, 10) == ReturnStatus::kEOF);
+    ASSERT_EQ(batch.size(), 4U);
+    ASSERT_DOCUMENT_EQ(batch[3], (Document{{"a", 1}, {"b", 3}}));
+
+    ASSERT(match->getNextBatch(&batch, 10) == ReturnStatus::kEOF);
+    ASSERT_EQ(batch.size(), 4U);
+}
+
 TEST_F(DocumentSourceMatchTest, ShouldCorrectlyJoinWithSubsequentMatch) {
     const auto match = DocumentSourceMatch::create(BSON("a" << 1), getExpCtx());
     const auto secondMatch = DocumentSourceMatch::create(BSON("b" << 1), getExpCtx());
@@ -31,6 +31,8 @@
 
 #include "mongo/db/pipeline/document_source_single_document_transformation.h"
 
+#include <utility>
+
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 
 #include "mongo/db/exec/document_value/document.h"
@@ -72,6 +74,22 @@ DocumentSource::GetNextResult DocumentSourceSingleDocumentTransformation::doGetN
     return _parsedTransform->applyTransformation(input.releaseDocument());
 }
 
+DocumentSource::GetNextResult::ReturnStatus
+DocumentSourceSingleDocumentTransformation::doGetNextBatch(std::vector<Document>* batch,
+                                                           size_t maxBatchSize) {
+    if (!_parsedTransform) {
+        return GetNextResult::ReturnStatus::kEOF;
+    }
+
+    // Transform the documents appended by our source in place.
+    const size_t batchStart = batch->size();
+    auto status = pSource->getNextBatch(batch, maxBatchSize);
+    for (size_t i = batchStart; i < batch->size(); ++i) {
+        (*batch)[i] = _parsedTransform->applyTransformation(std::exchange((*batch)[i], {}));
+    }
+    return status;
+}
+
 intrusive_ptr<DocumentSource> DocumentSourceSingleDocumentTransformation::optimize() {
     if (_parsedTransform) {
         _parsedTransform->optimize();
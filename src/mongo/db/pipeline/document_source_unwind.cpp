@@ -208,6 +208,27 @@ DocumentSource::GetNextResult DocumentSourceUnwind::doGetNext() {
     return nextOut;
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSourceUnwind::doGetNextBatch(
+    std::vector<Document>* batch, size_t maxBatchSize) {
+    // Every input document may produce many outputs, so the input is still pulled one document at
+    // a time; only the outputs are batched.
+    for (size_t nOut = 0; nOut < maxBatchSize;) {
+        auto nextOut = _unwinder->getNext();
+        if (nextOut.isAdvanced()) {
+            batch->push_back(nextOut.releaseDocument());
+            ++nOut;
+            continue;
+        }
+
+        auto nextInput = pSource->getNext();
+        if (!nextInput.isAdvanced()) {
+            return nextInput.getStatus();
+        }
+        _unwinder->resetDocument(nextInput.releaseDocument());
+    }
+    return GetNextResult::ReturnStatus::kAdvanced;
+}
+
 DocumentSource::GetModPathsReturn DocumentSourceUnwind::getModifiedPaths() const {
     std::set<std::string> modifiedFields{_unwindPath.fullPath()};
     if (_indexPath) {
@@ -106,6 +106,8 @@ private:
                          const boost::optional<FieldPath>& includeArrayIndex);
 
     GetNextResult doGetNext() final;
+    GetNextResult::ReturnStatus doGetNextBatch(std::vector<Document>* batch,
+                                               size_t maxBatchSize) final;
 
     // Configuration state.
     const FieldPath _unwindPath;
@@ -709,6 +709,31 @@ TEST_F(UnwindStageTest, ShouldPropagatePauses) {
     ASSERT_TRUE(unwind->getNext().isEOF());
 }
 
+TEST_F(UnwindStageTest, GetNextBatchShouldUnwindAcrossInputDocuments) {
+    auto unwind = DocumentSourceUnwind::create(getExpCtx(), "array", false, boost::none);
+    auto source = DocumentSourceMock::createForTest(
+        {Document{{"array", vector<Value>{Value(1), Value(2), Value(3)}}},
+         Document{{"array", vector<Value>{}}},
+         Document{{"array", vector<Value>{Value(4)}}},
+         DocumentSource::GetNextResult::makePauseExecution(),
+         Document{{"array", vector<Value>{Value(5), Value(6)}}}},
+        getExpCtx());
+    unwind->setSource(source.get());
+
+    using ReturnStatus = DocumentSource::GetNextResult::ReturnStatus;
+    std::vector<Document> batch;
+
+    // A batch may end in the middle of an input document's array.
+    ASSERT(unwind->getNextBatch(&batch, 2) == ReturnStatus::kAdvanced);
+    ASSERT(unwind->getNextBatch(&batch, 10) == ReturnStatus::kPauseExecution);
+    ASSERT(unwind->getNextBatch(&batch, 10) == ReturnStatus::kEOF);
+
+    ASSERT_EQ(batch.size(), 6U);
+    for (size_t i = 0; i < batch.size(); ++i) {
+        ASSERT_VALUE_EQ(batch[i]["array"], Value(static_cast<int>(i + 1)));
+    }
+}
+
 TEST_F(UnwindStageTest, UnwindOnlyModifiesUnwoundPathWhenNotIncludingIndex) {
     const bool includeNullIfEmptyOrMissing = false;
     const boost::optional<std::string> includeArrayIndex = boost::none;
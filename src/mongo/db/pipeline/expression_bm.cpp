@@ -31,7 +31,9 @@
 
 #include <benchmark/benchmark.h>
 
+#include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/compiled_expression.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/query/query_test_service_context.h"
@@ -407,5 +409,63 @@ BENCHMARK(BM_SetFieldEvaluateExpression);
 BENCHMARK(BM_SetFieldWithRemoveExpression);
 BENCHMARK(BM_UnsetFieldEvaluateExpression);
 
+/**
+ * Tests performance of evaluating an optimized expression on a document, either by walking the
+ * expression tree or through its CompiledExpression, the way $project and $addFields evaluate
+ * their computed fields.
+ */
+void testProjectedExpression(StringData expressionSpec, bool compile, benchmark::State& state) {
+    QueryTestServiceContext testServiceContext;
+    auto opContext = testServiceContext.makeOperationContext();
+    NamespaceString nss("test.bm");
+    boost::intrusive_ptr<ExpressionContextForTest> exprContext =
+        new ExpressionContextForTest(opContext.get(), nss);
+
+    auto expression = Expression::parseExpression(exprContext.get(),
+                                                  fromjson(expressionSpec.toString()),
+                                                  exprContext->variablesParseState)
+                          ->optimize();
+    auto compiled = CompiledExpression::compile(expression);
+
+    auto variables = &(exprContext->variables);
+    Document document{fromjson("{_id: 1, price: 12.5, qty: 4, discount: 1.5, "
+                               "item: {sku: 'abc', dims: {h: 10, w: 20}}, tags: ['x', 'y']}")};
+
+    for (auto keepRunning : state) {
+        if (compile) {
+            benchmark::DoNotOptimize(compiled.evaluate(document, variables));
+        } else {
+            benchmark::DoNotOptimize(expression->evaluate(document, variables));
+        }
+        benchmark::ClobberMemory();
+    }
+}
+
+constexpr auto kProjectedTotalSpec =
+    "{$subtract: [{$multiply: ['$price', '$qty']}, '$discount']}"_sd;
+constexpr auto kProjectedAreaSpec =
+    "{$multiply: [{$add: ['$item.dims.h', 1]}, {$add: ['$item.dims.w', 1]}]}"_sd;
+
+void BM_ProjectedArithmeticInterpreted(benchmark::State& state) {
+    testProjectedExpression(kProjectedTotalSpec, false, state);
+}
+
+void BM_ProjectedArithmeticCompiled(benchmark::State& state) {
+    testProjectedExpression(kProjectedTotalSpec, true, state);
+}
+
+void BM_ProjectedNestedPathsInterpreted(benchmark::State& state) {
+    testProjectedExpression(kProjectedAreaSpec, false, state);
+}
+
+void BM_ProjectedNestedPathsCompiled(benchmark::State& state) {
+    testProjectedExpression(kProjectedAreaSpec, true, state);
+}
+
+BENCHMARK(BM_ProjectedArithmeticInterpreted);
+BENCHMARK(BM_ProjectedArithmeticCompiled);
+BENCHMARK(BM_ProjectedNestedPathsInterpreted);
+BENCHMARK(BM_ProjectedNestedPathsCompiled);
+
 }  // namespace
 }  // namespace mongo
@@ -62,6 +62,7 @@
 #include "mongo/db/pipeline/document_source_geo_near.h"
 #include "mongo/db/pipeline/document_source_geo_near_cursor.h"
 #include "mongo/db/pipeline/document_source_group.h"
+#include "mongo/db/pipeline/document_source_internal_parallel_group.h"
 #include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_sample.h"
@@ -74,6 +75,7 @@
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_executor_factory.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/sort_pattern.h"
 #include "mongo/db/s/collection_sharding_state.h"
@@ -578,6 +580,37 @@ void PipelineD::buildAndAttachInnerQueryExecutorToPipeline(
         collection, callback.first, std::move(callback.second), pipeline);
 }
 
+void PipelineD::parallelizeGroupIfEligible(Pipeline* pipeline) {
+    const auto nConsumers = internalDocumentSourceGroupParallelConsumers.load();
+    const auto& expCtx = pipeline->getContext();
+
+    // Sub-pipelines, such as those of $lookup, may be executed once per input document, which is
+    // far too often to be worth handing work to other threads.
+    if (nConsumers <= 1 || expCtx->inMongos || expCtx->subPipelineDepth > 0) {
+        return;
+    }
+
+    auto& sources = pipeline->_sources;
+    auto groupIt = std::find_if(sources.begin(), sources.end(), [](auto&& source) {
+        return dynamic_cast<DocumentSourceGroup*>(source.get());
+    });
+    if (groupIt == sources.end() || groupIt == sources.begin()) {
+        return;
+    }
+
+    boost::intrusive_ptr<DocumentSourceGroup> group =
+        static_cast<DocumentSourceGroup*>(groupIt->get());
+
+    // Everything ahead of the $group becomes the input of the exchange and keeps running on this
+    // thread; only the $group itself is split across consumers.
+    Pipeline::SourceContainer input(sources.begin(), groupIt);
+    sources.erase(sources.begin(), std::next(groupIt));
+
+    sources.push_front(DocumentSourceInternalParallelGroup::create(
+        expCtx, Pipeline::create(std::move(input), expCtx), group, nConsumers));
+    pipeline->stitch();
+}
+
 namespace {
 
 /**
@@ -122,6 +122,14 @@ public:
         const AggregateCommandRequest* aggRequest,
         Pipeline* pipeline);
 
+    /**
+     * If enabled by 'internalDocumentSourceGroupParallelConsumers', replaces the first $group of
+     * 'pipeline' and everything preceding it with a $_internalParallelGroup stage, which
+     * hash-partitions the $group's input across several local threads. Must be called once the
+     * pipeline has been optimized and its $cursor stage has been attached.
+     */
+    static void parallelizeGroupIfEligible(Pipeline* pipeline);
+
     static Timestamp getLatestOplogTimestamp(const Pipeline* pipeline);
 
     /**
@@ -32,6 +32,7 @@
 #include "mongo/db/pipeline/plan_explainer_pipeline.h"
 
 #include "mongo/db/pipeline/document_source_cursor.h"
+#include "mongo/db/pipeline/document_source_internal_parallel_group.h"
 #include "mongo/db/pipeline/document_source_lookup.h"
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/document_source_union_with.h"
@@ -50,19 +51,31 @@ void collectPlanSummaryStats(const DocSourceType& source, PlanSummaryStats* stat
     statsOut->accumulate(docSpecificStats.planSummaryStats);
 }
 
+namespace {
+/**
+ * Returns the $cursor stage feeding 'pipeline', if any. A parallel $group moves the stages ahead of
+ * it, including the $cursor, into its own input pipeline.
+ */
+DocumentSourceCursor* getCursorStage(const Pipeline& pipeline) {
+    const auto& front = pipeline.getSources().front();
+    if (auto parallelGroup = dynamic_cast<DocumentSourceInternalParallelGroup*>(front.get())) {
+        return getCursorStage(*parallelGroup->getInputPipeline());
+    }
+    return dynamic_cast<DocumentSourceCursor*>(front.get());
+}
+}  // namespace
+
 const PlanExplainer::ExplainVersion& PlanExplainerPipeline::getVersion() const {
     static const ExplainVersion kExplainVersion = "1";
 
-    if (auto docSourceCursor =
-            dynamic_cast<DocumentSourceCursor*>(_pipeline->getSources().front().get())) {
+    if (auto docSourceCursor = getCursorStage(*_pipeline)) {
         return docSourceCursor->getExplainVersion();
     }
     return kExplainVersion;
 }
 
 std::string PlanExplainerPipeline::getPlanSummary() const {
-    if (auto docSourceCursor =
-            dynamic_cast<DocumentSourceCursor*>(_pipeline->getSources().front().get())) {
+    if (auto docSourceCursor = getCursorStage(*_pipeline)) {
         return docSourceCursor->getPlanSummaryStr();
     }
 
@@ -72,8 +85,7 @@ std::string PlanExplainerPipeline::getPlanSummary() const {
 void PlanExplainerPipeline::getSummaryStats(PlanSummaryStats* statsOut) const {
     invariant(statsOut);
 
-    if (auto docSourceCursor =
-            dynamic_cast<DocumentSourceCursor*>(_pipeline->getSources().front().get())) {
+    if (auto docSourceCursor = getCursorStage(*_pipeline)) {
         *statsOut = docSourceCursor->getPlanSummaryStats();
     }
 
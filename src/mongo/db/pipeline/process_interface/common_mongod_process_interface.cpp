@@ -385,6 +385,17 @@ BackupCursorExtendState CommonMongodProcessInterface::extendBackupCursor(
     }
 }
 
+bool CommonMongodProcessInterface::isFileReturnedByBackupCursor(OperationContext* opCtx,
+                                                                const UUID& backupId,
+                                                                const std::string& filePath) {
+    auto backupCursorHooks = BackupCursorHooks::get(opCtx->getServiceContext());
+    if (backupCursorHooks->enabled()) {
+        return backupCursorHooks->isFileReturnedByCursor(backupId, filePath);
+    } else {
+        uasserted(5904500, "Backup cursors are an enterprise only feature.");
+    }
+}
+
 std::vector<BSONObj> CommonMongodProcessInterface::getMatchingPlanCacheEntryStats(
     OperationContext* opCtx, const NamespaceString& nss, const MatchExpression* matchExp) const {
     const auto serializer = [](const PlanCacheEntry& entry) {
@@ -84,6 +84,9 @@ public:
     BackupCursorExtendState extendBackupCursor(OperationContext* opCtx,
                                                const UUID& backupId,
                                                const Timestamp& extendTo) final;
+    bool isFileReturnedByBackupCursor(OperationContext* opCtx,
+                                      const UUID& backupId,
+                                      const std::string& filePath) final;
 
     std::vector<BSONObj> getMatchingPlanCacheEntryStats(OperationContext*,
                                                         const NamespaceString&,
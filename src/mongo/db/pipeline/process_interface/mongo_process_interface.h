@@ -385,6 +385,10 @@ public:
                                                        const UUID& backupId,
                                                        const Timestamp& extendTo) = 0;
 
+    virtual bool isFileReturnedByBackupCursor(OperationContext* opCtx,
+                                              const UUID& backupId,
+                                              const std::string& filePath) = 0;
+
     /**
      * Returns a vector of BSON objects, where each entry in the vector describes a plan cache entry
      * inside the cache for the given namespace. Only those entries which match the supplied
@@ -189,6 +189,12 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    bool isFileReturnedByBackupCursor(OperationContext* opCtx,
+                                      const UUID& backupId,
+                                      const std::string& filePath) final {
+        uasserted(ErrorCodes::NotImplemented, "Backup files cannot be read through mongos");
+    }
+
     /**
      * Mongos does not have a plan cache, so this method should never be called on mongos. Upstream
      * checks are responsible for generating an error if a user attempts to introspect the plan
@@ -221,6 +221,12 @@ public:
         return {{}};
     }
 
+    bool isFileReturnedByBackupCursor(OperationContext* opCtx,
+                                      const UUID& backupId,
+                                      const std::string& filePath) final {
+        return false;
+    }
+
     std::vector<BSONObj> getMatchingPlanCacheEntryStats(OperationContext*,
                                                         const NamespaceString&,
                                                         const MatchExpression*) const override {
@@ -215,6 +215,7 @@ void AllDatabaseCloner::postStage() {
                                                                       getClient(),
                                                                       getStorageInterface(),
                                                                       getDBPool());
+            inheritCreateClientFn(_currentDatabaseCloner.get());
         }
         auto dbStatus = _currentDatabaseCloner->run();
         if (dbStatus.isOK()) {
@@ -31,10 +31,15 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+#include <utility>
+
 #include "mongo/base/string_data.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/commands/list_collections_filter.h"
 #include "mongo/db/index_build_entry_helpers.h"
 #include "mongo/db/index_builds_coordinator.h"
+#include "mongo/db/query/cursor_response.h"
 #include "mongo/db/repl/collection_bulk_loader.h"
 #include "mongo/db/repl/collection_cloner.h"
 #include "mongo/db/repl/database_cloner_gen.h"
@@ -56,6 +61,14 @@ MONGO_FAIL_POINT_DEFINE(initialSyncHangDuringCollectionClone);
 // DBClientConnection, optionally limited to a specific collection.
 MONGO_FAIL_POINT_DEFINE(initialSyncHangCollectionClonerAfterHandlingBatchResponse);
 
+namespace {
+
+// How many _id values are sampled per range when partitioning a collection, to even out the
+// number of documents in each range.
+const size_t kSamplesPerPartition = 10;
+
+}  // namespace
+
 CollectionCloner::CollectionCloner(const NamespaceString& sourceNss,
                                    const CollectionOptions& collectionOptions,
                                    InitialSyncSharedData* sharedData,
@@ -72,6 +85,7 @@ CollectionCloner::CollectionCloner(const NamespaceString& sourceNss,
       _countStage("count", this, &CollectionCloner::countStage),
       _listIndexesStage("listIndexes", this, &CollectionCloner::listIndexesStage),
       _createCollectionStage("createCollection", this, &CollectionCloner::createCollectionStage),
+      _partitionStage("partition", this, &CollectionCloner::partitionStage),
       _queryStage("query", this, &CollectionCloner::queryStage),
       _setupIndexBuildersForUnfinishedIndexesStage(
           "setupIndexBuildersForUnfinishedIndexes",
@@ -110,6 +124,7 @@ BaseCloner::ClonerStages CollectionCloner::getStages() {
     return {&_countStage,
             &_listIndexesStage,
             &_createCollectionStage,
+            &_partitionStage,
             &_queryStage,
             &_setupIndexBuildersForUnfinishedIndexesStage};
 }
@@ -235,8 +250,121 @@ BaseCloner::AfterStageBehavior CollectionCloner::createCollectionStage() {
     return kContinueNormally;
 }
 
+BaseCloner::AfterStageBehavior CollectionCloner::partitionStage() {
+    long long bytesToCopy;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        bytesToCopy = _stats.bytesToCopy;
+        // A retry of this stage starts over; nothing has been fetched yet.
+        _partitions.clear();
+        _stats.partitions = 0;
+    }
+
+    // Ranges are fetched through the _id index with 'min' and 'max' bounds, which compare keys in
+    // index order, so the index must exist and use the simple collation.  Capped collections
+    // must be cloned in insertion order.  The ranges are resumed by _id, which requires resumable
+    // initial sync on the sync source.
+    if (!_resumeSupported || _idIndexSpec.isEmpty() || _collectionOptions.capped ||
+        _collectionOptions.clusteredIndex || !_collectionOptions.collation.isEmpty()) {
+        return kContinueNormally;
+    }
+    auto numPartitions = static_cast<size_t>(
+        std::min<long long>(collectionClonerMaxPartitions,
+                            bytesToCopy / collectionClonerMinPartitionSizeBytes));
+    if (numPartitions <= 1) {
+        return kContinueNormally;
+    }
+
+    const auto sampleSize = static_cast<long long>(numPartitions * kSamplesPerPartition);
+    BSONObj res;
+    getClient()->runCommand(
+        _sourceNss.db().toString(),
+        BSON("aggregate" << _sourceNss.coll() << "pipeline"
+                         << BSON_ARRAY(BSON("$sample" << BSON("size" << sampleSize))
+                                       << BSON("$project" << BSON("_id" << 1)))
+                         << "cursor" << BSON("batchSize" << sampleSize)),
+        res,
+        QueryOption_SecondaryOk);
+    auto swCursor = CursorResponse::parseFromBSON(res);
+    if (!swCursor.isOK()) {
+        if (ErrorCodes::isRetriableError(swCursor.getStatus())) {
+            uassertStatusOK(swCursor.getStatus());
+        }
+        // The collection may have been renamed on the sync source, since it is sampled by name.
+        // Whatever the reason, cloning with a single query is always correct.
+        LOGV2_DEBUG(5904401,
+                    1,
+                    "Cloning collection with a single query because sampling it failed",
+                    "namespace"_attr = _sourceNss,
+                    "error"_attr = swCursor.getStatus());
+        return kContinueNormally;
+    }
+    if (swCursor.getValue().getCursorId() != 0) {
+        getClient()->killCursor(_sourceNss, swCursor.getValue().getCursorId());
+    }
+
+    std::vector<BSONObj> sampledIds;
+    for (const auto& doc : swCursor.getValue().getBatch()) {
+        if (auto id = doc["_id"]) {
+            sampledIds.push_back(BSON("_id" << id));
+        }
+    }
+    auto bounds = selectPartitionBounds(std::move(sampledIds), numPartitions);
+    if (bounds.empty()) {
+        return kContinueNormally;
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    for (size_t i = 0; i <= bounds.size(); ++i) {
+        Partition partition;
+        if (i > 0) {
+            partition.min = bounds[i - 1];
+        }
+        if (i < bounds.size()) {
+            partition.max = bounds[i];
+        }
+        _partitions.push_back(std::move(partition));
+    }
+    _stats.partitions = _partitions.size();
+    LOGV2(5904402,
+          "Cloning collection in concurrent _id ranges",
+          "namespace"_attr = _sourceNss,
+          "partitions"_attr = _partitions.size(),
+          "bytesToCopy"_attr = bytesToCopy);
+    return kContinueNormally;
+}
+
+std::vector<BSONObj> CollectionCloner::selectPartitionBounds(std::vector<BSONObj> sampledIds,
+                                                             size_t numPartitions) {
+    const auto& comparator = SimpleBSONObjComparator::kInstance;
+    std::sort(sampledIds.begin(), sampledIds.end(), comparator.makeLessThan());
+    sampledIds.erase(
+        std::unique(sampledIds.begin(), sampledIds.end(), comparator.makeEqualTo()),
+        sampledIds.end());
+
+    std::vector<BSONObj> bounds;
+    for (size_t i = 1; i < numPartitions && !sampledIds.empty(); ++i) {
+        const auto& bound = sampledIds[i * sampledIds.size() / numPartitions];
+        // The first sampled _id would leave the first range without any samples.
+        if (comparator.evaluate(bound == sampledIds.front()) ||
+            (!bounds.empty() && !comparator.evaluate(bounds.back() < bound))) {
+            continue;
+        }
+        bounds.push_back(bound.getOwned());
+    }
+    return bounds;
+}
+
 BaseCloner::AfterStageBehavior CollectionCloner::queryStage() {
-    runQuery();
+    bool partitioned = [&] {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return !_partitions.empty();
+    }();
+    if (partitioned) {
+        runPartitionedQuery();
+    } else {
+        runQuery();
+    }
     waitForDatabaseWorkToComplete();
     // We want to free the _collLoader regardless of whether the commit succeeds.
     std::unique_ptr<CollectionBulkLoader> loader = std::move(_collLoader);
@@ -371,18 +499,118 @@ void CollectionCloner::runQuery() {
     }
 }
 
-void CollectionCloner::handleNextBatch(DBClientCursorBatchIterator& iter) {
+void CollectionCloner::runPartitionedQuery() {
+    // Ranges finished by a previous attempt of this stage are not fetched again.
+    std::vector<size_t> remaining;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        for (size_t i = 0; i < _partitions.size(); ++i) {
+            if (!_partitions[i].done) {
+                remaining.push_back(i);
+            }
+        }
+    }
+    uassertStatusOK(runConcurrently("CollectionClonerPartition",
+                                    remaining.size(),
+                                    remaining.size(),
+                                    [&](size_t i, DBClientConnection* client) {
+                                        return clonePartition(remaining[i], client);
+                                    }));
+}
+
+Status CollectionCloner::clonePartition(size_t index, DBClientConnection* client) {
+    Query query;
+    bool skipResumeDocument = false;
     {
-        stdx::lock_guard<InitialSyncSharedData> lk(*getSharedData());
-        if (!getSharedData()->getStatus(lk).isOK()) {
-            static constexpr char message[] =
-                "Collection cloning cancelled due to initial sync failure";
-            LOGV2(21136, message, "error"_attr = getSharedData()->getStatus(lk));
-            uasserted(ErrorCodes::CallbackCanceled,
-                      str::stream() << message << ": " << getSharedData()->getStatus(lk));
+        stdx::lock_guard<Latch> lk(_mutex);
+        const auto& partition = _partitions[index];
+        query.hint(BSON("_id" << 1));
+        // The lower bound is inclusive, so a resumed range starts with the last document it
+        // queued for insertion, if that document still exists.
+        if (!partition.lastId.isEmpty()) {
+            query.minKey(partition.lastId);
+            skipResumeDocument = true;
+        } else if (!partition.min.isEmpty()) {
+            query.minKey(partition.min);
+        }
+        if (!partition.max.isEmpty()) {
+            query.maxKey(partition.max);
         }
     }
 
+    try {
+        client->query(
+            [&](DBClientCursorBatchIterator& iter) {
+                handleNextPartitionBatch(index, iter, &skipResumeDocument);
+            },
+            _sourceDbAndUuid,
+            query,
+            nullptr /* fieldsToReturn */,
+            QueryOption_NoCursorTimeout | QueryOption_SecondaryOk |
+                (collectionClonerUsesExhaust ? QueryOption_Exhaust : 0),
+            _collectionClonerBatchSize,
+            ReadConcernArgs::kImplicitDefault);
+    } catch (const DBException& e) {
+        return e.toStatus();
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    _partitions[index].done = true;
+    return Status::OK();
+}
+
+void CollectionCloner::handleNextPartitionBatch(size_t index,
+                                                DBClientCursorBatchIterator& iter,
+                                                bool* skipResumeDocument) {
+    uassertInitialSyncNotFailed();
+
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        auto& partition = _partitions[index];
+        _stats.receivedBatches++;
+        while (iter.moreInCurrentBatch()) {
+            auto doc = iter.nextSafe();
+            auto id = BSON("_id" << doc["_id"]);
+            if (std::exchange(*skipResumeDocument, false) &&
+                SimpleBSONObjComparator::kInstance.evaluate(id == partition.lastId)) {
+                continue;
+            }
+            partition.lastId = std::move(id);
+            _documentsToInsert.emplace_back(std::move(doc));
+        }
+    }
+
+    scheduleInsertDocuments();
+
+    pauseAfterHandlingBatchIfRequested();
+}
+
+void CollectionCloner::uassertInitialSyncNotFailed() {
+    stdx::lock_guard<InitialSyncSharedData> lk(*getSharedData());
+    if (!getSharedData()->getStatus(lk).isOK()) {
+        static constexpr char message[] =
+            "Collection cloning cancelled due to initial sync failure";
+        LOGV2(21136, message, "error"_attr = getSharedData()->getStatus(lk));
+        uasserted(ErrorCodes::CallbackCanceled,
+                  str::stream() << message << ": " << getSharedData()->getStatus(lk));
+    }
+}
+
+void CollectionCloner::scheduleInsertDocuments() {
+    auto&& scheduleResult = _scheduleDbWorkFn(
+        [=](const executor::TaskExecutor::CallbackArgs& cbd) { insertDocumentsCallback(cbd); });
+
+    if (!scheduleResult.isOK()) {
+        Status newStatus = scheduleResult.getStatus().withContext(
+            str::stream() << "Error cloning collection '" << _sourceNss.ns() << "'");
+        // We must throw an exception to terminate query.
+        uassertStatusOK(newStatus);
+    }
+}
+
+void CollectionCloner::handleNextBatch(DBClientCursorBatchIterator& iter) {
+    uassertInitialSyncNotFailed();
+
     // If this is 'true', it means that something happened to our remote cursor for a reason other
     // than the collection being dropped, all while we were running a non-resumable (4.2) clone.
     // We must abort initial sync in that case.
@@ -406,21 +634,17 @@ void CollectionCloner::handleNextBatch(DBClientCursorBatchIterator& iter) {
     }
 
     // Schedule the next document batch insertion.
-    auto&& scheduleResult = _scheduleDbWorkFn(
-        [=](const executor::TaskExecutor::CallbackArgs& cbd) { insertDocumentsCallback(cbd); });
-
-    if (!scheduleResult.isOK()) {
-        Status newStatus = scheduleResult.getStatus().withContext(
-            str::stream() << "Error cloning collection '" << _sourceNss.ns() << "'");
-        // We must throw an exception to terminate query.
-        uassertStatusOK(newStatus);
-    }
+    scheduleInsertDocuments();
 
     if (_resumeSupported) {
         // Store the resume token for this batch.
         _resumeToken = iter.getPostBatchResumeToken();
     }
 
+    pauseAfterHandlingBatchIfRequested();
+}
+
+void CollectionCloner::pauseAfterHandlingBatchIfRequested() {
     initialSyncHangCollectionClonerAfterHandlingBatchResponse.executeIf(
         [&](const BSONObj&) {
             while (MONGO_unlikely(
@@ -452,10 +676,15 @@ void CollectionCloner::insertDocumentsCallback(const executor::TaskExecutor::Cal
         // 'receivedBatches'.
         ++_stats.fetchedBatches;
         if (_documentsToInsert.size() == 0) {
-            LOGV2_WARNING(21145,
-                          "insertDocumentsCallback, but no documents to insert for ns:{namespace}",
-                          "insertDocumentsCallback, but no documents to insert",
-                          "namespace"_attr = _sourceNss);
+            // The _id ranges of a partitioned clone share the documents to insert, so an earlier
+            // insertion may have taken the documents this insertion was scheduled for.
+            if (_partitions.empty()) {
+                LOGV2_WARNING(
+                    21145,
+                    "insertDocumentsCallback, but no documents to insert for ns:{namespace}",
+                    "insertDocumentsCallback, but no documents to insert",
+                    "namespace"_attr = _sourceNss);
+            }
             return;
         }
         _documentsToInsert.swap(docs);
@@ -542,6 +771,9 @@ void CollectionCloner::Stats::append(BSONObjBuilder* builder) const {
         }
     }
     builder->appendNumber("receivedBatches", static_cast<long long>(receivedBatches));
+    if (partitions) {
+        builder->appendNumber("partitions", static_cast<long long>(partitions));
+    }
 }
 
 }  // namespace repl
@@ -63,6 +63,7 @@ public:
         long long bytesToCopy{0};
         long long avgObjSize{0};
         long long approxBytesCopied{0};
+        size_t partitions{0};  // Number of _id ranges fetched concurrently, if partitioned.
 
         std::string toString() const;
         BSONObj toBSON() const;
@@ -96,6 +97,14 @@ public:
 
     std::string toString() const;
 
+    /**
+     * Returns up to 'numPartitions' - 1 distinct split points, in _id index order, chosen evenly
+     * from the sampled {_id: ...} documents in 'sampledIds'.  The split points divide the
+     * collection into at most 'numPartitions' _id ranges of roughly equal document counts.
+     */
+    static std::vector<BSONObj> selectPartitionBounds(std::vector<BSONObj> sampledIds,
+                                                      size_t numPartitions);
+
     NamespaceString getSourceNss() const {
         return _sourceNss;
     }
@@ -194,6 +203,14 @@ private:
      */
     AfterStageBehavior createCollectionStage();
 
+    /**
+     * Stage function that splits a large collection into _id ranges to be fetched concurrently,
+     * using split points sampled from the sync source.  Collections that are small, capped,
+     * clustered, or have a non-simple default collation or no _id index are cloned with a single
+     * query.
+     */
+    AfterStageBehavior partitionStage();
+
     /**
      * Stage function that executes a query to retrieve all documents in the collection.  For each
      * batch returned by the upstream node, handleNextBatch will be called with the data.  This
@@ -212,6 +229,31 @@ private:
      */
     void handleNextBatch(DBClientCursorBatchIterator& iter);
 
+    /**
+     * Like handleNextBatch, for a batch of the _id range at 'index' in _partitions.  Skips the
+     * document the range is resuming after, if 'skipResumeDocument' is set, and records the _id
+     * of the last document queued for insertion so that the range can be resumed from there.
+     */
+    void handleNextPartitionBatch(size_t index,
+                                  DBClientCursorBatchIterator& iter,
+                                  bool* skipResumeDocument);
+
+    /**
+     * Blocks while the initialSyncHangCollectionClonerAfterHandlingBatchResponse fail point is
+     * enabled for this collection.
+     */
+    void pauseAfterHandlingBatchIfRequested();
+
+    /**
+     * Throws if initial sync has failed, to stop the query in progress.
+     */
+    void uassertInitialSyncNotFailed();
+
+    /**
+     * Schedules the insertion of the documents in _documentsToInsert.
+     */
+    void scheduleInsertDocuments();
+
     /**
      * Called whenever there is a new batch of documents ready from the DBClientConnection.
      *
@@ -226,6 +268,18 @@ private:
      */
     void runQuery();
 
+    /**
+     * Fetches all unfinished _id ranges in _partitions concurrently, each over its own
+     * connection to the sync source.
+     */
+    void runPartitionedQuery();
+
+    /**
+     * Fetches the _id range at 'index' in _partitions over 'client', resuming after the last
+     * document it queued for insertion, if any.
+     */
+    Status clonePartition(size_t index, DBClientConnection* client);
+
     /**
      * Used to terminate the clone when we encounter a fatal error during a non-resumable query.
      * Throws.
@@ -249,6 +303,7 @@ private:
     CollectionClonerStage _countStage;                                   // (R)
     CollectionClonerStage _listIndexesStage;                             // (R)
     CollectionClonerStage _createCollectionStage;                        // (R)
+    CollectionClonerStage _partitionStage;                               // (R)
     CollectionClonerQueryStage _queryStage;                              // (R)
     CollectionClonerStage _setupIndexBuildersForUnfinishedIndexesStage;  // (R)
 
@@ -278,6 +333,17 @@ private:
     // If true, it means we are starting a new query or resuming an interrupted one.
     bool _firstBatchOfQueryRound = true;  // (X)
 
+    // An _id range of a collection fetched concurrently with the other ranges.
+    struct Partition {
+        BSONObj min;     // Inclusive lower bound, as {_id: ...}; empty for the first range.
+        BSONObj max;     // Exclusive upper bound, as {_id: ...}; empty for the last range.
+        BSONObj lastId;  // {_id: ...} of the last document queued for insertion, if any.
+        bool done = false;
+    };
+
+    // The _id ranges of a partitioned clone; empty if the collection is cloned with one query.
+    std::vector<Partition> _partitions;  // (M)
+
     // Only set during non-resumable (4.2) queries.
     // Signifies that there were changes to the collection on the sync source that resulted in
     // our remote cursor getting killed.
@@ -32,6 +32,7 @@
 #include <vector>
 
 #include "mongo/bson/bsonmisc.h"
+#include "mongo/client/dbclient_mockcursor.h"
 #include "mongo/db/repl/collection_cloner.h"
 #include "mongo/db/repl/initial_sync_cloner_test_fixture.h"
 #include "mongo/db/repl/repl_server_parameters_gen.h"
@@ -39,6 +40,7 @@
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/service_context_test_fixture.h"
 #include "mongo/dbtests/mock/mock_dbclient_connection.h"
+#include "mongo/idl/server_parameter_test_util.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/thread_pool.h"
 
@@ -90,13 +92,62 @@ protected:
         CollectionOptions options = CollectionOptions()) {
         options.uuid = _collUuid;
         _options = options;
-        return std::make_unique<CollectionCloner>(_nss,
-                                                  options,
-                                                  getSharedData(),
-                                                  _source,
-                                                  _mockClient.get(),
-                                                  &_storageInterface,
-                                                  _dbWorkThreadPool.get());
+        auto cloner = std::make_unique<CollectionCloner>(_nss,
+                                                         options,
+                                                         getSharedData(),
+                                                         _source,
+                                                         _mockClient.get(),
+                                                         &_storageInterface,
+                                                         _dbWorkThreadPool.get());
+        // The _id ranges of a partitioned clone are fetched over connections of their own.
+        cloner->setCreateClientFn_forTest([this] {
+            auto client = std::make_unique<MockDBClientConnection>(_mockServer.get());
+            client->setWireVersions(WireVersion::RESUMABLE_INITIAL_SYNC,
+                                    WireVersion::RESUMABLE_INITIAL_SYNC);
+            return std::unique_ptr<DBClientConnection>(std::move(client));
+        });
+        return cloner;
+    }
+
+    // Sets up a collection of 'numDocs' documents, large enough to be split into 'numPartitions'
+    // _id ranges, with all of its _ids returned by the sampling of the partition stage.
+    void setUpPartitionedCollection(int numDocs, int numPartitions) {
+        _maxPartitions.emplace("collectionClonerMaxPartitions", numPartitions);
+        _minPartitionSize.emplace("collectionClonerMinPartitionSizeBytes", 1000LL);
+        setMockServerReplies(BSON("size" << numPartitions * 1000),
+                             createCountResponse(numDocs),
+                             createCursorResponse(_nss.ns(), BSON_ARRAY(_idIndexSpec)));
+        BSONArrayBuilder sampledIds;
+        for (int i = 1; i <= numDocs; ++i) {
+            _mockServer->insert(_nss.ns(), BSON("_id" << i));
+            sampledIds.append(BSON("_id" << i));
+        }
+        _mockServer->setCommandReply("aggregate",
+                                     createCursorResponse(_nss.ns(), sampledIds.arr()));
+    }
+
+    // Makes 'cloner' fetch a single _id range, which resumes after 'lastId'.
+    void setResumingPartition(CollectionCloner* cloner, const BSONObj& lastId) {
+        CollectionCloner::Partition partition;
+        partition.lastId = lastId;
+        cloner->_partitions = {partition};
+    }
+
+    BSONObj getPartitionLastId(CollectionCloner* cloner) {
+        return cloner->_partitions[0].lastId;
+    }
+
+    // Hands 'docs' to the single _id range of 'cloner' as fetched from the sync source, and
+    // returns the documents queued for insertion.
+    std::vector<BSONObj> handlePartitionBatch(CollectionCloner* cloner,
+                                              const BSONArray& docs,
+                                              bool* skipResumeDocument) {
+        DBClientMockCursor cursor(_mockClient.get(), docs);
+        while (cursor.more()) {
+            DBClientCursorBatchIterator iter(cursor);
+            cloner->handleNextPartitionBatch(0, iter, skipResumeDocument);
+        }
+        return std::exchange(cloner->_documentsToInsert, {});
     }
 
     ProgressMeter& getProgressMeter(CollectionCloner* cloner) {
@@ -128,6 +179,9 @@ protected:
     CollectionBulkLoaderMock* _loader = nullptr;  // Owned by CollectionCloner.
     CollectionOptions _options;
 
+    boost::optional<RAIIServerParameterControllerForTest> _maxPartitions;
+    boost::optional<RAIIServerParameterControllerForTest> _minPartitionSize;
+
     NamespaceString _nss = {"testDb", "testColl"};
     UUID _collUuid = UUID::gen();
     BSONObj _idIndexSpec = BSON("v" << 1 << "key" << BSON("_id" << 1) << "name"
@@ -1229,5 +1283,151 @@ TEST_F(CollectionClonerTestNonResumable, NonResumableCursorErrorThenSuccessEqual
     clonerThread.join();
 }
 
+TEST_F(CollectionClonerTestResumable, SmallCollectionIsClonedWithSingleQuery) {
+    auto maxPartitionsDefault = collectionClonerMaxPartitions;
+    collectionClonerMaxPartitions = 4;
+    ON_BLOCK_EXIT([&]() { collectionClonerMaxPartitions = maxPartitionsDefault; });
+
+    // The collection is far smaller than 'collectionClonerMinPartitionSizeBytes'.
+    setMockServerReplies(BSON("size" << 10),
+                         createCountResponse(2),
+                         createCursorResponse(_nss.ns(), BSON_ARRAY(_idIndexSpec)));
+    _mockServer->insert(_nss.ns(), BSON("_id" << 1));
+    _mockServer->insert(_nss.ns(), BSON("_id" << 2));
+
+    auto cloner = makeCollectionCloner();
+    ASSERT_OK(cloner->run());
+
+    ASSERT_EQUALS(2, _collectionStats->insertCount);
+    ASSERT_TRUE(_collectionStats->commitCalled);
+
+    auto stats = cloner->getStats();
+    ASSERT_EQUALS(0u, stats.partitions);
+    ASSERT_FALSE(stats.toBSON().hasField("partitions"));
+}
+
+TEST_F(CollectionClonerTestResumable, LargeCollectionIsClonedInConcurrentIdRanges) {
+    setUpPartitionedCollection(8, 4);
+
+    auto cloner = makeCollectionCloner();
+    ASSERT_OK(cloner->run());
+
+    // Each range only fetches its own documents, so every document is inserted exactly once.
+    ASSERT_EQUALS(8, _collectionStats->insertCount);
+    ASSERT_TRUE(_collectionStats->commitCalled);
+
+    auto stats = cloner->getStats();
+    ASSERT_EQUALS(4u, stats.partitions);
+    ASSERT_EQUALS(8u, stats.documentsCopied);
+    ASSERT_EQUALS(4, stats.toBSON()["partitions"].numberInt());
+}
+
+TEST_F(CollectionClonerTestResumable, FailedIdRangeResumesAfterLastQueuedDocument) {
+    setUpPartitionedCollection(8, 4);
+
+    // Hang every range after its first batch of one document.
+    auto afterBatchFailPoint =
+        globalFailPointRegistry().find("initialSyncHangCollectionClonerAfterHandlingBatchResponse");
+    auto timesEnteredAfterBatch = afterBatchFailPoint->setMode(FailPoint::alwaysOn, 0);
+
+    auto cloner = makeCollectionCloner();
+    cloner->setBatchSize_forTest(1);
+
+    stdx::thread clonerThread([&] {
+        Client::initThread("ClonerRunner");
+        ASSERT_OK(cloner->run());
+    });
+    afterBatchFailPoint->waitForTimesEntered(timesEnteredAfterBatch + 4);
+
+    // Fail the next batch of whichever range asks for it first, which fails the query stage.
+    auto failNextBatch = globalFailPointRegistry().find("mockCursorThrowErrorOnGetMore");
+    failNextBatch->setMode(FailPoint::nTimes, 1, fromjson("{errorType: 'HostUnreachable'}"));
+    afterBatchFailPoint->setMode(FailPoint::off, 0);
+    clonerThread.join();
+
+    // The retried query stage only fetches the failed range again. It resumes with the document
+    // it last queued, which it skips. Refetching that document, or the whole range, would
+    // insert 9 documents.
+    ASSERT_EQUALS(8, _collectionStats->insertCount);
+    ASSERT_TRUE(_collectionStats->commitCalled);
+    auto stats = cloner->getStats();
+    ASSERT_EQUALS(4u, stats.partitions);
+    ASSERT_EQUALS(8u, stats.documentsCopied);
+}
+
+TEST_F(CollectionClonerTestResumable, ResumedIdRangeOnlySkipsItsLastQueuedDocument) {
+    auto cloner = makeCollectionCloner();
+    cloner->setScheduleDbWorkFn_forTest([](const executor::TaskExecutor::CallbackFn& workFn) {
+        return executor::TaskExecutor::CallbackHandle(std::make_shared<MockCallbackState>());
+    });
+
+    // The range resumes with the document it last queued, which was already inserted.
+    setResumingPartition(cloner.get(), BSON("_id" << 2));
+    bool skipResumeDocument = true;
+    auto docs = handlePartitionBatch(
+        cloner.get(), BSON_ARRAY(BSON("_id" << 2) << BSON("_id" << 3)), &skipResumeDocument);
+    ASSERT_EQUALS(1u, docs.size());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 3), docs[0]);
+    ASSERT_FALSE(skipResumeDocument);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 3), getPartitionLastId(cloner.get()));
+
+    // Only the first document of the resumed range may be skipped.
+    docs = handlePartitionBatch(
+        cloner.get(), BSON_ARRAY(BSON("_id" << 3) << BSON("_id" << 4)), &skipResumeDocument);
+    ASSERT_EQUALS(2u, docs.size());
+
+    // The document the range last queued was deleted on the sync source before it resumed.
+    setResumingPartition(cloner.get(), BSON("_id" << 2));
+    skipResumeDocument = true;
+    docs = handlePartitionBatch(cloner.get(), BSON_ARRAY(BSON("_id" << 3)), &skipResumeDocument);
+    ASSERT_EQUALS(1u, docs.size());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 3), docs[0]);
+    ASSERT_FALSE(skipResumeDocument);
+}
+
+TEST(CollectionClonerPartitionBoundsTest, SplitsSampledIdsEvenly) {
+    std::vector<BSONObj> sampledIds;
+    for (int i = 99; i >= 0; --i) {
+        sampledIds.push_back(BSON("_id" << i));
+        // Duplicate samples do not skew the split points.
+        if (i % 2 == 0) {
+            sampledIds.push_back(BSON("_id" << i));
+        }
+    }
+
+    auto bounds = CollectionCloner::selectPartitionBounds(sampledIds, 4);
+    ASSERT_EQUALS(3u, bounds.size());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 25), bounds[0]);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 50), bounds[1]);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 75), bounds[2]);
+}
+
+TEST(CollectionClonerPartitionBoundsTest, OrdersIdsOfDifferentTypesAsTheIdIndex) {
+    // Numbers sort before strings, which sort before ObjectIds, regardless of numeric type.
+    std::vector<BSONObj> sampledIds{BSON("_id" << OID()),
+                                    BSON("_id"
+                                         << "a"),
+                                    BSON("_id" << 2.5),
+                                    BSON("_id" << 1LL)};
+
+    auto bounds = CollectionCloner::selectPartitionBounds(sampledIds, 4);
+    ASSERT_EQUALS(3u, bounds.size());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 2.5), bounds[0]);
+    ASSERT_BSONOBJ_EQ(BSON("_id"
+                           << "a"),
+                      bounds[1]);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << OID()), bounds[2]);
+}
+
+TEST(CollectionClonerPartitionBoundsTest, TooFewSampledIdsYieldFewerRanges) {
+    ASSERT_TRUE(CollectionCloner::selectPartitionBounds({}, 4).empty());
+    ASSERT_TRUE(CollectionCloner::selectPartitionBounds({BSON("_id" << 1)}, 4).empty());
+
+    auto bounds = CollectionCloner::selectPartitionBounds(
+        {BSON("_id" << 1), BSON("_id" << 2), BSON("_id" << 2)}, 8);
+    ASSERT_EQUALS(1u, bounds.size());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 2), bounds[0]);
+}
+
 }  // namespace repl
 }  // namespace mongo
@@ -36,6 +36,7 @@
 #include "mongo/db/repl/database_cloner.h"
 #include "mongo/db/repl/database_cloner_common.h"
 #include "mongo/db/repl/database_cloner_gen.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/assert_util.h"
 
@@ -127,57 +128,89 @@ void DatabaseCloner::postStage() {
             _stats.collectionStats.back().ns = coll.first.ns();
         }
     }
-    for (const auto& coll : _collections) {
-        auto& sourceNss = coll.first;
-        auto& collectionOptions = coll.second;
-        {
-            stdx::lock_guard<Latch> lk(_mutex);
-            _currentCollectionCloner = std::make_unique<CollectionCloner>(sourceNss,
-                                                                          collectionOptions,
-                                                                          getSharedData(),
-                                                                          getSource(),
-                                                                          getClient(),
-                                                                          getStorageInterface(),
-                                                                          getDBPool());
+    const size_t concurrency = initialSyncCollectionClonerConcurrency;
+    if (concurrency > 1 && _collections.size() > 1) {
+        LOGV2_DEBUG(5904400,
+                    1,
+                    "Cloning collections concurrently",
+                    "db"_attr = _dbName,
+                    "collections"_attr = _collections.size(),
+                    "concurrency"_attr = concurrency);
+        auto status = runConcurrently(
+            "DatabaseCloner",
+            _collections.size(),
+            concurrency,
+            [this](size_t index, DBClientConnection* client) {
+                return runCollectionCloner(index, client);
+            });
+        if (!status.isOK()) {
+            // Collection clone failures have already failed the sync; this covers failures to
+            // connect to the sync source.
+            setSyncFailedStatus(status);
+            return;
         }
-        auto collStatus = _currentCollectionCloner->run();
-        if (collStatus.isOK()) {
-            LOGV2_DEBUG(21148,
-                        1,
-                        "collection clone finished: {namespace}",
-                        "Collection clone finished",
-                        "namespace"_attr = sourceNss);
-        } else {
-            LOGV2_ERROR(21149,
-                        "collection clone for '{namespace}' failed due to {error}",
-                        "Collection clone failed",
-                        "namespace"_attr = sourceNss,
-                        "error"_attr = collStatus.toString());
-            setSyncFailedStatus({ErrorCodes::InitialSyncFailure,
-                                 collStatus
-                                     .withContext(str::stream() << "Error cloning collection '"
-                                                                << sourceNss.toString() << "'")
-                                     .toString()});
-        }
-        {
-            stdx::lock_guard<Latch> lk(_mutex);
-            _stats.collectionStats[_stats.clonedCollections] = _currentCollectionCloner->getStats();
-            _currentCollectionCloner = nullptr;
+    } else {
+        for (size_t index = 0; index < _collections.size(); ++index) {
             // Abort the database cloner if the collection clone failed.
-            if (!collStatus.isOK())
+            if (!runCollectionCloner(index, getClient()).isOK())
                 return;
-            _stats.clonedCollections++;
         }
     }
     stdx::lock_guard<Latch> lk(_mutex);
     _stats.end = getSharedData()->getClock()->now();
 }
 
+Status DatabaseCloner::runCollectionCloner(size_t index, DBClientConnection* client) {
+    auto& sourceNss = _collections[index].first;
+    auto& collectionOptions = _collections[index].second;
+    CollectionCloner* collectionCloner;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        auto& cloner = _activeCollectionCloners[index];
+        cloner = std::make_unique<CollectionCloner>(sourceNss,
+                                                    collectionOptions,
+                                                    getSharedData(),
+                                                    getSource(),
+                                                    client,
+                                                    getStorageInterface(),
+                                                    getDBPool());
+        inheritCreateClientFn(cloner.get());
+        collectionCloner = cloner.get();
+    }
+    auto collStatus = collectionCloner->run();
+    if (collStatus.isOK()) {
+        LOGV2_DEBUG(21148,
+                    1,
+                    "collection clone finished: {namespace}",
+                    "Collection clone finished",
+                    "namespace"_attr = sourceNss);
+    } else {
+        LOGV2_ERROR(21149,
+                    "collection clone for '{namespace}' failed due to {error}",
+                    "Collection clone failed",
+                    "namespace"_attr = sourceNss,
+                    "error"_attr = collStatus.toString());
+        collStatus = {ErrorCodes::InitialSyncFailure,
+                      collStatus
+                          .withContext(str::stream() << "Error cloning collection '"
+                                                     << sourceNss.toString() << "'")
+                          .toString()};
+        setSyncFailedStatus(collStatus);
+    }
+    stdx::lock_guard<Latch> lk(_mutex);
+    _stats.collectionStats[index] = collectionCloner->getStats();
+    _activeCollectionCloners.erase(index);
+    if (collStatus.isOK()) {
+        _stats.clonedCollections++;
+    }
+    return collStatus;
+}
+
 DatabaseCloner::Stats DatabaseCloner::getStats() const {
     stdx::lock_guard<Latch> lk(_mutex);
     DatabaseCloner::Stats stats = _stats;
-    if (_currentCollectionCloner) {
-        stats.collectionStats[_stats.clonedCollections] = _currentCollectionCloner->getStats();
+    for (const auto& [index, cloner] : _activeCollectionCloners) {
+        stats.collectionStats[index] = cloner->getStats();
     }
     return stats;
 }
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <map>
 #include <vector>
 
 #include "mongo/db/repl/base_cloner.h"
@@ -88,11 +89,18 @@ private:
     void preStage() final;
 
     /**
-     * The postStage creates and runs the individual CollectionCloners on each database found on
-     * the sync source, and sets the end time in _stats when done.
+     * The postStage creates and runs the individual CollectionCloners on each collection found in
+     * the database on the sync source, and sets the end time in _stats when done.  Up to
+     * 'initialSyncCollectionClonerConcurrency' collections are cloned at the same time.
      */
     void postStage() final;
 
+    /**
+     * Creates and runs the CollectionCloner for the collection at 'index' in _collections,
+     * fetching over 'client', and records its stats.  Fails the sync if the clone fails.
+     */
+    Status runCollectionCloner(size_t index, DBClientConnection* client);
+
     std::string describeForFuzzer(BaseClonerStage* stage) const final {
         return _dbName + " db: { " + stage->getName() + ": 1 } ";
     }
@@ -109,8 +117,10 @@ private:
     const std::string _dbName;                                                // (R)
     ClonerStage<DatabaseCloner> _listCollectionsStage;                        // (R)
     std::vector<std::pair<NamespaceString, CollectionOptions>> _collections;  // (X)
-    std::unique_ptr<CollectionCloner> _currentCollectionCloner;               // (MX)
-    Stats _stats;                                                             // (MX)
+    Stats _stats;                                                             // (M)
+
+    // Collection cloners currently running, keyed by their index in _collections.
+    std::map<size_t, std::unique_ptr<CollectionCloner>> _activeCollectionCloners;  // (M)
 };
 
 }  // namespace repl
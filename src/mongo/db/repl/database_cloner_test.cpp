@@ -32,6 +32,7 @@
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/repl/database_cloner.h"
 #include "mongo/db/repl/initial_sync_cloner_test_fixture.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/service_context_test_fixture.h"
@@ -39,6 +40,7 @@
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
 #include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace repl {
@@ -61,6 +63,8 @@ protected:
                    const BSONObj& idIndexSpec,
                    const std::vector<BSONObj>& secondaryIndexSpecs)
             -> StatusWith<std::unique_ptr<CollectionBulkLoaderMock>> {
+            // Collections may be cloned concurrently.
+            stdx::lock_guard<Latch> lk(_collectionsMutex);
             const auto collInfo = &_collections[nss];
 
             auto localLoader = std::make_unique<CollectionBulkLoaderMock>(collInfo->stats);
@@ -74,12 +78,21 @@ protected:
         setInitialSyncId();
     }
     std::unique_ptr<DatabaseCloner> makeDatabaseCloner() {
-        return std::make_unique<DatabaseCloner>(_dbName,
-                                                getSharedData(),
-                                                _source,
-                                                _mockClient.get(),
-                                                &_storageInterface,
-                                                _dbWorkThreadPool.get());
+        auto cloner = std::make_unique<DatabaseCloner>(_dbName,
+                                                       getSharedData(),
+                                                       _source,
+                                                       _mockClient.get(),
+                                                       &_storageInterface,
+                                                       _dbWorkThreadPool.get());
+        // Collections cloned concurrently are fetched over connections of their own.
+        cloner->setCreateClientFn_forTest([this] {
+            _clientsCreated.fetchAndAdd(1);
+            auto client = std::make_unique<MockDBClientConnection>(_mockServer.get());
+            client->setWireVersions(WireVersion::RESUMABLE_INITIAL_SYNC,
+                                    WireVersion::RESUMABLE_INITIAL_SYNC);
+            return std::unique_ptr<DBClientConnection>(std::move(client));
+        });
+        return cloner;
     }
 
     BSONObj createListCollectionsResponse(const std::vector<BSONObj>& collections) {
@@ -105,7 +118,9 @@ protected:
         return cloner->_collections;
     }
 
+    Mutex _collectionsMutex = MONGO_MAKE_LATCH("DatabaseClonerTest::_collectionsMutex");
     std::map<NamespaceString, CollectionCloneInfo> _collections;
+    AtomicWord<int> _clientsCreated{0};
 
     static std::string _dbName;
 };
@@ -503,5 +518,56 @@ TEST_F(DatabaseClonerTest, DatabaseAndCollectionStats) {
     ASSERT_EQ(_clock.now(), stats.collectionStats[1].end);
 }
 
+TEST_F(DatabaseClonerTest, CollectionsAreClonedConcurrently) {
+    auto concurrencyDefault = initialSyncCollectionClonerConcurrency;
+    initialSyncCollectionClonerConcurrency = 2;
+    ON_BLOCK_EXIT([&]() { initialSyncCollectionClonerConcurrency = concurrencyDefault; });
+
+    const BSONObj idIndexSpec = BSON("v" << 1 << "key" << BSON("_id" << 1) << "name"
+                                         << "_id_");
+    std::vector<BSONObj> sourceInfos;
+    for (auto name : {"a", "b"}) {
+        sourceInfos.push_back(BSON("name" << name << "type"
+                                          << "collection"
+                                          << "options" << BSONObj() << "info"
+                                          << BSON("readOnly" << false << "uuid" << UUID::gen())));
+    }
+    _mockServer->setCommandReply("listCollections", createListCollectionsResponse(sourceInfos));
+    _mockServer->setCommandReply("collStats", BSON("size" << 0));
+    _mockServer->setCommandReply("count", createCountResponse(0));
+    _mockServer->setCommandReply("listIndexes",
+                                 createCursorResponse(_dbName + ".a", BSON_ARRAY(idIndexSpec)));
+    auto cloner = makeDatabaseCloner();
+
+    // Both collection cloners reach their count stage while the other one is still running.
+    auto collClonerBeforeFailPoint = globalFailPointRegistry().find("hangBeforeClonerStage");
+    auto timesEntered = collClonerBeforeFailPoint->setMode(
+        FailPoint::alwaysOn, 0, fromjson("{cloner: 'CollectionCloner', stage: 'count'}"));
+
+    stdx::thread clonerThread([&] {
+        Client::initThread("ClonerRunner");
+        ASSERT_OK(cloner->run());
+    });
+    collClonerBeforeFailPoint->waitForTimesEntered(timesEntered + 2);
+
+    auto stats = cloner->getStats();
+    ASSERT_EQ(2, stats.collections);
+    ASSERT_EQ(0, stats.clonedCollections);
+    ASSERT_EQ(2, _clientsCreated.load());
+
+    collClonerBeforeFailPoint->setMode(FailPoint::off, 0);
+    clonerThread.join();
+    ASSERT_OK(getSharedData()->getStatus(WithLock::withoutLock()));
+
+    stats = cloner->getStats();
+    ASSERT_EQ(2, stats.clonedCollections);
+    ASSERT_EQ(_dbName + ".a", stats.collectionStats[0].ns);
+    ASSERT_EQ(_dbName + ".b", stats.collectionStats[1].ns);
+    ASSERT_EQ(2U, _collections.size());
+    for (auto name : {"a", "b"}) {
+        ASSERT(_collections[NamespaceString{_dbName, name}].stats->commitCalled);
+    }
+}
+
 }  // namespace repl
 }  // namespace mongo
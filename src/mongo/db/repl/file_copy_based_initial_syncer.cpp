@@ -0,0 +1,810 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kReplicationInitialSync
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/file_copy_based_initial_syncer.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <limits>
+
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/client.h"
+#include "mongo/db/ftdc/constants.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/cursor_response.h"
+#include "mongo/bson/json.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
+#include "mongo/db/repl/replication_auth.h"
+#include "mongo/db/repl/replication_consistency_markers.h"
+#include "mongo/db/repl/sync_source_selector.h"
+#include "mongo/db/server_options.h"
+#include "mongo/db/storage/recovery_unit.h"
+#include "mongo/db/storage/storage_engine_lock_file.h"
+#include "mongo/db/storage/storage_file_util.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/logv2/log.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/util/exit.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace repl {
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+constexpr StringData kMethodName = "fileCopyBased"_sd;
+
+// The completion marker is renamed to this in the dbpath while the staged files are moved into
+// place, so that the move can be resumed if the server stops before it is done. It is kept until
+// the oplog truncate-after point it records has been set.
+constexpr StringData kMoveInProgressMarkerFileName = "FILE_COPY_MOVE_IN_PROGRESS"_sd;
+
+// Backup cursors time out like any other cursor, so the syncer issues a getMore at least this
+// often while it copies files.
+const Milliseconds kBackupCursorKeepAliveInterval = Minutes(1);
+
+// The error returned by a sync source that does not know the $backupCursor stage.
+const int kUnrecognizedPipelineStageErrorCode = 40324;
+
+/**
+ * Returns true if 'path' is the log file of the server, or a directory the log file is in.
+ */
+bool holdsLogFile(const fs::path& path) {
+    const fs::path logpath(serverGlobalParams.logpath);
+    if (logpath.empty() || !fs::exists(logpath)) {
+        return false;
+    }
+    for (auto dir = fs::canonical(logpath); !dir.empty(); dir = dir.parent_path()) {
+        if (fs::equivalent(dir, path)) {
+            return true;
+        }
+        if (dir == dir.root_path()) {
+            break;
+        }
+    }
+    return false;
+}
+
+/**
+ * Removes 'path', and everything under it if it is a directory, except for the log file of the
+ * server, which may have been configured to be written into the dbpath.
+ */
+void removeAllButLogFile(const fs::path& path) {
+    if (!holdsLogFile(path)) {
+        fs::remove_all(path);
+        return;
+    }
+    if (fs::is_directory(path)) {
+        for (fs::directory_iterator it(path), end; it != end; ++it) {
+            removeAllButLogFile(it->path());
+        }
+    }
+}
+
+/**
+ * Moves the staged file or directory 'source' to 'target', replacing whatever is there but the log
+ * file of the server. A directory holding the log file receives the contents of 'source' instead.
+ */
+void moveIntoPlace(const fs::path& source, const fs::path& target) {
+    if (!fs::exists(target) || !holdsLogFile(target)) {
+        fs::remove_all(target);
+        fs::rename(source, target);
+        return;
+    }
+    if (fs::is_directory(target) && fs::is_directory(source)) {
+        for (fs::directory_iterator it(source), end; it != end; ++it) {
+            moveIntoPlace(it->path(), target / it->path().filename());
+        }
+        return;
+    }
+    LOGV2_WARNING(5904524,
+                  "Not moving a file copied by file copy based initial sync over the log file",
+                  "file"_attr = source.string(),
+                  "logpath"_attr = serverGlobalParams.logpath);
+}
+
+bool getStorageOption(const BSONObj& parsedOpts, StringData path) {
+    return parsedOpts.getFieldDotted(path).trueValue();
+}
+
+}  // namespace
+
+constexpr StringData FileCopyBasedInitialSyncer::kStagingDirName;
+constexpr StringData FileCopyBasedInitialSyncer::kCompletionMarkerFileName;
+
+FileCopyBasedInitialSyncer::FileCopyBasedInitialSyncer(
+    InitialSyncerOptions opts, CreateLogicalInitialSyncerFn createLogicalInitialSyncer)
+    : _opts(std::move(opts)),
+      _createLogicalInitialSyncer(std::move(createLogicalInitialSyncer)),
+      _stagingDir(fs::path(storageGlobalParams.dbpath) / kStagingDirName.toString()),
+      _createClientFn(
+          [] { return std::make_unique<DBClientConnection>(true /* autoReconnect */); }),
+      _requestShutdownFn([] {
+          // Shutting down joins this syncer's thread, so it cannot run on that thread.
+          stdx::thread([] { exitCleanly(EXIT_CLEAN); }).detach();
+      }) {
+    invariant(_opts.syncSourceSelector);
+    invariant(_createLogicalInitialSyncer);
+}
+
+FileCopyBasedInitialSyncer::~FileCopyBasedInitialSyncer() {
+    shutdown().ignore();
+    join();
+}
+
+Status FileCopyBasedInitialSyncer::startup(OperationContext* opCtx,
+                                           std::uint32_t maxAttempts) noexcept {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_inShutdown) {
+        return Status(ErrorCodes::ShutdownInProgress, "initial syncer shut down");
+    }
+    if (_active || _thread.joinable()) {
+        return Status(ErrorCodes::IllegalOperation, "initial syncer already started");
+    }
+    _active = true;
+    _stats.maxAttempts = maxAttempts;
+    _stats.start = Date_t::now();
+    _thread = stdx::thread([this, maxAttempts] { _run(maxAttempts); });
+    return Status::OK();
+}
+
+Status FileCopyBasedInitialSyncer::shutdown() {
+    std::shared_ptr<InitialSyncerInterface> logicalInitialSyncer;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _inShutdown = true;
+        if (_client) {
+            _client->shutdownAndDisallowReconnect();
+        }
+        _cond.notify_all();
+        logicalInitialSyncer = _logicalInitialSyncer;
+    }
+    if (logicalInitialSyncer) {
+        return logicalInitialSyncer->shutdown();
+    }
+    return Status::OK();
+}
+
+void FileCopyBasedInitialSyncer::join() {
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    std::shared_ptr<InitialSyncerInterface> logicalInitialSyncer;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        logicalInitialSyncer = _logicalInitialSyncer;
+    }
+    if (logicalInitialSyncer) {
+        logicalInitialSyncer->join();
+    }
+}
+
+BSONObj FileCopyBasedInitialSyncer::getInitialSyncProgress() const {
+    std::shared_ptr<InitialSyncerInterface> logicalInitialSyncer;
+    BSONObjBuilder bob;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        logicalInitialSyncer = _logicalInitialSyncer;
+        if (!logicalInitialSyncer) {
+            if (!_active) {
+                return BSONObj();
+            }
+            bob.append("method", kMethodName);
+            bob.append("failedInitialSyncAttempts",
+                       static_cast<int>(_stats.attempt > 0 ? _stats.attempt - 1 : 0));
+            bob.append("maxFailedInitialSyncAttempts", static_cast<int>(_stats.maxAttempts));
+            bob.appendDate("initialSyncStart", _stats.start);
+            if (!_stats.syncSource.empty()) {
+                bob.append("syncSource", _stats.syncSource.toString());
+            }
+            if (_stats.backupId) {
+                _stats.backupId->appendToBuilder(&bob, "backupId");
+                bob.append("checkpointTimestamp", _stats.checkpointTimestamp);
+                bob.append("lastExtendTimestamp", _stats.lastExtendTimestamp);
+                bob.append("backupCursorExtensions", static_cast<int>(_stats.extensions));
+            }
+            bob.append("totalFiles", static_cast<long long>(_stats.totalFiles));
+            bob.append("copiedFiles", static_cast<long long>(_stats.copiedFiles));
+            bob.append("totalBytes", _stats.totalBytes);
+            bob.append("copiedBytes", _stats.copiedBytes);
+        }
+    }
+    if (logicalInitialSyncer) {
+        return logicalInitialSyncer->getInitialSyncProgress();
+    }
+    return bob.obj();
+}
+
+void FileCopyBasedInitialSyncer::cancelCurrentAttempt() {
+    std::shared_ptr<InitialSyncerInterface> logicalInitialSyncer;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        logicalInitialSyncer = _logicalInitialSyncer;
+        if (!logicalInitialSyncer && _active) {
+            LOGV2_DEBUG(5904501, 1, "Cancelling the current file copy based initial sync attempt");
+            _attemptCanceled = true;
+            if (_client) {
+                _client->shutdownAndDisallowReconnect();
+            }
+            _cond.notify_all();
+        }
+    }
+    if (logicalInitialSyncer) {
+        logicalInitialSyncer->cancelCurrentAttempt();
+    }
+}
+
+std::string FileCopyBasedInitialSyncer::getInitialSyncMethod() const {
+    return kMethodName.toString();
+}
+
+void FileCopyBasedInitialSyncer::setCreateClientFn_forTest(const CreateClientFn& createClientFn) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _createClientFn = createClientFn;
+}
+
+void FileCopyBasedInitialSyncer::setRequestShutdownFn_forTest(
+    const RequestShutdownFn& requestShutdownFn) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _requestShutdownFn = requestShutdownFn;
+}
+
+void FileCopyBasedInitialSyncer::_run(std::uint32_t maxAttempts) {
+    Client::initThread("FileCopyBasedInitialSyncer");
+    AuthorizationSession::get(cc())->grantInternalAuthorization(&cc());
+
+    Status status(ErrorCodes::InitialSyncFailure, "no file copy based initial sync attempt made");
+    for (std::uint32_t attempt = 1; attempt <= maxAttempts; ++attempt) {
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            if (_inShutdown) {
+                break;
+            }
+            _attemptCanceled = false;
+            _stats.attempt = attempt;
+        }
+
+        LOGV2(5904502,
+              "Starting file copy based initial sync attempt",
+              "attempt"_attr = attempt,
+              "maxAttempts"_attr = maxAttempts);
+        try {
+            _runAttempt();
+            status = Status::OK();
+        } catch (const DBException& ex) {
+            status = ex.toStatus();
+        } catch (const fs::filesystem_error& ex) {
+            status = Status(ErrorCodes::FileStreamFailed, ex.what());
+        }
+        if (status.isOK()) {
+            // The storage engine cannot be swapped out under a running server, the copied files
+            // are moved into place at the next startup.
+            LOGV2(5904503,
+                  "File copy based initial sync copied all files of the sync source, shutting "
+                  "down. Restart the server to complete initial sync",
+                  "stagingDir"_attr = _stagingDir.string());
+            std::function<void()> requestShutdown;
+            {
+                stdx::lock_guard<Latch> lk(_mutex);
+                _active = false;
+                requestShutdown = _requestShutdownFn;
+            }
+            requestShutdown();
+            return;
+        }
+        if (status == ErrorCodes::IncompatibleServerVersion) {
+            LOGV2(5904504, "Falling back to logical initial sync", "reason"_attr = status);
+            _fallBackToLogicalInitialSync(maxAttempts);
+            return;
+        }
+
+        stdx::unique_lock<Latch> lk(_mutex);
+        if (_inShutdown) {
+            break;
+        }
+        LOGV2_ERROR(5904505,
+                    "File copy based initial sync attempt failed",
+                    "attempt"_attr = attempt,
+                    "maxAttempts"_attr = maxAttempts,
+                    "error"_attr = status);
+        _cond.wait_for(lk, _opts.initialSyncRetryWait.toSystemDuration(), [&] {
+            return _inShutdown;
+        });
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    _active = false;
+    if (_inShutdown) {
+        LOGV2(5904506, "File copy based initial sync stopped because of shutdown");
+        return;
+    }
+    LOGV2_ERROR(5904507,
+                "File copy based initial sync failed, shutting down now. Restart the server to "
+                "attempt a new initial sync");
+    fassertFailedWithStatusNoTrace(5904508, status);
+}
+
+void FileCopyBasedInitialSyncer::_runAttempt() {
+    const auto syncSource = _chooseSyncSource();
+    std::unique_ptr<DBClientConnection> client;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        client = _createClientFn();
+    }
+    uassertStatusOK(client->connect(syncSource, StringData(), boost::none));
+    uassertStatusOK(replAuthenticate(client.get())
+                        .withContext(str::stream() << "Failed to authenticate to " << syncSource));
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _client = client.get();
+        Stats stats;
+        stats.attempt = _stats.attempt;
+        stats.maxAttempts = _stats.maxAttempts;
+        stats.start = _stats.start;
+        stats.syncSource = syncSource;
+        _stats = std::move(stats);
+    }
+    ON_BLOCK_EXIT([&] {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _client = nullptr;
+    });
+    _checkInterrupted();
+
+    uassertStatusOK(_checkStorageCompatibility(client.get()));
+
+    // Discard whatever an earlier attempt left behind.
+    fs::remove_all(_stagingDir);
+    fs::create_directories(_stagingDir);
+
+    BSONObj metadata;
+    std::vector<BackupFile> files;
+    CursorId backupCursorId = 0;
+    try {
+        backupCursorId = _aggregate(
+            client.get(), BSON_ARRAY(BSON("$backupCursor" << BSONObj())), [&](const BSONObj& doc) {
+                if (doc.hasField("metadata")) {
+                    metadata = doc["metadata"].Obj().getOwned();
+                } else {
+                    files.push_back({doc["filename"].str(), doc["fileSize"].safeNumberLong()});
+                }
+            });
+    } catch (const DBException& ex) {
+        if (ex.code() != kUnrecognizedPipelineStageErrorCode &&
+            ex.code() != ErrorCodes::CommandNotSupported) {
+            throw;
+        }
+        uasserted(ErrorCodes::IncompatibleServerVersion,
+                  str::stream() << "Sync source " << syncSource
+                                << " cannot open a backup cursor: " << ex.toStatus());
+    }
+
+    auto killBackupCursor = makeGuard([&] {
+        try {
+            BSONObj reply;
+            client->runCommand("admin",
+                               BSON("killCursors"
+                                    << "$cmd.aggregate"
+                                    << "cursors" << BSON_ARRAY(backupCursorId)),
+                               reply);
+        } catch (const DBException& ex) {
+            LOGV2_DEBUG(5904509, 1, "Failed to kill backup cursor", "error"_attr = ex);
+        }
+    });
+
+    uassert(5904510, "Backup cursor did not return its metadata", !metadata.isEmpty());
+    const auto backupId = uassertStatusOK(UUID::parse(metadata["backupId"]));
+    const auto remoteDbpath = metadata["dbpath"].str();
+    const auto checkpointTimestamp = metadata["checkpointTimestamp"].timestamp();
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _stats.backupId = backupId;
+        _stats.checkpointTimestamp = checkpointTimestamp;
+        _stats.lastExtendTimestamp = checkpointTimestamp;
+        _stats.totalFiles = files.size();
+        for (auto&& file : files) {
+            _stats.totalBytes += file.size;
+        }
+    }
+    LOGV2(5904511,
+          "Opened backup cursor on sync source",
+          "syncSource"_attr = syncSource,
+          "backupId"_attr = backupId,
+          "checkpointTimestamp"_attr = checkpointTimestamp,
+          "files"_attr = files.size());
+
+    _lastBackupCursorKeepAlive = Date_t::now();
+    for (auto&& file : files) {
+        _checkInterrupted();
+        _copyFile(client.get(), backupId, remoteDbpath, file);
+        _keepBackupCursorAlive(client.get(), backupCursorId);
+    }
+
+    // Writes keep coming in on the sync source while the files are copied. Extend the backup with
+    // the journal written since, so that fewer oplog entries remain to be fetched after restart.
+    auto lastExtendTimestamp = checkpointTimestamp;
+    auto lastLagSecs = std::numeric_limits<long long>::max();
+    int cyclesWithoutProgress = 0;
+    while (true) {
+        _checkInterrupted();
+        const auto sourceTimestamp = _getSourceLastAppliedTimestamp(client.get());
+        const long long lagSecs =
+            static_cast<long long>(sourceTimestamp.getSecs()) - lastExtendTimestamp.getSecs();
+        if (lagSecs <= fileCopyBasedInitialSyncMaxLagSecs.load()) {
+            break;
+        }
+        cyclesWithoutProgress = lagSecs < lastLagSecs ? 0 : cyclesWithoutProgress + 1;
+        if (cyclesWithoutProgress >= fileCopyBasedInitialSyncMaxCyclesWithoutProgress.load()) {
+            LOGV2(5904512,
+                  "Not extending the backup cursor further as the lag behind the sync source is "
+                  "not decreasing",
+                  "lagSecs"_attr = lagSecs);
+            break;
+        }
+        lastLagSecs = lagSecs;
+
+        std::vector<BackupFile> extendedFiles;
+        BSONObjBuilder extendSpec;
+        backupId.appendToBuilder(&extendSpec, "backupId");
+        extendSpec.append("timestamp", sourceTimestamp);
+        _aggregate(client.get(),
+                   BSON_ARRAY(BSON("$backupCursorExtend" << extendSpec.obj())),
+                   [&](const BSONObj& doc) {
+                       extendedFiles.push_back({doc["filename"].str(), 0});
+                   });
+        for (auto&& file : extendedFiles) {
+            _checkInterrupted();
+            _copyFile(client.get(), backupId, remoteDbpath, file);
+            _keepBackupCursorAlive(client.get(), backupCursorId);
+        }
+
+        lastExtendTimestamp = sourceTimestamp;
+        stdx::lock_guard<Latch> lk(_mutex);
+        _stats.lastExtendTimestamp = lastExtendTimestamp;
+        ++_stats.extensions;
+    }
+
+    // The journal copied with the last extension may hold oplog entries past the extend timestamp,
+    // with holes among them. Recovery truncates the oplog after this point.
+    BSONObjBuilder markerBuilder;
+    backupId.appendToBuilder(&markerBuilder, "backupId");
+    markerBuilder.append("oplogTruncateAfterPoint", lastExtendTimestamp);
+
+    const auto marker = _stagingDir / kCompletionMarkerFileName.toString();
+    {
+        std::ofstream out(marker.string(), std::ios::trunc);
+        out << markerBuilder.obj().jsonString() << std::endl;
+        uassert(ErrorCodes::FileStreamFailed,
+                str::stream() << "Failed to write " << marker.string(),
+                out.good());
+    }
+    uassertStatusOK(fsyncFile(marker));
+    uassertStatusOK(fsyncParentDirectory(marker));
+}
+
+void FileCopyBasedInitialSyncer::_fallBackToLogicalInitialSync(std::uint32_t maxAttempts) {
+    std::shared_ptr<InitialSyncerInterface> logicalInitialSyncer;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _active = false;
+        if (_inShutdown) {
+            return;
+        }
+        _logicalInitialSyncer = _createLogicalInitialSyncer();
+        logicalInitialSyncer = _logicalInitialSyncer;
+    }
+    fs::remove_all(_stagingDir);
+
+    auto opCtx = cc().makeOperationContext();
+    auto status = logicalInitialSyncer->startup(opCtx.get(), maxAttempts);
+    if (!status.isOK()) {
+        LOGV2(5904513, "Logical initial sync failed to start", "error"_attr = status);
+        if (ErrorCodes::CallbackCanceled == status ||
+            ErrorCodes::isShutdownError(status.code())) {
+            return;
+        }
+        fassertFailedWithStatusNoTrace(5904514, status);
+    }
+}
+
+HostAndPort FileCopyBasedInitialSyncer::_chooseSyncSource() {
+    for (int attempt = 1;; ++attempt) {
+        _checkInterrupted();
+        auto syncSource = _opts.syncSourceSelector->chooseNewSyncSource(OpTime());
+        if (!syncSource.empty()) {
+            return syncSource;
+        }
+        uassert(ErrorCodes::InitialSyncOplogSourceMissing,
+                "No valid sync source available for file copy based initial sync",
+                attempt < numInitialSyncConnectAttempts.load());
+        LOGV2(5904515,
+              "No valid sync source available, retrying",
+              "syncSourceRetryWait"_attr = _opts.syncSourceRetryWait,
+              "attempt"_attr = attempt);
+        stdx::unique_lock<Latch> lk(_mutex);
+        _cond.wait_for(lk, _opts.syncSourceRetryWait.toSystemDuration(), [&] {
+            return _inShutdown || _attemptCanceled;
+        });
+    }
+}
+
+Status FileCopyBasedInitialSyncer::_checkStorageCompatibility(DBClientConnection* client) {
+    if (storageGlobalParams.engine != "wiredTiger") {
+        return Status(ErrorCodes::IncompatibleServerVersion,
+                      str::stream() << "File copy based initial sync requires the wiredTiger "
+                                       "storage engine, this node uses "
+                                    << storageGlobalParams.engine);
+    }
+
+    BSONObj reply;
+    client->runCommand("admin", BSON("getCmdLineOpts" << 1), reply);
+    uassertStatusOK(getStatusFromCommandResult(reply));
+    const auto remoteOpts = reply["parsed"].Obj();
+    const auto& localOpts = serverGlobalParams.parsedOpts;
+
+    const auto remoteEngine = remoteOpts.getFieldDotted("storage.engine");
+    if (!remoteEngine.eoo() && remoteEngine.str() != "wiredTiger") {
+        return Status(ErrorCodes::IncompatibleServerVersion,
+                      str::stream() << "File copy based initial sync requires the wiredTiger "
+                                       "storage engine, the sync source uses "
+                                    << remoteEngine.str());
+    }
+
+    // The files are copied to the same path relative to the dbpath as on the sync source.
+    for (auto&& option :
+         {"storage.directoryPerDB"_sd, "storage.wiredTiger.engineConfig.directoryForIndexes"_sd}) {
+        if (getStorageOption(remoteOpts, option) != getStorageOption(localOpts, option)) {
+            return Status(ErrorCodes::IncompatibleServerVersion,
+                          str::stream() << "File copy based initial sync requires '" << option
+                                        << "' to be the same on this node and the sync source");
+        }
+    }
+    return Status::OK();
+}
+
+CursorId FileCopyBasedInitialSyncer::_aggregate(
+    DBClientConnection* client,
+    const BSONArray& pipeline,
+    const std::function<void(const BSONObj&)>& onDocument) {
+    BSONObj reply;
+    client->runCommand(
+        "admin", BSON("aggregate" << 1 << "pipeline" << pipeline << "cursor" << BSONObj()), reply);
+    uassertStatusOK(getStatusFromCommandResult(reply));
+    auto response = uassertStatusOK(CursorResponse::parseFromBSON(reply));
+    while (true) {
+        for (auto&& doc : response.getBatch()) {
+            onDocument(doc);
+        }
+        if (response.getCursorId() == 0 || response.getBatch().empty()) {
+            return response.getCursorId();
+        }
+        _checkInterrupted();
+        client->runCommand("admin",
+                           BSON("getMore" << response.getCursorId() << "collection"
+                                          << "$cmd.aggregate"),
+                           reply);
+        uassertStatusOK(getStatusFromCommandResult(reply));
+        response = uassertStatusOK(CursorResponse::parseFromBSON(reply));
+    }
+}
+
+void FileCopyBasedInitialSyncer::_copyFile(DBClientConnection* client,
+                                           const UUID& backupId,
+                                           const std::string& remoteDbpath,
+                                           const BackupFile& file) {
+    const auto localPath = _stagingDir / getRelativePath(remoteDbpath, file.path);
+    fs::create_directories(localPath.parent_path());
+
+    std::ofstream out(localPath.string(), std::ios::binary | std::ios::trunc);
+    uassert(ErrorCodes::FileOpenFailed,
+            str::stream() << "Failed to open " << localPath.string(),
+            out.is_open());
+
+    BSONObjBuilder spec;
+    backupId.appendToBuilder(&spec, "backupId");
+    spec.append("file", file.path);
+    long long bytesCopied = 0;
+    _aggregate(client, BSON_ARRAY(BSON("$_backupFile" << spec.obj())), [&](const BSONObj& doc) {
+        uassert(5904516,
+                str::stream() << "Unexpected byte offset while copying " << file.path << ": "
+                              << doc,
+                doc["byteOffset"].safeNumberLong() == bytesCopied);
+        int length = 0;
+        const char* data = doc["data"].binData(length);
+        out.write(data, length);
+        uassert(ErrorCodes::FileStreamFailed,
+                str::stream() << "Failed to write " << localPath.string(),
+                out.good());
+        bytesCopied += length;
+
+        stdx::lock_guard<Latch> lk(_mutex);
+        _stats.copiedBytes += length;
+    });
+    out.close();
+    uassert(ErrorCodes::FileStreamFailed,
+            str::stream() << "Failed to write " << localPath.string(),
+            !out.fail());
+    uassertStatusOK(fsyncFile(localPath));
+    uassertStatusOK(fsyncParentDirectory(localPath));
+
+    LOGV2_DEBUG(5904517,
+                1,
+                "Copied file from sync source",
+                "file"_attr = file.path,
+                "bytes"_attr = bytesCopied);
+    stdx::lock_guard<Latch> lk(_mutex);
+    ++_stats.copiedFiles;
+}
+
+void FileCopyBasedInitialSyncer::_keepBackupCursorAlive(DBClientConnection* client,
+                                                        CursorId backupCursorId) {
+    if (backupCursorId == 0 ||
+        Date_t::now() - _lastBackupCursorKeepAlive < kBackupCursorKeepAliveInterval) {
+        return;
+    }
+    BSONObj reply;
+    client->runCommand("admin",
+                       BSON("getMore" << backupCursorId << "collection"
+                                      << "$cmd.aggregate"),
+                       reply);
+    uassertStatusOK(getStatusFromCommandResult(reply));
+    _lastBackupCursorKeepAlive = Date_t::now();
+}
+
+Timestamp FileCopyBasedInitialSyncer::_getSourceLastAppliedTimestamp(DBClientConnection* client) {
+    BSONObj reply;
+    client->runCommand("admin", BSON("hello" << 1), reply);
+    uassertStatusOK(getStatusFromCommandResult(reply));
+    const auto lastWriteTimestamp = reply.getFieldDotted("lastWrite.opTime.ts");
+    uassert(5904518,
+            str::stream() << "Sync source did not report its last write: " << reply,
+            lastWriteTimestamp.type() == BSONType::bsonTimestamp);
+    return lastWriteTimestamp.timestamp();
+}
+
+void FileCopyBasedInitialSyncer::_checkInterrupted() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    uassert(ErrorCodes::ShutdownInProgress, "initial syncer shutting down", !_inShutdown);
+    uassert(ErrorCodes::CallbackCanceled, "initial sync attempt cancelled", !_attemptCanceled);
+}
+
+fs::path FileCopyBasedInitialSyncer::getRelativePath(const std::string& remoteDbpath,
+                                                     const std::string& remoteFilePath) {
+    // A trailing separator would make the dbpath end in a "." element.
+    auto dbpath = remoteDbpath;
+    while (dbpath.size() > 1 && (dbpath.back() == '/' || dbpath.back() == '\\')) {
+        dbpath.pop_back();
+    }
+    const auto relativePath = fs::path(remoteFilePath).lexically_relative(dbpath);
+    uassert(5904519,
+            str::stream() << "File " << remoteFilePath << " is not in the dbpath " << remoteDbpath
+                          << " of the sync source",
+            !relativePath.empty() && *relativePath.begin() != ".." &&
+                relativePath != fs::path("."));
+    return relativePath;
+}
+
+StatusWith<bool> FileCopyBasedInitialSyncer::moveStagedFilesIntoPlace(
+    const std::string& dbpath) try {
+    const fs::path dbpathDir(dbpath);
+    const auto stagingDir = dbpathDir / kStagingDirName.toString();
+    const auto completionMarker = stagingDir / kCompletionMarkerFileName.toString();
+    const auto moveMarker = dbpathDir / kMoveInProgressMarkerFileName.toString();
+
+    // Files left behind by an incomplete copy are discarded by the next file copy attempt. Once
+    // the staging directory is gone, only the oplog truncate-after point remains to be set.
+    if (!fs::exists(completionMarker) && !(fs::exists(moveMarker) && fs::exists(stagingDir))) {
+        return false;
+    }
+
+    // Make sure no other process uses the dbpath while its contents are replaced.
+    StorageEngineLockFile lockFile(dbpath);
+    uassertStatusOK(lockFile.open());
+    ON_BLOCK_EXIT([&] { lockFile.close(); });
+
+    LOGV2(5904520,
+          "Moving files copied by file copy based initial sync into the dbpath",
+          "dbpath"_attr = dbpath);
+
+    if (fs::exists(completionMarker)) {
+        // Remove the files of the node that initial synced, which have no data of use. Keep the
+        // diagnostic data and any log file written into the dbpath.
+        for (fs::directory_iterator it(dbpathDir), end; it != end; ++it) {
+            const auto name = it->path().filename().string();
+            if (name == kStagingDirName || name == kLockFileBasename ||
+                name == kFTDCDefaultDirectory || name == kMoveInProgressMarkerFileName) {
+                continue;
+            }
+            removeAllButLogFile(it->path());
+        }
+        // From here on the staged files are the only copy of the node's data, so the dbpath
+        // must not be cleared again if the move is interrupted.
+        uassertStatusOK(fsyncRename(completionMarker, moveMarker));
+    }
+
+    if (fs::exists(stagingDir)) {
+        for (fs::directory_iterator it(stagingDir), end; it != end; ++it) {
+            moveIntoPlace(it->path(), dbpathDir / it->path().filename());
+        }
+        uassertStatusOK(fsyncParentDirectory(moveMarker));
+        fs::remove_all(stagingDir);
+    }
+    uassertStatusOK(fsyncParentDirectory(moveMarker));
+    return true;
+} catch (const DBException& ex) {
+    return ex.toStatus();
+} catch (const fs::filesystem_error& ex) {
+    return {ErrorCodes::OperationFailed, ex.what()};
+}
+
+void FileCopyBasedInitialSyncer::setStagedOplogTruncateAfterPoint(
+    OperationContext* opCtx,
+    ReplicationConsistencyMarkers* consistencyMarkers,
+    const std::string& dbpath) {
+    const fs::path dbpathDir(dbpath);
+    const auto moveMarker = dbpathDir / kMoveInProgressMarkerFileName.toString();
+    if (!fs::exists(moveMarker)) {
+        return;
+    }
+    invariant(!fs::exists(dbpathDir / kStagingDirName.toString()));
+
+    std::string json;
+    {
+        std::ifstream in(moveMarker.string());
+        std::getline(in, json);
+        uassert(ErrorCodes::FileStreamFailed,
+                str::stream() << "Failed to read " << moveMarker.string(),
+                !in.bad());
+    }
+    const auto truncateAfterPoint = fromjson(json)["oplogTruncateAfterPoint"];
+    uassert(5904522,
+            str::stream() << "File copy based initial sync marker " << moveMarker.string()
+                          << " does not record the oplog truncate-after point: " << json,
+            truncateAfterPoint.type() == BSONType::bsonTimestamp);
+
+    LOGV2(5904523,
+          "Setting the oplog truncate-after point to the point the files copied by file copy "
+          "based initial sync are consistent to",
+          "oplogTruncateAfterPoint"_attr = truncateAfterPoint.timestamp());
+    consistencyMarkers->setOplogTruncateAfterPoint(opCtx, truncateAfterPoint.timestamp());
+
+    // Until the truncate-after point is durable, the marker is the only record of it.
+    opCtx->recoveryUnit()->waitUntilDurable(opCtx);
+    fs::remove(moveMarker);
+    uassertStatusOK(fsyncParentDirectory(moveMarker));
+}
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,247 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/filesystem/path.hpp>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status_with.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/client/dbclient_connection.h"
+#include "mongo/db/cursor_id.h"
+#include "mongo/db/repl/initial_syncer.h"
+#include "mongo/db/repl/initial_syncer_interface.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/net/hostandport.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+namespace repl {
+
+class ReplicationConsistencyMarkers;
+
+/**
+ * Initial sync by copying the storage engine files of the sync source rather than its documents.
+ *
+ * The syncer opens a $backupCursor on the sync source and streams every file of the backup, using
+ * the $_backupFile aggregation stage, into a staging directory under the local dbpath. It then
+ * extends the backup cursor with $backupCursorExtend until the copied files are close enough to
+ * the sync source's last applied optime, and marks the staged copy as complete.
+ *
+ * The storage engine cannot be replaced while the node is running, so the copy is moved into the
+ * dbpath by 'moveStagedFilesIntoPlace' when the server next starts, before the storage engine is
+ * initialized. Startup recovery then recovers to the checkpoint of the backup and replays the
+ * oplog from there, like a restore from a backup.
+ *
+ * When the sync source cannot open a backup cursor (for example because backup cursors are not
+ * available in its build) or the files of both nodes are not laid out the same way, the syncer
+ * falls back to logical initial sync.
+ */
+class FileCopyBasedInitialSyncer final : public InitialSyncerInterface {
+    FileCopyBasedInitialSyncer(const FileCopyBasedInitialSyncer&) = delete;
+    FileCopyBasedInitialSyncer& operator=(const FileCopyBasedInitialSyncer&) = delete;
+
+public:
+    /**
+     * Creates the logical initial syncer to fall back to.
+     */
+    using CreateLogicalInitialSyncerFn = std::function<std::shared_ptr<InitialSyncerInterface>()>;
+
+    /**
+     * Shuts the server down once the files have been copied, so that they are moved into place on
+     * restart.
+     */
+    using RequestShutdownFn = std::function<void()>;
+
+    using CreateClientFn = InitialSyncer::CreateClientFn;
+
+    // The directory under the dbpath the files of the sync source are copied into.
+    static constexpr StringData kStagingDirName = "initialSyncFileCopy"_sd;
+
+    // Written into the staging directory once every file of the backup has been copied.
+    static constexpr StringData kCompletionMarkerFileName = "FILE_COPY_COMPLETE"_sd;
+
+    FileCopyBasedInitialSyncer(InitialSyncerOptions opts,
+                               CreateLogicalInitialSyncerFn createLogicalInitialSyncer);
+
+    ~FileCopyBasedInitialSyncer();
+
+    Status startup(OperationContext* opCtx, std::uint32_t maxAttempts) noexcept final;
+
+    Status shutdown() final;
+
+    void join() final;
+
+    BSONObj getInitialSyncProgress() const final;
+
+    void cancelCurrentAttempt() final;
+
+    std::string getInitialSyncMethod() const final;
+
+    /**
+     * Overrides how the syncer creates the connection to the sync source.
+     *
+     * For testing only.
+     */
+    void setCreateClientFn_forTest(const CreateClientFn& createClientFn);
+
+    /**
+     * Overrides how the syncer shuts the server down after a successful copy.
+     *
+     * For testing only.
+     */
+    void setRequestShutdownFn_forTest(const RequestShutdownFn& requestShutdownFn);
+
+    /**
+     * Replaces the contents of 'dbpath' with the files staged by a completed file copy based
+     * initial sync, if any. Must be called at startup before the storage engine is initialized.
+     * Returns true if staged files were moved into place, or an error if the move failed and must
+     * be resumed by a restart once its cause is fixed.
+     */
+    static StatusWith<bool> moveStagedFilesIntoPlace(const std::string& dbpath);
+
+    /**
+     * Sets the oplog truncate-after point to the timestamp the files moved into 'dbpath' by
+     * moveStagedFilesIntoPlace() are consistent to, if it has not been set yet. Must be called at
+     * startup once the replication collections exist, before replication recovery.
+     */
+    static void setStagedOplogTruncateAfterPoint(OperationContext* opCtx,
+                                                 ReplicationConsistencyMarkers* consistencyMarkers,
+                                                 const std::string& dbpath);
+
+    /**
+     * Returns the path of 'remoteFilePath', a file in the sync source's dbpath 'remoteDbpath',
+     * relative to that dbpath.
+     */
+    static boost::filesystem::path getRelativePath(const std::string& remoteDbpath,
+                                                   const std::string& remoteFilePath);
+
+private:
+    struct BackupFile {
+        std::string path;
+        long long size;
+    };
+
+    /**
+     * Runs up to 'maxAttempts' file copy attempts on '_thread', or falls back to logical initial
+     * sync.
+     */
+    void _run(std::uint32_t maxAttempts);
+
+    /**
+     * Copies the files of a backup of the sync source into the staging directory. Throws
+     * IncompatibleServerVersion if file copy based initial sync is not possible with the chosen
+     * sync source.
+     */
+    void _runAttempt();
+
+    /**
+     * Starts the logical initial syncer in place of this one.
+     */
+    void _fallBackToLogicalInitialSync(std::uint32_t maxAttempts);
+
+    HostAndPort _chooseSyncSource();
+
+    /**
+     * Returns IncompatibleServerVersion if the files of the sync source cannot be used by this
+     * node.
+     */
+    Status _checkStorageCompatibility(DBClientConnection* client);
+
+    /**
+     * Runs 'pipeline' against the admin database and invokes 'onDocument' for each document
+     * returned, until the cursor is exhausted or returns an empty batch. Returns the id of the
+     * cursor, which is 0 if the cursor was exhausted.
+     */
+    CursorId _aggregate(DBClientConnection* client,
+                        const BSONArray& pipeline,
+                        const std::function<void(const BSONObj&)>& onDocument);
+
+    void _copyFile(DBClientConnection* client,
+                   const UUID& backupId,
+                   const std::string& remoteDbpath,
+                   const BackupFile& file);
+
+    /**
+     * Issues a getMore on the backup cursor so that the sync source does not time it out.
+     */
+    void _keepBackupCursorAlive(DBClientConnection* client, CursorId backupCursorId);
+
+    Timestamp _getSourceLastAppliedTimestamp(DBClientConnection* client);
+
+    void _checkInterrupted();
+
+    const InitialSyncerOptions _opts;
+    const CreateLogicalInitialSyncerFn _createLogicalInitialSyncer;
+    const boost::filesystem::path _stagingDir;
+
+    CreateClientFn _createClientFn;
+    RequestShutdownFn _requestShutdownFn;
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("FileCopyBasedInitialSyncer::_mutex");
+    stdx::condition_variable _cond;
+    stdx::thread _thread;
+
+    bool _active = false;
+    bool _inShutdown = false;
+    bool _attemptCanceled = false;
+
+    // The connection of the current attempt, shut down to interrupt it.
+    DBClientConnection* _client = nullptr;
+
+    // Set once this syncer has fallen back to logical initial sync.
+    std::shared_ptr<InitialSyncerInterface> _logicalInitialSyncer;
+
+    Date_t _lastBackupCursorKeepAlive;
+
+    // Progress of the current attempt, reported by getInitialSyncProgress().
+    struct Stats {
+        std::uint32_t attempt = 0;
+        std::uint32_t maxAttempts = 0;
+        HostAndPort syncSource;
+        boost::optional<UUID> backupId;
+        Timestamp checkpointTimestamp;
+        Timestamp lastExtendTimestamp;
+        std::uint32_t extensions = 0;
+        size_t totalFiles = 0;
+        size_t copiedFiles = 0;
+        long long totalBytes = 0;
+        long long copiedBytes = 0;
+        Date_t start;
+    } _stats;
+};
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,341 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+#include "mongo/bson/json.h"
+#include "mongo/db/repl/file_copy_based_initial_syncer.h"
+#include "mongo/db/repl/replication_consistency_markers_mock.h"
+#include "mongo/db/repl/sync_source_selector_mock.h"
+#include "mongo/db/server_options.h"
+#include "mongo/db/service_context_test_fixture.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/dbtests/mock/mock_dbclient_connection.h"
+#include "mongo/dbtests/mock/mock_remote_db_server.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/notification.h"
+#include "mongo/util/scopeguard.h"
+
+namespace {
+
+using namespace mongo;
+using namespace mongo::repl;
+
+namespace fs = boost::filesystem;
+
+void writeFile(const fs::path& path, const std::string& contents) {
+    fs::create_directories(path.parent_path());
+    std::ofstream out(path.string());
+    out << contents;
+}
+
+std::string readFile(const fs::path& path) {
+    std::ifstream in(path.string());
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+fs::path stagingDir(const unittest::TempDir& dbpath) {
+    return fs::path(dbpath.path()) / FileCopyBasedInitialSyncer::kStagingDirName.toString();
+}
+
+bool moveStagedFiles(const unittest::TempDir& dbpath) {
+    return unittest::assertGet(FileCopyBasedInitialSyncer::moveStagedFilesIntoPlace(dbpath.path()));
+}
+
+TEST(FileCopyBasedInitialSyncerTest, GetRelativePath) {
+    ASSERT_EQ(fs::path("collection-7.wt"),
+              FileCopyBasedInitialSyncer::getRelativePath("/data/db", "/data/db/collection-7.wt"));
+    ASSERT_EQ(fs::path("test/index-8.wt"),
+              FileCopyBasedInitialSyncer::getRelativePath("/data/db/", "/data/db/test/index-8.wt"));
+    ASSERT_EQ(fs::path("journal/WiredTigerLog.0000000001"),
+              FileCopyBasedInitialSyncer::getRelativePath(
+                  "/data/db", "/data/db/journal/WiredTigerLog.0000000001"));
+}
+
+TEST(FileCopyBasedInitialSyncerTest, GetRelativePathRejectsFilesOutsideOfDbpath) {
+    ASSERT_THROWS_CODE(FileCopyBasedInitialSyncer::getRelativePath("/data/db", "/etc/passwd"),
+                       DBException,
+                       5904519);
+    ASSERT_THROWS_CODE(FileCopyBasedInitialSyncer::getRelativePath("/data/db", "/data/db"),
+                       DBException,
+                       5904519);
+}
+
+TEST(FileCopyBasedInitialSyncerTest, NothingToMoveWithoutStagedFiles) {
+    unittest::TempDir dbpath("file_copy_based_initial_syncer_test");
+    writeFile(fs::path(dbpath.path()) / "collection-0.wt", "local");
+
+    ASSERT_FALSE(moveStagedFiles(dbpath));
+    ASSERT_EQ("local", readFile(fs::path(dbpath.path()) / "collection-0.wt"));
+}
+
+TEST(FileCopyBasedInitialSyncerTest, IncompleteCopyIsNotMoved) {
+    unittest::TempDir dbpath("file_copy_based_initial_syncer_test");
+    writeFile(fs::path(dbpath.path()) / "collection-0.wt", "local");
+    writeFile(stagingDir(dbpath) / "collection-0.wt", "remote");
+
+    ASSERT_FALSE(moveStagedFiles(dbpath));
+    ASSERT_EQ("local", readFile(fs::path(dbpath.path()) / "collection-0.wt"));
+}
+
+TEST(FileCopyBasedInitialSyncerTest, CompleteCopyReplacesDataFiles) {
+    unittest::TempDir dbpath("file_copy_based_initial_syncer_test");
+    const fs::path dir(dbpath.path());
+    writeFile(dir / "collection-0.wt", "local");
+    writeFile(dir / "collection-2.wt", "local");
+    writeFile(dir / "diagnostic.data" / "metrics.interim", "metrics");
+    writeFile(stagingDir(dbpath) / "collection-0.wt", "remote");
+    writeFile(stagingDir(dbpath) / "journal" / "WiredTigerLog.0000000001", "log");
+    writeFile(stagingDir(dbpath) /
+                  FileCopyBasedInitialSyncer::kCompletionMarkerFileName.toString(),
+              "{\"oplogTruncateAfterPoint\": {\"$timestamp\": {\"t\": 1, \"i\": 0}}}\n");
+
+    ASSERT_TRUE(moveStagedFiles(dbpath));
+    ASSERT_EQ("remote", readFile(dir / "collection-0.wt"));
+    ASSERT_EQ("log", readFile(dir / "journal" / "WiredTigerLog.0000000001"));
+    ASSERT_EQ("metrics", readFile(dir / "diagnostic.data" / "metrics.interim"));
+    ASSERT_FALSE(fs::exists(dir / "collection-2.wt"));
+    ASSERT_FALSE(fs::exists(stagingDir(dbpath)));
+    ASSERT_FALSE(
+        fs::exists(dir / FileCopyBasedInitialSyncer::kCompletionMarkerFileName.toString()));
+
+    // Once moved, there is nothing left to do on the next startup.
+    ASSERT_FALSE(moveStagedFiles(dbpath));
+    ASSERT_EQ("remote", readFile(dir / "collection-0.wt"));
+}
+
+TEST(FileCopyBasedInitialSyncerTest, CompleteCopyKeepsLogFileInDbpathSubdirectory) {
+    unittest::TempDir dbpath("file_copy_based_initial_syncer_test");
+    const fs::path dir(dbpath.path());
+    const auto logpath = dir / "log" / "mongod.log";
+    writeFile(logpath, "local log");
+    writeFile(dir / "log" / "mongod.log.1", "local");
+    writeFile(stagingDir(dbpath) / "log" / "collection-0.wt", "remote");
+    writeFile(stagingDir(dbpath) /
+                  FileCopyBasedInitialSyncer::kCompletionMarkerFileName.toString(),
+              "{\"oplogTruncateAfterPoint\": {\"$timestamp\": {\"t\": 1, \"i\": 0}}}\n");
+
+    const auto savedLogpath = serverGlobalParams.logpath;
+    serverGlobalParams.logpath = logpath.string();
+    ON_BLOCK_EXIT([&] { serverGlobalParams.logpath = savedLogpath; });
+
+    ASSERT_TRUE(moveStagedFiles(dbpath));
+    ASSERT_EQ("local log", readFile(logpath));
+    ASSERT_EQ("remote", readFile(dir / "log" / "collection-0.wt"));
+    ASSERT_FALSE(fs::exists(dir / "log" / "mongod.log.1"));
+    ASSERT_FALSE(fs::exists(stagingDir(dbpath)));
+}
+
+// Setting the truncate-after point waits for it to be durable, with an operation context.
+using FileCopyBasedInitialSyncerMarkerTest = ServiceContextTest;
+
+TEST_F(FileCopyBasedInitialSyncerMarkerTest, MovedFilesSetOplogTruncateAfterPoint) {
+    unittest::TempDir dbpath("file_copy_based_initial_syncer_test");
+    auto opCtx = makeOperationContext();
+    writeFile(stagingDir(dbpath) / "collection-0.wt", "remote");
+    writeFile(stagingDir(dbpath) /
+                  FileCopyBasedInitialSyncer::kCompletionMarkerFileName.toString(),
+              "{\"oplogTruncateAfterPoint\": {\"$timestamp\": {\"t\": 20, \"i\": 3}}}\n");
+    ReplicationConsistencyMarkersMock consistencyMarkers;
+
+    // The truncate-after point can only be set once the storage engine is up, so it must survive
+    // a restart in between.
+    ASSERT_TRUE(moveStagedFiles(dbpath));
+    ASSERT_FALSE(moveStagedFiles(dbpath));
+    ASSERT_EQ(Timestamp(), consistencyMarkers.getOplogTruncateAfterPoint(nullptr));
+
+    FileCopyBasedInitialSyncer::setStagedOplogTruncateAfterPoint(
+        opCtx.get(), &consistencyMarkers, dbpath.path());
+    ASSERT_EQ(Timestamp(20, 3), consistencyMarkers.getOplogTruncateAfterPoint(nullptr));
+
+    // It is only set once.
+    consistencyMarkers.setOplogTruncateAfterPoint(nullptr, Timestamp());
+    FileCopyBasedInitialSyncer::setStagedOplogTruncateAfterPoint(
+        opCtx.get(), &consistencyMarkers, dbpath.path());
+    ASSERT_EQ(Timestamp(), consistencyMarkers.getOplogTruncateAfterPoint(nullptr));
+}
+
+/**
+ * Stands in for the logical initial syncer the file copy based one falls back to.
+ */
+class LogicalInitialSyncerMock : public InitialSyncerInterface {
+public:
+    Status startup(OperationContext* opCtx, std::uint32_t maxAttempts) noexcept final {
+        startedWithMaxAttempts.set(maxAttempts);
+        return Status::OK();
+    }
+
+    Status shutdown() final {
+        return Status::OK();
+    }
+
+    void join() final {}
+
+    BSONObj getInitialSyncProgress() const final {
+        return BSON("method"
+                    << "logical");
+    }
+
+    void cancelCurrentAttempt() final {}
+
+    std::string getInitialSyncMethod() const final {
+        return "logical";
+    }
+
+    Notification<std::uint32_t> startedWithMaxAttempts;
+};
+
+class FileCopyBasedInitialSyncerRunTest : public ServiceContextTest {
+protected:
+    void setUp() override {
+        ServiceContextTest::setUp();
+        _savedDbpath = storageGlobalParams.dbpath;
+        _savedEngine = storageGlobalParams.engine;
+        storageGlobalParams.dbpath = _dbpath.path();
+        storageGlobalParams.engine = "wiredTiger";
+
+        _syncSourceSelector.setChooseNewSyncSourceResult_forTest(_syncSource);
+        _server.setCommandReply("getCmdLineOpts",
+                                BSON("parsed" << BSON("storage" << BSON("engine"
+                                                                        << "wiredTiger"))
+                                              << "ok" << 1));
+        _server.setCommandReply("hello",
+                                BSON("lastWrite" << BSON("opTime" << BSON("ts" << Timestamp(10, 1)
+                                                                              << "t" << 1LL))
+                                                 << "ok" << 1));
+        _server.setCommandReply("getMore",
+                                BSON("cursor" << BSON("id" << kBackupCursorId << "ns"
+                                                           << "admin.$cmd.aggregate"
+                                                           << "nextBatch" << BSONArray())
+                                              << "ok" << 1));
+        _server.setCommandReply("killCursors", BSON("ok" << 1));
+
+        InitialSyncerOptions opts;
+        opts.syncSourceSelector = &_syncSourceSelector;
+        opts.initialSyncRetryWait = Milliseconds(1);
+        _syncer = std::make_unique<FileCopyBasedInitialSyncer>(opts, [this] {
+            _logicalInitialSyncer = std::make_shared<LogicalInitialSyncerMock>();
+            return _logicalInitialSyncer;
+        });
+        _syncer->setCreateClientFn_forTest(
+            [this] { return std::make_unique<MockDBClientConnection>(&_server); });
+        _syncer->setRequestShutdownFn_forTest([this] { _shutdownRequested.set(); });
+    }
+
+    void tearDown() override {
+        _syncer.reset();
+        storageGlobalParams.dbpath = _savedDbpath;
+        storageGlobalParams.engine = _savedEngine;
+        ServiceContextTest::tearDown();
+    }
+
+    static BSONObj cursorReply(CursorId id, const BSONArray& firstBatch) {
+        return BSON("cursor" << BSON("id" << id << "ns"
+                                          << "admin.$cmd.aggregate"
+                                          << "firstBatch" << firstBatch)
+                             << "ok" << 1);
+    }
+
+    static BSONObj fileChunk(const std::string& data) {
+        return BSON("byteOffset" << 0LL << "data"
+                                 << BSONBinData(data.data(), data.size(), BinDataGeneral));
+    }
+
+    static constexpr CursorId kBackupCursorId = 123;
+
+    unittest::TempDir _dbpath{"file_copy_based_initial_syncer_test"};
+    HostAndPort _syncSource{"localhost", 12345};
+    MockRemoteDBServer _server{_syncSource.toString()};
+    SyncSourceSelectorMock _syncSourceSelector;
+    std::unique_ptr<FileCopyBasedInitialSyncer> _syncer;
+    std::shared_ptr<LogicalInitialSyncerMock> _logicalInitialSyncer;
+    Notification<void> _shutdownRequested;
+
+private:
+    std::string _savedDbpath;
+    std::string _savedEngine;
+};
+
+TEST_F(FileCopyBasedInitialSyncerRunTest, CopiesFilesOfBackupCursorIntoStagingDirectory) {
+    const auto backupId = UUID::gen();
+    BSONObjBuilder metadata;
+    backupId.appendToBuilder(&metadata, "backupId");
+    metadata.append("dbpath", "/remote/db");
+    metadata.append("checkpointTimestamp", Timestamp(10, 1));
+    _server.setCommandReply(
+        "aggregate",
+        std::vector<StatusWith<BSONObj>>{
+            cursorReply(kBackupCursorId,
+                        BSON_ARRAY(BSON("metadata" << metadata.obj())
+                                   << BSON("filename"
+                                           << "/remote/db/collection-0.wt"
+                                           << "fileSize" << 6LL)
+                                   << BSON("filename"
+                                           << "/remote/db/journal/WiredTigerLog.0000000001"
+                                           << "fileSize" << 3LL))),
+            cursorReply(0, BSON_ARRAY(fileChunk("remote"))),
+            cursorReply(0, BSON_ARRAY(fileChunk("log")))});
+
+    auto opCtx = makeOperationContext();
+    ASSERT_OK(_syncer->startup(opCtx.get(), 1));
+    _shutdownRequested.get();
+    _syncer->join();
+
+    ASSERT_EQ("remote", readFile(stagingDir(_dbpath) / "collection-0.wt"));
+    ASSERT_EQ("log", readFile(stagingDir(_dbpath) / "journal" / "WiredTigerLog.0000000001"));
+    const auto marker = fromjson(readFile(
+        stagingDir(_dbpath) / FileCopyBasedInitialSyncer::kCompletionMarkerFileName.toString()));
+    ASSERT_EQ(backupId, unittest::assertGet(UUID::parse(marker["backupId"])));
+    ASSERT_EQ(Timestamp(10, 1), marker["oplogTruncateAfterPoint"].timestamp());
+    ASSERT_FALSE(_logicalInitialSyncer);
+}
+
+TEST_F(FileCopyBasedInitialSyncerRunTest, FallsBackToLogicalInitialSyncWithoutBackupCursor) {
+    _server.setCommandReply("aggregate",
+                            Status(ErrorCodes::Error(40324),
+                                   "Unrecognized pipeline stage name: '$backupCursor'"));
+
+    auto opCtx = makeOperationContext();
+    ASSERT_OK(_syncer->startup(opCtx.get(), 3));
+    _syncer->join();
+
+    ASSERT_TRUE(_logicalInitialSyncer);
+    ASSERT_EQ(3U, _logicalInitialSyncer->startedWithMaxAttempts.get());
+    ASSERT_BSONOBJ_EQ(BSON("method"
+                           << "logical"),
+                      _syncer->getInitialSyncProgress());
+    ASSERT_FALSE(fs::exists(stagingDir(_dbpath)));
+    ASSERT_FALSE(_shutdownRequested);
+}
+
+}  // namespace
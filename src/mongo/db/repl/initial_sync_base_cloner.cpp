@@ -31,10 +31,18 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+#include <vector>
+
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/client.h"
 #include "mongo/db/repl/initial_sync_base_cloner.h"
 #include "mongo/db/repl/replication_consistency_markers_gen.h"
 #include "mongo/db/repl/replication_consistency_markers_impl.h"
 #include "mongo/logv2/log.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -54,6 +62,135 @@ InitialSyncBaseCloner::InitialSyncBaseCloner(StringData clonerName,
                                              ThreadPool* dbPool)
     : BaseCloner(clonerName, sharedData, source, client, storageInterface, dbPool) {}
 
+std::unique_ptr<DBClientConnection> InitialSyncBaseCloner::makeSyncSourceClient() const {
+    auto client = _createClientFn ? _createClientFn()
+                                  : std::make_unique<DBClientConnection>(true /* autoReconnect */);
+    uassertStatusOK(client->connect(getSource(), StringData(), boost::none));
+    uassertStatusOK(replAuthenticate(client.get())
+                        .withContext(str::stream() << "Failed to authenticate to " << getSource()));
+    return client;
+}
+
+Status InitialSyncBaseCloner::runConcurrently(const std::string& threadName,
+                                              size_t count,
+                                              size_t concurrency,
+                                              const ConcurrentWorkFn& work) {
+    concurrency = std::min(concurrency, count);
+    if (concurrency == 0) {
+        return Status::OK();
+    }
+
+    struct State {
+        Mutex mutex = MONGO_MAKE_LATCH("InitialSyncBaseCloner::runConcurrently::mutex");
+        stdx::condition_variable workerExited;
+        std::vector<DBClientConnection*> clients;
+        size_t nextIndex = 0;
+        size_t activeWorkers = 0;
+        bool clientsShutDown = false;
+        Status status = Status::OK();
+    } state;
+
+    // Shutting down a connection is allowed from any thread and interrupts any network call the
+    // worker using it is blocked in.
+    auto shutDownClients = [&state](WithLock) {
+        state.clientsShutDown = true;
+        for (auto* client : state.clients) {
+            client->shutdownAndDisallowReconnect();
+        }
+    };
+    auto recordError = [&](WithLock lk, Status status) {
+        if (state.status.isOK()) {
+            state.status = std::move(status);
+        }
+        shutDownClients(lk);
+    };
+
+    auto worker = [&](Status scheduleStatus) {
+        ON_BLOCK_EXIT([&] {
+            stdx::lock_guard<Latch> lk(state.mutex);
+            --state.activeWorkers;
+            state.workerExited.notify_all();
+        });
+        if (!scheduleStatus.isOK()) {
+            stdx::lock_guard<Latch> lk(state.mutex);
+            recordError(lk, scheduleStatus);
+            return;
+        }
+
+        std::unique_ptr<DBClientConnection> client;
+        try {
+            client = makeSyncSourceClient();
+        } catch (const DBException& e) {
+            stdx::lock_guard<Latch> lk(state.mutex);
+            recordError(lk, e.toStatus());
+            return;
+        }
+        {
+            stdx::lock_guard<Latch> lk(state.mutex);
+            if (state.clientsShutDown) {
+                return;
+            }
+            state.clients.push_back(client.get());
+        }
+        ON_BLOCK_EXIT([&] {
+            stdx::lock_guard<Latch> lk(state.mutex);
+            state.clients.erase(
+                std::find(state.clients.begin(), state.clients.end(), client.get()));
+        });
+
+        while (true) {
+            size_t index;
+            {
+                stdx::lock_guard<Latch> lk(state.mutex);
+                if (state.clientsShutDown || state.nextIndex == count) {
+                    return;
+                }
+                index = state.nextIndex++;
+            }
+            auto status = work(index, client.get());
+            if (!status.isOK()) {
+                stdx::lock_guard<Latch> lk(state.mutex);
+                recordError(lk, std::move(status));
+                return;
+            }
+        }
+    };
+
+    ThreadPool::Options options;
+    options.poolName = threadName + "ThreadPool";
+    options.threadNamePrefix = threadName + "-";
+    options.minThreads = 0;
+    options.maxThreads = concurrency;
+    options.onCreateThread = [](const std::string& name) {
+        Client::initThread(name);
+        AuthorizationSession::get(cc())->grantInternalAuthorization(&cc());
+    };
+    ThreadPool pool(options);
+    pool.startup();
+    {
+        stdx::lock_guard<Latch> lk(state.mutex);
+        state.activeWorkers = concurrency;
+    }
+    for (size_t i = 0; i < concurrency; ++i) {
+        pool.schedule(worker);
+    }
+
+    {
+        stdx::unique_lock<Latch> lk(state.mutex);
+        while (state.activeWorkers > 0) {
+            state.workerExited.wait_for(lk, Seconds(1).toSystemDuration());
+            // The connections of the workers are not known to the initial syncer, so they have to
+            // be shut down here when initial sync is canceled.
+            if (!state.clientsShutDown && mustExit()) {
+                shutDownClients(lk);
+            }
+        }
+    }
+    pool.shutdown();
+    pool.join();
+    return state.status;
+}
+
 void InitialSyncBaseCloner::clearRetryingState() {
     _retryableOp = boost::none;
 }
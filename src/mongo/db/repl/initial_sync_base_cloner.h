@@ -29,6 +29,9 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+
 #include "mongo/base/checked_cast.h"
 #include "mongo/db/repl/base_cloner.h"
 #include "mongo/db/repl/initial_sync_shared_data.h"
@@ -46,11 +49,51 @@ public:
                           ThreadPool* dbPool);
     virtual ~InitialSyncBaseCloner() = default;
 
+    using CreateClientFn = std::function<std::unique_ptr<DBClientConnection>()>;
+
+    /**
+     * Overrides how makeSyncSourceClient() creates the connections it then connects and
+     * authenticates, for this cloner and the cloners it creates.
+     */
+    void setCreateClientFn_forTest(const CreateClientFn& createClientFn) {
+        _createClientFn = createClientFn;
+    }
+
 protected:
     InitialSyncSharedData* getSharedData() const final {
         return checked_cast<InitialSyncSharedData*>(BaseCloner::getSharedData());
     }
 
+    /**
+     * Type of function run by runConcurrently() for each work item.  Must not throw.
+     */
+    using ConcurrentWorkFn = std::function<Status(size_t index, DBClientConnection* client)>;
+
+    /**
+     * Opens and authenticates an additional connection to the sync source.  Throws on failure.
+     */
+    std::unique_ptr<DBClientConnection> makeSyncSourceClient() const;
+
+    /**
+     * Makes 'cloner', created by this cloner, create its connections to the sync source as this
+     * cloner does.
+     */
+    void inheritCreateClientFn(InitialSyncBaseCloner* cloner) const {
+        cloner->_createClientFn = _createClientFn;
+    }
+
+    /**
+     * Runs 'work' for every index in [0, count) on up to 'concurrency' threads, each of which
+     * fetches over its own connection to the sync source.  Indexes are claimed in increasing
+     * order by whichever thread becomes free first.  Once an item fails, or initial sync is
+     * canceled, no further items are started and all of the connections are shut down so that
+     * the items in progress return promptly.  Returns the first error.
+     */
+    Status runConcurrently(const std::string& threadName,
+                           size_t count,
+                           size_t concurrency,
+                           const ConcurrentWorkFn& work);
+
 private:
     /**
      * Make sure the initial sync ID on the sync source has not changed.  Throws an exception
@@ -102,6 +145,9 @@ private:
 
     // Operation that may currently be retrying.
     InitialSyncSharedData::RetryableOperation _retryableOp;
+
+    // Creates the connections opened by makeSyncSourceClient(), if set.
+    CreateClientFn _createClientFn;
 };
 
 }  // namespace repl
@@ -44,6 +44,7 @@
 #include "mongo/db/repl/callback_completion_guard.h"
 #include "mongo/db/repl/data_replicator_external_state.h"
 #include "mongo/db/repl/initial_sync_shared_data.h"
+#include "mongo/db/repl/initial_syncer_interface.h"
 #include "mongo/db/repl/multiapplier.h"
 #include "mongo/db/repl/oplog_applier.h"
 #include "mongo/db/repl/oplog_buffer.h"
@@ -121,7 +122,7 @@ struct InitialSyncerOptions {
  * Entry Points:
  *      -- startup: Start initial sync.
  */
-class InitialSyncer {
+class InitialSyncer : public InitialSyncerInterface {
     InitialSyncer(const InitialSyncer&) = delete;
     InitialSyncer& operator=(const InitialSyncer&) = delete;
 
@@ -207,17 +208,17 @@ public:
     /**
      * Starts initial sync process, with the provided number of attempts
      */
-    Status startup(OperationContext* opCtx, std::uint32_t maxAttempts) noexcept;
+    Status startup(OperationContext* opCtx, std::uint32_t maxAttempts) noexcept final;
 
     /**
      * Shuts down replication if "start" has been called, and blocks until shutdown has completed.
      */
-    Status shutdown();
+    Status shutdown() final;
 
     /**
      * Block until inactive.
      */
-    void join();
+    void join() final;
 
     /**
      * Returns internal state in a loggable format.
@@ -228,12 +229,16 @@ public:
      * Returns stats about the progress of initial sync. If initial sync is not in progress it
      * returns an empty BSON object.
      */
-    BSONObj getInitialSyncProgress() const;
+    BSONObj getInitialSyncProgress() const final;
 
     /**
      * Cancels the current initial sync attempt if the initial syncer is active.
      */
-    void cancelCurrentAttempt();
+    void cancelCurrentAttempt() final;
+
+    std::string getInitialSyncMethod() const final {
+        return "logical";
+    }
 
     /**
      *
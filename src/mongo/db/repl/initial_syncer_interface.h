@@ -0,0 +1,86 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "mongo/base/status.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+class OperationContext;
+
+namespace repl {
+
+/**
+ * The interface through which the ReplicationCoordinator drives an initial sync, independent of
+ * the method ('initialSyncMethod') used to obtain the data from the sync source.
+ */
+class InitialSyncerInterface {
+public:
+    virtual ~InitialSyncerInterface() = default;
+
+    /**
+     * Starts initial sync process, with the provided number of attempts.
+     */
+    virtual Status startup(OperationContext* opCtx, std::uint32_t maxAttempts) noexcept = 0;
+
+    /**
+     * Shuts down initial sync if "startup" has been called.
+     */
+    virtual Status shutdown() = 0;
+
+    /**
+     * Blocks until inactive.
+     */
+    virtual void join() = 0;
+
+    /**
+     * Returns stats about the progress of initial sync. If initial sync is not in progress it
+     * returns an empty BSON object.
+     */
+    virtual BSONObj getInitialSyncProgress() const = 0;
+
+    /**
+     * Cancels the current initial sync attempt if the initial syncer is active.
+     */
+    virtual void cancelCurrentAttempt() = 0;
+
+    /**
+     * Returns the name of the initial sync method implemented, as accepted by the
+     * 'initialSyncMethod' server parameter.
+     */
+    virtual std::string getInitialSyncMethod() const = 0;
+};
+
+}  // namespace repl
+}  // namespace mongo
@@ -35,6 +35,7 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <deque>
 #include <memory>
 #include <set>
@@ -468,6 +469,86 @@ OpTime logOp(OperationContext* opCtx, MutableOplogEntry* oplogEntry) {
     return slot;
 }
 
+namespace {
+/**
+ * Builds the oplog entries of non-retryable inserts of the documents starting at 'begin', one per
+ * optime in 'opTimes', into the single buffer 'buffer' and points 'records' at them. The fields
+ * shared by all entries, such as the namespace, UUID and wall clock time, are serialized once from
+ * 'oplogEntryTemplate'. The entries are identical to those built by MutableOplogEntry::toBSON().
+ *
+ * Returns false without building anything if the template has fields between the document and the
+ * optime, such as 'o2', which could not be kept in place.
+ */
+bool buildInsertOplogEntries(const MutableOplogEntry& oplogEntryTemplate,
+                             std::vector<InsertStatement>::const_iterator begin,
+                             const std::vector<OpTime>& opTimes,
+                             const std::vector<boost::optional<ShardId>>& destinedRecipients,
+                             size_t totalDocSize,
+                             BufBuilder* buffer,
+                             std::vector<Record>* records) {
+    // Split a serialization of the template into the fields that precede the document and those
+    // that follow the optime. The fields in between are the ones that differ between entries.
+    MutableOplogEntry oplogEntry = oplogEntryTemplate;
+    oplogEntry.setObject(BSONObj());
+    oplogEntry.setOpTime(opTimes.front());
+    oplogEntry.setDestinedRecipient(boost::none);
+    const auto templateObj = oplogEntry.toBSON();
+
+    BSONObjBuilder prefixBuilder;
+    BSONObjBuilder suffixBuilder;
+    bool seenObject = false;
+    bool seenOpTime = false;
+    for (auto&& elem : templateObj) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == OplogEntryBase::kObjectFieldName) {
+            seenObject = true;
+        } else if (fieldName == OplogEntryBase::kTimestampFieldName ||
+                   fieldName == OplogEntryBase::kTermFieldName) {
+            seenOpTime = true;
+        } else if (!seenObject) {
+            prefixBuilder.append(elem);
+        } else if (seenOpTime) {
+            suffixBuilder.append(elem);
+        } else {
+            return false;
+        }
+    }
+    const auto prefix = prefixBuilder.done();
+    const auto suffix = suffixBuilder.done();
+
+    // Size the buffer up front for the documents, the shared fields and the per-entry fields.
+    const size_t count = opTimes.size();
+    const size_t bufferSize = totalDocSize + count * (prefix.objsize() + suffix.objsize() + 64);
+    buffer->reserveBytes(bufferSize);
+    buffer->claimReservedBytes(bufferSize);
+
+    std::vector<int> offsets(count);
+    for (size_t i = 0; i < count; i++) {
+        offsets[i] = buffer->len();
+        BSONObjBuilder entryBuilder(*buffer);
+        entryBuilder.appendElements(prefix);
+        entryBuilder.append(OplogEntryBase::kObjectFieldName, begin[i].doc);
+        if (destinedRecipients[i]) {
+            entryBuilder.append(OplogEntryBase::kDestinedRecipientFieldName,
+                                destinedRecipients[i]->toString());
+        }
+        entryBuilder.append(OplogEntryBase::kTimestampFieldName, opTimes[i].getTimestamp());
+        if (opTimes[i].getTerm() != OpTime::kUninitializedTerm) {
+            entryBuilder.append(OplogEntryBase::kTermFieldName, opTimes[i].getTerm());
+        }
+        entryBuilder.appendElements(suffix);
+        entryBuilder.doneFast();
+    }
+
+    // The buffer may have moved while it grew, so only point at the entries once all are built.
+    for (size_t i = 0; i < count; i++) {
+        BSONObj entry(buffer->buf() + offsets[i]);
+        (*records)[i] = Record{RecordId(), RecordData(entry.objdata(), entry.objsize())};
+    }
+    return true;
+}
+}  // namespace
+
 std::vector<OpTime> logInsertOps(
     OperationContext* opCtx,
     MutableOplogEntry* oplogEntryTemplate,
@@ -502,39 +583,67 @@ std::vector<OpTime> logInsertOps(
 
     WriteUnitOfWork wuow(opCtx);
 
+    // Fetch the optimes not already fetched by the caller with a single reservation.
+    const size_t numSlotsToReserve = std::count_if(
+        begin, end, [](const InsertStatement& stmt) { return stmt.oplogSlot.isNull(); });
+    std::vector<OplogSlot> reservedSlots;
+    if (numSlotsToReserve > 0) {
+        reservedSlots = oplogInfo->getNextOpTimes(opCtx, numSlotsToReserve);
+    }
+    auto nextReservedSlot = reservedSlots.begin();
+
     std::vector<OpTime> opTimes(count);
     std::vector<Timestamp> timestamps(count);
-    std::vector<BSONObj> bsonOplogEntries(count);
-    std::vector<Record> records(count);
+    std::vector<boost::optional<ShardId>> destinedRecipients(count);
+    bool allNonRetryable = true;
+    size_t totalDocSize = 0;
     for (size_t i = 0; i < count; i++) {
-        // Make a copy from the template for each insert oplog entry.
-        MutableOplogEntry oplogEntry = *oplogEntryTemplate;
-        // Make a mutable copy.
-        auto insertStatementOplogSlot = begin[i].oplogSlot;
-        // Fetch optime now, if not already fetched.
-        if (insertStatementOplogSlot.isNull()) {
-            insertStatementOplogSlot = oplogInfo->getNextOpTimes(opCtx, 1U)[0];
-        }
-        oplogEntry.setObject(begin[i].doc);
-        oplogEntry.setOpTime(insertStatementOplogSlot);
-        oplogEntry.setDestinedRecipient(getDestinedRecipientFn(begin[i].doc));
+        opTimes[i] = begin[i].oplogSlot.isNull() ? *nextReservedSlot++ : begin[i].oplogSlot;
+        timestamps[i] = opTimes[i].getTimestamp();
+        destinedRecipients[i] = getDestinedRecipientFn(begin[i].doc);
         addDestinedRecipient.execute([&](const BSONObj& data) {
             auto recipient = data["destinedRecipient"].String();
-            oplogEntry.setDestinedRecipient(boost::make_optional<ShardId>({recipient}));
+            destinedRecipients[i] = boost::make_optional<ShardId>({recipient});
         });
+        allNonRetryable = allNonRetryable && begin[i].stmtIds.front() == kUninitializedStmtId;
+        totalDocSize += begin[i].doc.objsize();
+    }
 
-        OplogLink oplogLink;
-        if (i > 0)
-            oplogLink.prevOpTime = opTimes[i - 1];
-        appendOplogEntryChainInfo(opCtx, &oplogEntry, &oplogLink, begin[i].stmtIds);
-
-        opTimes[i] = insertStatementOplogSlot;
-        timestamps[i] = insertStatementOplogSlot.getTimestamp();
-        bsonOplogEntries[i] = oplogEntry.toBSON();
-        // The storage engine will assign the RecordId based on the "ts" field of the oplog entry,
-        // see record_id_helpers::extractKey.
-        records[i] = Record{
-            RecordId(), RecordData(bsonOplogEntries[i].objdata(), bsonOplogEntries[i].objsize())};
+    // The storage engine will assign the RecordId based on the "ts" field of the oplog entry, see
+    // record_id_helpers::extractKey.
+    std::vector<Record> records(count);
+    BufBuilder oplogEntriesBuffer;
+    std::vector<BSONObj> bsonOplogEntries;
+    // Entries of non-retryable inserts only differ in their document, optime and destined
+    // recipient, so they are built together from a single serialization of the template.
+    const bool builtFromTemplate = allNonRetryable &&
+        totalDocSize < static_cast<size_t>(BufferMaxSize / 2) &&
+        buildInsertOplogEntries(*oplogEntryTemplate,
+                                begin,
+                                opTimes,
+                                destinedRecipients,
+                                totalDocSize,
+                                &oplogEntriesBuffer,
+                                &records);
+    if (!builtFromTemplate) {
+        bsonOplogEntries.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            // Make a copy from the template for each insert oplog entry.
+            MutableOplogEntry oplogEntry = *oplogEntryTemplate;
+            oplogEntry.setObject(begin[i].doc);
+            oplogEntry.setOpTime(opTimes[i]);
+            oplogEntry.setDestinedRecipient(destinedRecipients[i]);
+
+            OplogLink oplogLink;
+            if (i > 0)
+                oplogLink.prevOpTime = opTimes[i - 1];
+            appendOplogEntryChainInfo(opCtx, &oplogEntry, &oplogLink, begin[i].stmtIds);
+
+            bsonOplogEntries[i] = oplogEntry.toBSON();
+            records[i] = Record{RecordId(),
+                                RecordData(bsonOplogEntries[i].objdata(),
+                                           bsonOplogEntries[i].objsize())};
+        }
     }
 
     sleepBetweenInsertOpTimeGenerationAndLogOp.execute([&](const BSONObj& data) {
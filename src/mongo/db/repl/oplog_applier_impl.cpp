@@ -31,6 +31,8 @@
 
 #include "mongo/db/repl/oplog_applier_impl.h"
 
+#include <algorithm>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/catalog/database.h"
@@ -38,6 +40,7 @@
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/txn_cmds_gen.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/logical_session_id.h"
@@ -73,6 +76,11 @@ ServerStatusMetricField<Counter64> displayOplogApplicationBatchSize("repl.apply.
 TimerStats applyBatchStats;
 ServerStatusMetricField<TimerStats> displayOpBatchesApplied("repl.apply.batches", &applyBatchStats);
 
+// Number of batches prepared while the previous batch was being applied.
+Counter64 oplogApplicationPipelinedBatches;
+ServerStatusMetricField<Counter64> displayPipelinedBatches("repl.apply.pipelinedBatches",
+                                                           &oplogApplicationPipelinedBatches);
+
 /**
  * Used for logging a report of ops that take longer than "slowMS" to apply. This is called
  * right before returning from applyOplogEntryOrGroupedInserts, and it returns the same status.
@@ -287,31 +295,38 @@ void OplogApplierImpl::_run(OplogBuffer* oplogBuffer) {
         // Transition to SECONDARY state, if possible.
         _replCoord->finishRecoveryIfEligible(&opCtx);
 
-        // Blocks up to a second waiting for a batch to be ready to apply. If one doesn't become
-        // ready in time, we'll loop again so we can do the above checks periodically.
-        OplogBatch ops = _oplogBatcher->getNextBatch(Seconds(1));
-        if (ops.empty()) {
-            if (ops.mustShutdown()) {
-                // Shut down and exit oplog application loop.
-                return;
-            }
-            if (MONGO_unlikely(rsSyncApplyStop.shouldFail())) {
-                continue;
-            }
-            if (ops.termWhenExhausted()) {
-                // Signal drain complete if we're in Draining state and the buffer is empty.
-                // Since we check the states of batcher and oplog buffer without synchronization,
-                // they can be stale. We make sure the applier is still draining in the given term
-                // before and after the check, so that if the oplog buffer was exhausted, then
-                // it still will be.
-                _replCoord->signalDrainComplete(&opCtx, *ops.termWhenExhausted());
+        // A batch taken from the batcher while the previous batch was being applied goes first.
+        auto batch = std::move(_preparedBatch);
+        if (!batch) {
+            // Blocks up to a second waiting for a batch to be ready to apply. If one doesn't
+            // become ready in time, we'll loop again so we can do the above checks periodically.
+            OplogBatch ops = _oplogBatcher->getNextBatch(Seconds(1));
+            if (ops.empty()) {
+                if (ops.mustShutdown()) {
+                    // Shut down and exit oplog application loop.
+                    return;
+                }
+                if (MONGO_unlikely(rsSyncApplyStop.shouldFail())) {
+                    continue;
+                }
+                if (ops.termWhenExhausted()) {
+                    // Signal drain complete if we're in Draining state and the buffer is empty.
+                    // Since we check the states of batcher and oplog buffer without
+                    // synchronization, they can be stale. We make sure the applier is still
+                    // draining in the given term before and after the check, so that if the oplog
+                    // buffer was exhausted, then it still will be.
+                    _replCoord->signalDrainComplete(&opCtx, *ops.termWhenExhausted());
+                }
+                continue;  // Try again.
             }
-            continue;  // Try again.
+
+            batch = std::make_unique<PreparedBatch>();
+            batch->ops = ops.releaseBatch();
         }
 
-        // Extract some info from ops that we'll need after releasing the batch below.
-        const auto firstOpTimeInBatch = ops.front().getOpTime();
-        const auto lastOpInBatch = ops.back();
+        // Extract some info from ops that we'll need after applying the batch below.
+        const auto firstOpTimeInBatch = batch->ops.front().getOpTime();
+        const auto lastOpInBatch = batch->ops.back();
         const auto lastOpTimeInBatch = lastOpInBatch.getOpTime();
         const auto lastWallTimeInBatch = lastOpInBatch.getWallClockTime();
         const auto lastAppliedOpTimeAtStartOfBatch = _replCoord->getMyLastAppliedOpTime();
@@ -329,9 +344,10 @@ void OplogApplierImpl::_run(OplogBuffer* oplogBuffer) {
         // Don't allow the fsync+lock thread to see intermediate states of batch application.
         stdx::lock_guard<SimpleMutex> fsynclk(filesLockedFsync);
 
-        // Apply the operations in this batch. '_applyOplogBatch' returns the optime of the
+        // Apply the operations in this batch. '_applyPreparedBatch' returns the optime of the
         // last op that was applied, which should be the last optime in the batch.
-        auto swLastOpTimeAppliedInBatch = _applyOplogBatch(&opCtx, ops.releaseBatch());
+        auto swLastOpTimeAppliedInBatch = _applyPreparedBatch(
+            &opCtx, batch.get(), oplogApplicationPipelineBatches.load() && !inShutdown());
         if (swLastOpTimeAppliedInBatch.getStatus().code() == ErrorCodes::InterruptedAtShutdown) {
             // If an operation was interrupted at shutdown, fail the batch without advancing
             // appliedThrough as if this were an unclean shutdown. This ensures the stable timestamp
@@ -431,6 +447,54 @@ void scheduleWritesToOplog(OperationContext* opCtx,
 
 StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
                                                       std::vector<OplogEntry> ops) {
+    PreparedBatch batch;
+    batch.ops = std::move(ops);
+    return _applyPreparedBatch(opCtx, &batch, false /* pipelineNextBatch */);
+}
+
+void OplogApplierImpl::_prepareNextBatch(OperationContext* opCtx,
+                                         const std::vector<OplogEntry>& currentOps) {
+    invariant(!_preparedBatch);
+    if (getOptions().skipWritesToOplog || MONGO_unlikely(rsSyncApplyStop.shouldFail())) {
+        return;
+    }
+
+    // Commands may change the catalog that writer assignment depends on, and transactions read
+    // their earlier entries back from the oplog, so batches with commands act as barriers.
+    auto isCommand = [](const OplogEntry& op) { return op.isCommand(); };
+    if (std::any_of(currentOps.begin(), currentOps.end(), isCommand)) {
+        return;
+    }
+
+    OplogBatch nextOps = _oplogBatcher->getNextBatchIfReady();
+    if (nextOps.empty()) {
+        return;
+    }
+
+    _preparedBatch = std::make_unique<PreparedBatch>();
+    auto& ops = _preparedBatch->ops;
+    ops = nextOps.releaseBatch();
+    if (std::any_of(ops.begin(), ops.end(), isCommand)) {
+        // This batch is written and applied on its own once the current batch is done.
+        return;
+    }
+
+    // Every entry of the current batch is in the oplog already. If we crash before the current
+    // batch is applied, recovery discards the partially written next batch and replays the
+    // current batch from the oplog.
+    _consistencyMarkers->setOplogTruncateAfterPoint(opCtx, currentOps.back().getTimestamp());
+    scheduleWritesToOplog(opCtx, _storageInterface, _writerPool, ops);
+
+    _preparedBatch->writerVectors.resize(_getNumPartitions());
+    fillWriterVectors(opCtx, &ops, &_preparedBatch->writerVectors, &_preparedBatch->derivedOps);
+    _preparedBatch->prepared = true;
+    oplogApplicationPipelinedBatches.increment();
+}
+
+StatusWith<OpTime> OplogApplierImpl::_applyPreparedBatch(OperationContext* opCtx,
+                                                         PreparedBatch* batch,
+                                                         bool pipelineNextBatch) {
+    auto& ops = batch->ops;
     invariant(!ops.empty());
 
     LOGV2_DEBUG(21230,
@@ -453,7 +517,7 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
     // Increment the batch size stat.
     oplogApplicationBatchSize.increment(ops.size());
 
-    std::vector<WorkerMultikeyPathInfo> multikeyVector(_writerPool->getStats().options.maxThreads);
+    std::vector<WorkerMultikeyPathInfo> multikeyVector;
     {
         // Each node records cumulative batch application stats for itself using this timer.
         TimerHolder timer(&applyBatchStats);
@@ -462,28 +526,24 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
         // because the spawned threads refer to objects on the stack
         ON_BLOCK_EXIT([&] { _writerPool->waitForIdle(); });
 
-        // Write batch of ops into oplog.
-        if (!getOptions().skipWritesToOplog) {
-            _consistencyMarkers->setOplogTruncateAfterPoint(
-                opCtx, _replCoord->getMyLastAppliedOpTime().getTimestamp());
-            scheduleWritesToOplog(opCtx, _storageInterface, _writerPool, ops);
-        }
+        auto& writerVectors = batch->writerVectors;
 
-        // Holds 'pseudo operations' generated by secondaries to aid in replication.
-        // Keep in scope until all operations in 'ops' and 'derivedOps' have been applied.
-        // Pseudo operations include:
-        // - applyOps operations expanded to individual ops.
-        // - ops to update config.transactions. Normal writes to config.transactions in the
-        //   primary don't create an oplog entry, so extract info from writes with transactions
-        //   and create a pseudo oplog.
-        std::vector<std::vector<OplogEntry>> derivedOps;
+        // A pipelined batch was written into the oplog and assigned to writer threads while the
+        // previous batch was being applied.
+        if (!batch->prepared) {
+            // Write batch of ops into oplog.
+            if (!getOptions().skipWritesToOplog) {
+                _consistencyMarkers->setOplogTruncateAfterPoint(
+                    opCtx, _replCoord->getMyLastAppliedOpTime().getTimestamp());
+                scheduleWritesToOplog(opCtx, _storageInterface, _writerPool, ops);
+            }
 
-        std::vector<std::vector<const OplogEntry*>> writerVectors(
-            _writerPool->getStats().options.maxThreads);
-        fillWriterVectors(opCtx, &ops, &writerVectors, &derivedOps);
+            writerVectors.resize(_getNumPartitions());
+            fillWriterVectors(opCtx, &ops, &writerVectors, &batch->derivedOps);
 
-        // Wait for writes to finish before applying ops.
-        _writerPool->waitForIdle();
+            // Wait for writes to finish before applying ops.
+            _writerPool->waitForIdle();
+        }
 
         // Use this fail point to hold the PBWM lock after we have written the oplog entries but
         // before we have applied them.
@@ -505,37 +565,72 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
         }
 
         {
+            // The status and multikey paths of each partition of the batch.
+            std::vector<Status> statusVector(writerVectors.size(), Status::OK());
+            multikeyVector.resize(writerVectors.size());
+
+            // Partitions are independent of each other, so rather than binding each partition to
+            // a writer, writers claim partitions one at a time until none are left. A writer
+            // busy with a hot partition then doesn't hold up the partitions behind it. The
+            // largest partitions are claimed first so that the last ones to finish are short.
+            std::vector<size_t> partitionOrder;
+            for (size_t i = 0; i < writerVectors.size(); i++) {
+                if (!writerVectors[i].empty()) {
+                    partitionOrder.push_back(i);
+                }
+            }
+            std::stable_sort(partitionOrder.begin(),
+                             partitionOrder.end(),
+                             [&writerVectors](size_t lhs, size_t rhs) {
+                                 return writerVectors[lhs].size() > writerVectors[rhs].size();
+                             });
+            AtomicWord<size_t> nextPartition{0};
 
-            std::vector<Status> statusVector(_writerPool->getStats().options.maxThreads,
-                                             Status::OK());
             // Doles out all the work to the writer pool threads. writerVectors is not modified,
             // but  applyOplogBatchPerWorker will modify the vectors that it contains.
-            invariant(writerVectors.size() == statusVector.size());
-            for (size_t i = 0; i < writerVectors.size(); i++) {
-                if (writerVectors[i].empty())
-                    continue;
-
+            const size_t numWriters = std::min<size_t>(
+                _writerPool->getStats().options.maxThreads, partitionOrder.size());
+            for (size_t i = 0; i < numWriters; i++) {
                 _writerPool->schedule([this,
-                                       &writer = writerVectors.at(i),
-                                       &status = statusVector.at(i),
-                                       &multikeyVector = multikeyVector.at(i),
+                                       &writerVectors,
+                                       &statusVector,
+                                       &multikeyVector,
+                                       &partitionOrder,
+                                       &nextPartition,
                                        isDataConsistent = isDataConsistent](auto scheduleStatus) {
                     invariant(scheduleStatus);
 
-                    auto opCtx = cc().makeOperationContext();
-
-                    // This code path is only executed on secondaries and initial syncing nodes,
-                    // so it is safe to exclude any writes from Flow Control.
-                    opCtx->setShouldParticipateInFlowControl(false);
-                    opCtx->setEnforceConstraints(false);
-
-                    status = opCtx->runWithoutInterruptionExceptAtGlobalShutdown([&] {
-                        return applyOplogBatchPerWorker(
-                            opCtx.get(), &writer, &multikeyVector, isDataConsistent);
-                    });
+                    for (auto next = nextPartition.fetchAndAdd(1); next < partitionOrder.size();
+                         next = nextPartition.fetchAndAdd(1)) {
+                        const auto partition = partitionOrder[next];
+                        auto opCtx = cc().makeOperationContext();
+
+                        // This code path is only executed on secondaries and initial syncing
+                        // nodes, so it is safe to exclude any writes from Flow Control.
+                        opCtx->setShouldParticipateInFlowControl(false);
+                        opCtx->setEnforceConstraints(false);
+
+                        auto& status = statusVector[partition];
+                        status = opCtx->runWithoutInterruptionExceptAtGlobalShutdown([&] {
+                            return applyOplogBatchPerWorker(opCtx.get(),
+                                                            &writerVectors[partition],
+                                                            &multikeyVector[partition],
+                                                            isDataConsistent);
+                        });
+                        if (!status.isOK()) {
+                            return;
+                        }
+                    }
                 });
             }
 
+            // Overlap the oplog writes and writer assignment of the next batch with the
+            // application of this one. Writers that finish early pick up the oplog writes.
+            if (pipelineNextBatch) {
+                _prepareNextBatch(opCtx, ops);
+            }
+
+            // Also waits for the oplog writes of the next batch, if any.
             _writerPool->waitForIdle();
 
             // If any of the statuses is not ok, return error.
@@ -559,6 +654,15 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
                 }
             }
         }
+
+        for (const auto& op : ops) {
+            if (_shouldSplitPreparedCommit(op)) {
+                auto status = _applySplitPreparedCommit(opCtx, op, &multikeyVector);
+                if (!status.isOK()) {
+                    return status;
+                }
+            }
+        }
     }
 
     // Use this fail point to hold the PBWM lock and prevent the batch from completing.
@@ -706,6 +810,12 @@ void OplogApplierImpl::_deriveOpsAndFillWriterVectors(
             continue;
         }
 
+        // The operations of a prepared transaction committed during recovery are split across the
+        // writers by _applySplitPreparedCommit().
+        if (_shouldSplitPreparedCommit(op)) {
+            continue;
+        }
+
         // Writes to the tenant migration namespaces must be serialized to preserve the order of
         // migration and access blocker states.
         if (op.getNss() == NamespaceString::kTenantMigrationDonorsNamespace ||
@@ -723,6 +833,100 @@ void OplogApplierImpl::_deriveOpsAndFillWriterVectors(
     }
 }
 
+bool OplogApplierImpl::_shouldSplitPreparedCommit(const OplogEntry& op) const {
+    return op.isPreparedCommit() && getOptions().mode == OplogApplication::Mode::kRecovering &&
+        op.getOpTime() > getOptions().beginApplyingOpTime &&
+        oplogApplicationSplitPreparedTransactionsInRecovery;
+}
+
+Status OplogApplierImpl::_applySplitPreparedCommit(
+    OperationContext* opCtx,
+    const OplogEntry& commitOp,
+    std::vector<WorkerMultikeyPathInfo>* multikeyVector) {
+    IDLParserErrorContext ctx("commitTransaction");
+    auto commitCommand = CommitTransactionOplogObject::parse(ctx, commitOp.getObject());
+    invariant(commitCommand.getCommitTimestamp());
+    const auto commitTimestamp = *commitCommand.getCommitTimestamp();
+    const auto durableTimestamp = commitOp.getOpTime().getTimestamp();
+    const auto dbName = commitOp.getNss().db();
+
+    auto txnOps = readTransactionOperationsFromOplogChain(opCtx, commitOp, {});
+
+    // Every partition is a separate storage transaction, so use one per writer thread.
+    std::vector<std::vector<const OplogEntry*>> partitions(
+        _writerPool->getStats().options.maxThreads);
+    CachedCollectionProperties collPropertiesCache;
+    for (auto&& op : txnOps) {
+        OplogApplierUtils::addToWriterVector(opCtx, &op, &partitions, &collPropertiesCache);
+    }
+
+    std::vector<Status> statusVector(partitions.size(), Status::OK());
+    std::vector<WorkerMultikeyPathInfo> partitionMultikeyVector(partitions.size());
+    for (size_t i = 0; i < partitions.size(); i++) {
+        if (partitions[i].empty()) {
+            continue;
+        }
+        _writerPool->schedule([&, i](auto scheduleStatus) {
+            invariant(scheduleStatus);
+
+            auto writerOpCtx = cc().makeOperationContext();
+            writerOpCtx->setShouldParticipateInFlowControl(false);
+            writerOpCtx->setEnforceConstraints(false);
+
+            // Set up the same context as applyOplogBatchPerWorker.
+            UnreplicatedWritesBlock uwb(writerOpCtx.get());
+            writerOpCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(false);
+            writerOpCtx->recoveryUnit()->setPrepareConflictBehavior(
+                PrepareConflictBehavior::kIgnoreConflictsAllowWrites);
+            DisableDocumentValidation validationDisabler(writerOpCtx.get());
+
+            std::vector<OplogEntry> ops;
+            ops.reserve(partitions[i].size());
+            for (auto op : partitions[i]) {
+                ops.push_back(*op);
+            }
+
+            auto& multikeyPathTracker = MultikeyPathTracker::get(writerOpCtx.get());
+            {
+                ON_BLOCK_EXIT([&] { multikeyPathTracker.stopTrackingMultikeyPathInfo(); });
+                multikeyPathTracker.startTrackingMultikeyPathInfo();
+                statusVector[i] = writerOpCtx->runWithoutInterruptionExceptAtGlobalShutdown([&] {
+                    return applyRecoveredPreparedTransactionOps(
+                        writerOpCtx.get(), dbName, ops, commitTimestamp, durableTimestamp);
+                });
+            }
+            partitionMultikeyVector[i] = multikeyPathTracker.getMultikeyPathInfo();
+        });
+    }
+    _writerPool->waitForIdle();
+
+    for (size_t i = 0; i < partitions.size(); i++) {
+        if (!statusVector[i].isOK()) {
+            LOGV2_FATAL_CONTINUE(5904800,
+                                 "Failed to apply part of a prepared transaction",
+                                 "commitOplogEntry"_attr = redact(commitOp.toBSONForLogging()),
+                                 "numOperations"_attr = partitions[i].size(),
+                                 "error"_attr = redact(statusVector[i]));
+            return statusVector[i];
+        }
+        if (!partitionMultikeyVector[i].empty()) {
+            multikeyVector->push_back(std::move(partitionMultikeyVector[i]));
+        }
+    }
+
+    LOGV2_DEBUG(5904801,
+                2,
+                "Applied prepared transaction across writer threads",
+                "commitTimestamp"_attr = commitTimestamp,
+                "numOperations"_attr = txnOps.size());
+    return Status::OK();
+}
+
+size_t OplogApplierImpl::_getNumPartitions() const {
+    return _writerPool->getStats().options.maxThreads *
+        oplogApplicationPartitionsPerWriter.load();
+}
+
 void OplogApplierImpl::fillWriterVectors(
     OperationContext* opCtx,
     std::vector<OplogEntry>* ops,
@@ -748,6 +952,23 @@ void OplogApplierImpl::fillWriterVectors_forTest(
     fillWriterVectors(opCtx, ops, writerVectors, derivedOps);
 }
 
+StatusWith<OpTime> OplogApplierImpl::applyOplogBatchPipelined_forTest(
+    OperationContext* opCtx, std::vector<OplogEntry> ops) {
+    PreparedBatch batch;
+    batch.ops = std::move(ops);
+    return _applyPreparedBatch(opCtx, &batch, true /* pipelineNextBatch */);
+}
+
+StatusWith<OpTime> OplogApplierImpl::applyPipelinedBatch_forTest(OperationContext* opCtx) {
+    invariant(_preparedBatch);
+    auto batch = std::move(_preparedBatch);
+    return _applyPreparedBatch(opCtx, batch.get(), false /* pipelineNextBatch */);
+}
+
+bool OplogApplierImpl::isNextBatchPrepared_forTest() const {
+    return _preparedBatch && _preparedBatch->prepared;
+}
+
 Status applyOplogEntryOrGroupedInserts(OperationContext* opCtx,
                                        const OplogEntryOrGroupedInserts& entryOrGroupedInserts,
                                        OplogApplication::Mode oplogApplicationMode,
@@ -79,6 +79,24 @@ public:
                                    std::vector<std::vector<const OplogEntry*>>* writerVectors,
                                    std::vector<std::vector<OplogEntry>>* derivedOps) noexcept;
 
+    /**
+     * Applies 'ops' as _run() does with batch pipelining enabled, which may leave the next batch
+     * of the batcher prepared for applyPipelinedBatch_forTest().
+     */
+    StatusWith<OpTime> applyOplogBatchPipelined_forTest(OperationContext* opCtx,
+                                                        std::vector<OplogEntry> ops);
+
+    /**
+     * Applies the batch taken from the batcher by the last applyOplogBatchPipelined_forTest().
+     */
+    StatusWith<OpTime> applyPipelinedBatch_forTest(OperationContext* opCtx);
+
+    /**
+     * Returns whether a batch was taken from the batcher and written to the oplog while the last
+     * batch was being applied.
+     */
+    bool isNextBatchPrepared_forTest() const;
+
 private:
     /**
      * Runs oplog application in a loop until shutdown() is called.
@@ -102,6 +120,68 @@ private:
      */
     StatusWith<OpTime> _applyOplogBatch(OperationContext* opCtx, std::vector<OplogEntry> ops);
 
+    /**
+     * A batch of oplog entries along with the assignment of its operations to writer threads.
+     */
+    struct PreparedBatch {
+        std::vector<OplogEntry> ops;
+
+        // Holds 'pseudo operations' generated by secondaries to aid in replication.
+        // Must stay in scope until all operations in 'ops' and 'derivedOps' have been applied.
+        // Pseudo operations include:
+        // - applyOps operations expanded to individual ops.
+        // - ops to update config.transactions. Normal writes to config.transactions in the
+        //   primary don't create an oplog entry, so extract info from writes with transactions
+        //   and create a pseudo oplog.
+        std::vector<std::vector<OplogEntry>> derivedOps;
+
+        std::vector<std::vector<const OplogEntry*>> writerVectors;
+
+        // Whether 'ops' have already been written to the oplog and 'writerVectors' filled in.
+        bool prepared = false;
+    };
+
+    /**
+     * Does the work of _applyOplogBatch(). If 'pipelineNextBatch' is true, the next batch is taken
+     * from the batcher while the writer threads apply this one, and left in '_preparedBatch'.
+     */
+    StatusWith<OpTime> _applyPreparedBatch(OperationContext* opCtx,
+                                           PreparedBatch* batch,
+                                           bool pipelineNextBatch);
+
+    /**
+     * Called while the writer threads are applying 'currentOps'. If the next batch is ready and
+     * neither batch contains a command, schedules the writes of the next batch to the oplog and
+     * assigns its operations to writer threads. Operations on the same document hash to the same
+     * writer in both batches, and the next batch is not applied until the current one is done.
+     */
+    void _prepareNextBatch(OperationContext* opCtx, const std::vector<OplogEntry>& currentOps);
+
+    /**
+     * Returns the number of partitions, and so writer vectors, the operations of a batch are
+     * hashed into. Operations on the same document, or on the same capped collection, always land
+     * in the same partition and are applied in oplog order. Distinct partitions have no ordering
+     * constraints between them.
+     */
+    size_t _getNumPartitions() const;
+
+    /**
+     * Returns whether 'op' is the commit of a prepared transaction whose operations are split
+     * across the writer threads by _applySplitPreparedCommit() instead of being applied by a
+     * single writer.
+     */
+    bool _shouldSplitPreparedCommit(const OplogEntry& op) const;
+
+    /**
+     * Applies the operations of the prepared transaction committed by 'commitOp', hashed by
+     * document into partitions that the writer threads apply concurrently. Each partition is
+     * applied in its own storage transaction at the transaction's commit timestamp. The multikey
+     * paths the partitions ignored are appended to 'multikeyVector'.
+     */
+    Status _applySplitPreparedCommit(OperationContext* opCtx,
+                                     const OplogEntry& commitOp,
+                                     std::vector<WorkerMultikeyPathInfo>* multikeyVector);
+
     void _deriveOpsAndFillWriterVectors(OperationContext* opCtx,
                                         std::vector<OplogEntry>* ops,
                                         std::vector<std::vector<const OplogEntry*>>* writerVectors,
@@ -123,6 +203,10 @@ private:
     // we will apply all operations that were fetched.
     OpTime _beginApplyingOpTime = OpTime();
 
+    // The batch taken from the batcher while the previous batch was being applied. Only accessed
+    // by the thread running _run().
+    std::unique_ptr<PreparedBatch> _preparedBatch;
+
     void fillWriterVectors(OperationContext* opCtx,
                            std::vector<OplogEntry>* ops,
                            std::vector<std::vector<const OplogEntry*>>* writerVectors,
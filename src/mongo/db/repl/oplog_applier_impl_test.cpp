@@ -31,6 +31,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -66,7 +67,9 @@
 #include "mongo/db/session_txn_record_gen.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/db/transaction_participant_gen.h"
+#include "mongo/idl/server_parameter_test_util.h"
 #include "mongo/platform/mutex.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
@@ -539,6 +542,148 @@ TEST_F(OplogApplierImplTest,
                   secondDerivedOp.getObject()["lastWriteOpTime"]["ts"].timestamp());
 }
 
+/**
+ * Test only subclass of TrackOpsAppliedApplier that can hand batches to its batcher, to be
+ * pipelined behind the batch being applied, and fail the application of a batch.
+ */
+class PipelineTrackOpsAppliedApplier : public TrackOpsAppliedApplier {
+public:
+    using TrackOpsAppliedApplier::TrackOpsAppliedApplier;
+
+    Status applyOplogBatchPerWorker(OperationContext* opCtx,
+                                    std::vector<const OplogEntry*>* ops,
+                                    WorkerMultikeyPathInfo* workerMultikeyPathInfo,
+                                    bool isDataConsistent) override {
+        if (!failure.isOK()) {
+            return failure;
+        }
+        return TrackOpsAppliedApplier::applyOplogBatchPerWorker(
+            opCtx, ops, workerMultikeyPathInfo, isDataConsistent);
+    }
+
+    void setNextBatch(const std::vector<OplogEntry>& ops) {
+        OplogBatch batch(ops.size());
+        for (const auto& op : ops) {
+            batch.emplace_back(op);
+        }
+        _oplogBatcher->setNextBatch_forTest(std::move(batch));
+    }
+
+    // Returned by every writer thread when not OK.
+    Status failure = Status::OK();
+};
+
+class OplogApplierImplPipelineTest : public OplogApplierImplTest {
+protected:
+    void setUp() override {
+        OplogApplierImplTest::setUp();
+        createCollection(_opCtx.get(), _nss, CollectionOptions());
+        _writerPool = makeReplWriterPool();
+        _applier = std::make_unique<PipelineTrackOpsAppliedApplier>(
+            nullptr,  // executor
+            nullptr,  // oplogBuffer
+            &_observer,
+            ReplicationCoordinator::get(_opCtx.get()),
+            getConsistencyMarkers(),
+            getStorageInterface(),
+            repl::OplogApplier::Options(repl::OplogApplication::Mode::kSecondary),
+            _writerPool.get());
+    }
+
+    void tearDown() override {
+        _applier.reset();
+        _writerPool.reset();
+        OplogApplierImplTest::tearDown();
+    }
+
+    std::vector<OplogEntry> makeInserts(unsigned secs, int n) {
+        std::vector<OplogEntry> ops;
+        for (int i = 1; i <= n; i++) {
+            const auto id = static_cast<int>(secs * 100 + i);
+            ops.push_back(
+                makeInsertDocumentOplogEntry({Timestamp(secs, i), 1LL}, _nss, BSON("_id" << id)));
+        }
+        return ops;
+    }
+
+    long long countOplogEntriesFrom(Timestamp ts) {
+        DBDirectClient client(_opCtx.get());
+        return client.count(NamespaceString::kRsOplogNamespace, BSON("ts" << BSON("$gte" << ts)));
+    }
+
+    const NamespaceString _nss{"test.pipeline"};
+    NoopOplogApplierObserver _observer;
+    std::unique_ptr<ThreadPool> _writerPool;
+    std::unique_ptr<PipelineTrackOpsAppliedApplier> _applier;
+};
+
+TEST_F(OplogApplierImplPipelineTest, NextBatchIsWrittenToOplogWhileCurrentBatchIsApplied) {
+    auto currentOps = makeInserts(1, 3);
+    auto nextOps = makeInserts(2, 3);
+    _applier->setNextBatch(nextOps);
+
+    ASSERT_EQ(currentOps.back().getOpTime(),
+              unittest::assertGet(
+                  _applier->applyOplogBatchPipelined_forTest(_opCtx.get(), currentOps)));
+
+    // The next batch is in the oplog and assigned to writers, but not applied yet. Recovery would
+    // truncate it and replay the current batch.
+    ASSERT_TRUE(_applier->isNextBatchPrepared_forTest());
+    ASSERT_EQ(3, countOplogEntriesFrom(nextOps.front().getTimestamp()));
+    ASSERT_EQ(currentOps.size(), _applier->getOperationsApplied().size());
+    auto consistencyMarkers = getConsistencyMarkers();
+    ASSERT_EQ(currentOps.back().getTimestamp(),
+              consistencyMarkers->getOplogTruncateAfterPoint(_opCtx.get()));
+    ASSERT_EQ(currentOps.back().getOpTime(), consistencyMarkers->getMinValid(_opCtx.get()));
+
+    ASSERT_EQ(nextOps.back().getOpTime(),
+              unittest::assertGet(_applier->applyPipelinedBatch_forTest(_opCtx.get())));
+    ASSERT_FALSE(_applier->isNextBatchPrepared_forTest());
+    ASSERT_EQ(3, countOplogEntriesFrom(nextOps.front().getTimestamp()));
+    ASSERT_EQ(currentOps.size() + nextOps.size(), _applier->getOperationsApplied().size());
+    ASSERT_EQ(Timestamp(), consistencyMarkers->getOplogTruncateAfterPoint(_opCtx.get()));
+    ASSERT_EQ(nextOps.back().getOpTime(), consistencyMarkers->getMinValid(_opCtx.get()));
+}
+
+TEST_F(OplogApplierImplPipelineTest, FailureMidPipelineLeavesNextBatchToBeTruncated) {
+    auto currentOps = makeInserts(1, 3);
+    auto nextOps = makeInserts(2, 3);
+    _applier->setNextBatch(nextOps);
+    _applier->failure = Status(ErrorCodes::OperationFailed, "failing the current batch");
+
+    ASSERT_EQ(ErrorCodes::OperationFailed,
+              _applier->applyOplogBatchPipelined_forTest(_opCtx.get(), currentOps).getStatus());
+
+    // Both batches are in the oplog, but minValid only covers the current batch and the oplog is
+    // truncated after it on recovery, which then replays the current batch.
+    ASSERT_EQ(3, countOplogEntriesFrom(nextOps.front().getTimestamp()));
+    auto consistencyMarkers = getConsistencyMarkers();
+    ASSERT_EQ(currentOps.back().getTimestamp(),
+              consistencyMarkers->getOplogTruncateAfterPoint(_opCtx.get()));
+    ASSERT_EQ(currentOps.back().getOpTime(), consistencyMarkers->getMinValid(_opCtx.get()));
+    ASSERT_TRUE(_applier->getOperationsApplied().empty());
+}
+
+TEST_F(OplogApplierImplPipelineTest, BatchWithCommandIsNotPipelined) {
+    auto currentOps = makeInserts(1, 3);
+    auto command = makeCommandOplogEntry(
+        {Timestamp(2, 1), 1LL}, NamespaceString("test.$cmd"), BSON("create" << "other"));
+    _applier->setNextBatch({command});
+
+    ASSERT_EQ(currentOps.back().getOpTime(),
+              unittest::assertGet(
+                  _applier->applyOplogBatchPipelined_forTest(_opCtx.get(), currentOps)));
+
+    // The command is taken from the batcher but written and applied on its own afterwards.
+    ASSERT_FALSE(_applier->isNextBatchPrepared_forTest());
+    ASSERT_EQ(0, countOplogEntriesFrom(command.getTimestamp()));
+    ASSERT_EQ(Timestamp(), getConsistencyMarkers()->getOplogTruncateAfterPoint(_opCtx.get()));
+
+    ASSERT_EQ(command.getOpTime(),
+              unittest::assertGet(_applier->applyPipelinedBatch_forTest(_opCtx.get())));
+    ASSERT_EQ(1, countOplogEntriesFrom(command.getTimestamp()));
+}
+
 class MultiOplogEntryOplogApplierImplTest : public OplogApplierImplTest {
 public:
     MultiOplogEntryOplogApplierImplTest()
@@ -1245,6 +1390,147 @@ TEST_F(MultiOplogEntryPreparedTransactionTest, MultiApplyPreparedTransactionReco
                   DurableTxnStateEnum::kCommitted);
 }
 
+TEST_F(MultiOplogEntryPreparedTransactionTest,
+       MultiApplyPreparedTransactionRecoveryWithoutSplittingAcrossWriters) {
+    RAIIServerParameterControllerForTest splitPreparedTransactions{
+        "oplogApplicationSplitPreparedTransactionsInRecovery", false};
+
+    // For recovery, the oplog must contain the operations before starting.
+    for (auto&& entry :
+         {*_insertOp1, *_insertOp2, *_prepareWithPrevOp, *_commitPrepareWithPrevOp}) {
+        ASSERT_OK(getStorageInterface()->insertDocument(
+            _opCtx.get(),
+            NamespaceString::kRsOplogNamespace,
+            {entry.getEntry().toBSON(), entry.getOpTime().getTimestamp()},
+            entry.getOpTime().getTerm()));
+    }
+    // Ignore docs inserted into oplog in setup.
+    oplogDocs().clear();
+
+    NoopOplogApplierObserver observer;
+    OplogApplierImpl oplogApplier(
+        nullptr,  // executor
+        nullptr,  // oplogBuffer
+        &observer,
+        ReplicationCoordinator::get(_opCtx.get()),
+        getConsistencyMarkers(),
+        getStorageInterface(),
+        repl::OplogApplier::Options(repl::OplogApplication::Mode::kRecovering),
+        _writerPool.get());
+
+    ASSERT_OK(oplogApplier.applyOplogBatch(_opCtx.get(), {*_insertOp1, *_insertOp2}));
+    ASSERT_OK(oplogApplier.applyOplogBatch(_opCtx.get(), {*_prepareWithPrevOp}));
+    ASSERT_TRUE(_insertedDocs[_nss1].empty());
+    ASSERT_TRUE(_insertedDocs[_nss2].empty());
+
+    // The commit applies the whole transaction on a single writer.
+    ASSERT_OK(oplogApplier.applyOplogBatch(_opCtx.get(), {*_commitPrepareWithPrevOp}));
+    ASSERT_TRUE(oplogDocs().empty());
+    ASSERT_EQ(1U, _insertedDocs[_nss1].size());
+    ASSERT_EQ(2U, _insertedDocs[_nss2].size());
+    checkTxnTable(_lsid,
+                  _txnNum,
+                  _commitPrepareWithPrevOp->getOpTime(),
+                  _commitPrepareWithPrevOp->getWallClockTime(),
+                  boost::none,
+                  DurableTxnStateEnum::kCommitted);
+}
+
+TEST_F(MultiOplogEntryPreparedTransactionTest,
+       MultiApplyPreparedTransactionRecoverySplitsAcrossWritersAtCommitTimestamp) {
+    RAIIServerParameterControllerForTest splitPreparedTransactions{
+        "oplogApplicationSplitPreparedTransactionsInRecovery", true};
+
+    // Enough documents for the transaction to hash to more than one writer.
+    const int numDocs = 20;
+    BSONArrayBuilder applyOpsBuilder;
+    for (int i = 0; i < numDocs; i++) {
+        applyOpsBuilder.append(BSON("op"
+                                    << "i"
+                                    << "ns" << _nss1.ns() << "ui" << *_uuid1 << "o"
+                                    << BSON("_id" << i)));
+    }
+    auto prepareOp = makeCommandOplogEntryWithSessionInfoAndStmtIds(
+        {Timestamp(Seconds(1), 3), 1LL},
+        _nss1,
+        BSON("applyOps" << applyOpsBuilder.arr() << "prepare" << true),
+        _lsid,
+        _txnNum,
+        {StmtId(0)},
+        OpTime());
+    const Timestamp commitTimestamp(Seconds(1), 4);
+    auto commitOp = makeCommandOplogEntryWithSessionInfoAndStmtIds(
+        {Timestamp(Seconds(1), 5), 1LL},
+        _nss1,
+        BSON("commitTransaction" << 1 << "commitTimestamp" << commitTimestamp),
+        _lsid,
+        _txnNum,
+        {StmtId(1)},
+        prepareOp.getOpTime());
+
+    // For recovery, the oplog must contain the operations before starting.
+    for (auto&& entry : {prepareOp, commitOp}) {
+        ASSERT_OK(getStorageInterface()->insertDocument(
+            _opCtx.get(),
+            NamespaceString::kRsOplogNamespace,
+            {entry.getEntry().toBSON(), entry.getOpTime().getTimestamp()},
+            entry.getOpTime().getTerm()));
+    }
+
+    // Record which operation inserted each document, and the timestamps its storage transaction
+    // was prepared and committed at.
+    Mutex mutex = MONGO_MAKE_LATCH("SplitPreparedTransactionTest::mutex");
+    std::set<OperationId> writerOpIds;
+    std::vector<std::pair<Timestamp, Timestamp>> committedTimestamps;
+    _opObserver->onInsertsFn =
+        [&](OperationContext* opCtx, const NamespaceString& nss, const std::vector<BSONObj>& docs) {
+            if (nss != _nss1) {
+                return;
+            }
+            stdx::lock_guard<Latch> lock(mutex);
+            writerOpIds.insert(opCtx->getOpID());
+            for (size_t i = 0; i < docs.size(); i++) {
+                opCtx->recoveryUnit()->onCommit([&, opCtx](boost::optional<Timestamp>) {
+                    stdx::lock_guard<Latch> lock(mutex);
+                    committedTimestamps.emplace_back(
+                        opCtx->recoveryUnit()->getPrepareTimestamp(),
+                        opCtx->recoveryUnit()->getCommitTimestamp());
+                });
+            }
+        };
+
+    NoopOplogApplierObserver observer;
+    OplogApplierImpl oplogApplier(
+        nullptr,  // executor
+        nullptr,  // oplogBuffer
+        &observer,
+        ReplicationCoordinator::get(_opCtx.get()),
+        getConsistencyMarkers(),
+        getStorageInterface(),
+        repl::OplogApplier::Options(repl::OplogApplication::Mode::kRecovering),
+        _writerPool.get());
+
+    ASSERT_OK(oplogApplier.applyOplogBatch(_opCtx.get(), {prepareOp}));
+    ASSERT_TRUE(writerOpIds.empty());
+
+    // The commit applies the transaction in several storage transactions, each on its own writer
+    // operation, all prepared and committed at the transaction's commit timestamp.
+    ASSERT_OK(oplogApplier.applyOplogBatch(_opCtx.get(), {commitOp}));
+    ASSERT_GT(writerOpIds.size(), 1U);
+    ASSERT_EQ(0U, writerOpIds.count(_opCtx->getOpID()));
+    ASSERT_EQ(static_cast<size_t>(numDocs), committedTimestamps.size());
+    for (auto&& [prepareTimestamp, docCommitTimestamp] : committedTimestamps) {
+        ASSERT_EQ(commitTimestamp, prepareTimestamp);
+        ASSERT_EQ(commitTimestamp, docCommitTimestamp);
+    }
+    checkTxnTable(_lsid,
+                  _txnNum,
+                  commitOp.getOpTime(),
+                  commitOp.getWallClockTime(),
+                  boost::none,
+                  DurableTxnStateEnum::kCommitted);
+}
+
 TEST_F(MultiOplogEntryPreparedTransactionTest, MultiApplySingleApplyOpsPreparedTransaction) {
     NoopOplogApplierObserver observer;
     OplogApplierImpl oplogApplier(
@@ -2512,6 +2798,52 @@ TEST_F(OplogApplierImplTest, SerializeOplogApplicationOfWritesToTenantMigrationN
     ASSERT_BSONOBJ_EQ(opsToApply[3].getEntry().toBSON(), applied[3].getEntry().toBSON());
 }
 
+TEST_F(OplogApplierImplTest, MultiApplyWithManyPartitionsPreservesOrderOfWritesToSameDocument) {
+    RAIIServerParameterControllerForTest partitionsPerWriter{"oplogApplicationPartitionsPerWriter",
+                                                             8};
+    auto writerPool = makeReplWriterPool();
+    NoopOplogApplierObserver observer;
+    TrackOpsAppliedApplier oplogApplier(
+        nullptr,  // executor
+        nullptr,  // oplogBuffer
+        &observer,
+        ReplicationCoordinator::get(_opCtx.get()),
+        getConsistencyMarkers(),
+        getStorageInterface(),
+        repl::OplogApplier::Options(repl::OplogApplication::Mode::kSecondary),
+        writerPool.get());
+
+    const NamespaceString nss("test.t");
+    const int kNumDocs = 32;
+    std::vector<OplogEntry> opsToApply;
+    for (int i = 0; i < kNumDocs; i++) {
+        opsToApply.push_back(makeInsertDocumentOplogEntry(
+            {Timestamp(Seconds(i + 1), 0), 1LL}, nss, BSON("_id" << i)));
+    }
+    for (int i = 0; i < kNumDocs; i++) {
+        opsToApply.push_back(makeDeleteDocumentOplogEntry(
+            {Timestamp(Seconds(kNumDocs + i + 1), 0), 1LL}, nss, BSON("_id" << i)));
+    }
+
+    ASSERT_OK(oplogApplier.applyOplogBatch(_opCtx.get(), opsToApply));
+    const auto applied = oplogApplier.getOperationsApplied();
+    ASSERT_EQ(opsToApply.size(), applied.size());
+
+    // Writes to different documents may be applied in any order, but each document must see its
+    // insert before its delete.
+    stdx::unordered_map<int, OpTypeEnum> lastOpTypeById;
+    for (const auto& op : applied) {
+        auto id = op.getIdElement().numberInt();
+        if (op.getOpType() == OpTypeEnum::kInsert) {
+            ASSERT_FALSE(lastOpTypeById.count(id));
+        } else {
+            ASSERT(lastOpTypeById[id] == OpTypeEnum::kInsert);
+        }
+        lastOpTypeById[id] = op.getOpType();
+    }
+    ASSERT_EQ(static_cast<size_t>(kNumDocs), lastOpTypeById.size());
+}
+
 
 class OplogApplierImplTxnTableTest : public OplogApplierImplTest {
 public:
@@ -70,6 +70,26 @@ OplogBatch OplogBatcher::getNextBatch(Seconds maxWaitTime) {
     return ops;
 }
 
+OplogBatch OplogBatcher::getNextBatchIfReady() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_ops.empty()) {
+        return OplogBatch(0);
+    }
+
+    OplogBatch ops = std::move(_ops);
+    _ops = OplogBatch(0);
+    _cv.notify_all();
+    return ops;
+}
+
+void OplogBatcher::setNextBatch_forTest(OplogBatch ops) {
+    invariant(!_thread);
+    stdx::lock_guard<Latch> lk(_mutex);
+    invariant(_ops.empty());
+    _ops = std::move(ops);
+    _cv.notify_all();
+}
+
 void OplogBatcher::startup(StorageInterface* storageInterface) {
     _thread = std::make_unique<stdx::thread>([this, storageInterface] { _run(storageInterface); });
 }
@@ -160,7 +180,7 @@ StatusWith<std::vector<OplogEntry>> OplogBatcher::getNextApplierBatch(
     std::vector<OplogEntry> ops;
     BSONObj op;
     while (_oplogBuffer->peek(opCtx, &op)) {
-        auto entry = OplogEntry(op);
+        auto entry = _parsePeekedEntry(op);
 
         // Check for oplog version change.
         if (entry.getVersion() != OplogEntry::kOplogVersion) {
@@ -186,6 +206,7 @@ StatusWith<std::vector<OplogEntry>> OplogBatcher::getNextApplierBatch(
                     // reconfigs and shutdown to occur.
                     sleepsecs(1);
                 }
+                _peekedEntry = std::move(entry);
                 return std::move(ops);
             }
         }
@@ -197,6 +218,7 @@ StatusWith<std::vector<OplogEntry>> OplogBatcher::getNextApplierBatch(
             }
 
             // Otherwise, apply what we have so far and come back for this entry.
+            _peekedEntry = std::move(entry);
             return std::move(ops);
         }
 
@@ -205,6 +227,7 @@ StatusWith<std::vector<OplogEntry>> OplogBatcher::getNextApplierBatch(
         auto opBytes = entry.getRawObjSizeBytes();
         if (totalOps > 0) {
             if (totalOps + opCount > batchLimits.ops || totalBytes + opBytes > batchLimits.bytes) {
+                _peekedEntry = std::move(entry);
                 return std::move(ops);
             }
         }
@@ -213,6 +236,7 @@ StatusWith<std::vector<OplogEntry>> OplogBatcher::getNextApplierBatch(
         if (totalOps > 0 && !batchLimits.forceBatchBoundaryAfter.isNull() &&
             entry.getOpTime().getTimestamp() > batchLimits.forceBatchBoundaryAfter &&
             ops.back().getOpTime().getTimestamp() <= batchLimits.forceBatchBoundaryAfter) {
+            _peekedEntry = std::move(entry);
             return std::move(ops);
         }
 
@@ -225,6 +249,16 @@ StatusWith<std::vector<OplogEntry>> OplogBatcher::getNextApplierBatch(
     return std::move(ops);
 }
 
+OplogEntry OplogBatcher::_parsePeekedEntry(const BSONObj& op) {
+    auto peekedEntry = std::exchange(_peekedEntry, boost::none);
+    // An owned document cannot be freed while the entry parsed from it shares its buffer, so the
+    // same address means the same document is still at the front of the buffer.
+    if (peekedEntry && op.isOwned() && peekedEntry->getEntry().getRaw().objdata() == op.objdata()) {
+        return std::move(*peekedEntry);
+    }
+    return OplogEntry(op);
+}
+
 /**
  * If slaveDelay is enabled, this function calculates the most recent timestamp of any oplog
  * entries that can be be returned in a batch.
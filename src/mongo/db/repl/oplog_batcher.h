@@ -151,6 +151,19 @@ public:
      */
     OplogBatch getNextBatch(Seconds maxWaitTime);
 
+    /**
+     * Returns the next batch of oplog entries if one is ready, without waiting. Unlike
+     * getNextBatch(), this never consumes a shutdown or drain signal, so the returned batch is
+     * either empty or holds oplog entries to apply.
+     */
+    OplogBatch getNextBatchIfReady();
+
+    /**
+     * Makes 'ops' the batch handed out next, as if the batcher thread had produced it. The
+     * batcher thread must not be running.
+     */
+    void setNextBatch_forTest(OplogBatch ops);
+
     /**
      * Starts up a thread to continuously pull from the OplogBuffer into the OplogBatcher's oplog
      * batch.
@@ -192,6 +205,12 @@ private:
      */
     boost::optional<Date_t> _calculateSlaveDelayLatestTimestamp();
 
+    /**
+     * Parses 'op', the operation at the front of the OplogBuffer. If the previous call to
+     * getNextApplierBatch() already parsed it before ending its batch, returns that entry instead.
+     */
+    OplogEntry _parsePeekedEntry(const BSONObj& op);
+
     /**
      * Pops the operation at the front of the OplogBuffer.
      */
@@ -210,6 +229,10 @@ private:
      */
     OplogBatch _ops;
 
+    // The entry at the front of the OplogBuffer that ended the last batch returned by
+    // getNextApplierBatch(). Only accessed by the single consumer of the OplogBuffer.
+    boost::optional<OplogEntry> _peekedEntry;
+
     std::unique_ptr<stdx::thread> _thread;
 };
 
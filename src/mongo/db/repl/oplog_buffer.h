@@ -190,6 +190,14 @@ public:
         size.increment(std::size_t(value.objsize()));
     }
 
+    /**
+     * Accounts for 'n' operations totalling 'bytes' in a single update of each counter.
+     */
+    void increment(std::size_t n, std::size_t bytes) {
+        count.increment(n);
+        size.increment(bytes);
+    }
+
     void decrement(const Value& value) {
         count.decrement(1);
         size.decrement(std::size_t(value.objsize()));
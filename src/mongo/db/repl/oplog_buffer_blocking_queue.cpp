@@ -69,9 +69,11 @@ void OplogBufferBlockingQueue::push(OperationContext*,
     _notEmptyCv.notify_one();
 
     if (_counters) {
+        std::size_t bytes = 0;
         for (auto i = begin; i != end; ++i) {
-            _counters->increment(*i);
+            bytes += getDocumentSize(*i);
         }
+        _counters->increment(std::distance(begin, end), bytes);
     }
 }
 
@@ -113,11 +115,12 @@ bool OplogBufferBlockingQueue::tryPop(OperationContext*, Value* value) {
 }
 
 bool OplogBufferBlockingQueue::waitForData(Seconds waitDuration) {
-    Value ignored;
+    // Emptiness is tracked atomically by the queue, so checking for data neither copies the front
+    // entry nor takes the queue lock that the fetcher and the batcher contend on.
     stdx::unique_lock<Latch> lk(_notEmptyMutex);
     _notEmptyCv.wait_for(
-        lk, waitDuration.toSystemDuration(), [&] { return _drainMode || _queue.peek(ignored); });
-    return _queue.peek(ignored);
+        lk, waitDuration.toSystemDuration(), [&] { return _drainMode || !_queue.empty(); });
+    return !_queue.empty();
 }
 
 bool OplogBufferBlockingQueue::peek(OperationContext*, Value* value) {
@@ -396,6 +396,91 @@ TEST_F(OplogTest, MigrationIdAddedToOplog) {
     ASSERT_EQ(migrationUuid, oplogEntry.getFromTenantMigration());
 }
 
+/**
+ * Returns all the entries of the oplog, keyed by their optime.
+ */
+std::map<OpTime, BSONObj> _getOplogEntriesByOpTime(OperationContext* opCtx) {
+    std::map<OpTime, BSONObj> entries;
+    OplogInterfaceLocal oplogInterface(opCtx);
+    auto oplogIter = oplogInterface.makeIterator();
+    while (true) {
+        auto next = oplogIter->next();
+        if (next.getStatus() == ErrorCodes::CollectionIsEmpty) {
+            return entries;
+        }
+        auto entry = unittest::assertGet(next).first.getOwned();
+        entries.emplace(unittest::assertGet(OpTime::parseFromOplogEntry(entry)), entry);
+    }
+}
+
+/**
+ * Logs inserts with logInsertOps() from 'oplogEntryTemplate', and checks that the oplog entries
+ * written are those MutableOplogEntry::toBSON() builds.
+ */
+void _logInsertOpsAndCheckEntries(OperationContext* opCtx, MutableOplogEntry oplogEntryTemplate) {
+    const NamespaceString nss("test.coll");
+    oplogEntryTemplate.setNss(nss);
+    oplogEntryTemplate.setUuid(UUID::gen());
+    oplogEntryTemplate.setWallClockTime(Date_t::now());
+
+    std::vector<InsertStatement> inserts;
+    std::vector<OpTime> opTimes;
+    OplogSlot reservedSlot;
+    {
+        AutoGetDb autoDb(opCtx, nss.db(), MODE_X);
+        WriteUnitOfWork wunit(opCtx);
+
+        // Mix statements with and without optimes reserved by the caller. The optime reserved
+        // first is the oldest, so the optimes are not in the order of the statements.
+        reservedSlot = getNextOpTimes(opCtx, 1U)[0];
+        inserts.emplace_back(BSON("_id" << 0 << "x" << std::string(1024, 'x')));
+        inserts.emplace_back(
+            std::vector<StmtId>{kUninitializedStmtId}, BSON("_id" << 1), reservedSlot);
+        inserts.emplace_back(BSON("_id" << 2));
+
+        opTimes = logInsertOps(opCtx,
+                               &oplogEntryTemplate,
+                               inserts.cbegin(),
+                               inserts.cend(),
+                               [&](const BSONObj& doc) -> boost::optional<ShardId> {
+                                   if (doc["_id"].numberInt() == 2) {
+                                       return ShardId("recipient");
+                                   }
+                                   return boost::none;
+                               });
+        wunit.commit();
+    }
+    ASSERT_EQUALS(inserts.size(), opTimes.size());
+    ASSERT_EQUALS(reservedSlot, opTimes[1]);
+
+    const auto entries = _getOplogEntriesByOpTime(opCtx);
+    ASSERT_EQUALS(inserts.size(), entries.size());
+    for (size_t i = 0; i < inserts.size(); i++) {
+        MutableOplogEntry expectedEntry = oplogEntryTemplate;
+        expectedEntry.setObject(inserts[i].doc);
+        expectedEntry.setOpTime(opTimes[i]);
+        if (i == 2) {
+            expectedEntry.setDestinedRecipient(ShardId("recipient"));
+        }
+        auto it = entries.find(opTimes[i]);
+        ASSERT(it != entries.end()) << "No oplog entry at " << opTimes[i];
+        ASSERT_BSONOBJ_EQ(expectedEntry.toBSON(), it->second);
+    }
+}
+
+TEST_F(OplogTest, LogInsertOpsWritesSameEntriesAsMutableOplogEntry) {
+    auto opCtx = cc().makeOperationContext();
+    _logInsertOpsAndCheckEntries(opCtx.get(), MutableOplogEntry());
+}
+
+TEST_F(OplogTest, LogInsertOpsKeepsTemplateFieldsBetweenObjectAndOpTime) {
+    // The entries cannot be built from a single serialization of such a template.
+    auto opCtx = cc().makeOperationContext();
+    MutableOplogEntry oplogEntryTemplate;
+    oplogEntryTemplate.setObject2(BSON("_id" << 0));
+    _logInsertOpsAndCheckEntries(opCtx.get(), oplogEntryTemplate);
+}
+
 }  // namespace
 }  // namespace repl
 }  // namespace mongo
@@ -68,6 +68,7 @@
 #include "mongo/db/repl/always_allow_non_local_writes.h"
 #include "mongo/db/repl/check_quorum_for_config_change.h"
 #include "mongo/db/repl/data_replicator_external_state_initial_sync.h"
+#include "mongo/db/repl/file_copy_based_initial_syncer.h"
 #include "mongo/db/repl/hello_response.h"
 #include "mongo/db/repl/isself.h"
 #include "mongo/db/repl/last_vote.h"
@@ -204,22 +205,52 @@ constexpr StringData kQuiesceModeShutdownMessage =
 
 }  // namespace
 
+ReplicationCoordinatorImpl::WaiterList::GroupKey
+ReplicationCoordinatorImpl::WaiterList::_makeGroupKey(
+    const boost::optional<WriteConcernOptions>& w) {
+    if (!w) {
+        return {std::string(), -1, -1, -1};
+    }
+    return {w->wMode,
+            w->wMode.empty() ? w->wNumNodes : 0,
+            static_cast<int>(w->syncMode),
+            static_cast<int>(w->checkCondition)};
+}
+
 void ReplicationCoordinatorImpl::WaiterList::add_inlock(const OpTime& opTime,
                                                         SharedWaiterHandle waiter) {
-    _waiters.emplace(opTime, std::move(waiter));
+    _groups[_makeGroupKey(waiter->writeConcern)].emplace(opTime, std::move(waiter));
 }
 
 SharedSemiFuture<void> ReplicationCoordinatorImpl::WaiterList::add_inlock(
     const OpTime& opTime, boost::optional<WriteConcernOptions> wc) {
-    auto pf = makePromiseFuture<void>();
-    _waiters.emplace(opTime, std::make_shared<Waiter>(std::move(pf.promise), std::move(wc)));
-    return std::move(pf.future);
+    auto& group = _groups[_makeGroupKey(wc)];
+    auto range = group.equal_range(opTime);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second->shareable) {
+            return it->second->promise.getFuture();
+        }
+    }
+
+    auto waiter = std::make_shared<Waiter>(std::move(wc));
+    waiter->shareable = true;
+    auto future = waiter->promise.getFuture();
+    group.emplace_hint(range.second, opTime, std::move(waiter));
+    return future;
 }
 
 bool ReplicationCoordinatorImpl::WaiterList::remove_inlock(SharedWaiterHandle waiter) {
-    for (auto iter = _waiters.begin(); iter != _waiters.end(); iter++) {
+    auto groupIt = _groups.find(_makeGroupKey(waiter->writeConcern));
+    if (groupIt == _groups.end()) {
+        return false;
+    }
+    auto& group = groupIt->second;
+    for (auto iter = group.begin(); iter != group.end(); iter++) {
         if (iter->second == waiter) {
-            _waiters.erase(iter);
+            group.erase(iter);
+            if (group.empty()) {
+                _groups.erase(groupIt);
+            }
             return true;
         }
     }
@@ -229,35 +260,43 @@ bool ReplicationCoordinatorImpl::WaiterList::remove_inlock(SharedWaiterHandle wa
 template <typename Func>
 void ReplicationCoordinatorImpl::WaiterList::setValueIf_inlock(Func&& func,
                                                                boost::optional<OpTime> opTime) {
-    for (auto it = _waiters.begin(); it != _waiters.end() && (!opTime || it->first <= *opTime);) {
-        const auto& waiter = it->second;
-        try {
-            if (func(it->first, waiter)) {
+    for (auto groupIt = _groups.begin(); groupIt != _groups.end();) {
+        auto& group = groupIt->second;
+        for (auto it = group.begin(); it != group.end() && (!opTime || it->first <= *opTime);) {
+            const auto& waiter = it->second;
+            try {
+                if (!func(it->first, waiter)) {
+                    // No waiter of this group with an equal or later opTime can be satisfied.
+                    break;
+                }
                 waiter->promise.emplaceValue();
-                it = _waiters.erase(it);
-            } else {
-                ++it;
+                it = group.erase(it);
+            } catch (const DBException& e) {
+                waiter->promise.setError(e.toStatus());
+                it = group.erase(it);
             }
-        } catch (const DBException& e) {
-            waiter->promise.setError(e.toStatus());
-            it = _waiters.erase(it);
         }
+        groupIt = group.empty() ? _groups.erase(groupIt) : std::next(groupIt);
     }
 }
 
 void ReplicationCoordinatorImpl::WaiterList::setValueAll_inlock() {
-    for (auto& [opTime, waiter] : _waiters) {
-        waiter->promise.emplaceValue();
+    for (auto& [key, group] : _groups) {
+        for (auto& [opTime, waiter] : group) {
+            waiter->promise.emplaceValue();
+        }
     }
-    _waiters.clear();
+    _groups.clear();
 }
 
 void ReplicationCoordinatorImpl::WaiterList::setErrorAll_inlock(Status status) {
     invariant(!status.isOK());
-    for (auto& [opTime, waiter] : _waiters) {
-        waiter->promise.setError(status);
+    for (auto& [key, group] : _groups) {
+        for (auto& [opTime, waiter] : group) {
+            waiter->promise.setError(status);
+        }
     }
-    _waiters.clear();
+    _groups.clear();
 }
 
 namespace {
@@ -427,6 +466,13 @@ bool ReplicationCoordinatorImpl::_startLoadLocalConfig(
     // matches the collection contents.
     _replicationProcess->getConsistencyMarkers()->ensureFastCountOnOplogTruncateAfterPoint(opCtx);
 
+    // Files copied by a file copy based initial sync are only consistent up to the point their
+    // backup was extended to, recovery must truncate the oplog entries after it.
+    if (!storageGlobalParams.readOnly) {
+        FileCopyBasedInitialSyncer::setStagedOplogTruncateAfterPoint(
+            opCtx, _replicationProcess->getConsistencyMarkers(), storageGlobalParams.dbpath);
+    }
+
     _replicationProcess->getConsistencyMarkers()->initializeMinValidDocument(opCtx);
 
     fassert(51240, _externalState->createLocalLastVoteCollection(opCtx));
@@ -776,7 +822,7 @@ void ReplicationCoordinatorImpl::_startDataReplication(OperationContext* opCtx,
         LOGV2_DEBUG(4853000, 1, "initial sync complete.");
     };
 
-    std::shared_ptr<InitialSyncer> initialSyncerCopy;
+    std::shared_ptr<InitialSyncerInterface> initialSyncerCopy;
     try {
         {
             // Must take the lock to set _initialSyncer, but not call it.
@@ -785,14 +831,28 @@ void ReplicationCoordinatorImpl::_startDataReplication(OperationContext* opCtx,
                 LOGV2(21326, "Initial Sync not starting because replication is shutting down");
                 return;
             }
-            initialSyncerCopy = std::make_shared<InitialSyncer>(
-                createInitialSyncerOptions(this, _externalState.get()),
-                std::make_unique<DataReplicatorExternalStateInitialSync>(this,
-                                                                         _externalState.get()),
-                _externalState->getDbWorkThreadPool(),
-                _storage,
-                _replicationProcess,
-                onCompletion);
+            auto createLogicalInitialSyncer = [this, onCompletion] {
+                return std::make_shared<InitialSyncer>(
+                    createInitialSyncerOptions(this, _externalState.get()),
+                    std::make_unique<DataReplicatorExternalStateInitialSync>(this,
+                                                                             _externalState.get()),
+                    _externalState->getDbWorkThreadPool(),
+                    _storage,
+                    _replicationProcess,
+                    onCompletion);
+            };
+            if (initialSyncMethod == "fileCopyBased") {
+                initialSyncerCopy = std::make_shared<FileCopyBasedInitialSyncer>(
+                    createInitialSyncerOptions(this, _externalState.get()),
+                    createLogicalInitialSyncer);
+            } else {
+                if (initialSyncMethod != "logical") {
+                    LOGV2_WARNING(5904521,
+                                  "Unknown initial sync method, using logical initial sync",
+                                  "initialSyncMethod"_attr = initialSyncMethod);
+                }
+                initialSyncerCopy = createLogicalInitialSyncer();
+            }
             _initialSyncer = initialSyncerCopy;
         }
         // InitialSyncer::startup() must be called outside lock because it uses features (eg.
@@ -935,7 +995,7 @@ void ReplicationCoordinatorImpl::shutdown(OperationContext* opCtx) {
     LOGV2(21328, "Shutting down replication subsystems");
 
     // Used to shut down outside of the lock.
-    std::shared_ptr<InitialSyncer> initialSyncerCopy;
+    std::shared_ptr<InitialSyncerInterface> initialSyncerCopy;
     {
         stdx::unique_lock<Latch> lk(_mutex);
         fassert(28533, !_inShutdown);
@@ -2986,7 +3046,7 @@ Status ReplicationCoordinatorImpl::processReplSetGetStatus(
 
     BSONObj initialSyncProgress;
     if (responseStyle == ReplSetGetStatusResponseStyle::kInitialSync) {
-        std::shared_ptr<InitialSyncer> initialSyncerCopy;
+        std::shared_ptr<InitialSyncerInterface> initialSyncerCopy;
         {
             stdx::lock_guard<Latch> lk(_mutex);
             initialSyncerCopy = _initialSyncer;
@@ -3217,7 +3277,7 @@ Status ReplicationCoordinatorImpl::processReplSetSyncFrom(OperationContext* opCt
                                                           const HostAndPort& target,
                                                           BSONObjBuilder* resultObj) {
     Status result(ErrorCodes::InternalError, "didn't set status in prepareSyncFromResponse");
-    std::shared_ptr<InitialSyncer> initialSyncerCopy;
+    std::shared_ptr<InitialSyncerInterface> initialSyncerCopy;
     {
         stdx::lock_guard<Latch> lk(_mutex);
         _topCoord->prepareSyncFromResponse(target, resultObj, &result);
@@ -4475,9 +4535,8 @@ void ReplicationCoordinatorImpl::CatchupState::signalHeartbeatUpdate_inlock() {
             abort_inlock(PrimaryCatchUpConclusionReason::kSucceeded);
         }
     };
-    auto pf = makePromiseFuture<void>();
-    _waiter = std::make_shared<Waiter>(std::move(pf.promise));
-    auto future = std::move(pf.future).onCompletion(targetOpTimeCB);
+    _waiter = std::make_shared<Waiter>();
+    auto future = _waiter->promise.getFuture().unsafeToInlineFuture().onCompletion(targetOpTimeCB);
     _repl->_opTimeWaiterList.add_inlock(_targetOpTime, _waiter);
 }
 
@@ -5587,9 +5646,8 @@ void ReplicationCoordinatorImpl::createWMajorityWriteAvailabilityDateWaiter(OpTi
         return;
     }
 
-    auto pf = makePromiseFuture<void>();
-    auto waiter = std::make_shared<Waiter>(std::move(pf.promise), writeConcern);
-    auto future = std::move(pf.future).onCompletion(setOpTimeCB);
+    auto waiter = std::make_shared<Waiter>(writeConcern);
+    auto future = waiter->promise.getFuture().unsafeToInlineFuture().onCompletion(setOpTimeCB);
     _replicationWaiterList.add_inlock(opTime, waiter);
 }
 
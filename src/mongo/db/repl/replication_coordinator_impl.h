@@ -31,6 +31,8 @@
 
 #include <map>
 #include <memory>
+#include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -678,14 +680,25 @@ private:
     };
 
     struct Waiter {
-        Promise<void> promise;
+        SharedPromise<void> promise;
         boost::optional<WriteConcernOptions> writeConcern;
-        explicit Waiter(Promise<void> p, boost::optional<WriteConcernOptions> w = boost::none)
-            : promise(std::move(p)), writeConcern(w) {}
+        // Whether further waiters for the same OpTime and write concern may share this promise.
+        // Waiters whose handles are held outside of the WaiterList can be removed individually
+        // and are never shared.
+        bool shareable = false;
+        explicit Waiter(boost::optional<WriteConcernOptions> w = boost::none)
+            : writeConcern(std::move(w)) {}
     };
 
     using SharedWaiterHandle = std::shared_ptr<Waiter>;
 
+    /**
+     * Waiters are grouped by the parts of their write concern that determine when they are
+     * satisfied, and each group is kept sorted by OpTime. Whether a waiter is satisfied is
+     * monotonic in OpTime within a group, so signalling stops at the first waiter of each group
+     * that is not yet satisfied instead of evaluating every waiter at or below the given OpTime.
+     * Waiters for the same OpTime and write concern share a single promise.
+     */
     class WaiterList {
     public:
         // Adds waiter into the list.
@@ -695,8 +708,9 @@ private:
                                           boost::optional<WriteConcernOptions> w = boost::none);
         // Returns whether waiter is found and removed.
         bool remove_inlock(SharedWaiterHandle waiter);
-        // Signals all waiters whose opTime is <= the given opTime (if any) that satisfy the
-        // condition in func.
+        // Signals waiters whose opTime is <= the given opTime (if any) that satisfy the condition
+        // in func. The condition must only depend on the waiter's opTime and the grouped write
+        // concern fields, and must not hold for an opTime once it fails for a lower one.
         template <typename Func>
         void setValueIf_inlock(Func&& func, boost::optional<OpTime> opTime = boost::none);
         // Signals all waiters from the list and fulfills promises with OK status.
@@ -705,8 +719,15 @@ private:
         void setErrorAll_inlock(Status status);
 
     private:
-        // Waiters sorted by OpTime.
-        std::multimap<OpTime, SharedWaiterHandle> _waiters;
+        // The write concern fields that _doneWaitingForReplication_inlock depends on: wMode,
+        // wNumNodes, syncMode and checkCondition.
+        using GroupKey = std::tuple<std::string, int, int, int>;
+        // Waiters of one group sorted by OpTime.
+        using Group = std::multimap<OpTime, SharedWaiterHandle>;
+
+        static GroupKey _makeGroupKey(const boost::optional<WriteConcernOptions>& w);
+
+        std::map<GroupKey, Group> _groups;
     };
 
     enum class HeartbeatState { kScheduled = 0, kSent = 1 };
@@ -1632,7 +1653,7 @@ private:
     // Storage interface used by initial syncer.
     StorageInterface* _storage;  // (PS)
     // InitialSyncer used for initial sync.
-    std::shared_ptr<InitialSyncer>
+    std::shared_ptr<InitialSyncerInterface>
         _initialSyncer;  // (I) pointer set under mutex, copied by callers.
 
     // The non-null OpTime used for committed reads, if there is one.
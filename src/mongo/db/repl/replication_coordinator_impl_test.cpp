@@ -1124,6 +1124,63 @@ TEST_F(ReplCoordTest, NodeReturnsOkWhenAWriteConcernWithNoTimeoutHasBeenSatisfie
 }
 
 
+TEST_F(ReplCoordTest, AsyncReplicationWaitersAreSignaledPerWriteConcernInOpTimeOrder) {
+    assertStartSuccess(BSON("_id"
+                            << "mySet"
+                            << "version" << 2 << "members"
+                            << BSON_ARRAY(BSON("host"
+                                               << "node1:12345"
+                                               << "_id" << 0)
+                                          << BSON("host"
+                                                  << "node2:12345"
+                                                  << "_id" << 1)
+                                          << BSON("host"
+                                                  << "node3:12345"
+                                                  << "_id" << 2))),
+                       HostAndPort("node1", 12345));
+    ASSERT_OK(getReplCoord()->setFollowerMode(MemberState::RS_SECONDARY));
+    replCoordSetMyLastAppliedOpTime(OpTimeWithTermOne(100, 1), Date_t() + Seconds(100));
+    replCoordSetMyLastDurableOpTime(OpTimeWithTermOne(100, 1), Date_t() + Seconds(100));
+    simulateSuccessfulV1Election();
+
+    OpTimeWithTermOne time1(100, 2);
+    OpTimeWithTermOne time2(100, 3);
+    replCoordSetMyLastAppliedOpTime(time2, Date_t() + Seconds(100));
+    replCoordSetMyLastDurableOpTime(time2, Date_t() + Seconds(100));
+
+    WriteConcernOptions twoNodes;
+    twoNodes.wTimeout = WriteConcernOptions::kNoTimeout;
+    twoNodes.wNumNodes = 2;
+    WriteConcernOptions threeNodes = twoNodes;
+    threeNodes.wNumNodes = 3;
+
+    auto twoNodesTime1 = getReplCoord()->awaitReplicationAsyncNoWTimeout(time1, twoNodes);
+    auto twoNodesTime1Again = getReplCoord()->awaitReplicationAsyncNoWTimeout(time1, twoNodes);
+    auto twoNodesTime2 = getReplCoord()->awaitReplicationAsyncNoWTimeout(time2, twoNodes);
+    auto threeNodesTime1 = getReplCoord()->awaitReplicationAsyncNoWTimeout(time1, threeNodes);
+
+    // Only the waiters for time1 with a two node write concern are satisfied.
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 1, time1));
+    ASSERT_OK(getReplCoord()->setLastDurableOptime_forTest(2, 1, time1));
+    ASSERT_TRUE(twoNodesTime1.isReady());
+    ASSERT_OK(twoNodesTime1.getNoThrow());
+    ASSERT_TRUE(twoNodesTime1Again.isReady());
+    ASSERT_OK(twoNodesTime1Again.getNoThrow());
+    ASSERT_FALSE(twoNodesTime2.isReady());
+    ASSERT_FALSE(threeNodesTime1.isReady());
+
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 2, time1));
+    ASSERT_OK(getReplCoord()->setLastDurableOptime_forTest(2, 2, time1));
+    ASSERT_FALSE(twoNodesTime2.isReady());
+    ASSERT_TRUE(threeNodesTime1.isReady());
+    ASSERT_OK(threeNodesTime1.getNoThrow());
+
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 1, time2));
+    ASSERT_OK(getReplCoord()->setLastDurableOptime_forTest(2, 1, time2));
+    ASSERT_TRUE(twoNodesTime2.isReady());
+    ASSERT_OK(twoNodesTime2.getNoThrow());
+}
+
 TEST_F(ReplCoordTest, NodeCalculatesDefaultWriteConcernOnStartupExistingLocalConfigMajority) {
     assertStartSuccess(BSON("_id"
                             << "mySet"
@@ -35,7 +35,10 @@
 
 #include "mongo/db/repl/replication_recovery.h"
 
+#include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/catalog/document_validation.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/namespace_string.h"
@@ -55,6 +58,9 @@
 #include "mongo/db/transaction_history_iterator.h"
 #include "mongo/db/transaction_participant.h"
 #include "mongo/logv2/log.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -68,11 +74,84 @@ namespace {
 const auto kRecoveryBatchLogLevel = logv2::LogSeverity::Debug(2);
 const auto kRecoveryOperationLogLevel = logv2::LogSeverity::Debug(3);
 
+// How often the progress of recovery oplog application is logged.
+const Seconds kRecoveryProgressLogInterval{10};
+
+/**
+ * Progress of the recovery oplog application in progress, if any, reported in serverStatus as
+ * metrics.repl.recovery.
+ */
+struct RecoveryProgress {
+    bool inProgress = false;
+    Timestamp startPoint;
+    Timestamp endPoint;
+    Timestamp lastApplied;
+    long long numOpsApplied = 0;
+    long long numBatches = 0;
+    long long elapsedMillis = 0;
+    boost::optional<long long> estimatedMillisRemaining;
+
+    /**
+     * Estimates the time left from the share of the timestamp range from 'startPoint' to
+     * 'endPoint' applied so far, assuming writes were spread evenly over it.
+     */
+    void estimateRemaining() {
+        const double total = endPoint.getSecs() - startPoint.getSecs();
+        const double applied = lastApplied.getSecs() - startPoint.getSecs();
+        if (total <= 0 || applied <= 0) {
+            estimatedMillisRemaining = boost::none;
+            return;
+        }
+        estimatedMillisRemaining =
+            static_cast<long long>(elapsedMillis * (total - applied) / applied);
+    }
+
+    void append(BSONObjBuilder* builder) const {
+        builder->append("inProgress", inProgress);
+        builder->append("startPoint", startPoint);
+        builder->append("endPoint", endPoint);
+        builder->append("lastApplied", lastApplied);
+        builder->append("numOpsApplied", numOpsApplied);
+        builder->append("numBatches", numBatches);
+        builder->append("elapsedMillis", elapsedMillis);
+        if (estimatedMillisRemaining) {
+            builder->append("estimatedMillisRemaining", *estimatedMillisRemaining);
+        }
+    }
+};
+
+Mutex recoveryProgressMutex = MONGO_MAKE_LATCH("recoveryProgressMutex");
+RecoveryProgress recoveryProgress;
+
+class RecoveryProgressSSM final : public ServerStatusMetric {
+public:
+    RecoveryProgressSSM() : ServerStatusMetric("repl.recovery") {}
+
+    void appendAtLeaf(BSONObjBuilder& b) const final {
+        b.append(_leafName, ReplicationRecoveryImpl::getRecoveryProgress());
+    }
+} recoveryProgressSSM;
+
 /**
  * Tracks and logs operations applied during recovery.
  */
 class RecoveryOplogApplierStats : public OplogApplier::Observer {
 public:
+    RecoveryOplogApplierStats(Timestamp startPoint, Timestamp endPoint) {
+        stdx::lock_guard<Latch> lk(recoveryProgressMutex);
+        recoveryProgress = RecoveryProgress();
+        recoveryProgress.inProgress = true;
+        recoveryProgress.startPoint = startPoint;
+        recoveryProgress.endPoint = endPoint;
+        recoveryProgress.lastApplied = startPoint;
+    }
+
+    ~RecoveryOplogApplierStats() {
+        stdx::lock_guard<Latch> lk(recoveryProgressMutex);
+        recoveryProgress.inProgress = false;
+        recoveryProgress.estimatedMillisRemaining = boost::none;
+    }
+
     void onBatchBegin(const std::vector<OplogEntry>& batch) final {
         _numBatches++;
         LOGV2_FOR_RECOVERY(24098,
@@ -106,7 +185,31 @@ public:
         }
     }
 
-    void onBatchEnd(const StatusWith<OpTime>&, const std::vector<OplogEntry>&) final {}
+    void onBatchEnd(const StatusWith<OpTime>& lastApplied, const std::vector<OplogEntry>&) final {
+        if (!lastApplied.isOK()) {
+            return;
+        }
+
+        RecoveryProgress progress;
+        {
+            stdx::lock_guard<Latch> lk(recoveryProgressMutex);
+            recoveryProgress.lastApplied = lastApplied.getValue().getTimestamp();
+            recoveryProgress.numOpsApplied = _numOpsApplied;
+            recoveryProgress.numBatches = _numBatches;
+            recoveryProgress.elapsedMillis = durationCount<Milliseconds>(_timer.elapsed());
+            recoveryProgress.estimateRemaining();
+            progress = recoveryProgress;
+        }
+
+        if (_timer.seconds() < _nextProgressLogSecs) {
+            return;
+        }
+        _nextProgressLogSecs =
+            _timer.seconds() + durationCount<Seconds>(kRecoveryProgressLogInterval);
+        BSONObjBuilder progressBob;
+        progress.append(&progressBob);
+        LOGV2(5904600, "Recovery oplog application progress", "progress"_attr = progressBob.obj());
+    }
 
     void complete(const OpTime& applyThroughOpTime) const {
         LOGV2(21536,
@@ -121,6 +224,9 @@ public:
 private:
     std::size_t _numBatches = 0;
     std::size_t _numOpsApplied = 0;
+
+    Timer _timer;
+    long long _nextProgressLogSecs = durationCount<Seconds>(kRecoveryProgressLogInterval);
 };
 
 /**
@@ -241,6 +347,144 @@ private:
     std::unique_ptr<DBClientCursor> _cursor;
 };
 
+/**
+ * Reads the batches of oplog entries to apply during recovery. With 'readAhead', the next batch is
+ * read from the oplog on a separate thread while the writer threads apply the current one, so
+ * that they do not sit idle while the oplog is scanned and parsed.
+ */
+class RecoveryOplogBatchReader {
+    RecoveryOplogBatchReader(const RecoveryOplogBatchReader&) = delete;
+    RecoveryOplogBatchReader& operator=(const RecoveryOplogBatchReader&) = delete;
+
+public:
+    RecoveryOplogBatchReader(OplogApplier* oplogApplier,
+                             OplogBufferLocalOplog* oplogBuffer,
+                             OplogApplier::BatchLimits batchLimits,
+                             bool readAhead)
+        : _oplogApplier(oplogApplier),
+          _oplogBuffer(oplogBuffer),
+          _batchLimits(batchLimits),
+          _readAhead(readAhead) {}
+
+    ~RecoveryOplogBatchReader() {
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _inShutdown = true;
+            _cond.notify_all();
+        }
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+    }
+
+    void startup(OperationContext* opCtx) {
+        if (!_readAhead) {
+            _oplogBuffer->startup(opCtx);
+            return;
+        }
+        _thread = stdx::thread([this] { _run(); });
+        stdx::unique_lock<Latch> lk(_mutex);
+        _cond.wait(lk, [&] { return _started; });
+    }
+
+    /**
+     * Returns the next batch to apply, or an empty batch once the end point has been reached.
+     */
+    std::vector<OplogEntry> getNextBatch(OperationContext* opCtx) {
+        if (!_readAhead) {
+            return fassert(50763, _oplogApplier->getNextApplierBatch(opCtx, _batchLimits));
+        }
+        stdx::unique_lock<Latch> lk(_mutex);
+        _cond.wait(lk, [&] { return _nextBatch.is_initialized(); });
+        auto nextBatch = std::move(*_nextBatch);
+        _nextBatch = boost::none;
+        _cond.notify_all();
+        return fassert(50763, std::move(nextBatch));
+    }
+
+    /**
+     * Shuts down the oplog buffer. Returns whether every entry up to the end point was read.
+     */
+    bool shutdown(OperationContext* opCtx) {
+        if (!_readAhead) {
+            const bool exhausted = _oplogBuffer->isEmpty();
+            _oplogBuffer->shutdown(opCtx);
+            return exhausted;
+        }
+        _thread.join();
+        return _exhausted;
+    }
+
+private:
+    void _run() {
+        Client::initThread("ReplRecoveryOplogReader");
+        AuthorizationSession::get(cc())->grantInternalAuthorization(&cc());
+        auto opCtx = cc().makeOperationContext();
+        // Recovery does not write to the oplog, so reading it does not need to wait for the
+        // application of a batch to finish.
+        opCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(false);
+
+        try {
+            _oplogBuffer->startup(opCtx.get());
+            _setStarted();
+
+            while (true) {
+                auto batch = _oplogApplier->getNextApplierBatch(opCtx.get(), _batchLimits);
+                const bool done = !batch.isOK() || batch.getValue().empty();
+                if (!_setNextBatch(std::move(batch)) || done) {
+                    break;
+                }
+            }
+
+            _exhausted = _oplogBuffer->isEmpty();
+            _oplogBuffer->shutdown(opCtx.get());
+        } catch (const DBException& ex) {
+            // Hand the error over to the thread applying the batches, which fails on it like on
+            // any batch that could not be read.
+            _setStarted();
+            _setNextBatch(ex.toStatus());
+        }
+    }
+
+    void _setStarted() {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _started = true;
+        _cond.notify_all();
+    }
+
+    /**
+     * Waits for the previous batch to be taken and hands over 'batch'. Returns false if the reader
+     * is shutting down.
+     */
+    bool _setNextBatch(StatusWith<std::vector<OplogEntry>> batch) {
+        stdx::unique_lock<Latch> lk(_mutex);
+        _cond.wait(lk, [&] { return !_nextBatch || _inShutdown; });
+        if (_inShutdown) {
+            return false;
+        }
+        _nextBatch = std::move(batch);
+        _cond.notify_all();
+        return true;
+    }
+
+    OplogApplier* const _oplogApplier;
+    OplogBufferLocalOplog* const _oplogBuffer;
+    const OplogApplier::BatchLimits _batchLimits;
+    const bool _readAhead;
+
+    Mutex _mutex = MONGO_MAKE_LATCH("RecoveryOplogBatchReader::_mutex");
+    stdx::condition_variable _cond;
+    stdx::thread _thread;
+    bool _started = false;
+    bool _inShutdown = false;
+
+    // The batch read ahead, waiting to be applied.
+    boost::optional<StatusWith<std::vector<OplogEntry>>> _nextBatch;
+
+    // Written by '_thread' before it exits.
+    bool _exhausted = false;
+};
+
 boost::optional<Timestamp> recoverFromOplogPrecursor(OperationContext* opCtx,
                                                      StorageInterface* storageInterface) {
     if (!storageInterface->supportsRecoveryTimestamp(opCtx->getServiceContext())) {
@@ -422,6 +666,13 @@ void ReplicationRecoveryImpl::recoverFromOplogUpTo(OperationContext* opCtx, Time
     reconstructPreparedTransactions(opCtx, OplogApplication::Mode::kRecovering);
 }
 
+BSONObj ReplicationRecoveryImpl::getRecoveryProgress() {
+    BSONObjBuilder progressBob;
+    stdx::lock_guard<Latch> lk(recoveryProgressMutex);
+    recoveryProgress.append(&progressBob);
+    return progressBob.obj();
+}
+
 void ReplicationRecoveryImpl::recoverFromOplog(OperationContext* opCtx,
                                                boost::optional<Timestamp> stableTimestamp) try {
     if (_consistencyMarkers->getInitialSyncFlag(opCtx)) {
@@ -656,9 +907,8 @@ Timestamp ReplicationRecoveryImpl::_applyOplogOperations(OperationContext* opCtx
           "endPoint"_attr = endPoint);
 
     OplogBufferLocalOplog oplogBuffer(startPoint, endPoint);
-    oplogBuffer.startup(opCtx);
 
-    RecoveryOplogApplierStats stats;
+    RecoveryOplogApplierStats stats(startPoint, endPoint);
 
     auto writerPool = makeReplWriterPool();
     auto* replCoord = ReplicationCoordinator::get(opCtx);
@@ -671,9 +921,15 @@ Timestamp ReplicationRecoveryImpl::_applyOplogOperations(OperationContext* opCtx
                                   OplogApplier::Options(OplogApplication::Mode::kRecovering),
                                   writerPool.get());
 
+    // Recovery has the node to itself and does not write to the oplog, so it uses larger batches
+    // than steady state replication, which caps them to a share of the oplog.
     OplogApplier::BatchLimits batchLimits;
-    batchLimits.bytes = getBatchLimitOplogBytes(opCtx, _storageInterface);
-    batchLimits.ops = getBatchLimitOplogEntries();
+    batchLimits.bytes = std::size_t(recoveryOplogApplicationBatchLimitBytes.load());
+    batchLimits.ops = std::size_t(recoveryOplogApplicationBatchLimitOperations.load());
+
+    RecoveryOplogBatchReader batchReader(
+        &oplogApplier, &oplogBuffer, batchLimits, recoveryOplogApplicationReadAhead.load());
+    batchReader.startup(opCtx);
 
     // If we're doing unstable checkpoints during the recovery process (as we do during the special
     // startupRecoveryForRestore mode), we need to advance the consistency marker for each batch so
@@ -690,8 +946,7 @@ Timestamp ReplicationRecoveryImpl::_applyOplogOperations(OperationContext* opCtx
 
     OpTime applyThroughOpTime;
     std::vector<OplogEntry> batch;
-    while (
-        !(batch = fassert(50763, oplogApplier.getNextApplierBatch(opCtx, batchLimits))).empty()) {
+    while (!(batch = batchReader.getNextBatch(opCtx)).empty()) {
         if (advanceTimestampsEachBatch && applyThroughOpTime.isNull()) {
             // We must set appliedThrough before applying anything at all, so we know
             // any unstable checkpoints we take are "dirty".  A null appliedThrough indicates
@@ -707,11 +962,10 @@ Timestamp ReplicationRecoveryImpl::_applyOplogOperations(OperationContext* opCtx
         }
     }
     stats.complete(applyThroughOpTime);
-    invariant(oplogBuffer.isEmpty(),
+    invariant(batchReader.shutdown(opCtx),
               str::stream() << "Oplog buffer not empty after applying operations. Last operation "
                                "applied with optime: "
                             << applyThroughOpTime.toBSON());
-    oplogBuffer.shutdown(opCtx);
 
     // The applied up to timestamp will be null if no oplog entries were applied.
     if (applyThroughOpTime.isNull()) {
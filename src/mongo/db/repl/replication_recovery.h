@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/base/status_with.h"
+#include "mongo/bson/bsonobj.h"
 #include "mongo/db/repl/optime.h"
 
 namespace mongo {
@@ -84,6 +85,12 @@ public:
 
     void recoverFromOplogUpTo(OperationContext* opCtx, Timestamp endPoint) override;
 
+    /**
+     * Returns the progress of the current or last recovery oplog application, as reported in
+     * serverStatus as metrics.repl.recovery.
+     */
+    static BSONObj getRecoveryProgress();
+
 private:
     enum class RecoveryMode {
         kStartupFromStableTimestamp,
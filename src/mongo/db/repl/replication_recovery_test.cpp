@@ -53,6 +53,7 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/db/transaction_participant.h"
+#include "mongo/idl/server_parameter_test_util.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
@@ -1262,6 +1263,39 @@ TEST_F(ReplicationRecoveryTest, RecoverFromOplogUpToEndOfOplog) {
     ASSERT_EQ(getConsistencyMarkers()->getAppliedThrough(opCtx), OpTime(Timestamp(10, 10), 1));
 }
 
+TEST_F(ReplicationRecoveryTest, RecoverFromOplogInMultipleBatchesReportsProgress) {
+    RAIIServerParameterControllerForTest batchLimit{"recoveryOplogApplicationBatchLimitOperations",
+                                                    2};
+    ReplicationRecoveryImpl recovery(getStorageInterface(), getConsistencyMarkers());
+    auto opCtx = getOperationContext();
+
+    _setUpOplog(opCtx, getStorageInterface(), {2, 3, 4, 5, 6, 7, 8, 9, 10});
+
+    // Recover the first half of the oplog without reading batches ahead and the second half with.
+    const std::vector<std::pair<bool, std::vector<int>>> steps = {{false, {2, 3, 4, 5, 6}},
+                                                                  {true, {6, 7, 8, 9, 10}}};
+    for (auto&& [readAhead, timestamps] : steps) {
+        RAIIServerParameterControllerForTest readAheadController{
+            "recoveryOplogApplicationReadAhead", readAhead};
+        const Timestamp startPoint(timestamps.front(), timestamps.front());
+        const Timestamp endPoint(timestamps.back(), timestamps.back());
+        getStorageInterfaceRecovery()->setRecoveryTimestamp(startPoint);
+
+        recovery.recoverFromOplogUpTo(opCtx, endPoint);
+        ASSERT_EQ(getConsistencyMarkers()->getAppliedThrough(opCtx), OpTime(endPoint, 1));
+
+        auto progress = ReplicationRecoveryImpl::getRecoveryProgress();
+        ASSERT_FALSE(progress["inProgress"].boolean()) << progress;
+        ASSERT_EQ(progress["startPoint"].timestamp(), startPoint) << progress;
+        ASSERT_EQ(progress["endPoint"].timestamp(), endPoint) << progress;
+        ASSERT_EQ(progress["lastApplied"].timestamp(), endPoint) << progress;
+        ASSERT_EQ(progress["numOpsApplied"].numberLong(), 4) << progress;
+        ASSERT_GT(progress["numBatches"].numberLong(), 1) << progress;
+        ASSERT_FALSE(progress.hasField("estimatedMillisRemaining")) << progress;
+    }
+    _assertDocsInTestCollection(opCtx, {3, 4, 5, 6, 7, 8, 9, 10});
+}
+
 TEST_F(ReplicationRecoveryTest, RecoverFromOplogUpToInvalidEndPoint) {
     ReplicationRecoveryImpl recovery(getStorageInterface(), getConsistencyMarkers());
     auto opCtx = getOperationContext();
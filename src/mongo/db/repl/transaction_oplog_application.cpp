@@ -129,8 +129,17 @@ Status _applyTransactionFromOplogChain(OperationContext* opCtx,
     invariant(mode == repl::OplogApplication::Mode::kRecovering);
 
     auto ops = readTransactionOperationsFromOplogChain(opCtx, entry, {});
+    return applyRecoveredPreparedTransactionOps(
+        opCtx, entry.getNss().db(), ops, commitTimestamp, durableTimestamp);
+}
+}  // namespace
 
-    const auto dbName = entry.getNss().db().toString();
+Status applyRecoveredPreparedTransactionOps(OperationContext* opCtx,
+                                            StringData dbName,
+                                            const std::vector<OplogEntry>& ops,
+                                            Timestamp commitTimestamp,
+                                            Timestamp durableTimestamp) {
+    const auto mode = repl::OplogApplication::Mode::kRecovering;
     Status status = Status::OK();
 
     writeConflictRetry(opCtx, "replaying prepared transaction", dbName, [&] {
@@ -159,7 +168,6 @@ Status _applyTransactionFromOplogChain(OperationContext* opCtx,
     });
     return status;
 }
-}  // namespace
 
 /**
  * Helper used to get previous oplog entry from the same transaction.
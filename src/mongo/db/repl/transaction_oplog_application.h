@@ -43,6 +43,18 @@ Status applyCommitTransaction(OperationContext* opCtx,
                               const repl::OplogEntry& entry,
                               repl::OplogApplication::Mode mode);
 
+/**
+ * Applies 'ops' from a prepared transaction committed during recovery in one storage transaction
+ * that is prepared and committed at 'commitTimestamp', with 'durableTimestamp' as its durable
+ * timestamp. The operations of a transaction may be split by document across several calls, as
+ * every part becomes visible at the same commit timestamp.
+ */
+Status applyRecoveredPreparedTransactionOps(OperationContext* opCtx,
+                                            StringData dbName,
+                                            const std::vector<repl::OplogEntry>& ops,
+                                            Timestamp commitTimestamp,
+                                            Timestamp durableTimestamp);
+
 /**
  * Apply `abortTransaction` oplog entry.
  */
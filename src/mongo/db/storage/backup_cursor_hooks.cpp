@@ -95,4 +95,10 @@ BackupCursorExtendState BackupCursorHooks::extendBackupCursor(OperationContext*
 bool BackupCursorHooks::isBackupCursorOpen() const {
     return false;
 }
+
+bool BackupCursorHooks::isFileReturnedByCursor(const UUID& backupId,
+                                               boost::filesystem::path filePath) {
+    // No backup cursor can be open without an implementation of the hooks.
+    return false;
+}
 }  // namespace mongo
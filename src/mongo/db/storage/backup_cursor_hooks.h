@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <boost/filesystem/path.hpp>
 #include <memory>
 #include <vector>
 
@@ -71,6 +72,12 @@ public:
                                                        const Timestamp& extendTo);
 
     virtual bool isBackupCursorOpen() const;
+
+    /**
+     * Returns true if 'filePath' is one of the files returned by the open backup cursor
+     * 'backupId', including by any of its extensions.
+     */
+    virtual bool isFileReturnedByCursor(const UUID& backupId, boost::filesystem::path filePath);
 };
 
 }  // namespace mongo
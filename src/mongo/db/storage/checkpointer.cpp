@@ -33,9 +33,11 @@
 
 #include "mongo/db/storage/checkpointer.h"
 
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/fail_point.h"
@@ -48,6 +50,24 @@ const auto getCheckpointer = ServiceContext::declareDecoration<std::unique_ptr<C
 
 MONGO_FAIL_POINT_DEFINE(pauseCheckpointThread);
 
+class CheckpointerServerStatusSection : public ServerStatusSection {
+public:
+    CheckpointerServerStatusSection() : ServerStatusSection("checkpointer") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder builder;
+        if (auto checkpointer = Checkpointer::get(opCtx)) {
+            checkpointer->appendStats(&builder);
+        }
+        return builder.obj();
+    }
+} checkpointerServerStatusSection;
+
 }  // namespace
 
 Checkpointer* Checkpointer::get(ServiceContext* serviceCtx) {
@@ -78,12 +98,11 @@ void Checkpointer::run() {
             stdx::unique_lock<Latch> lock(_mutex);
             MONGO_IDLE_THREAD_BLOCK;
 
-            // Wait for 'storageGlobalParams.checkpointDelaySecs' seconds; or until either shutdown
-            // is signaled or a checkpoint is triggered.
-            _sleepCV.wait_for(lock,
-                              stdx::chrono::seconds(static_cast<std::int64_t>(
-                                  storageGlobalParams.checkpointDelaySecs)),
-                              [&] { return _shuttingDown || _triggerCheckpoint; });
+            if (gAdaptiveCheckpointing.load()) {
+                _waitForAdaptiveCheckpoint(lock);
+            } else {
+                _waitForPeriodicCheckpoint(lock);
+            }
 
             // If the checkpointDelaySecs is set to 0, that means we should skip checkpointing.
             // However, checkpointDelaySecs is adjustable by a runtime server parameter, so we
@@ -105,8 +124,14 @@ void Checkpointer::run() {
                 return;
             }
 
+            if (_triggerCheckpoint) {
+                _lastCheckpointReason = "triggered"_sd;
+            }
+
             // Clear the trigger so we do not immediately checkpoint again after this.
             _triggerCheckpoint = false;
+
+            _recordCheckpointStart(lock, Date_t::now());
         }
 
         pauseCheckpointThread.pauseWhileSet();
@@ -126,6 +151,131 @@ void Checkpointer::run() {
     }
 }
 
+void Checkpointer::_waitForPeriodicCheckpoint(stdx::unique_lock<Latch>& lock) {
+    _sleepCV.wait_for(
+        lock,
+        stdx::chrono::seconds(static_cast<std::int64_t>(storageGlobalParams.checkpointDelaySecs)),
+        [&] { return _shuttingDown || _triggerCheckpoint; });
+    _lastCheckpointReason = "interval"_sd;
+}
+
+void Checkpointer::_waitForAdaptiveCheckpoint(stdx::unique_lock<Latch>& lock) {
+    while (true) {
+        if (_sleepCV.wait_for(lock, stdx::chrono::seconds(1), [&] {
+                return _shuttingDown || _triggerCheckpoint;
+            })) {
+            return;
+        }
+
+        if (storageGlobalParams.checkpointDelaySecs == 0) {
+            // Checkpointing is disabled, which the caller waits out.
+            return;
+        }
+
+        if (!gAdaptiveCheckpointing.load()) {
+            // Adaptive checkpointing was turned off at runtime.
+            _waitForPeriodicCheckpoint(lock);
+            return;
+        }
+
+        // Reading the statistics may take a storage engine session, so do not hold the mutex while
+        // doing so, to keep serverStatus and shutdown from waiting on it.
+        lock.unlock();
+        // TODO SERVER-50861: Access the storage engine via the ServiceContext.
+        auto pressure = _kvEngine->getCheckpointPressure();
+        lock.lock();
+
+        if (_shouldTakeAdaptiveCheckpoint(lock, pressure, Date_t::now())) {
+            return;
+        }
+    }
+}
+
+bool Checkpointer::_shouldTakeAdaptiveCheckpoint(
+    WithLock, const boost::optional<KVEngine::CheckpointPressure>& pressure, Date_t now) {
+    if (pressure) {
+        if (!_lastPressure) {
+            // Only count history store growth from the point we start sampling it.
+            _historyStoreBytesAtLastCheckpoint = pressure->historyStoreBytes;
+        } else if (auto elapsedMillis = durationCount<Milliseconds>(now - _lastPressureTime);
+                   elapsedMillis > 0) {
+            _historyStoreGrowthRate =
+                (pressure->historyStoreBytes - _lastPressure->historyStoreBytes) * 1000 /
+                elapsedMillis;
+        }
+        _lastPressure = pressure;
+        _lastPressureTime = now;
+    }
+
+    const auto sinceLastCheckpoint = now - _lastCheckpointTime;
+    if (sinceLastCheckpoint < Seconds(gCheckpointMinIntervalSecs.load())) {
+        return false;
+    }
+
+    // 'syncdelay' bounds the time between two checkpoints.
+    const bool intervalElapsed =
+        sinceLastCheckpoint >= Seconds(static_cast<std::int64_t>(
+                                   storageGlobalParams.checkpointDelaySecs));
+    if (!pressure) {
+        // Without any statistics to go by, fall back to periodic checkpoints.
+        if (intervalElapsed) {
+            _lastCheckpointReason = "interval"_sd;
+        }
+        return intervalElapsed;
+    }
+
+    const double dirtyTrigger = static_cast<double>(pressure->cacheBytes) *
+        gCheckpointDirtyCachePercentTrigger.load() / 100.0;
+    if (pressure->dirtyBytes > 0 && pressure->dirtyBytes >= dirtyTrigger) {
+        _lastCheckpointReason = "dirtyCache"_sd;
+        return true;
+    }
+
+    const int64_t historyStoreGrowth =
+        pressure->historyStoreBytes - _historyStoreBytesAtLastCheckpoint;
+    const int64_t historyStoreTrigger =
+        int64_t{gCheckpointHistoryStoreGrowthTriggerMB.load()} * 1024 * 1024;
+    if (historyStoreGrowth >= historyStoreTrigger) {
+        _lastCheckpointReason = "historyStoreGrowth"_sd;
+        return true;
+    }
+
+    // History piling up quickly is costly for the next checkpoint to write out, even while the
+    // total growth is still small, so checkpoint early to spread that cost.
+    const int64_t historyStoreRateTrigger =
+        int64_t{gCheckpointHistoryStoreGrowthRateTriggerMBPerSec.load()} * 1024 * 1024;
+    if (_historyStoreGrowthRate >= historyStoreRateTrigger) {
+        _lastCheckpointReason = "historyStoreGrowthRate"_sd;
+        return true;
+    }
+
+    // An idle node has nothing to write, so there is no point in checkpointing it.
+    if (intervalElapsed && pressure->dirtyBytes > 0) {
+        _lastCheckpointReason = "interval"_sd;
+        return true;
+    }
+
+    return false;
+}
+
+void Checkpointer::_recordCheckpointStart(WithLock, Date_t now) {
+    _lastCheckpointTime = now;
+    if (_lastPressure) {
+        _historyStoreBytesAtLastCheckpoint = _lastPressure->historyStoreBytes;
+    }
+}
+
+bool Checkpointer::shouldTakeAdaptiveCheckpoint_forTest(
+    const boost::optional<KVEngine::CheckpointPressure>& pressure, Date_t now) {
+    stdx::lock_guard<Latch> lock(_mutex);
+    return _shouldTakeAdaptiveCheckpoint(lock, pressure, now);
+}
+
+void Checkpointer::recordCheckpointStart_forTest(Date_t now) {
+    stdx::lock_guard<Latch> lock(_mutex);
+    _recordCheckpointStart(lock, now);
+}
+
 void Checkpointer::triggerFirstStableCheckpoint(Timestamp prevStable,
                                                 Timestamp initialData,
                                                 Timestamp currStable) {
@@ -165,4 +315,22 @@ void Checkpointer::shutdown(const Status& reason) {
     LOGV2(22323, "Finished shutting down checkpoint thread");
 }
 
+void Checkpointer::appendStats(BSONObjBuilder* builder) {
+    stdx::unique_lock<Latch> lock(_mutex);
+    builder->append("adaptive", gAdaptiveCheckpointing.load());
+    builder->append("lastCheckpointReason", _lastCheckpointReason);
+    builder->append("lastCheckpointTime", _lastCheckpointTime);
+    if (_lastPressure) {
+        builder->append("dirtyBytes", static_cast<long long>(_lastPressure->dirtyBytes));
+        builder->append("cacheBytes", static_cast<long long>(_lastPressure->cacheBytes));
+        builder->append("historyStoreBytes",
+                        static_cast<long long>(_lastPressure->historyStoreBytes));
+        builder->append("historyStoreGrowthSinceCheckpointBytes",
+                        static_cast<long long>(_lastPressure->historyStoreBytes -
+                                               _historyStoreBytesAtLastCheckpoint));
+        builder->append("historyStoreGrowthBytesPerSec",
+                        static_cast<long long>(_historyStoreGrowthRate));
+    }
+}
+
 }  // namespace mongo
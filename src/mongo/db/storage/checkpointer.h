@@ -29,13 +29,16 @@
 
 #pragma once
 
+#include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/util/background.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
-class KVEngine;
+class BSONObjBuilder;
 class OperationContext;
 class ServiceContext;
 class Timestamp;
@@ -48,7 +51,8 @@ public:
           _shuttingDown(false),
           _shutdownReason(Status::OK()),
           _hasTriggeredFirstStableCheckpoint(false),
-          _triggerCheckpoint(false) {}
+          _triggerCheckpoint(false),
+          _lastCheckpointTime(Date_t::now()) {}
 
     static Checkpointer* get(ServiceContext* serviceCtx);
     static Checkpointer* get(OperationContext* opCtx);
@@ -59,7 +63,8 @@ public:
     }
 
     /**
-     * Starts the checkpoint thread that runs every storageGlobalParams.checkpointDelaySecs seconds.
+     * Starts the checkpoint thread that runs every storageGlobalParams.checkpointDelaySecs seconds,
+     * or whenever enough dirty data has built up when 'adaptiveCheckpointing' is enabled.
      */
     void run() override;
 
@@ -87,7 +92,46 @@ public:
      */
     void shutdown(const Status& reason);
 
+    /**
+     * Appends the inputs of the last adaptive checkpointing decision to 'builder'.
+     */
+    void appendStats(BSONObjBuilder* builder);
+
+    /**
+     * Returns whether adaptive checkpointing takes a checkpoint given 'pressure' sampled at 'now'.
+     */
+    bool shouldTakeAdaptiveCheckpoint_forTest(
+        const boost::optional<KVEngine::CheckpointPressure>& pressure, Date_t now);
+
+    /**
+     * Records that a checkpoint started at 'now', as the checkpoint thread does.
+     */
+    void recordCheckpointStart_forTest(Date_t now);
+
 private:
+    /**
+     * Waits for 'storageGlobalParams.checkpointDelaySecs' seconds, or until either shutdown is
+     * signaled or a checkpoint is triggered.
+     */
+    void _waitForPeriodicCheckpoint(stdx::unique_lock<Latch>& lock);
+
+    /**
+     * Samples the checkpoint pressure of the storage engine every second until it calls for a
+     * checkpoint, or until either shutdown is signaled or a checkpoint is triggered.
+     */
+    void _waitForAdaptiveCheckpoint(stdx::unique_lock<Latch>& lock);
+
+    /**
+     * Records 'pressure', sampled at 'now', and returns whether it calls for a checkpoint.
+     */
+    bool _shouldTakeAdaptiveCheckpoint(
+        WithLock, const boost::optional<KVEngine::CheckpointPressure>& pressure, Date_t now);
+
+    /**
+     * Starts measuring the time and history store growth since the last checkpoint from 'now'.
+     */
+    void _recordCheckpointStart(WithLock, Date_t now);
+
     // A pointer to the KVEngine is maintained only due to unit testing limitations that don't fully
     // setup the ServiceContext.
     // TODO SERVER-50861: Remove this pointer.
@@ -109,6 +153,19 @@ private:
 
     // This flag allows the checkpoint thread to wake up early when _sleepCV is signaled.
     bool _triggerCheckpoint;
+
+    // When the last checkpoint started, and how large the history store was at that point.
+    Date_t _lastCheckpointTime;
+    int64_t _historyStoreBytesAtLastCheckpoint = 0;
+
+    // The last checkpoint pressure sampled by adaptive checkpointing, when it was sampled, and how
+    // fast the history store grew since the previous sample, in bytes per second.
+    boost::optional<KVEngine::CheckpointPressure> _lastPressure;
+    Date_t _lastPressureTime;
+    int64_t _historyStoreGrowthRate = 0;
+
+    // Why the last checkpoint was taken.
+    StringData _lastCheckpointReason = "none"_sd;
 };
 
 }  // namespace mongo
@@ -0,0 +1,131 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/checkpointer.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/idl/server_parameter_test_util.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const int64_t kMB = 1024 * 1024;
+
+class AdaptiveCheckpointTest : public unittest::Test {
+public:
+    void setUp() override {
+        _checkpointDelaySecs = std::exchange(storageGlobalParams.checkpointDelaySecs, 60);
+        _checkpointer.recordCheckpointStart_forTest(_start);
+    }
+
+    void tearDown() override {
+        storageGlobalParams.checkpointDelaySecs = _checkpointDelaySecs;
+    }
+
+protected:
+    bool shouldCheckpoint(Seconds sinceStart,
+                          int64_t dirtyBytes,
+                          int64_t historyStoreBytes,
+                          int64_t cacheBytes = 1000 * kMB) {
+        return _checkpointer.shouldTakeAdaptiveCheckpoint_forTest(
+            KVEngine::CheckpointPressure{dirtyBytes, cacheBytes, historyStoreBytes},
+            _start + sinceStart);
+    }
+
+    std::string lastCheckpointReason() {
+        BSONObjBuilder builder;
+        _checkpointer.appendStats(&builder);
+        return builder.obj()["lastCheckpointReason"].str();
+    }
+
+    RAIIServerParameterControllerForTest _minInterval{"checkpointMinIntervalSecs", 5};
+    RAIIServerParameterControllerForTest _dirtyCache{"checkpointDirtyCachePercentTrigger", 2.0};
+    RAIIServerParameterControllerForTest _historyStoreGrowth{
+        "checkpointHistoryStoreGrowthTriggerMB", 512};
+    RAIIServerParameterControllerForTest _historyStoreGrowthRate{
+        "checkpointHistoryStoreGrowthRateTriggerMBPerSec", 16};
+
+    const Date_t _start = Date_t::now();
+    Checkpointer _checkpointer{nullptr};
+
+private:
+    size_t _checkpointDelaySecs;
+};
+
+TEST_F(AdaptiveCheckpointTest, NoCheckpointWithinMinimumInterval) {
+    ASSERT_FALSE(shouldCheckpoint(Seconds(4), 500 * kMB, 0));
+    ASSERT_TRUE(shouldCheckpoint(Seconds(5), 500 * kMB, 0));
+}
+
+TEST_F(AdaptiveCheckpointTest, DirtyCacheTriggersCheckpoint) {
+    ASSERT_FALSE(shouldCheckpoint(Seconds(10), 19 * kMB, 0));
+    ASSERT_TRUE(shouldCheckpoint(Seconds(11), 20 * kMB, 0));
+    ASSERT_EQ("dirtyCache", lastCheckpointReason());
+}
+
+TEST_F(AdaptiveCheckpointTest, HistoryStoreGrowthTriggersCheckpoint) {
+    // Growth is counted from the first sample, and spread out so it stays below the rate trigger.
+    ASSERT_FALSE(shouldCheckpoint(Seconds(1), 0, 1000 * kMB));
+    ASSERT_FALSE(shouldCheckpoint(Seconds(100), 0, 1511 * kMB));
+    ASSERT_TRUE(shouldCheckpoint(Seconds(101), 0, 1512 * kMB));
+    ASSERT_EQ("historyStoreGrowth", lastCheckpointReason());
+
+    // Taking a checkpoint resets the growth.
+    _checkpointer.recordCheckpointStart_forTest(_start + Seconds(101));
+    ASSERT_FALSE(shouldCheckpoint(Seconds(110), 0, 1513 * kMB));
+}
+
+TEST_F(AdaptiveCheckpointTest, HistoryStoreGrowthRateTriggersCheckpoint) {
+    ASSERT_FALSE(shouldCheckpoint(Seconds(10), 0, 0));
+    ASSERT_FALSE(shouldCheckpoint(Seconds(11), 0, 15 * kMB));
+    ASSERT_TRUE(shouldCheckpoint(Seconds(12), 0, 31 * kMB));
+    ASSERT_EQ("historyStoreGrowthRate", lastCheckpointReason());
+}
+
+TEST_F(AdaptiveCheckpointTest, IntervalTriggersCheckpointOnlyWithDirtyData) {
+    ASSERT_FALSE(shouldCheckpoint(Seconds(59), 1, 0));
+    ASSERT_FALSE(shouldCheckpoint(Seconds(60), 0, 0));
+    ASSERT_TRUE(shouldCheckpoint(Seconds(61), 1, 0));
+    ASSERT_EQ("interval", lastCheckpointReason());
+}
+
+TEST_F(AdaptiveCheckpointTest, IntervalTriggersCheckpointWithoutStatistics) {
+    ASSERT_FALSE(_checkpointer.shouldTakeAdaptiveCheckpoint_forTest(boost::none,
+                                                                    _start + Seconds(59)));
+    ASSERT_TRUE(_checkpointer.shouldTakeAdaptiveCheckpoint_forTest(boost::none,
+                                                                   _start + Seconds(60)));
+    ASSERT_EQ("interval", lastCheckpointReason());
+}
+
+}  // namespace
+}  // namespace mongo
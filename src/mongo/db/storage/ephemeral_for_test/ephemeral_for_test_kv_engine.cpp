@@ -115,13 +115,16 @@ std::unique_ptr<mongo::RecordStore> KVEngine::getRecordStore(OperationContext* u
 }
 
 bool KVEngine::trySwapMaster(StringStore& newMaster, uint64_t version) {
+    invariant(!newMaster.hasBranch());
+    // Copy the tree before taking _masterLock, which every reader and committer serializes on.
+    auto newMasterPtr = std::make_shared<StringStore>(newMaster);
+
     stdx::lock_guard<Latch> lock(_masterLock);
-    invariant(!newMaster.hasBranch() && !_master->hasBranch());
+    invariant(!_master->hasBranch());
     if (_masterVersion != version)
         return false;
     // TODO SERVER-48314: replace _masterVersion with a Timestamp of transaction.
     Timestamp commitTimestamp(_masterVersion++, 0);
-    auto newMasterPtr = std::make_shared<StringStore>(newMaster);
     _availableHistory[commitTimestamp] = newMasterPtr;
     _master = newMasterPtr;
     _cleanHistory(lock);
@@ -255,6 +258,14 @@ void KVEngine::setOldestTimestamp(Timestamp newOldestTimestamp, bool force) {
     invariant(_availableHistory.size() >= 1);
 }
 
+void KVEngine::setStableTimestamp(Timestamp stableTimestamp, bool force) {
+    // The stable timestamp may only move backwards when forced, as after a rollback.
+    if (!force && stableTimestamp < getStableTimestamp()) {
+        return;
+    }
+    _stableTimestamp.store(stableTimestamp.asULL());
+}
+
 std::map<Timestamp, std::shared_ptr<StringStore>> KVEngine::getHistory_forTest() {
     stdx::lock_guard<Latch> lock(_masterLock);
     return _availableHistory;
@@ -191,9 +191,15 @@ public:
     Timestamp getOldestTimestamp() const override;
 
     Timestamp getStableTimestamp() const override {
-        return Timestamp();
+        return Timestamp(_stableTimestamp.load());
     }
 
+    /**
+     * Nothing is ever persisted, so the stable timestamp is only tracked to be reported back to
+     * replication.
+     */
+    void setStableTimestamp(Timestamp stableTimestamp, bool force) override;
+
     void setOldestTimestamp(Timestamp newOldestTimestamp, bool force) override;
 
     std::map<Timestamp, std::shared_ptr<StringStore>> getHistory_forTest();
@@ -225,6 +231,8 @@ private:
     // commit timestamps. We need to start at 1 to avoid the null timestamp.
     uint64_t _masterVersion = 1;
 
+    AtomicWord<unsigned long long> _stableTimestamp{0};
+
     // This map contains the different versions of the StringStore's referenced by their commit
     // timestamps.
     std::map<Timestamp, std::shared_ptr<StringStore>> _availableHistory;
@@ -39,7 +39,9 @@
 #include "mongo/db/service_context.h"
 #include "mongo/db/service_context_test_fixture.h"
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_kv_engine.h"
+#include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_parameters_gen.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace ephemeral_for_test {
@@ -454,5 +456,128 @@ TEST_F(EphemeralForTestKVEngineTest, SetReadTimestampBehindOldestTimestamp) {
     ASSERT(rs->findRecord(&opCtx, loc2, &rd));
 }
 
+TEST_F(EphemeralForTestKVEngineTest, MemoryLimitOnlyRejectsGrowingTransactions) {
+    NamespaceString nss("a.b");
+    std::string ident = "collection-1234";
+    std::string record = "abcd";
+    CollectionOptions defaultCollectionOptions;
+
+    std::unique_ptr<mongo::RecordStore> rs;
+    {
+        OperationContextFromKVEngine opCtx(_engine);
+        ASSERT_OK(_engine->createRecordStore(&opCtx, nss.ns(), ident, defaultCollectionOptions));
+        rs = _engine->getRecordStore(&opCtx, nss.ns(), ident, defaultCollectionOptions);
+        ASSERT(rs);
+    }
+
+    RecordId loc;
+    {
+        OperationContextFromKVEngine opCtx(_engine);
+        WriteUnitOfWork uow(&opCtx);
+        StatusWith<RecordId> res =
+            rs->insertRecord(&opCtx, record.c_str(), record.length() + 1, Timestamp());
+        ASSERT_OK(res.getStatus());
+        loc = res.getValue();
+        uow.commit();
+    }
+
+    const auto originalLimit = gMemoryLimitBytes.load();
+    gMemoryLimitBytes.store(1);
+    ON_BLOCK_EXIT([&] { gMemoryLimitBytes.store(originalLimit); });
+
+    {
+        OperationContextFromKVEngine opCtx(_engine);
+        WriteUnitOfWork uow(&opCtx);
+        StatusWith<RecordId> res =
+            rs->insertRecord(&opCtx, record.c_str(), record.length() + 1, Timestamp());
+        ASSERT_OK(res.getStatus());
+        ASSERT_THROWS_CODE(uow.commit(), DBException, ErrorCodes::ExceededMemoryLimit);
+    }
+
+    // The rejected transaction left nothing behind, and deleting data is still allowed.
+    {
+        OperationContextFromKVEngine opCtx(_engine);
+        ASSERT_EQ(1, rs->numRecords(&opCtx));
+
+        WriteUnitOfWork uow(&opCtx);
+        rs->deleteRecord(&opCtx, loc);
+        uow.commit();
+    }
+
+    OperationContextFromKVEngine opCtx(_engine);
+    ASSERT_EQ(0, rs->numRecords(&opCtx));
+}
+
+TEST_F(EphemeralForTestKVEngineTest, MemoryLimitIsTrackedPerEngine) {
+    NamespaceString nss("a.b");
+    std::string ident = "collection-1234";
+    std::string record = "abcd";
+    std::string largeRecord(1000, 'x');
+    CollectionOptions defaultCollectionOptions;
+
+    // Another engine in the same process holds more data than the limit allows.
+    KVEngine otherEngine;
+    std::unique_ptr<mongo::RecordStore> otherRs;
+    {
+        OperationContextFromKVEngine opCtx(&otherEngine);
+        ASSERT_OK(
+            otherEngine.createRecordStore(&opCtx, nss.ns(), ident, defaultCollectionOptions));
+        otherRs = otherEngine.getRecordStore(&opCtx, nss.ns(), ident, defaultCollectionOptions);
+        ASSERT(otherRs);
+
+        WriteUnitOfWork uow(&opCtx);
+        StatusWith<RecordId> res = otherRs->insertRecord(
+            &opCtx, largeRecord.c_str(), largeRecord.length() + 1, Timestamp());
+        ASSERT_OK(res.getStatus());
+        uow.commit();
+    }
+
+    const auto originalLimit = gMemoryLimitBytes.load();
+    gMemoryLimitBytes.store(500);
+    ON_BLOCK_EXIT([&] { gMemoryLimitBytes.store(originalLimit); });
+
+    std::unique_ptr<mongo::RecordStore> rs;
+    {
+        OperationContextFromKVEngine opCtx(_engine);
+        ASSERT_OK(_engine->createRecordStore(&opCtx, nss.ns(), ident, defaultCollectionOptions));
+        rs = _engine->getRecordStore(&opCtx, nss.ns(), ident, defaultCollectionOptions);
+        ASSERT(rs);
+    }
+
+    // The data of the other engine does not count against this one.
+    {
+        OperationContextFromKVEngine opCtx(_engine);
+        WriteUnitOfWork uow(&opCtx);
+        StatusWith<RecordId> res =
+            rs->insertRecord(&opCtx, record.c_str(), record.length() + 1, Timestamp());
+        ASSERT_OK(res.getStatus());
+        uow.commit();
+        ASSERT_EQ(1, rs->numRecords(&opCtx));
+    }
+
+    // While the other engine may not grow any further.
+    {
+        OperationContextFromKVEngine opCtx(&otherEngine);
+        WriteUnitOfWork uow(&opCtx);
+        StatusWith<RecordId> res =
+            otherRs->insertRecord(&opCtx, record.c_str(), record.length() + 1, Timestamp());
+        ASSERT_OK(res.getStatus());
+        ASSERT_THROWS_CODE(uow.commit(), DBException, ErrorCodes::ExceededMemoryLimit);
+    }
+}
+
+TEST_F(EphemeralForTestKVEngineTest, StableTimestampOnlyMovesBackwardsWhenForced) {
+    ASSERT_EQ(Timestamp(), _engine->getStableTimestamp());
+
+    _engine->setStableTimestamp(Timestamp(10, 1), false);
+    ASSERT_EQ(Timestamp(10, 1), _engine->getStableTimestamp());
+
+    _engine->setStableTimestamp(Timestamp(5, 1), false);
+    ASSERT_EQ(Timestamp(10, 1), _engine->getStableTimestamp());
+
+    _engine->setStableTimestamp(Timestamp(5, 1), true);
+    ASSERT_EQ(Timestamp(5, 1), _engine->getStableTimestamp());
+}
+
 }  // namespace ephemeral_for_test
 }  // namespace mongo
@@ -35,6 +35,7 @@
 
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/record_id_helpers.h"
+#include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_parameters_gen.h"
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_recovery_unit.h"
 #include "mongo/util/fail_point.h"
 
@@ -62,13 +63,20 @@ void RecoveryUnit::doCommitUnitOfWork() {
 
     if (_dirty) {
         invariant(_forked);
+        invariant(_mergeBase);
+        const auto growth = static_cast<int64_t>(_workingCopy.dataSize()) -
+            static_cast<int64_t>(_mergeBase->dataSize());
         while (true) {
             auto masterInfo = _KVEngine->getMasterInfo(_readAtTimestamp);
-            try {
-                invariant(_mergeBase);
-                _workingCopy.merge3(*_mergeBase, *masterInfo.second);
-            } catch (const merge_conflict_exception&) {
-                throw WriteConflictException();
+            _checkMemoryLimit(*masterInfo.second, growth);
+            // Nothing was committed since we forked, so there is nothing to merge. This is the
+            // common case when there is a single writer.
+            if (masterInfo.second != _mergeBase) {
+                try {
+                    _workingCopy.merge3(*_mergeBase, *masterInfo.second);
+                } catch (const merge_conflict_exception&) {
+                    throw WriteConflictException();
+                }
             }
 
             if (_KVEngine->trySwapMaster(_workingCopy, masterInfo.first)) {
@@ -172,6 +180,20 @@ Status RecoveryUnit::setTimestamp(Timestamp timestamp) {
 
 void RecoveryUnit::setOrderedCommit(bool orderedCommit) {}
 
+void RecoveryUnit::_checkMemoryLimit(const StringStore& master, int64_t growth) {
+    const auto memoryLimit = gMemoryLimitBytes.load();
+    if (memoryLimit == 0 || growth <= 0) {
+        return;
+    }
+
+    const auto dataSize = static_cast<int64_t>(master.dataSize()) + growth;
+    uassert(ErrorCodes::ExceededMemoryLimit,
+            str::stream() << "Committing would grow the data of the in-memory storage engine to "
+                          << dataSize << " bytes, which exceeds its limit (" << memoryLimit
+                          << " bytes)",
+            dataSize <= memoryLimit);
+}
+
 void RecoveryUnit::_abort() {
     _forked = false;
     _dirty = false;
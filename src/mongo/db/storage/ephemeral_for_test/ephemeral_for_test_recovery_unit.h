@@ -109,6 +109,13 @@ private:
 
     void doAbandonSnapshot() override final;
 
+    /**
+     * Throws ExceededMemoryLimit if growing the data of 'master', the engine's tree this unit of
+     * work merges into, by 'growth' bytes would exceed 'ephemeralForTestMemoryLimitBytes'. Units of
+     * work that do not grow the data set are always allowed.
+     */
+    void _checkMemoryLimit(const StringStore& master, int64_t growth);
+
     void _abort();
 
     void _setMergeNull();
@@ -36,6 +36,7 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_kv_engine.h"
+#include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_parameters_gen.h"
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_radix_store.h"
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_record_store.h"
 #include "mongo/logv2/log.h"
@@ -61,6 +62,8 @@ BSONObj ServerStatusSection::generateSection(OperationContext* opCtx,
 
     BSONObjBuilder bob;
     bob.append("totalMemoryUsage", StringStore::totalMemory());
+    bob.append("dataSize", static_cast<long long>(_engine->getMasterInfo().second->dataSize()));
+    bob.append("memoryLimit", gMemoryLimitBytes.load());
     bob.append("totalNodes", StringStore::totalNodes());
     bob.append("averageChildren", StringStore::averageChildren());
 
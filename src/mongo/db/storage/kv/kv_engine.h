@@ -215,6 +215,26 @@ public:
 
     virtual void checkpoint() {}
 
+    /**
+     * Statistics telling how much work the next checkpoint has ahead of it.
+     */
+    struct CheckpointPressure {
+        // Bytes of dirty data in the cache.
+        int64_t dirtyBytes = 0;
+        // Size of the cache in bytes.
+        int64_t cacheBytes = 0;
+        // On-disk size in bytes of the history kept for older snapshots.
+        int64_t historyStoreBytes = 0;
+    };
+
+    /**
+     * Returns the current checkpoint pressure, or boost::none if the storage engine does not track
+     * it, in which case checkpoints are only taken periodically.
+     */
+    virtual boost::optional<CheckpointPressure> getCheckpointPressure() {
+        return boost::none;
+    }
+
     virtual bool isDurable() const = 0;
 
     /**
@@ -49,6 +49,7 @@
 #include "mongo/db/storage/storage_repair_observer.h"
 #include "mongo/unittest/barrier.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/fail_point.h"
 #include "mongo/util/periodic_runner_factory.h"
 
 namespace mongo {
@@ -110,6 +111,80 @@ TEST_F(StorageEngineTest, LoadCatalogDropsOrphansAfterUncleanShutdown) {
     ASSERT(!collectionExists(opCtx.get(), collNs));
 }
 
+TEST_F(StorageEngineTest, LoadCatalogInParallel) {
+    auto opCtx = cc().makeOperationContext();
+
+    std::vector<std::pair<NamespaceString, UUID>> collections;
+    for (int i = 0; i < 20; ++i) {
+        const NamespaceString nss("db.coll" + std::to_string(i));
+        ASSERT_OK(createCollection(opCtx.get(), nss).getStatus());
+        collections.emplace_back(
+            nss, *CollectionCatalog::get(opCtx.get())->lookupUUIDByNSS(opCtx.get(), nss));
+    }
+
+    FailPointEnableBlock loadInParallel("loadCatalogInParallel", BSON("threads" << 4));
+    {
+        Lock::GlobalWrite writeLock(opCtx.get(), Date_t::max(), Lock::InterruptBehavior::kThrow);
+        _storageEngine->closeCatalog(opCtx.get());
+        _storageEngine->loadCatalog(opCtx.get(), StorageEngine::LastShutdownState::kClean);
+
+        // The global lock given up while the workers ran is held again.
+        ASSERT(opCtx->lockState()->isW());
+    }
+    loadInParallel->waitForTimesEntered(loadInParallel.initialTimesEntered() + 1);
+
+    auto catalog = CollectionCatalog::get(opCtx.get());
+    for (auto&& [nss, uuid] : collections) {
+        auto collection = catalog->lookupCollectionByNamespace(opCtx.get(), nss);
+        ASSERT(collection) << nss;
+        ASSERT_EQ(uuid, collection->uuid());
+        ASSERT(collection->getRecordStore());
+    }
+}
+
+TEST_F(StorageEngineTest, LoadCatalogInParallelFailsIfACollectionFailsToLoad) {
+    auto opCtx = cc().makeOperationContext();
+
+    std::vector<NamespaceString> collections;
+    for (int i = 0; i < 20; ++i) {
+        collections.emplace_back("db.coll" + std::to_string(i));
+        ASSERT_OK(createCollection(opCtx.get(), collections.back()).getStatus());
+    }
+
+    FailPointEnableBlock loadInParallel("loadCatalogInParallel", BSON("threads" << 4));
+    {
+        FailPointEnableBlock failToLoad("failToLoadCollection", BSON("nss" << "db.coll10"));
+
+        Lock::GlobalWrite writeLock(opCtx.get(), Date_t::max(), Lock::InterruptBehavior::kThrow);
+        _storageEngine->closeCatalog(opCtx.get());
+        ASSERT_THROWS_CODE(
+            _storageEngine->loadCatalog(opCtx.get(), StorageEngine::LastShutdownState::kClean),
+            DBException,
+            5903201);
+        failToLoad->waitForTimesEntered(failToLoad.initialTimesEntered() + 1);
+
+        // The global lock is held again and none of the collections made by the workers were
+        // registered.
+        ASSERT(opCtx->lockState()->isW());
+        auto catalog = CollectionCatalog::get(opCtx.get());
+        for (auto&& nss : collections) {
+            ASSERT_FALSE(catalog->lookupCollectionByNamespace(opCtx.get(), nss)) << nss;
+        }
+    }
+
+    // The catalog loads once every collection can be built.
+    {
+        Lock::GlobalWrite writeLock(opCtx.get(), Date_t::max(), Lock::InterruptBehavior::kThrow);
+        _storageEngine->closeCatalog(opCtx.get());
+        _storageEngine->loadCatalog(opCtx.get(), StorageEngine::LastShutdownState::kClean);
+    }
+
+    auto catalog = CollectionCatalog::get(opCtx.get());
+    for (auto&& nss : collections) {
+        ASSERT(catalog->lookupCollectionByNamespace(opCtx.get(), nss)) << nss;
+    }
+}
+
 TEST_F(StorageEngineTest, ReconcileDropsTemporary) {
     auto opCtx = cc().makeOperationContext();
 
@@ -39,6 +39,7 @@
 #include "mongo/db/storage/ident.h"
 #include "mongo/db/storage/key_format.h"
 #include "mongo/db/storage/record_data.h"
+#include "mongo/util/duration.h"
 
 namespace mongo {
 
@@ -113,6 +114,13 @@ public:
      */
     virtual boost::optional<Record> next() = 0;
 
+    /**
+     * Hints that the caller is about to iterate over a large number of records with next(), so that
+     * the storage engine may start reading the following records ahead of time. Storage engines
+     * which would not benefit from this are free to ignore it.
+     */
+    virtual void setReadAhead(bool readAhead) {}
+
     //
     // Saving and restoring state
     //
@@ -467,9 +475,13 @@ public:
     /**
      * Attempt to reduce the storage space used by this RecordStore.
      *
+     * If 'timeLimit' is set, gives up after roughly that long and returns ExceededTimeLimit. The
+     * space reclaimed before the time limit was reached is kept, so compaction can be resumed by
+     * calling compact() again.
+     *
      * Only called if compactSupported() returns true.
      */
-    virtual Status compact(OperationContext* opCtx) {
+    virtual Status compact(OperationContext* opCtx, boost::optional<Seconds> timeLimit) {
         MONGO_UNREACHABLE;
     }
 
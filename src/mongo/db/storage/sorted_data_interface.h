@@ -127,9 +127,10 @@ public:
 
     /**
      * Attempt to reduce the storage space used by this index via compaction. Only called if the
-     * indexed record store supports compaction-in-place.
+     * indexed record store supports compaction-in-place. See RecordStore::compact() for the
+     * meaning of 'timeLimit'.
      */
-    virtual Status compact(OperationContext* opCtx) {
+    virtual Status compact(OperationContext* opCtx, boost::optional<Seconds> timeLimit) {
         return Status::OK();
     }
 
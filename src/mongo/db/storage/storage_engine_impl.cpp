@@ -47,10 +47,12 @@
 #include "mongo/db/storage/durable_history_pin.h"
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/storage/kv/temporary_kv_record_store.h"
+#include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/db/storage/storage_repair_observer.h"
 #include "mongo/db/storage/storage_util.h"
 #include "mongo/db/storage/two_phase_index_build_knobs_gen.h"
 #include "mongo/logv2/log.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/fail_point.h"
@@ -66,10 +68,18 @@ using std::string;
 using std::vector;
 
 MONGO_FAIL_POINT_DEFINE(failToParseResumeIndexInfo);
+// Loads the catalog on the number of threads given by the 'threads' data, whatever the number of
+// collections and even once the storage engine is installed on the ServiceContext.
+MONGO_FAIL_POINT_DEFINE(loadCatalogInParallel);
+// Fails to build the collection whose namespace is given by the 'nss' data.
+MONGO_FAIL_POINT_DEFINE(failToLoadCollection);
 
 namespace {
 const std::string catalogInfo = "_mdb_catalog";
 const auto kCatalogLogLevel = logv2::LogSeverity::Debug(2);
+
+// Below this many collections per thread, starting threads costs more than it saves.
+const size_t kMinCollectionsPerCatalogLoadThread = 100;
 }  // namespace
 
 StorageEngineImpl::StorageEngineImpl(OperationContext* opCtx,
@@ -235,6 +245,7 @@ void StorageEngineImpl::loadCatalog(OperationContext* opCtx, LastShutdownState l
         }
     }
 
+    std::vector<CollectionToInit> collectionsToInit;
     for (DurableCatalog::Entry entry : catalogEntries) {
         if (loadingFromUncleanShutdownOrRepair) {
             // If we are loading the catalog after an unclean shutdown or during repair, it's
@@ -289,7 +300,7 @@ void StorageEngineImpl::loadCatalog(OperationContext* opCtx, LastShutdownState l
             }
         }
 
-        _initCollection(opCtx, entry.catalogId, entry.nss, _options.forRepair, minVisibleTs);
+        collectionsToInit.push_back({entry.catalogId, entry.nss, minVisibleTs});
 
         if (entry.nss.isOrphanCollection()) {
             LOGV2(22248,
@@ -299,14 +310,130 @@ void StorageEngineImpl::loadCatalog(OperationContext* opCtx, LastShutdownState l
         }
     }
 
+    _initCollections(opCtx, collectionsToInit);
+
     opCtx->recoveryUnit()->abandonSnapshot();
 }
 
+void StorageEngineImpl::_initCollections(OperationContext* opCtx,
+                                         const std::vector<CollectionToInit>& entries) {
+    std::vector<std::shared_ptr<Collection>> collections(entries.size());
+    auto makeCollection = [&](OperationContext* opCtx, size_t i) {
+        const auto& entry = entries[i];
+        collections[i] = _makeCollection(
+            opCtx, entry.catalogId, entry.nss, _options.forRepair, entry.minVisibleTs);
+    };
+
+    size_t numThreads = std::min(static_cast<size_t>(gStorageEngineCatalogLoadThreads),
+                                 entries.size() / kMinCollectionsPerCatalogLoadThread);
+    // The workers need the global lock to read the catalog, which this thread holds exclusively.
+    // Until this storage engine is installed on the ServiceContext no other operation can use it,
+    // so this thread can let go of the lock while the workers run. Otherwise, as when reopening
+    // the catalog for rollback, other operations must not see the catalog half loaded.
+    bool atStartup = opCtx->getServiceContext()->getStorageEngine() != this;
+    loadCatalogInParallel.execute([&](const BSONObj& data) {
+        numThreads = data["threads"].numberInt();
+        atStartup = true;
+    });
+    if (numThreads <= 1 || !atStartup) {
+        for (size_t i = 0; i < entries.size(); ++i) {
+            makeCollection(opCtx, i);
+        }
+    } else {
+        // Opening the oplog's record store also starts the oplog manager, so keep it on this
+        // thread, which holds the global lock.
+        std::vector<size_t> toMakeInParallel;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i].nss.isOplog()) {
+                makeCollection(opCtx, i);
+            } else {
+                toMakeInParallel.push_back(i);
+            }
+        }
+
+        invariant(opCtx->lockState()->isW());
+        Locker::LockSnapshot lockSnapshot;
+        invariant(opCtx->lockState()->saveLockStateAndUnlock(&lockSnapshot));
+        ON_BLOCK_EXIT([&] { opCtx->lockState()->restoreLockState(opCtx, lockSnapshot); });
+
+        AtomicWord<size_t> next{0};
+        Mutex errorMutex = MONGO_MAKE_LATCH("StorageEngineImpl::_initCollections::errorMutex");
+        Status firstError = Status::OK();
+
+        std::vector<stdx::thread> workers;
+        for (size_t t = 0; t < numThreads; ++t) {
+            workers.emplace_back([&, t] {
+                ThreadClient tc("CatalogLoader-" + std::to_string(t), opCtx->getServiceContext());
+                auto workerOpCtx = tc->makeOperationContext();
+                // The storage engine may not be installed on the ServiceContext yet, in which case
+                // new operations only get a noop recovery unit.
+                workerOpCtx->setRecoveryUnit(
+                    std::unique_ptr<RecoveryUnit>(_engine->newRecoveryUnit()),
+                    WriteUnitOfWork::RecoveryUnitState::kNotInUnitOfWork);
+
+                try {
+                    Lock::GlobalLock globalLk(workerOpCtx.get(), MODE_IS);
+                    for (size_t i = next.fetchAndAdd(1); i < toMakeInParallel.size();
+                         i = next.fetchAndAdd(1)) {
+                        makeCollection(workerOpCtx.get(), toMakeInParallel[i]);
+                    }
+                } catch (const DBException& ex) {
+                    // Make the other threads stop early.
+                    next.store(toMakeInParallel.size());
+                    stdx::lock_guard<Latch> lk(errorMutex);
+                    if (firstError.isOK()) {
+                        firstError = ex.toStatus();
+                    }
+                }
+                workerOpCtx->recoveryUnit()->abandonSnapshot();
+            });
+        }
+        for (auto&& worker : workers) {
+            worker.join();
+        }
+        uassertStatusOK(firstError);
+
+        LOGV2_DEBUG(5903200,
+                    1,
+                    "Initialized collections in parallel",
+                    "collections"_attr = toMakeInParallel.size(),
+                    "threads"_attr = numThreads);
+    }
+
+    // Registering collections one at a time would copy the whole CollectionCatalog for each of
+    // them, so register all of them in a single catalog write.
+    CollectionCatalog::write(opCtx, [&](CollectionCatalog& catalog) {
+        for (auto&& collection : collections) {
+            auto uuid = collection->uuid();
+            catalog.registerCollection(opCtx, uuid, std::move(collection));
+        }
+    });
+}
+
 void StorageEngineImpl::_initCollection(OperationContext* opCtx,
                                         RecordId catalogId,
                                         const NamespaceString& nss,
                                         bool forRepair,
                                         Timestamp minVisibleTs) {
+    auto collection = _makeCollection(opCtx, catalogId, nss, forRepair, minVisibleTs);
+    auto uuid = collection->uuid();
+
+    CollectionCatalog::write(opCtx, [&](CollectionCatalog& catalog) {
+        catalog.registerCollection(opCtx, uuid, std::move(collection));
+    });
+}
+
+std::shared_ptr<Collection> StorageEngineImpl::_makeCollection(OperationContext* opCtx,
+                                                               RecordId catalogId,
+                                                               const NamespaceString& nss,
+                                                               bool forRepair,
+                                                               Timestamp minVisibleTs) {
+    failToLoadCollection.executeIf(
+        [&](const BSONObj&) {
+            uasserted(5903201, str::stream() << "Failed to load collection " << nss);
+        },
+        [&](const BSONObj& data) { return data["nss"].str() == nss.ns(); });
+
     auto md = _catalog->getMetaData(opCtx, catalogId);
     uassert(ErrorCodes::MustDowngrade,
             str::stream() << "Collection does not have UUID in KVCatalog. Collection: " << nss,
@@ -327,10 +454,7 @@ void StorageEngineImpl::_initCollection(OperationContext* opCtx,
     auto collectionFactory = Collection::Factory::get(getGlobalServiceContext());
     auto collection = collectionFactory->make(opCtx, nss, catalogId, md, std::move(rs));
     collection->setMinimumVisibleSnapshot(minVisibleTs);
-
-    CollectionCatalog::write(opCtx, [&](CollectionCatalog& catalog) {
-        catalog.registerCollection(opCtx, md->options.uuid.get(), std::move(collection));
-    });
+    return collection;
 }
 
 void StorageEngineImpl::closeCatalog(OperationContext* opCtx) {
@@ -367,6 +367,30 @@ private:
                          bool forRepair,
                          Timestamp minVisibleTs);
 
+    /**
+     * Builds the Collection for the catalog entry 'catalogId' without registering it with the
+     * CollectionCatalog. Only reads from storage, so it may run on any thread with its own
+     * OperationContext.
+     */
+    std::shared_ptr<Collection> _makeCollection(OperationContext* opCtx,
+                                                RecordId catalogId,
+                                                const NamespaceString& nss,
+                                                bool forRepair,
+                                                Timestamp minVisibleTs);
+
+    struct CollectionToInit {
+        RecordId catalogId;
+        NamespaceString nss;
+        Timestamp minVisibleTs;
+    };
+
+    /**
+     * Builds the collections for 'entries', spreading the work across up to
+     * 'storageEngineCatalogLoadThreads' threads, then registers all of them with the
+     * CollectionCatalog in a single catalog write.
+     */
+    void _initCollections(OperationContext* opCtx, const std::vector<CollectionToInit>& entries);
+
     Status _dropCollectionsNoTimestamp(OperationContext* opCtx, const std::vector<UUID>& toDrop);
 
     /**
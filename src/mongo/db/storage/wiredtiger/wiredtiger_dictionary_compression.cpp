@@ -0,0 +1,872 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_dictionary_compression.h"
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <zdict.h>
+#include <zstd.h>
+
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/data_type_validated.h"
+#include "mongo/base/data_view.h"
+#include "mongo/base/parse_number.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/storage_file_util.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/logv2/log.h"
+#include "mongo/rpc/object_check.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+
+// Larger dictionaries rarely compress small documents any better, and all dictionaries of a table
+// are kept in memory for as long as the table exists.
+constexpr size_t kDictionaryCapacity = 64 * 1024;
+
+// Training needs a sample many times larger than the dictionary to produce anything useful.
+constexpr size_t kMinSampleBytes = 10 * kDictionaryCapacity;
+
+// A new dictionary replaces the current one of a table only if it compresses the sample to at most
+// this fraction of the size the current one does. This bounds the number of dictionaries kept for
+// a table whose documents do not change shape.
+constexpr double kMinImprovementRatio = 0.95;
+
+// The file of each compressor is named after its slot. Files with any other name, such as the
+// temporary file left behind by a crash while replacing one, are ignored.
+constexpr auto kFileExtension = ".bson"_sd;
+constexpr auto kTempFileExtension = ".tmp"_sd;
+
+// Every compressed block starts with the length of the zstd frame that follows it, as WiredTiger
+// may hand decompress() a source buffer padded beyond the end of the frame.
+constexpr size_t kBlockHeaderSize = sizeof(uint64_t);
+
+// The extensions loaded by wiredtiger_open() find the object whose compressors they register
+// through the home directory of the connection.
+Mutex registryMutex = MONGO_MAKE_LATCH("WiredTigerDictionaryCompression::registryMutex");
+StringMap<WiredTigerDictionaryCompression*> registry;
+
+std::string getCompressorName(size_t slot) {
+    return "mongodb_zstd_dictionary_" + std::to_string(slot);
+}
+
+/**
+ * Durably replaces the contents of the file 'path' with 'obj', so that a crash leaves either its
+ * previous contents or the new ones.
+ */
+void writeFile(const boost::filesystem::path& path, const BSONObj& obj) {
+    boost::system::error_code ec;
+    if (boost::filesystem::create_directories(path.parent_path(), ec)) {
+        uassertStatusOK(fsyncParentDirectory(path.parent_path()));
+    }
+    uassert(ErrorCodes::FileOpenFailed,
+            str::stream() << "Failed to create " << path.parent_path().string() << ": "
+                          << ec.message(),
+            !ec);
+
+    auto tempPath = path;
+    tempPath.replace_extension(kTempFileExtension.toString());
+    {
+        std::ofstream ofs(tempPath.string(),
+                          std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+        ofs.write(obj.objdata(), obj.objsize());
+        ofs.close();
+        uassert(ErrorCodes::FileStreamFailed,
+                str::stream() << "Failed to write " << tempPath.string() << ": "
+                              << errnoWithDescription(),
+                !ofs.fail());
+    }
+    uassertStatusOK(fsyncFile(tempPath));
+
+    boost::filesystem::rename(tempPath, path, ec);
+    uassert(ErrorCodes::FileRenameFailed,
+            str::stream() << "Failed to rename " << tempPath.string() << " to " << path.string()
+                          << ": " << ec.message(),
+            !ec);
+    uassertStatusOK(fsyncParentDirectory(path));
+}
+
+/**
+ * Durably removes the file 'path', if it exists.
+ */
+void removeFile(const boost::filesystem::path& path) {
+    boost::system::error_code ec;
+    boost::filesystem::remove(path, ec);
+    uassert(ErrorCodes::OperationFailed,
+            str::stream() << "Failed to remove " << path.string() << ": " << ec.message(),
+            !ec);
+    uassertStatusOK(fsyncParentDirectory(path));
+}
+
+BSONObj readFile(const boost::filesystem::path& path) {
+    std::ifstream ifs(path.string(), std::ios_base::in | std::ios_base::binary);
+    uassert(ErrorCodes::FileOpenFailed,
+            str::stream() << "Failed to open " << path.string() << ": " << errnoWithDescription(),
+            ifs.is_open());
+    const std::string buffer{std::istreambuf_iterator<char>(ifs),
+                             std::istreambuf_iterator<char>()};
+    uassert(ErrorCodes::FileStreamFailed,
+            str::stream() << "Failed to read " << path.string() << ": " << errnoWithDescription(),
+            !ifs.bad());
+
+    auto swObj = ConstDataRange(buffer.data(), buffer.size()).readNoThrow<Validated<BSONObj>>();
+    uassertStatusOKWithContext(swObj.getStatus(), str::stream() << "Invalid " << path.string());
+    BSONObj obj = swObj.getValue();
+    return obj.getOwned();
+}
+
+int compressionLevel() {
+    return wiredTigerGlobalOptions.zstdCompressorLevel;
+}
+
+/**
+ * A trained dictionary, along with its digested forms for compression and decompression.
+ */
+struct Dictionary {
+    explicit Dictionary(std::string content)
+        : content(std::move(content)),
+          id(ZDICT_getDictID(this->content.data(), this->content.size())),
+          cdict(ZSTD_createCDict(this->content.data(), this->content.size(), compressionLevel())),
+          ddict(ZSTD_createDDict(this->content.data(), this->content.size())) {
+        invariant(cdict && ddict);
+    }
+
+    ~Dictionary() {
+        ZSTD_freeCDict(cdict);
+        ZSTD_freeDDict(ddict);
+    }
+
+    Dictionary(const Dictionary&) = delete;
+    Dictionary& operator=(const Dictionary&) = delete;
+
+    const std::string content;
+    const unsigned id;
+    ZSTD_CDict* const cdict;
+    ZSTD_DDict* const ddict;
+};
+
+// WiredTiger compresses and decompresses blocks on many threads at once, and creating a zstd
+// context for every block would cost more than compressing it.
+ZSTD_CCtx* getThreadCompressionContext() {
+    thread_local std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> ctx(ZSTD_createCCtx(),
+                                                                          &ZSTD_freeCCtx);
+    return ctx.get();
+}
+
+ZSTD_DCtx* getThreadDecompressionContext() {
+    thread_local std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> ctx(ZSTD_createDCtx(),
+                                                                          &ZSTD_freeDCtx);
+    return ctx.get();
+}
+
+/**
+ * Compresses 'src' into a zstd frame in 'dst', with 'dictionary' if not null. Returns a zstd error
+ * code on failure, which callers check with ZSTD_isError().
+ */
+size_t compressFrame(const Dictionary* dictionary,
+                     const void* src,
+                     size_t srcLen,
+                     void* dst,
+                     size_t dstLen) {
+    auto ctx = getThreadCompressionContext();
+    return dictionary ? ZSTD_compress_usingCDict(ctx, dst, dstLen, src, srcLen, dictionary->cdict)
+                      : ZSTD_compressCCtx(ctx, dst, dstLen, src, srcLen, compressionLevel());
+}
+
+/**
+ * Returns the total size of 'samples' once each of them is compressed with 'dictionary'.
+ */
+size_t compressedSize(const std::vector<std::string>& samples, const Dictionary* dictionary) {
+    size_t total = 0;
+    std::vector<char> buffer;
+    for (auto&& sample : samples) {
+        buffer.resize(ZSTD_compressBound(sample.size()));
+        size_t ret =
+            compressFrame(dictionary, sample.data(), sample.size(), buffer.data(), buffer.size());
+        total += ZSTD_isError(ret) ? sample.size() : ret;
+    }
+    return total;
+}
+
+}  // namespace
+
+
+/**
+ * One of the WiredTiger compressors, bound to at most one table at a time. WiredTiger only knows
+ * about the WT_COMPRESSOR at the start of '_adapter', from which the callbacks find their way back
+ * to this object.
+ */
+class WiredTigerDictionaryCompression::TableCompressor {
+public:
+    TableCompressor(WiredTigerDictionaryCompression* owner, size_t slot)
+        : _owner(owner), _slot(slot) {
+        _adapter.compressor.compress = &TableCompressor::_compress;
+        _adapter.compressor.decompress = &TableCompressor::_decompress;
+        _adapter.owner = this;
+    }
+
+    TableCompressor(const TableCompressor&) = delete;
+    TableCompressor& operator=(const TableCompressor&) = delete;
+
+    WT_COMPRESSOR* getWTCompressor() {
+        return &_adapter.compressor;
+    }
+
+    size_t getSlot() const {
+        return _slot;
+    }
+
+    /**
+     * Returns the ident of the table the compressor is bound to, or an empty string if none.
+     */
+    std::string getIdent() const {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return _ident;
+    }
+
+    bool isBound() const {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return !_ident.empty();
+    }
+
+    void bind(std::string ident) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _ident = std::move(ident);
+    }
+
+    /**
+     * Forgets the dictionaries of the table which was dropped, so that the compressor can be bound
+     * to another one.
+     */
+    void unbind() {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _ident.clear();
+        _current.reset();
+        _dictionaries.clear();
+    }
+
+    /**
+     * Makes 'dictionary' the one new blocks are compressed with. It must already be durable.
+     */
+    void addDictionary(std::shared_ptr<Dictionary> dictionary) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _dictionaries[dictionary->id] = dictionary;
+        _current = std::move(dictionary);
+    }
+
+    /**
+     * Durably writes the binding of the compressor to the table of 'ident' and its dictionaries
+     * to its file, followed by 'newDictionary' if not null, which then becomes the one new blocks
+     * are compressed with. Returns false without writing anything if the compressor is no longer
+     * bound to 'ident'.
+     */
+    bool persist(StringData ident, std::shared_ptr<Dictionary> newDictionary) {
+        stdx::lock_guard<Latch> writeLk(_writeMutex);
+
+        // The current dictionary is written last, so that it is the current one once read again.
+        std::vector<std::shared_ptr<Dictionary>> dictionaries;
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            if (_ident != ident) {
+                return false;
+            }
+            for (auto&& [id, dictionary] : _dictionaries) {
+                if (dictionary != _current) {
+                    dictionaries.push_back(dictionary);
+                }
+            }
+            if (_current) {
+                dictionaries.push_back(_current);
+            }
+        }
+        if (newDictionary) {
+            dictionaries.push_back(newDictionary);
+        }
+
+        BSONObjBuilder builder;
+        builder.append("ident", ident);
+        {
+            BSONArrayBuilder array(builder.subarrayStart("dictionaries"));
+            for (auto&& dictionary : dictionaries) {
+                array.appendBinData(
+                    dictionary->content.size(), BinDataGeneral, dictionary->content.data());
+            }
+        }
+        writeFile(_owner->_getPath(_slot), builder.obj());
+
+        if (newDictionary) {
+            addDictionary(std::move(newDictionary));
+        }
+        return true;
+    }
+
+    /**
+     * Durably removes the file of the compressor, then unbinds it.
+     */
+    void remove() {
+        stdx::lock_guard<Latch> writeLk(_writeMutex);
+        removeFile(_owner->_getPath(_slot));
+        unbind();
+    }
+
+    std::shared_ptr<Dictionary> getCurrentDictionary() const {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return _current;
+    }
+
+    std::shared_ptr<Dictionary> findDictionary(unsigned id) const {
+        stdx::lock_guard<Latch> lk(_mutex);
+        auto it = _dictionaries.find(id);
+        return it == _dictionaries.end() ? nullptr : it->second;
+    }
+
+    size_t getNumDictionaries() const {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return _dictionaries.size();
+    }
+
+private:
+    struct Adapter {
+        WT_COMPRESSOR compressor = {};
+        TableCompressor* owner = nullptr;
+    };
+
+    static TableCompressor* _fromWT(WT_COMPRESSOR* compressor) {
+        return reinterpret_cast<Adapter*>(compressor)->owner;
+    }
+
+    static int _compress(WT_COMPRESSOR* compressor,
+                         WT_SESSION* session,
+                         uint8_t* src,
+                         size_t srcLen,
+                         uint8_t* dst,
+                         size_t dstLen,
+                         size_t* resultLen,
+                         int* compressionFailed) {
+        *compressionFailed = 1;
+        if (dstLen <= kBlockHeaderSize) {
+            return 0;
+        }
+
+        // Blocks of a table for which no dictionary was trained yet are compressed without one.
+        auto dictionary = _fromWT(compressor)->getCurrentDictionary();
+        size_t ret = compressFrame(
+            dictionary.get(), src, srcLen, dst + kBlockHeaderSize, dstLen - kBlockHeaderSize);
+
+        // Failing to compress, most likely because the output would not fit in 'dst', only makes
+        // WiredTiger write the block uncompressed.
+        if (ZSTD_isError(ret) || ret + kBlockHeaderSize >= srcLen) {
+            return 0;
+        }
+
+        DataView(reinterpret_cast<char*>(dst)).write<LittleEndian<uint64_t>>(ret);
+        *resultLen = ret + kBlockHeaderSize;
+        *compressionFailed = 0;
+        return 0;
+    }
+
+    static int _decompress(WT_COMPRESSOR* compressor,
+                           WT_SESSION* session,
+                           uint8_t* src,
+                           size_t srcLen,
+                           uint8_t* dst,
+                           size_t dstLen,
+                           size_t* resultLen) {
+        auto self = _fromWT(compressor);
+        if (srcLen < kBlockHeaderSize) {
+            return WT_ERROR;
+        }
+        const size_t frameLen =
+            ConstDataView(reinterpret_cast<const char*>(src)).read<LittleEndian<uint64_t>>();
+        if (frameLen > srcLen - kBlockHeaderSize) {
+            return WT_ERROR;
+        }
+        const uint8_t* frame = src + kBlockHeaderSize;
+
+        std::shared_ptr<Dictionary> dictionary;
+        if (unsigned id = ZSTD_getDictID_fromFrame(frame, frameLen)) {
+            dictionary = self->findDictionary(id);
+            if (!dictionary) {
+                LOGV2_ERROR(5903400,
+                            "A block was compressed with an unknown dictionary",
+                            "compressor"_attr = getCompressorName(self->_slot),
+                            "dictionaryId"_attr = id);
+                return WT_ERROR;
+            }
+        }
+
+        auto ctx = getThreadDecompressionContext();
+        size_t ret = dictionary
+            ? ZSTD_decompress_usingDDict(ctx, dst, dstLen, frame, frameLen, dictionary->ddict)
+            : ZSTD_decompressDCtx(ctx, dst, dstLen, frame, frameLen);
+        if (ZSTD_isError(ret)) {
+            LOGV2_ERROR(5903401,
+                        "Failed to decompress a block",
+                        "compressor"_attr = getCompressorName(self->_slot),
+                        "error"_attr = ZSTD_getErrorName(ret));
+            return WT_ERROR;
+        }
+
+        *resultLen = ret;
+        return 0;
+    }
+
+    WiredTigerDictionaryCompression* const _owner;
+    const size_t _slot;
+    Adapter _adapter;
+
+    // Serializes the changes to the file of the compressor, which are made without holding
+    // '_mutex' so that blocks can be compressed and decompressed meanwhile.
+    Mutex _writeMutex = MONGO_MAKE_LATCH("WiredTigerDictionaryCompression::TableCompressor::write");
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("WiredTigerDictionaryCompression::TableCompressor");
+    std::string _ident;
+    std::shared_ptr<Dictionary> _current;
+    std::map<unsigned, std::shared_ptr<Dictionary>> _dictionaries;
+};
+
+WiredTigerDictionaryCompression::WiredTigerDictionaryCompression(std::string dbpath)
+    : _dbpath(std::move(dbpath)) {
+    for (size_t slot = 0; slot < kMaxTables; ++slot) {
+        _compressors.push_back(std::make_unique<TableCompressor>(this, slot));
+    }
+
+    // An engine may be created on a dbpath before the previous one on it is destroyed, but only the
+    // latest opens connections.
+    stdx::lock_guard<Latch> lk(registryMutex);
+    registry[_dbpath] = this;
+}
+
+WiredTigerDictionaryCompression::~WiredTigerDictionaryCompression() {
+    stdx::lock_guard<Latch> lk(registryMutex);
+    auto it = registry.find(_dbpath);
+    if (it != registry.end() && it->second == this) {
+        registry.erase(it);
+    }
+}
+
+std::string WiredTigerDictionaryCompression::getOpenExtension() {
+    return "local=(entry=mongo_addWiredTigerDictionaryCompressors)";
+}
+
+Status WiredTigerDictionaryCompression::registerCompressors(WT_CONNECTION* conn) {
+    stdx::lock_guard<Latch> lk(registryMutex);
+    auto it = registry.find(conn->get_home(conn));
+    if (it == registry.end()) {
+        return {ErrorCodes::InternalError,
+                str::stream() << "No compression dictionaries for " << conn->get_home(conn)};
+    }
+
+    // WiredTiger may decompress blocks as soon as the compressors are registered, so they must
+    // already know every dictionary.
+    Status status = it->second->_load();
+    if (!status.isOK()) {
+        return status;
+    }
+
+    for (auto&& compressor : it->second->_compressors) {
+        int ret = conn->add_compressor(conn,
+                                       getCompressorName(compressor->getSlot()).c_str(),
+                                       compressor->getWTCompressor(),
+                                       nullptr);
+        if (ret != 0) {
+            return wtRCToStatus(ret);
+        }
+    }
+    return Status::OK();
+}
+
+Status WiredTigerDictionaryCompression::_load() try {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _slots.clear();
+    for (auto&& compressor : _compressors) {
+        compressor->unbind();
+    }
+
+    const auto directory = boost::filesystem::path(_dbpath) / kDirectoryName.toString();
+    if (!boost::filesystem::exists(directory)) {
+        return Status::OK();
+    }
+
+    for (auto&& entry : boost::filesystem::directory_iterator(directory)) {
+        const auto& path = entry.path();
+        unsigned long slot;
+        if (path.extension() != kFileExtension.toString() ||
+            !NumberParser{}(path.stem().string(), &slot).isOK()) {
+            continue;
+        }
+        uassert(5903414,
+                str::stream() << "Invalid compressor " << slot << " in " << directory.string(),
+                slot < kMaxTables);
+
+        const BSONObj obj = readFile(path);
+        const auto ident = obj["ident"];
+        const auto dictionaries = obj["dictionaries"];
+        uassert(5903413,
+                str::stream() << "Invalid compression dictionaries file " << path.string(),
+                ident.type() == String && !ident.valueStringData().empty() &&
+                    dictionaries.type() == Array);
+
+        auto& compressor = _compressors[slot];
+        compressor->bind(ident.str());
+        _slots[ident.valueStringData()] = slot;
+        for (auto&& dictionary : dictionaries.Obj()) {
+            uassert(5903416,
+                    str::stream() << "Invalid compression dictionary in " << path.string(),
+                    dictionary.type() == BinData);
+            int length;
+            const char* data = dictionary.binData(length);
+            compressor->addDictionary(std::make_shared<Dictionary>(std::string(data, length)));
+        }
+    }
+    return Status::OK();
+} catch (const DBException& ex) {
+    return ex.toStatus();
+} catch (const boost::filesystem::filesystem_error& ex) {
+    return {ErrorCodes::FileStreamFailed,
+            str::stream() << "Failed to read the compression dictionaries: " << ex.what()};
+}
+
+Status WiredTigerDictionaryCompression::startup(WT_CONNECTION* conn, bool readOnly) try {
+    if (readOnly) {
+        return Status::OK();
+    }
+
+    StringSet tables;
+    {
+        WiredTigerSession session(conn);
+        WT_SESSION* s = session.getSession();
+        WT_CURSOR* cursor;
+        uassertStatusOK(wtRCToStatus(s->open_cursor(s, "metadata:", nullptr, nullptr, &cursor)));
+        ON_BLOCK_EXIT([&] { cursor->close(cursor); });
+
+        int ret;
+        while ((ret = cursor->next(cursor)) == 0) {
+            const char* key;
+            uassertStatusOK(wtRCToStatus(cursor->get_key(cursor, &key)));
+            StringData uri(key);
+            if (uri.startsWith(WiredTigerKVEngine::kTableUriPrefix)) {
+                tables.insert(uri.substr(WiredTigerKVEngine::kTableUriPrefix.size()).toString());
+            }
+        }
+        if (ret != WT_NOTFOUND) {
+            uassertStatusOK(wtRCToStatus(ret));
+        }
+    }
+
+    std::vector<TableCompressor*> leaked;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        for (auto it = _slots.begin(); it != _slots.end();) {
+            if (tables.count(it->first)) {
+                ++it;
+                continue;
+            }
+            leaked.push_back(_compressors[it->second].get());
+            _slots.erase(it++);
+        }
+    }
+
+    for (auto compressor : leaked) {
+        LOGV2(5903417,
+              "Freeing the compressor of a table which does not exist",
+              "ident"_attr = compressor->getIdent(),
+              "compressor"_attr = getCompressorName(compressor->getSlot()));
+        _free(compressor);
+    }
+    return Status::OK();
+} catch (const DBException& ex) {
+    return ex.toStatus();
+}
+
+WiredTigerDictionaryCompression::TableCompressor* WiredTigerDictionaryCompression::_find(
+    WithLock, StringData ident) const {
+    auto it = _slots.find(ident);
+    return it == _slots.end() ? nullptr : _compressors[it->second].get();
+}
+
+std::string WiredTigerDictionaryCompression::_getPath(size_t slot) const {
+    const auto path = boost::filesystem::path(_dbpath) / kDirectoryName.toString() /
+        (std::to_string(slot) + kFileExtension);
+    return path.string();
+}
+
+void WiredTigerDictionaryCompression::_free(TableCompressor* compressor) {
+    const std::string ident = compressor->getIdent();
+    try {
+        compressor->remove();
+    } catch (const DBException& ex) {
+        // The compressor stays bound to the dropped table, which only makes it unavailable to
+        // other tables until startup() frees it.
+        LOGV2_WARNING(5903402,
+                      "Failed to remove the compression dictionaries of a dropped table",
+                      "ident"_attr = ident,
+                      "error"_attr = ex.toStatus());
+    }
+}
+
+StatusWith<std::string> WiredTigerDictionaryCompression::addTable(StringData ident) try {
+    TableCompressor* compressor;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (auto bound = _find(lk, ident)) {
+            return getCompressorName(bound->getSlot());
+        }
+
+        auto it = std::find_if(_compressors.begin(), _compressors.end(), [](auto&& compressor) {
+            return !compressor->isBound();
+        });
+        if (it == _compressors.end()) {
+            return {ErrorCodes::CannotCreateCollection,
+                    str::stream() << "Cannot use dictionary compression for more than "
+                                  << kMaxTables << " collections"};
+        }
+
+        // Binding the compressor reserves it, but it is only found through '_slots' once the
+        // binding is durable.
+        compressor = it->get();
+        compressor->bind(ident.toString());
+    }
+
+    // The binding must be durable before the table is created, so that the table never shares
+    // its compressor with another one.
+    auto unbindGuard = makeGuard([&] { compressor->unbind(); });
+    compressor->persist(ident, nullptr);
+    unbindGuard.dismiss();
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    _slots[ident] = compressor->getSlot();
+    return getCompressorName(compressor->getSlot());
+} catch (const DBException& ex) {
+    return ex.toStatus();
+}
+
+void WiredTigerDictionaryCompression::dropTable(StringData ident) {
+    TableCompressor* compressor;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        compressor = _find(lk, ident);
+        if (!compressor) {
+            return;
+        }
+        _slots.erase(ident);
+
+        if (_backupInProgress) {
+            _droppedDuringBackup.push_back(compressor);
+            return;
+        }
+    }
+    _free(compressor);
+}
+
+std::vector<std::string> WiredTigerDictionaryCompression::beginBackup() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    invariant(!_backupInProgress);
+    _backupInProgress = true;
+
+    std::vector<std::string> paths;
+    for (auto&& [ident, slot] : _slots) {
+        paths.push_back(_getPath(slot));
+    }
+    return paths;
+}
+
+void WiredTigerDictionaryCompression::endBackup() {
+    std::vector<TableCompressor*> dropped;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _backupInProgress = false;
+        std::swap(dropped, _droppedDuringBackup);
+    }
+    for (auto compressor : dropped) {
+        _free(compressor);
+    }
+}
+
+size_t WiredTigerDictionaryCompression::getNumDictionaries(StringData ident) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto compressor = _find(lk, ident);
+    return compressor ? compressor->getNumDictionaries() : 0;
+}
+
+void WiredTigerDictionaryCompression::trainDictionaries(WT_CONNECTION* conn) {
+    std::vector<std::pair<std::string, TableCompressor*>> tables;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        for (auto&& [ident, slot] : _slots) {
+            tables.emplace_back(ident, _compressors[slot].get());
+        }
+    }
+
+    for (auto&& [ident, compressor] : tables) {
+        try {
+            _trainDictionary(conn, ident, compressor);
+        } catch (const DBException& ex) {
+            LOGV2_WARNING(5903403,
+                          "Failed to train a compression dictionary",
+                          "ident"_attr = ident,
+                          "error"_attr = ex.toStatus());
+        }
+    }
+}
+
+void WiredTigerDictionaryCompression::_trainDictionary(WT_CONNECTION* conn,
+                                                       const std::string& ident,
+                                                       TableCompressor* compressor) {
+    // Sample the table outside of any transaction; the sample does not need to be consistent.
+    std::vector<std::string> samples;
+    size_t sampleBytes = 0;
+    {
+        WT_SESSION* session;
+        invariantWTOK(conn->open_session(conn, nullptr, "isolation=snapshot", &session));
+        ON_BLOCK_EXIT([&] { session->close(session, nullptr); });
+
+        const std::string uri = WiredTigerKVEngine::kTableUriPrefix + ident;
+        WT_CURSOR* cursor;
+        int ret = session->open_cursor(session, uri.c_str(), nullptr, "next_random=true", &cursor);
+        if (ret == ENOENT || ret == EBUSY) {
+            // The table is being dropped.
+            return;
+        }
+        uassertStatusOK(wtRCToStatus(ret));
+
+        const auto sampleSize = gWiredTigerDictionaryCompressionSampleSize.load();
+        for (int i = 0; i < sampleSize; ++i) {
+            ret = cursor->next(cursor);
+            if (ret == WT_NOTFOUND) {
+                break;
+            }
+            uassertStatusOK(wtRCToStatus(ret));
+
+            WT_ITEM value;
+            uassertStatusOK(wtRCToStatus(cursor->get_value(cursor, &value)));
+            samples.emplace_back(static_cast<const char*>(value.data), value.size);
+            sampleBytes += value.size;
+        }
+    }
+
+    if (sampleBytes < kMinSampleBytes) {
+        LOGV2_DEBUG(5903405,
+                    1,
+                    "Not enough data to train a compression dictionary",
+                    "ident"_attr = ident,
+                    "sampleBytes"_attr = sampleBytes);
+        return;
+    }
+
+    std::string concatenated;
+    std::vector<size_t> sampleSizes;
+    concatenated.reserve(sampleBytes);
+    for (auto&& sample : samples) {
+        concatenated += sample;
+        sampleSizes.push_back(sample.size());
+    }
+
+    std::string content(kDictionaryCapacity, '\0');
+    size_t dictSize = ZDICT_trainFromBuffer(content.data(),
+                                            content.size(),
+                                            concatenated.data(),
+                                            sampleSizes.data(),
+                                            sampleSizes.size());
+    if (ZDICT_isError(dictSize)) {
+        LOGV2_DEBUG(5903406,
+                    1,
+                    "Failed to train a compression dictionary",
+                    "ident"_attr = ident,
+                    "error"_attr = ZDICT_getErrorName(dictSize));
+        return;
+    }
+    content.resize(dictSize);
+
+    auto dictionary = std::make_shared<Dictionary>(std::move(content));
+    if (dictionary->id == 0 || compressor->findDictionary(dictionary->id)) {
+        return;
+    }
+
+    auto current = compressor->getCurrentDictionary();
+    const size_t currentSize = compressedSize(samples, current.get());
+    const size_t newSize = compressedSize(samples, dictionary.get());
+    if (newSize > currentSize * kMinImprovementRatio) {
+        LOGV2_DEBUG(5903407,
+                    1,
+                    "Keeping the current compression dictionary",
+                    "ident"_attr = ident,
+                    "currentSize"_attr = currentSize,
+                    "newSize"_attr = newSize);
+        return;
+    }
+
+    // No block may be compressed with the dictionary until it is durable, or the block would be
+    // unreadable after a crash.
+    if (!compressor->persist(ident, dictionary)) {
+        // The table was dropped while we were training.
+        return;
+    }
+
+    LOGV2(5903409,
+          "Trained a new compression dictionary",
+          "ident"_attr = ident,
+          "dictionaryId"_attr = dictionary->id,
+          "previousSampleSize"_attr = currentSize,
+          "newSampleSize"_attr = newSize);
+}
+
+}  // namespace mongo
+
+/**
+ * WiredTiger extension entry point registering the compressors of the tables using dictionary
+ * compression. Loaded from the running binary, so it is exported and has C linkage.
+ */
+extern "C" MONGO_COMPILER_API_EXPORT int mongo_addWiredTigerDictionaryCompressors(
+    WT_CONNECTION* conn, WT_CONFIG_ARG* config) {
+    using namespace mongo;
+
+    Status status = WiredTigerDictionaryCompression::registerCompressors(conn);
+    if (!status.isOK()) {
+        LOGV2_ERROR(
+            5903410, "Failed to register the compression dictionaries", "error"_attr = status);
+        return EINVAL;
+    }
+    return 0;
+}
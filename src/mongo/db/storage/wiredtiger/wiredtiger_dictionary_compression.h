@@ -0,0 +1,182 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <wiredtiger.h>
+
+#include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * Compresses the tables of collections created with the 'dictionaryCompression' WiredTiger storage
+ * engine option with zstd, using dictionaries trained from a sample of each table's records. Small
+ * documents of a similar shape compress poorly on their own, as a page holds too few of them for
+ * the compressor to learn their common structure; a dictionary provides that structure up front.
+ *
+ * Every such table is bound to one of a fixed number of WiredTiger compressors, which compresses
+ * new blocks with the latest dictionary of the table and decompresses blocks with whichever
+ * dictionary their zstd frame names, so that retraining never makes existing blocks unreadable.
+ *
+ * The binding of each compressor and its dictionaries are stored in a file of its own under the
+ * 'kDirectoryName' directory of the dbpath, which is replaced atomically whenever it changes. As
+ * WiredTiger may need to read compressed tables while opening the connection, to run recovery,
+ * every compressor is registered by a WiredTiger extension loaded by wiredtiger_open(), which
+ * reads these files first: the compressors never have to read anything while WiredTiger waits.
+ *
+ * All methods are thread-safe.
+ */
+class WiredTigerDictionaryCompression {
+public:
+    static constexpr StringData kDirectoryName = "compressionDictionaries"_sd;
+
+    // The number of compressors registered with every connection, which bounds the number of
+    // tables using dictionary compression at any time.
+    static constexpr size_t kMaxTables = 1024;
+
+    /**
+     * Makes this object the one whose compressors the extension registers with the connections
+     * opened on 'dbpath', until it is destroyed or another one is created for 'dbpath'.
+     */
+    explicit WiredTigerDictionaryCompression(std::string dbpath);
+    ~WiredTigerDictionaryCompression();
+
+    /**
+     * Returns the entry to add to the 'extensions' list of wiredtiger_open() so that the
+     * compressors are registered before WiredTiger reads any table.
+     */
+    static std::string getOpenExtension();
+
+    /**
+     * Reads the bindings and dictionaries of the object created for the home directory of 'conn'
+     * into its compressors, and registers every compressor with 'conn'. Called by the extension
+     * returned by getOpenExtension() while the connection is being opened.
+     */
+    static Status registerCompressors(WT_CONNECTION* conn);
+
+    /**
+     * Frees the compressors bound to tables which do not exist once the connection is open, as a
+     * crash between addTable() and the creation of the table leaves them bound, unless 'readOnly'.
+     * Must be called once the connection is open, before any of the other methods below.
+     */
+    Status startup(WT_CONNECTION* conn, bool readOnly);
+
+    /**
+     * Sets up dictionary compression for the table of 'ident', which is about to be created, and
+     * returns the name of the compressor to create it with. Until a dictionary is trained for the
+     * table, its blocks are compressed with plain zstd.
+     */
+    StatusWith<std::string> addTable(StringData ident);
+
+    /**
+     * Removes the dictionaries of the table of 'ident', which has been dropped, and frees its
+     * compressor for another table.
+     */
+    void dropTable(StringData ident);
+
+    /**
+     * Trains a new dictionary for every table using dictionary compression from a random sample of
+     * its records, and starts compressing new blocks with it if it compresses the sample
+     * noticeably better than the table's current dictionary.
+     */
+    void trainDictionaries(WT_CONNECTION* conn);
+
+    /**
+     * Returns the number of dictionaries known for the table of 'ident'.
+     */
+    size_t getNumDictionaries(StringData ident) const;
+
+    /**
+     * Returns the paths of the files of the compressors bound to tables, which a backup of the
+     * WiredTiger files must include. Until endBackup(), the files of dropped tables are kept so
+     * that they can still be copied.
+     */
+    std::vector<std::string> beginBackup();
+    void endBackup();
+
+private:
+    class TableCompressor;
+
+    /**
+     * Reads the files of the compressors into them, replacing whatever they held.
+     */
+    Status _load();
+
+    /**
+     * Returns the compressor bound to the table of 'ident', or nullptr if there is none.
+     */
+    TableCompressor* _find(WithLock, StringData ident) const;
+
+    /**
+     * Returns the path of the file holding the binding and the dictionaries of compressor 'slot'.
+     */
+    std::string _getPath(size_t slot) const;
+
+    /**
+     * Removes the file of 'compressor', which is no longer bound to a table, and makes it
+     * available to another table. Logs and leaves it bound on failure.
+     */
+    void _free(TableCompressor* compressor);
+
+    /**
+     * Trains a new dictionary for the table of 'ident' and, if it is worth it, persists it and
+     * starts compressing with it.
+     */
+    void _trainDictionary(WT_CONNECTION* conn,
+                          const std::string& ident,
+                          TableCompressor* compressor);
+
+    const std::string _dbpath;
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("WiredTigerDictionaryCompression::_mutex");
+
+    // The compressors registered with the connection, indexed by slot. WiredTiger keeps pointers
+    // to them until the connection is closed, so they are only ever rebound to another table.
+    std::vector<std::unique_ptr<TableCompressor>> _compressors;
+
+    // The slot of the compressor bound to each table using dictionary compression.
+    StringMap<size_t> _slots;
+
+    // Set between beginBackup() and endBackup(), during which the compressors of the tables
+    // dropped are only recorded in '_droppedDuringBackup', to be freed by endBackup().
+    bool _backupInProgress = false;
+    std::vector<TableCompressor*> _droppedDuringBackup;
+};
+
+}  // namespace mongo
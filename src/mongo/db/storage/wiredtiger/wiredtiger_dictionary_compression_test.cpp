@@ -0,0 +1,238 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_dictionary_compression.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const std::string kIdent = "collection-1-1234";
+const std::string kUri = "table:" + kIdent;
+
+std::vector<std::string> makeRecords() {
+    std::vector<std::string> records;
+    for (int i = 0; i < 10000; ++i) {
+        BSONObj obj = BSON("_id" << i << "customer" << ("customer" + std::to_string(i % 977))
+                                 << "status" << (i % 3 ? "active" : "suspended") << "balance"
+                                 << i * 1.5 << "address"
+                                 << BSON("street" << std::to_string(i % 101) + " Main Street"
+                                                  << "city"
+                                                  << "Springfield"
+                                                  << "country"
+                                                  << "US"));
+        records.emplace_back(obj.objdata(), obj.objsize());
+    }
+    return records;
+}
+
+void insertRecords(WT_SESSION* session, const std::vector<std::string>& records) {
+    WT_CURSOR* cursor;
+    ASSERT_OK(wtRCToStatus(session->open_cursor(session, kUri.c_str(), nullptr, nullptr, &cursor)));
+    for (size_t i = 0; i < records.size(); ++i) {
+        WT_ITEM value{records[i].data(), records[i].size()};
+        cursor->set_key(cursor, static_cast<int64_t>(i));
+        cursor->set_value(cursor, &value);
+        ASSERT_OK(wtRCToStatus(cursor->insert(cursor)));
+    }
+    ASSERT_OK(wtRCToStatus(cursor->close(cursor)));
+}
+
+void createTable(WT_CONNECTION* conn, const std::string& compressor) {
+    WiredTigerSession session(conn);
+    WT_SESSION* s = session.getSession();
+    const std::string config =
+        "key_format=q,value_format=u,block_compressor=\"" + compressor + "\"";
+    ASSERT_OK(wtRCToStatus(s->create(s, kUri.c_str(), config.c_str())));
+}
+
+void dropTable(WT_CONNECTION* conn) {
+    WiredTigerSession session(conn);
+    WT_SESSION* s = session.getSession();
+    ASSERT_OK(wtRCToStatus(s->drop(s, kUri.c_str(), nullptr)));
+}
+
+size_t countFiles(const std::string& dbpath) {
+    const auto directory = boost::filesystem::path(dbpath) /
+        WiredTigerDictionaryCompression::kDirectoryName.toString();
+    if (!boost::filesystem::exists(directory)) {
+        return 0;
+    }
+    return std::distance(boost::filesystem::directory_iterator(directory),
+                         boost::filesystem::directory_iterator());
+}
+
+WT_CONNECTION* openConnection(const std::string& dbpath) {
+    WT_CONNECTION* conn;
+    const std::string config =
+        "create,extensions=[" + WiredTigerDictionaryCompression::getOpenExtension() + "]";
+    ASSERT_OK(wtRCToStatus(wiredtiger_open(dbpath.c_str(), nullptr, config.c_str(), &conn)));
+    return conn;
+}
+
+TEST(WiredTigerDictionaryCompressionTest, TablesAreReadableWithTrainedDictionariesAfterReopening) {
+    unittest::TempDir dbpath("wiredtiger_dictionary_compression_test");
+    const auto records = makeRecords();
+
+    {
+        WiredTigerDictionaryCompression compression(dbpath.path());
+        WT_CONNECTION* conn = openConnection(dbpath.path());
+        ASSERT_OK(compression.startup(conn, false /* readOnly */));
+
+        auto compressor = compression.addTable(kIdent);
+        ASSERT_OK(compressor.getStatus());
+        createTable(conn, compressor.getValue());
+        {
+            WiredTigerSession session(conn);
+            insertRecords(session.getSession(), records);
+        }
+
+        compression.trainDictionaries(conn);
+        ASSERT_EQUALS(compression.getNumDictionaries(kIdent), 1U);
+
+        // Training again on the same data does not produce a dictionary worth keeping.
+        compression.trainDictionaries(conn);
+        ASSERT_EQUALS(compression.getNumDictionaries(kIdent), 1U);
+
+        // Closing the connection writes every page, compressed with the dictionary.
+        ASSERT_OK(wtRCToStatus(conn->close(conn, nullptr)));
+    }
+
+    {
+        // The dictionaries are read while the connection is opened, before startup().
+        WiredTigerDictionaryCompression compression(dbpath.path());
+        WT_CONNECTION* conn = openConnection(dbpath.path());
+        ASSERT_EQUALS(compression.getNumDictionaries(kIdent), 1U);
+
+        {
+            WiredTigerSession session(conn);
+            WT_SESSION* s = session.getSession();
+            WT_CURSOR* cursor;
+            ASSERT_OK(wtRCToStatus(s->open_cursor(s, kUri.c_str(), nullptr, nullptr, &cursor)));
+            size_t count = 0;
+            while (cursor->next(cursor) == 0) {
+                int64_t key;
+                WT_ITEM value;
+                ASSERT_OK(wtRCToStatus(cursor->get_key(cursor, &key)));
+                ASSERT_OK(wtRCToStatus(cursor->get_value(cursor, &value)));
+                ASSERT_EQUALS(std::string(static_cast<const char*>(value.data), value.size),
+                              records[key]);
+                ++count;
+            }
+            ASSERT_EQUALS(count, records.size());
+            ASSERT_OK(wtRCToStatus(cursor->close(cursor)));
+        }
+
+        ASSERT_OK(compression.startup(conn, false /* readOnly */));
+        ASSERT_EQUALS(compression.getNumDictionaries(kIdent), 1U);
+
+        dropTable(conn);
+        compression.dropTable(kIdent);
+        ASSERT_EQUALS(compression.getNumDictionaries(kIdent), 0U);
+        ASSERT_EQUALS(countFiles(dbpath.path()), 0U);
+        ASSERT_OK(wtRCToStatus(conn->close(conn, nullptr)));
+    }
+
+    {
+        // Dropping the table removed its dictionaries for good.
+        WiredTigerDictionaryCompression compression(dbpath.path());
+        WT_CONNECTION* conn = openConnection(dbpath.path());
+        ASSERT_OK(compression.startup(conn, false /* readOnly */));
+        ASSERT_EQUALS(compression.getNumDictionaries(kIdent), 0U);
+        ASSERT_EQUALS(compression.addTable(kIdent).getValue(), "mongodb_zstd_dictionary_0");
+        ASSERT_OK(wtRCToStatus(conn->close(conn, nullptr)));
+    }
+}
+
+TEST(WiredTigerDictionaryCompressionTest, StartupFreesCompressorOfTableNeverCreated) {
+    unittest::TempDir dbpath("wiredtiger_dictionary_compression_test");
+
+    {
+        // Crash between binding the compressor and creating the table.
+        WiredTigerDictionaryCompression compression(dbpath.path());
+        WT_CONNECTION* conn = openConnection(dbpath.path());
+        ASSERT_OK(compression.startup(conn, false /* readOnly */));
+        ASSERT_EQUALS(compression.addTable(kIdent).getValue(), "mongodb_zstd_dictionary_0");
+        ASSERT_OK(wtRCToStatus(conn->close(conn, nullptr)));
+    }
+
+    WiredTigerDictionaryCompression compression(dbpath.path());
+    WT_CONNECTION* conn = openConnection(dbpath.path());
+    ASSERT_EQUALS(countFiles(dbpath.path()), 1U);
+    ASSERT_OK(compression.startup(conn, false /* readOnly */));
+    ASSERT_EQUALS(countFiles(dbpath.path()), 0U);
+
+    // The compressor is available to another table.
+    ASSERT_EQUALS(compression.addTable("collection-2-1234").getValue(),
+                  "mongodb_zstd_dictionary_0");
+    ASSERT_OK(wtRCToStatus(conn->close(conn, nullptr)));
+}
+
+TEST(WiredTigerDictionaryCompressionTest, BackupKeepsFilesOfTablesDroppedMeanwhile) {
+    unittest::TempDir dbpath("wiredtiger_dictionary_compression_test");
+    WiredTigerDictionaryCompression compression(dbpath.path());
+    WT_CONNECTION* conn = openConnection(dbpath.path());
+    ASSERT_OK(compression.startup(conn, false /* readOnly */));
+
+    auto compressor = compression.addTable(kIdent);
+    ASSERT_OK(compressor.getStatus());
+    createTable(conn, compressor.getValue());
+
+    auto files = compression.beginBackup();
+    ASSERT_EQUALS(files.size(), 1U);
+    ASSERT(boost::filesystem::exists(files[0]));
+
+    dropTable(conn);
+    compression.dropTable(kIdent);
+    ASSERT(boost::filesystem::exists(files[0]));
+
+    // The compressor cannot be bound to another table before its file is removed.
+    ASSERT_EQUALS(compression.addTable("collection-2-1234").getValue(),
+                  "mongodb_zstd_dictionary_1");
+
+    compression.endBackup();
+    ASSERT_FALSE(boost::filesystem::exists(files[0]));
+    ASSERT_EQUALS(compression.addTable("collection-3-1234").getValue(),
+                  "mongodb_zstd_dictionary_0");
+    ASSERT_OK(wtRCToStatus(conn->close(conn, nullptr)));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -46,8 +46,9 @@ WiredTigerExtensions* WiredTigerExtensions::get(ServiceContext* service) {
     return &getConfigHooks(service);
 }
 
-std::string WiredTigerExtensions::getOpenExtensionsConfig() const {
-    if (_wtExtensions.size() == 0) {
+std::string WiredTigerExtensions::getOpenExtensionsConfig(
+    const std::vector<std::string>& engineExtensions) const {
+    if (_wtExtensions.size() == 0 && engineExtensions.size() == 0) {
         return "";
     }
 
@@ -56,6 +57,9 @@ std::string WiredTigerExtensions::getOpenExtensionsConfig() const {
     for (const auto& ext : _wtExtensions) {
         extensions << ext << ",";
     }
+    for (const auto& ext : engineExtensions) {
+        extensions << ext << ",";
+    }
     extensions << "],";
 
     return extensions.str();
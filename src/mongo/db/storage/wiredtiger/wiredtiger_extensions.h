@@ -43,9 +43,12 @@ public:
     static WiredTigerExtensions* get(ServiceContext* service);
 
     /**
-     * Return the `extensions=[...]` piece for a `wiredtiger_open` call.
+     * Return the `extensions=[...]` piece for a `wiredtiger_open` call. 'engineExtensions' are
+     * extensions which the storage engine needs for this particular connection, and are loaded
+     * along with the ones added through addExtension().
      */
-    std::string getOpenExtensionsConfig() const;
+    std::string getOpenExtensionsConfig(
+        const std::vector<std::string>& engineExtensions = {}) const;
 
     /**
      * Add an item to the `wiredtiger_open` extensions list.
@@ -81,6 +81,7 @@ namespace mongo {
 namespace {
 
 MONGO_FAIL_POINT_DEFINE(WTCompactIndexEBUSY);
+MONGO_FAIL_POINT_DEFINE(WTCompactIndexETIMEDOUT);
 MONGO_FAIL_POINT_DEFINE(WTEmulateOutOfOrderNextIndexKey);
 MONGO_FAIL_POINT_DEFINE(WTIndexPauseAfterSearchNear);
 
@@ -475,22 +476,31 @@ Status WiredTigerIndex::initAsEmpty(OperationContext* opCtx) {
     return Status::OK();
 }
 
-Status WiredTigerIndex::compact(OperationContext* opCtx) {
+Status WiredTigerIndex::compact(OperationContext* opCtx, boost::optional<Seconds> timeLimit) {
     dassert(opCtx->lockState()->isWriteLocked());
     WiredTigerSessionCache* cache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
     if (!cache->isEphemeral()) {
         WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
         opCtx->recoveryUnit()->abandonSnapshot();
-        int ret = s->compact(s, uri().c_str(), "timeout=0");
+        int ret =
+            s->compact(s, uri().c_str(), WiredTigerUtil::buildCompactConfig(timeLimit).c_str());
         if (MONGO_unlikely(WTCompactIndexEBUSY.shouldFail())) {
             ret = EBUSY;
         }
+        if (timeLimit && MONGO_unlikely(WTCompactIndexETIMEDOUT.shouldFail())) {
+            ret = ETIMEDOUT;
+        }
 
         if (ret == EBUSY) {
             return Status(ErrorCodes::Interrupted,
                           str::stream() << "Compaction interrupted on " << uri().c_str()
                                         << " due to cache eviction pressure");
         }
+        if (ret == ETIMEDOUT && timeLimit) {
+            return Status(ErrorCodes::ExceededTimeLimit,
+                          str::stream() << "Compaction of " << uri().c_str()
+                                        << " did not finish within " << *timeLimit);
+        }
         invariantWTOK(ret);
     }
     return Status::OK();
@@ -123,7 +123,7 @@ public:
 
     virtual Status initAsEmpty(OperationContext* opCtx);
 
-    Status compact(OperationContext* opCtx) override;
+    Status compact(OperationContext* opCtx, boost::optional<Seconds> timeLimit) override;
 
     const std::string& uri() const {
         return _uri;
@@ -79,10 +79,12 @@
 #include "mongo/db/storage/storage_repair_observer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_cursor.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_dictionary_compression.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_extensions.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_index.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
@@ -244,6 +246,59 @@ private:
     stdx::condition_variable _condvar;
 };
 
+class WiredTigerKVEngine::WiredTigerDictionaryTrainer : public BackgroundJob {
+public:
+    WiredTigerDictionaryTrainer(WiredTigerDictionaryCompression* dictionaryCompression,
+                                WT_CONNECTION* conn)
+        : BackgroundJob(false /* deleteSelf */),
+          _dictionaryCompression(dictionaryCompression),
+          _conn(conn) {}
+
+    virtual string name() const {
+        return "WTDictionaryTrainer";
+    }
+
+    virtual void run() {
+        ThreadClient tc(name(), getGlobalServiceContext());
+        LOGV2_DEBUG(5903411, 1, "starting {name} thread", "name"_attr = name());
+
+        while (!_shuttingDown.load()) {
+            {
+                stdx::unique_lock<Latch> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                _condvar.wait_for(
+                    lock,
+                    stdx::chrono::seconds(
+                        gWiredTigerDictionaryCompressionTrainingIntervalSecs.load()),
+                    [&] { return _shuttingDown.load(); });
+            }
+            if (_shuttingDown.load()) {
+                break;
+            }
+
+            _dictionaryCompression->trainDictionaries(_conn);
+        }
+        LOGV2_DEBUG(5903412, 1, "stopping {name} thread", "name"_attr = name());
+    }
+
+    void shutdown() {
+        _shuttingDown.store(true);
+        {
+            stdx::unique_lock<Latch> lock(_mutex);
+            _condvar.notify_one();
+        }
+        wait();
+    }
+
+private:
+    WiredTigerDictionaryCompression* const _dictionaryCompression;
+    WT_CONNECTION* const _conn;
+    AtomicWord<bool> _shuttingDown{false};
+
+    Mutex _mutex = MONGO_MAKE_LATCH("WiredTigerDictionaryTrainer::_mutex");  // protects _condvar
+    stdx::condition_variable _condvar;
+};
+
 std::string toString(const StorageEngine::OldestActiveTransactionTimestampResult& r) {
     if (r.isOK()) {
         if (r.getValue()) {
@@ -414,7 +469,9 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
 
     ss << WiredTigerCustomizationHooks::get(getGlobalServiceContext())
               ->getTableCreateConfig("system");
-    ss << WiredTigerExtensions::get(getGlobalServiceContext())->getOpenExtensionsConfig();
+    _dictionaryCompression = std::make_unique<WiredTigerDictionaryCompression>(path);
+    ss << WiredTigerExtensions::get(getGlobalServiceContext())
+              ->getOpenExtensionsConfig({WiredTigerDictionaryCompression::getOpenExtension()});
     ss << extraOpenOptions;
 
     if (!_durable) {
@@ -516,6 +573,10 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     _sessionSweeper = std::make_unique<WiredTigerSessionSweeper>(_sessionCache.get());
     _sessionSweeper->go();
 
+    if (!_readOnly && !_ephemeral) {
+        _readAhead = std::make_unique<WiredTigerReadAhead>(_sessionCache.get());
+    }
+
     // Until the Replication layer installs a real callback, prevent truncating the oplog.
     setOldestActiveTransactionTimestampCallback(
         [](Timestamp) { return StatusWith(boost::make_optional(Timestamp::min())); });
@@ -575,6 +636,16 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
 
     _sizeStorer = std::make_unique<WiredTigerSizeStorer>(_conn, _sizeStorerUri, _readOnly);
 
+    if (!_ephemeral) {
+        fassert(5903415, _dictionaryCompression->startup(_conn, _readOnly));
+    }
+
+    if (!_readOnly && !_ephemeral) {
+        _dictionaryTrainer =
+            std::make_unique<WiredTigerDictionaryTrainer>(_dictionaryCompression.get(), _conn);
+        _dictionaryTrainer->go();
+    }
+
     Locker::setGlobalThrottling(&openReadTransaction, &openWriteTransaction);
 
     _runTimeConfigParam.reset(new WiredTigerEngineRuntimeConfigParameter(
@@ -723,6 +794,12 @@ void WiredTigerKVEngine::cleanShutdown() {
         _sessionSweeper->shutdown();
         LOGV2(22319, "Finished shutting down session sweeper thread");
     }
+    if (_dictionaryTrainer) {
+        _dictionaryTrainer->shutdown();
+    }
+    if (_readAhead) {
+        _readAhead->shutdown();
+    }
     LOGV2_FOR_RECOVERY(23988,
                        2,
                        "Shutdown timestamps.",
@@ -1037,11 +1114,13 @@ public:
     explicit StreamingCursorImpl(WT_SESSION* session,
                                  std::string path,
                                  StorageEngine::BackupOptions options,
-                                 WiredTigerBackup* wtBackup)
+                                 WiredTigerBackup* wtBackup,
+                                 std::vector<std::string> dictionaryFiles)
         : StorageEngine::StreamingCursor(options),
           _session(session),
           _path(path),
-          _wtBackup(wtBackup){};
+          _wtBackup(wtBackup),
+          _dictionaryFiles(std::move(dictionaryFiles)){};
 
     ~StreamingCursorImpl() = default;
 
@@ -1112,6 +1191,24 @@ public:
             return wtRCToStatus(wtRet);
         }
 
+        // The compression dictionaries are stored outside of WiredTiger, so they follow its files.
+        // They are always copied whole, as they are replaced rather than modified.
+        while (wtRet == WT_NOTFOUND && backupBlocks.size() < batchSize &&
+               !_dictionaryFiles.empty()) {
+            const std::string filePath = std::move(_dictionaryFiles.back());
+            _dictionaryFiles.pop_back();
+
+            boost::system::error_code errorCode;
+            const std::uint64_t fileSize = boost::filesystem::file_size(filePath, errorCode);
+            uassert(31403,
+                    "Failed to get a file's size. Filename: {} Error: {}"_format(
+                        filePath, errorCode.message()),
+                    !errorCode);
+
+            const std::uint64_t length = options.incrementalBackup ? fileSize : 0;
+            backupBlocks.push_back({filePath, 0 /* offset */, length, fileSize});
+        }
+
         return backupBlocks;
     }
 
@@ -1182,6 +1279,7 @@ private:
     WT_SESSION* _session;
     std::string _path;
     WiredTigerBackup* _wtBackup;  // '_wtBackup' is an out parameter.
+    std::vector<std::string> _dictionaryFiles;
 };
 
 }  // namespace
@@ -1233,8 +1331,8 @@ WiredTigerKVEngine::beginNonBlockingBackup(OperationContext* opCtx,
 
     invariant(_wtBackup.logFilePathsSeenByExtendBackupCursor.empty());
     invariant(_wtBackup.logFilePathsSeenByGetNextBatch.empty());
-    auto streamingCursor =
-        std::make_unique<StreamingCursorImpl>(session, _path, options, &_wtBackup);
+    auto streamingCursor = std::make_unique<StreamingCursorImpl>(
+        session, _path, options, &_wtBackup, _dictionaryCompression->beginBackup());
 
     pinOplogGuard.dismiss();
     _backupSession = std::move(sessionRaii);
@@ -1247,6 +1345,7 @@ void WiredTigerKVEngine::endNonBlockingBackup(OperationContext* opCtx) {
     stdx::lock_guard<Latch> backupCursorLk(_wtBackup.wtBackupCursorMutex);
     stdx::lock_guard<Latch> backupDupCursorLk(_wtBackup.wtBackupDupCursorMutex);
     _backupSession.reset();
+    _dictionaryCompression->endBackup();
     {
         // Oplog truncation thread can now remove the pinned oplog.
         stdx::lock_guard<Latch> lock(_oplogPinnedByBackupMutex);
@@ -1351,6 +1450,18 @@ Status WiredTigerKVEngine::createRecordStore(OperationContext* opCtx,
     }
     std::string config = result.getValue();
 
+    if (!_ephemeral &&
+        WiredTigerRecordStore::usesDictionaryCompression(
+            options.storageEngine.getObjectField(_canonicalName))) {
+        auto compressor = _dictionaryCompression->addTable(ident);
+        if (!compressor.isOK()) {
+            return compressor.getStatus();
+        }
+        // The compressor is specific to the table, so it can only be chosen here. Being last, it
+        // overrides any block compressor set earlier in the configuration.
+        config += ",block_compressor=\"" + compressor.getValue() + "\"";
+    }
+
     string uri = _uri(ident);
     WT_SESSION* s = session.getSession();
     LOGV2_DEBUG(22331,
@@ -1665,10 +1776,12 @@ Status WiredTigerKVEngine::dropIdent(RecoveryUnit* ru,
     }
 
     if (ret == ENOENT) {
+        _dictionaryCompression->dropTable(ident);
         return Status::OK();
     }
 
     invariantWTOK(ret);
+    _dictionaryCompression->dropTable(ident);
     return Status::OK();
 }
 
@@ -1789,6 +1902,8 @@ void WiredTigerKVEngine::dropSomeQueuedIdents() {
             _identToDrop.push_back(std::move(identToDrop));
         } else {
             invariantWTOK(ret);
+            _dictionaryCompression->dropTable(
+                StringData(identToDrop.uri).substr(kTableUriPrefix.size()));
             if (identToDrop.callback) {
                 identToDrop.callback();
             }
@@ -1800,6 +1915,37 @@ bool WiredTigerKVEngine::supportsDirectoryPerDB() const {
     return true;
 }
 
+boost::optional<KVEngine::CheckpointPressure> WiredTigerKVEngine::getCheckpointPressure() {
+    if (_ephemeral || _readOnly) {
+        return boost::none;
+    }
+
+    auto session = _sessionCache->getSession();
+    auto getStat = [&](int key) {
+        return WiredTigerUtil::getStatisticsValue(
+            session->getSession(), "statistics:", "statistics=(fast)", key);
+    };
+
+    auto dirtyBytes = getStat(WT_STAT_CONN_CACHE_BYTES_DIRTY);
+    auto cacheBytes = getStat(WT_STAT_CONN_CACHE_BYTES_MAX);
+    auto historyStoreBytes = getStat(WT_STAT_CONN_CACHE_HS_ONDISK);
+    for (const auto& stat : {dirtyBytes, cacheBytes, historyStoreBytes}) {
+        if (!stat.isOK()) {
+            LOGV2_DEBUG(5903800,
+                        1,
+                        "Failed to read checkpoint pressure statistics",
+                        "error"_attr = stat.getStatus());
+            return boost::none;
+        }
+    }
+
+    CheckpointPressure pressure;
+    pressure.dirtyBytes = dirtyBytes.getValue();
+    pressure.cacheBytes = cacheBytes.getValue();
+    pressure.historyStoreBytes = historyStoreBytes.getValue();
+    return pressure;
+}
+
 void WiredTigerKVEngine::checkpoint() {
     const Timestamp stableTimestamp = getStableTimestamp();
     const Timestamp initialDataTimestamp = getInitialDataTimestamp();
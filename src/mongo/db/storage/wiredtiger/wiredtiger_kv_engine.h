@@ -53,6 +53,8 @@ namespace mongo {
 
 class ClockSource;
 class JournalListener;
+class WiredTigerDictionaryCompression;
+class WiredTigerReadAhead;
 class WiredTigerRecordStore;
 class WiredTigerSessionCache;
 class WiredTigerSizeStorer;
@@ -113,6 +115,8 @@ public:
 
     void checkpoint() override;
 
+    boost::optional<CheckpointPressure> getCheckpointPressure() override;
+
     bool isDurable() const override {
         return _durable;
     }
@@ -297,6 +301,14 @@ public:
         return _oplogManager.get();
     }
 
+    /**
+     * Returns the service reading records ahead of collection scans, or nullptr for in-memory and
+     * read-only engines.
+     */
+    WiredTigerReadAhead* getReadAhead() const {
+        return _readAhead.get();
+    }
+
     static void appendGlobalStats(BSONObjBuilder& b);
 
     Timestamp getStableTimestamp() const override;
@@ -362,6 +374,7 @@ public:
 
 private:
     class WiredTigerSessionSweeper;
+    class WiredTigerDictionaryTrainer;
 
     struct IdentToDrop {
         std::string uri;
@@ -456,6 +469,13 @@ private:
 
     std::unique_ptr<WiredTigerSessionSweeper> _sessionSweeper;
 
+    // Compressors of the tables of collections using dictionary compression, which must outlive
+    // the connection, and the thread periodically retraining their dictionaries.
+    std::unique_ptr<WiredTigerDictionaryCompression> _dictionaryCompression;
+    std::unique_ptr<WiredTigerDictionaryTrainer> _dictionaryTrainer;
+
+    std::unique_ptr<WiredTigerReadAhead> _readAhead;
+
     std::string _rsOptions;
     std::string _indexOptions;
 
@@ -45,12 +45,15 @@
 #include "mongo/db/service_context_test_fixture.h"
 #include "mongo/db/storage/checkpointer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/logv2/log.h"
 #include "mongo/unittest/log_test.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -501,6 +504,76 @@ TEST_F(WiredTigerKVEngineTest, TestPinOldestTimestampErrors) {
     ASSERT_EQ(initTs, _engine->getOldestTimestamp());
 }
 
+TEST_F(WiredTigerKVEngineTest, ScansWithReadAheadReturnEveryRecord) {
+    auto opCtxPtr = _makeOperationContext();
+
+    NamespaceString nss("a.b");
+    std::string ident = "collection-1234";
+    std::string record = "abcd";
+    CollectionOptions defaultCollectionOptions;
+
+    ASSERT_OK(
+        _engine->createRecordStore(opCtxPtr.get(), nss.ns(), ident, defaultCollectionOptions));
+    auto rs = _engine->getRecordStore(opCtxPtr.get(), nss.ns(), ident, defaultCollectionOptions);
+    ASSERT(rs);
+
+    const int nRecords = 1000;
+    {
+        WriteUnitOfWork uow(opCtxPtr.get());
+        for (int i = 0; i < nRecords; ++i) {
+            StatusWith<RecordId> res =
+                rs->insertRecord(opCtxPtr.get(), record.c_str(), record.length() + 1, Timestamp());
+            ASSERT_OK(res.getStatus());
+        }
+        uow.commit();
+    }
+
+    const auto originalReadAheadRecords = gWiredTigerCursorReadAheadRecords.load();
+    gWiredTigerCursorReadAheadRecords.store(10);
+    ON_BLOCK_EXIT([&] { gWiredTigerCursorReadAheadRecords.store(originalReadAheadRecords); });
+
+    // Without the hint, a scan does not read ahead.
+    const auto numRecordsReadBefore = WiredTigerReadAhead::getNumRecordsRead();
+    {
+        auto cursor = rs->getCursor(opCtxPtr.get(), /*forward=*/true);
+        int nSeen = 0;
+        while (cursor->next()) {
+            ++nSeen;
+        }
+        ASSERT_EQ(nRecords, nSeen);
+    }
+    ASSERT_EQ(numRecordsReadBefore, WiredTigerReadAhead::getNumRecordsRead());
+
+    for (bool forward : {true, false}) {
+        const auto numRecordsReadBeforeScan = WiredTigerReadAhead::getNumRecordsRead();
+        auto cursor = rs->getCursor(opCtxPtr.get(), forward);
+        cursor->setReadAhead(true);
+
+        int nSeen = 0;
+        RecordId lastId;
+        while (auto next = cursor->next()) {
+            if (nSeen > 0) {
+                ASSERT(forward ? lastId < next->id : next->id < lastId);
+            }
+            lastId = next->id;
+            ++nSeen;
+
+            // Reads ahead must not get in the way of yielding.
+            if (nSeen % 100 == 0) {
+                cursor->save();
+                opCtxPtr->recoveryUnit()->abandonSnapshot();
+                ASSERT(cursor->restore());
+            }
+        }
+        ASSERT_EQ(nRecords, nSeen);
+
+        // Every read scheduled by the scan starts at an existing record, so the records it read
+        // are counted once it completes.
+        while (WiredTigerReadAhead::getNumRecordsRead() == numRecordsReadBeforeScan) {
+            sleepmillis(1);
+        }
+    }
+}
 
 std::unique_ptr<KVHarnessHelper> makeHelper(ServiceContext* svcCtx) {
     return std::make_unique<WiredTigerKVHarnessHelper>(svcCtx);
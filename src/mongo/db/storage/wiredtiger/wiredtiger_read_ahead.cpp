@@ -0,0 +1,149 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
+
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+// Read-ahead only needs to keep a few reads in flight per disk to hide its latency; more threads
+// would mostly compete with the scans themselves for the cache.
+constexpr size_t kMaxReadAheadThreads = 4;
+
+Counter64 readAheadRecords;
+ServerStatusMetricField<Counter64> displayReadAheadRecords("storage.readAhead.records",
+                                                           &readAheadRecords);
+
+ThreadPool::Options makeThreadPoolOptions() {
+    ThreadPool::Options options;
+    options.poolName = "WTReadAhead";
+    options.threadNamePrefix = "WTReadAhead-";
+    options.minThreads = 0;
+    options.maxThreads = kMaxReadAheadThreads;
+    return options;
+}
+}  // namespace
+
+WiredTigerReadAhead::WiredTigerReadAhead(WiredTigerSessionCache* sessionCache)
+    : _sessionCache(sessionCache), _pool(makeThreadPoolOptions()) {
+    _pool.startup();
+}
+
+WiredTigerReadAhead::~WiredTigerReadAhead() {
+    shutdown();
+}
+
+int64_t WiredTigerReadAhead::getNumRecordsRead() {
+    return readAheadRecords.get();
+}
+
+void WiredTigerReadAhead::shutdown() {
+    if (_shutDown.swap(true)) {
+        return;
+    }
+
+    _pool.shutdown();
+    _pool.join();
+}
+
+bool WiredTigerReadAhead::schedule(const std::string& uri,
+                                   KeyFormat keyFormat,
+                                   const RecordId& start,
+                                   bool forward,
+                                   int64_t nRecords,
+                                   const std::shared_ptr<AtomicWord<bool>>& inFlight) {
+    if (inFlight->swap(true)) {
+        return false;
+    }
+
+    _pool.schedule([this, uri, keyFormat, start, forward, nRecords, inFlight](Status status) {
+        ON_BLOCK_EXIT([&] { inFlight->store(false); });
+        if (status.isOK()) {
+            _readAhead(uri, keyFormat, start, forward, nRecords);
+        }
+    });
+    return true;
+}
+
+void WiredTigerReadAhead::_readAhead(const std::string& uri,
+                                     KeyFormat keyFormat,
+                                     const RecordId& start,
+                                     bool forward,
+                                     int64_t nRecords) {
+    if (_sessionCache->isShuttingDown()) {
+        return;
+    }
+
+    auto session = _sessionCache->getSession();
+    WT_SESSION* s = session->getSession();
+
+    // The table may have been dropped since the read was scheduled, which is not worth reporting.
+    WT_CURSOR* c;
+    int ret = s->open_cursor(s, uri.c_str(), nullptr, nullptr, &c);
+    if (ret != 0) {
+        LOGV2_DEBUG(5903600,
+                    2,
+                    "Could not open a cursor to read ahead",
+                    "uri"_attr = uri,
+                    "error"_attr = wtRCToStatus(ret));
+        return;
+    }
+    ON_BLOCK_EXIT([&] { invariantWTOK(c->close(c)); });
+
+    if (keyFormat == KeyFormat::Long) {
+        c->set_key(c, start.getLong());
+    } else {
+        auto str = start.getStr();
+        WiredTigerItem item(str.rawData(), str.size());
+        c->set_key(c, item.Get());
+    }
+
+    // Walking the records is all it takes to bring their pages into the cache. Give up on anything
+    // unexpected, such as a prepare conflict or a rollback under cache pressure: nobody is waiting
+    // for this read, and the scan will simply read the remaining pages itself.
+    int cmp;
+    ret = c->search_near(c, &cmp);
+    int64_t nRead = 0;
+    while (ret == 0 && nRead < nRecords) {
+        ret = forward ? c->next(c) : c->prev(c);
+        ++nRead;
+    }
+    readAheadRecords.increment(nRead);
+}
+
+}  // namespace mongo
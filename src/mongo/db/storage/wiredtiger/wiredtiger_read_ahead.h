@@ -0,0 +1,97 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/key_format.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+
+class WiredTigerSessionCache;
+
+/**
+ * Reads records of a table ahead of a cursor scanning it, on a small pool of background threads,
+ * so that the pages the cursor is about to visit are already in the WiredTiger cache by the time
+ * it gets there. This only warms the cache: the records read ahead are never returned to anyone.
+ */
+class WiredTigerReadAhead {
+    WiredTigerReadAhead(const WiredTigerReadAhead&) = delete;
+    WiredTigerReadAhead& operator=(const WiredTigerReadAhead&) = delete;
+
+public:
+    explicit WiredTigerReadAhead(WiredTigerSessionCache* sessionCache);
+
+    ~WiredTigerReadAhead();
+
+    /**
+     * Returns the number of records read ahead by this process, reported in serverStatus as
+     * storage.readAhead.records.
+     */
+    static int64_t getNumRecordsRead();
+
+    /**
+     * Drops the pending reads and waits for the running ones to finish. Must be called before the
+     * session cache shuts down. Only the first call has any effect.
+     */
+    void shutdown();
+
+    /**
+     * Schedules reading the 'nRecords' records of the table 'uri' which follow 'start', or precede
+     * it when not 'forward'. 'inFlight' is set until the read has completed, which lets a cursor
+     * keep at most one read ahead of itself. Returns false if a read was already in flight.
+     */
+    bool schedule(const std::string& uri,
+                  KeyFormat keyFormat,
+                  const RecordId& start,
+                  bool forward,
+                  int64_t nRecords,
+                  const std::shared_ptr<AtomicWord<bool>>& inFlight);
+
+private:
+    void _readAhead(const std::string& uri,
+                    KeyFormat keyFormat,
+                    const RecordId& start,
+                    bool forward,
+                    int64_t nRecords);
+
+    WiredTigerSessionCache* const _sessionCache;
+
+    ThreadPool _pool;
+
+    // Set by the first call to shutdown(), since the pool can only be joined once.
+    AtomicWord<bool> _shutDown{false};
+};
+
+}  // namespace mongo
@@ -38,12 +38,14 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "mongo/base/checked_cast.h"
 #include "mongo/base/static_assert.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/catalog/validate_results.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/global_settings.h"
@@ -60,7 +62,9 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_prepare_conflict.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_read_ahead.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
@@ -83,6 +87,9 @@ using std::unique_ptr;
 
 namespace {
 
+// Name of the 'wiredTiger' collection option enabling dictionary compression.
+constexpr auto kDictionaryCompressionFieldName = "dictionaryCompression"_sd;
+
 struct RecordIdAndWall {
     RecordId id;
     Date_t wall;
@@ -107,6 +114,21 @@ MONGO_STATIC_ASSERT(kCurrentRecordStoreVersion <= kMaximumRecordStoreVersion);
 
 const double kNumMSInHour = 1000 * 60 * 60;
 
+// Number of record stores whose table format version was checked when the table was first used,
+// rather than when the record store was constructed.
+Counter64 deferredFormatVersionChecksCounter;
+ServerStatusMetricField<Counter64> displayDeferredFormatVersionChecks(
+    "storage.deferredFormatVersionChecks", &deferredFormatVersionChecksCounter);
+
+// The table of the durable catalog, which is read to open every other table.
+const std::string kCatalogIdent = "_mdb_catalog";
+
+Status checkFormatVersion(OperationContext* opCtx, const std::string& uri) {
+    return WiredTigerUtil::checkApplicationMetadataFormatVersion(
+               opCtx, uri, kMinimumRecordStoreVersion, kMaximumRecordStoreVersion)
+        .getStatus();
+}
+
 void checkOplogFormatVersion(OperationContext* opCtx, const std::string& uri) {
     StatusWith<BSONObj> appMetadata = WiredTigerUtil::getApplicationMetadata(opCtx, uri);
     fassert(39999, appMetadata);
@@ -116,6 +138,7 @@ void checkOplogFormatVersion(OperationContext* opCtx, const std::string& uri) {
 }  // namespace
 
 MONGO_FAIL_POINT_DEFINE(WTCompactRecordStoreEBUSY);
+MONGO_FAIL_POINT_DEFINE(WTCompactRecordStoreETIMEDOUT);
 MONGO_FAIL_POINT_DEFINE(WTWriteConflictException);
 MONGO_FAIL_POINT_DEFINE(WTWriteConflictExceptionForReads);
 MONGO_FAIL_POINT_DEFINE(slowOplogSamplingReads);
@@ -157,6 +180,7 @@ public:
 
         _oplogStones->_currentRecords.addAndFetch(_countInserted);
         int64_t newCurrentBytes = _oplogStones->_currentBytes.addAndFetch(_bytesInserted);
+        _oplogStones->_advanceLastAccountedRecord(_recordId);
         if (_wall != Date_t() && newCurrentBytes >= _oplogStones->_minBytesPerStone) {
             // When other InsertChanges commit concurrently, an uninitialized wallTime may delay the
             // creation of a new stone. This delay is limited to the number of concurrently running
@@ -183,6 +207,7 @@ public:
     void commit(boost::optional<Timestamp>) final {
         _oplogStones->_currentRecords.store(0);
         _oplogStones->_currentBytes.store(0);
+        _oplogStones->_lastAccountedRecord.store(0);
 
         stdx::lock_guard<Latch> lk(_oplogStones->_mutex);
         _oplogStones->_stones.clear();
@@ -401,6 +426,10 @@ void WiredTigerRecordStore::OplogStones::updateStonesAfterCappedTruncateAfter(
     // being filled.
     _currentRecords.addAndFetch(recordsInStonesToRemove - recordsRemoved);
     _currentBytes.addAndFetch(bytesInStonesToRemove - bytesRemoved);
+
+    if (_lastAccountedRecord.load() >= firstRemovedId.getLong()) {
+        _lastAccountedRecord.store(firstRemovedId.getLong() - 1);
+    }
 }
 
 void WiredTigerRecordStore::OplogStones::setMinBytesPerStone(int64_t size) {
@@ -442,6 +471,12 @@ void WiredTigerRecordStore::OplogStones::_calculateStones(OperationContext* opCt
         return;
     }
 
+    // Reload the stones stored by the size storer, which only requires scanning the records
+    // written since they were stored, regardless of the size of the oplog.
+    if (_loadPersistedStones(opCtx)) {
+        return;
+    }
+
     // Only use sampling to estimate where to place the oplog stones if the number of samples drawn
     // is less than 5% of the collection.
     const uint64_t kMinSampleRatioForRandCursor = 20;
@@ -473,20 +508,7 @@ void WiredTigerRecordStore::OplogStones::_calculateStonesByScanning(OperationCon
 
     auto cursor = _rs->getCursor(opCtx, true);
     while (auto record = cursor->next()) {
-        _currentRecords.addAndFetch(1);
-        int64_t newCurrentBytes = _currentBytes.addAndFetch(record->data.size());
-        if (newCurrentBytes >= _minBytesPerStone) {
-            BSONObj obj = record->data.toBson();
-            auto wallTime = obj.hasField("wall") ? obj["wall"].Date() : obj["ts"].timestampTime();
-
-            LOGV2_DEBUG(22385,
-                        1,
-                        "Marking oplog entry as a potential future oplog truncation point",
-                        "wall"_attr = wallTime);
-
-            _stones.emplace_back(
-                _currentRecords.swap(0), _currentBytes.swap(0), record->id, wallTime);
-        }
+        _addRecordToCurrentStone_inlock(*record);
 
         numRecords++;
         dataSize += record->data.size();
@@ -495,6 +517,96 @@ void WiredTigerRecordStore::OplogStones::_calculateStonesByScanning(OperationCon
     _rs->updateStatsAfterRepair(opCtx, numRecords, dataSize);
 }
 
+bool WiredTigerRecordStore::OplogStones::_loadPersistedStones(OperationContext* opCtx) {
+    if (!gPersistOplogStones) {
+        return false;
+    }
+
+    BSONObj persistedStones = _rs->_sizeInfo->getOplogStones();
+    if (persistedStones.isEmpty()) {
+        return false;
+    }
+
+    // The stored stones were accurate as of the size storer's last flush. Only use them if the
+    // oplog still contains the newest record they account for.
+    RecordId firstRecordId;
+    RecordId lastRecordId;
+    {
+        auto cursor = _rs->getCursor(opCtx, /*forward=*/true);
+        if (auto record = cursor->next()) {
+            firstRecordId = record->id;
+        }
+    }
+    {
+        auto cursor = _rs->getCursor(opCtx, /*forward=*/false);
+        if (auto record = cursor->next()) {
+            lastRecordId = record->id;
+        }
+    }
+
+    std::deque<OplogStones::Stone> stones;
+    RecordId lastAccountedRecord;
+    try {
+        lastAccountedRecord = RecordId(persistedStones["lastRecord"].safeNumberLong());
+        for (auto&& elem : persistedStones["stones"].Obj()) {
+            BSONObj stone = elem.Obj();
+            RecordId stoneLastRecord(stone["lastRecord"].safeNumberLong());
+            if (stoneLastRecord < firstRecordId) {
+                // The records of this stone were truncated after the stones were stored.
+                continue;
+            }
+            uassert(5905000,
+                    "Persisted oplog stones are not in ascending order",
+                    stones.empty() || stones.back().lastRecord <= stoneLastRecord);
+            stones.emplace_back(stone["records"].safeNumberLong(),
+                                stone["bytes"].safeNumberLong(),
+                                stoneLastRecord,
+                                stone["wallTime"].Date());
+        }
+    } catch (const DBException& ex) {
+        LOGV2_WARNING(5905001,
+                      "Failed to parse the persisted oplog stones, recalculating them",
+                      "error"_attr = ex.toStatus());
+        return false;
+    }
+
+    if (lastAccountedRecord.isNull() || lastAccountedRecord < firstRecordId ||
+        lastAccountedRecord > lastRecordId ||
+        (!stones.empty() && stones.back().lastRecord > lastAccountedRecord)) {
+        LOGV2(5905002,
+              "The persisted oplog stones do not match the oplog, recalculating them",
+              "lastAccountedRecord"_attr = lastAccountedRecord,
+              "firstRecord"_attr = firstRecordId,
+              "lastRecord"_attr = lastRecordId);
+        return false;
+    }
+
+    _processFromPersistedStones.store(true);
+    _stones = std::move(stones);
+    _currentRecords.store(persistedStones["currentRecords"].safeNumberLong());
+    _currentBytes.store(persistedStones["currentBytes"].safeNumberLong());
+    _lastAccountedRecord.store(lastAccountedRecord.getLong());
+
+    // Account for the records written after the stones were stored.
+    long long numTailRecords = 0;
+    auto cursor = _rs->getCursor(opCtx, /*forward=*/true);
+    auto record = cursor->seekNear(lastAccountedRecord);
+    if (record && record->id <= lastAccountedRecord) {
+        record = cursor->next();
+    }
+    for (; record; record = cursor->next()) {
+        _addRecordToCurrentStone_inlock(*record);
+        numTailRecords++;
+    }
+
+    LOGV2(5905003,
+          "Loaded the persisted oplog stones",
+          "numStones"_attr = _stones.size(),
+          "lastAccountedRecord"_attr = lastAccountedRecord,
+          "numTailRecords"_attr = numTailRecords);
+    return true;
+}
+
 void WiredTigerRecordStore::OplogStones::_calculateStonesBySampling(OperationContext* opCtx,
                                                                     int64_t estRecordsPerStone,
                                                                     int64_t estBytesPerStone) {
@@ -531,6 +643,7 @@ void WiredTigerRecordStore::OplogStones::_calculateStonesBySampling(OperationCon
             return;
         }
         latestOpTime = Timestamp(record->id.getLong());
+        _lastAccountedRecord.store(record->id.getLong());
     }
 
     LOGV2(22389,
@@ -620,6 +733,53 @@ void WiredTigerRecordStore::OplogStones::_pokeReclaimThreadIfNeeded() {
     }
 }
 
+void WiredTigerRecordStore::OplogStones::_addRecordToCurrentStone_inlock(const Record& record) {
+    _currentRecords.addAndFetch(1);
+    int64_t newCurrentBytes = _currentBytes.addAndFetch(record.data.size());
+    if (newCurrentBytes >= _minBytesPerStone) {
+        BSONObj obj = record.data.toBson();
+        auto wallTime = obj.hasField("wall") ? obj["wall"].Date() : obj["ts"].timestampTime();
+
+        LOGV2_DEBUG(22385,
+                    1,
+                    "Marking oplog entry as a potential future oplog truncation point",
+                    "wall"_attr = wallTime);
+
+        _stones.emplace_back(_currentRecords.swap(0), _currentBytes.swap(0), record.id, wallTime);
+    }
+    _lastAccountedRecord.store(record.id.getLong());
+}
+
+void WiredTigerRecordStore::OplogStones::_advanceLastAccountedRecord(const RecordId& recordId) {
+    // Inserts may commit out of RecordId order, so only ever move forward.
+    auto lastAccountedRecord = _lastAccountedRecord.load();
+    while (lastAccountedRecord < recordId.getLong() &&
+           !_lastAccountedRecord.compareAndSwap(&lastAccountedRecord, recordId.getLong())) {
+    }
+}
+
+BSONObj WiredTigerRecordStore::OplogStones::toBSON() const {
+    BSONObjBuilder builder;
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        BSONArrayBuilder stonesBuilder(builder.subarrayStart("stones"));
+        for (auto&& stone : _stones) {
+            BSONObjBuilder stoneBuilder(stonesBuilder.subobjStart());
+            stoneBuilder.append("records", stone.records);
+            stoneBuilder.append("bytes", stone.bytes);
+            stoneBuilder.append("lastRecord", stone.lastRecord.getLong());
+            stoneBuilder.append("wallTime", stone.wallTime);
+        }
+    }
+
+    // Read the newest accounted record before the stone being filled: an insert committing
+    // concurrently is then at worst counted twice at startup, which is harmless for stones.
+    builder.append("lastRecord", _lastAccountedRecord.load());
+    builder.append("currentRecords", _currentRecords.load());
+    builder.append("currentBytes", _currentBytes.load());
+    return builder.obj();
+}
+
 void WiredTigerRecordStore::OplogStones::adjust(int64_t maxSize) {
     stdx::lock_guard<Latch> reclaimLk(_oplogReclaimMutex);
     stdx::lock_guard<Latch> lk(_mutex);
@@ -648,6 +808,15 @@ StatusWith<std::string> WiredTigerRecordStore::parseOptionsField(const BSONObj o
                 return status;
             }
             ss << elem.valueStringData() << ',';
+        } else if (elem.fieldNameStringData() == kDictionaryCompressionFieldName) {
+            // The compressor depends on the table's ident, so the engine picks it when creating the
+            // table.
+            if (!elem.isBoolean()) {
+                return StatusWith<std::string>(ErrorCodes::TypeMismatch,
+                                               str::stream()
+                                                   << '\'' << kDictionaryCompressionFieldName
+                                                   << "' must be a boolean.");
+            }
         } else {
             // Return error on first unrecognized field.
             return StatusWith<std::string>(ErrorCodes::InvalidOptions,
@@ -658,6 +827,10 @@ StatusWith<std::string> WiredTigerRecordStore::parseOptionsField(const BSONObj o
     return StatusWith<std::string>(ss.str());
 }
 
+bool WiredTigerRecordStore::usesDictionaryCompression(const BSONObj& options) {
+    return options[kDictionaryCompressionFieldName].trueValue();
+}
+
 class WiredTigerRecordStore::RandomCursor final : public RecordCursor {
 public:
     RandomCursor(OperationContext* opCtx, const WiredTigerRecordStore& rs, StringData config)
@@ -863,17 +1036,20 @@ WiredTigerRecordStore::WiredTigerRecordStore(WiredTigerKVEngine* kvEngine,
         invariant(_isOplog, str::stream() << "Namespace " << params.ns);
     }
 
-    Status versionStatus = WiredTigerUtil::checkApplicationMetadataFormatVersion(
-                               ctx, _uri, kMinimumRecordStoreVersion, kMaximumRecordStoreVersion)
-                               .getStatus();
-
-    if (!versionStatus.isOK()) {
-        std::cout << " Version: " << versionStatus.reason() << std::endl;
-        if (versionStatus.code() == ErrorCodes::FailedToParse) {
-            uasserted(28548, versionStatus.reason());
-        } else {
-            fassertFailedNoTrace(34433);
+    // The server cannot run without the oplog and the catalog, so an unsupported format of their
+    // tables is a startup error. The format version of every other table is checked on first use,
+    // see _checkFormatVersionIfNeeded().
+    if (_isOplog || getIdent() == kCatalogIdent) {
+        Status versionStatus = checkFormatVersion(ctx, _uri);
+        if (!versionStatus.isOK()) {
+            std::cout << " Version: " << versionStatus.reason() << std::endl;
+            if (versionStatus.code() == ErrorCodes::FailedToParse) {
+                uasserted(28548, versionStatus.reason());
+            } else {
+                fassertFailedNoTrace(34433);
+            }
         }
+        _formatVersionChecked.store(true);
     }
 
     if (!params.isReadOnly) {
@@ -922,6 +1098,28 @@ WiredTigerRecordStore::~WiredTigerRecordStore() {
     }
 }
 
+void WiredTigerRecordStore::_checkFormatVersionIfNeeded(OperationContext* opCtx) const {
+    if (MONGO_likely(_formatVersionChecked.load())) {
+        return;
+    }
+
+    // Racing threads may both check the version, which is harmless. An unsupported format only
+    // fails the operations on this table, rather than the whole server.
+    Status versionStatus = checkFormatVersion(opCtx, _uri);
+    if (!versionStatus.isOK()) {
+        if (versionStatus.code() == ErrorCodes::FailedToParse) {
+            uasserted(28548, versionStatus.reason());
+        }
+        uasserted(ErrorCodes::UnsupportedFormat,
+                  str::stream() << "Unsupported format of table " << _uri << ": "
+                                << versionStatus.reason());
+    }
+
+    if (!_formatVersionChecked.swap(true)) {
+        deferredFormatVersionChecksCounter.increment();
+    }
+}
+
 void WiredTigerRecordStore::checkSize(OperationContext* opCtx) {
     std::unique_ptr<SeekableRecordCursor> cursor = getCursor(opCtx, /*forward=*/true);
     if (!cursor->next()) {
@@ -965,6 +1163,20 @@ void WiredTigerRecordStore::postConstructorInit(OperationContext* opCtx) {
         _oplogStones = std::make_shared<OplogStones>(opCtx, this);
     }
 
+    // Store the oplog stones with the size information of the oplog on every flush of the size
+    // storer. The source shares ownership of the stones so that their final state is still stored
+    // by the flush on shutdown, after this record store is destroyed. Otherwise, drop any stored
+    // stones since the oplog may change without them.
+    if (_isOplog && _sizeStorer) {
+        if (_oplogStones && gPersistOplogStones) {
+            _sizeInfo->setOplogStonesSource(
+                [oplogStones = _oplogStones] { return oplogStones->toBSON(); });
+        } else {
+            _sizeInfo->clearOplogStones();
+        }
+        _sizeStorer->store(_uri, _sizeInfo);
+    }
+
     if (_isOplog) {
         invariant(_kvEngine);
         _kvEngine->startOplogManager(opCtx, this);
@@ -1042,6 +1254,7 @@ bool WiredTigerRecordStore::findRecord(OperationContext* opCtx,
                                        const RecordId& id,
                                        RecordData* out) const {
     dassert(opCtx->lockState()->isReadLocked());
+    _checkFormatVersionIfNeeded(opCtx);
 
     WiredTigerCursor curwrap(_uri, _tableId, true, opCtx);
     WT_CURSOR* c = curwrap.get();
@@ -1072,6 +1285,7 @@ void WiredTigerRecordStore::deleteRecord(OperationContext* opCtx, const RecordId
     if (_keyFormat == KeyFormat::Long) {
         _initNextIdIfNeeded(opCtx);
     }
+    _checkFormatVersionIfNeeded(opCtx);
 
     WiredTigerCursor cursor(_uri, _tableId, true, opCtx);
     cursor.assertInActiveTxn();
@@ -1262,6 +1476,8 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
     dassert(opCtx->lockState()->isWriteLocked());
     invariant(opCtx->lockState()->inAWriteUnitOfWork() || opCtx->lockState()->isNoop());
 
+    _checkFormatVersionIfNeeded(opCtx);
+
     int64_t totalLength = 0;
     for (size_t i = 0; i < nRecords; i++)
         totalLength += records[i].data.size();
@@ -1275,6 +1491,19 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
     invariant(nRecords != 0);
 
     if (_keyFormat == KeyFormat::Long) {
+        // Reserve the RecordIds of the whole batch at once, so that its records are adjacent in
+        // the table even while other inserts run concurrently. Inserting a record right after the
+        // previous one lets WiredTiger find its page without searching the tree again.
+        int64_t nextId = 0;
+        if (!_isOplog) {
+            auto nIds = std::count_if(records, records + nRecords, [](const Record& record) {
+                return record.id.isNull();
+            });
+            if (nIds > 0) {
+                nextId = _reserveIds(opCtx, nIds).getLong();
+            }
+        }
+
         // Non-clustered record stores will extract the RecordId key for the oplog and generate
         // unique int64_t RecordIds if RecordIds are not set.
         for (size_t i = 0; i < nRecords; i++) {
@@ -1289,7 +1518,7 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
                 // Some RecordStores, like TemporaryRecordStores, may want to set their own
                 // RecordIds.
                 if (record.id.isNull()) {
-                    record.id = _nextId(opCtx);
+                    record.id = RecordId(nextId++);
                 }
             }
             dassert(record.id > highestIdRecord.id);
@@ -1297,6 +1526,8 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
         }
     }
 
+    auto& metricsCollector = ResourceConsumption::MetricsCollector::get(opCtx);
+    Timestamp lastTimestampSet;
     for (size_t i = 0; i < nRecords; i++) {
         auto& record = records[i];
         invariant(!record.id.isNull());
@@ -1314,9 +1545,12 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
         } else {
             ts = timestamps[i];
         }
-        if (!ts.isNull()) {
+        // Records sharing a timestamp, as when a batch is applied at a single timestamp, only
+        // need it set on the transaction once.
+        if (!ts.isNull() && ts != lastTimestampSet) {
             LOGV2_DEBUG(22403, 4, "inserting record with timestamp {ts}", "ts"_attr = ts);
             fassert(39001, opCtx->recoveryUnit()->setTimestamp(ts));
+            lastTimestampSet = ts;
         }
         CursorKey key = makeCursorKey(record.id, _keyFormat);
         setKey(c, &key);
@@ -1344,7 +1578,6 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
         // Increment metrics for each insert separately, as opposed to outside of the loop. The API
         // requires that each record be accounted for separately.
         if (!_isOplog) {
-            auto& metricsCollector = ResourceConsumption::MetricsCollector::get(opCtx);
             metricsCollector.incrementOneDocWritten(value.size);
         }
     }
@@ -1437,6 +1670,7 @@ Status WiredTigerRecordStore::updateRecord(OperationContext* opCtx,
                                            int len) {
     dassert(opCtx->lockState()->isWriteLocked());
     invariant(opCtx->lockState()->inAWriteUnitOfWork() || opCtx->lockState()->isNoop());
+    _checkFormatVersionIfNeeded(opCtx);
 
     WiredTigerCursor curwrap(_uri, _tableId, true, opCtx);
     curwrap.assertInActiveTxn();
@@ -1532,6 +1766,7 @@ StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
     const RecordData& oldRec,
     const char* damageSource,
     const mutablebson::DamageVector& damages) {
+    _checkFormatVersionIfNeeded(opCtx);
 
     const int nentries = damages.size();
     mutablebson::DamageVector::const_iterator where = damages.begin();
@@ -1573,10 +1808,12 @@ StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
 
 std::unique_ptr<RecordCursor> WiredTigerRecordStore::getRandomCursor(
     OperationContext* opCtx) const {
+    _checkFormatVersionIfNeeded(opCtx);
     return std::make_unique<RandomCursor>(opCtx, *this, "");
 }
 
 Status WiredTigerRecordStore::truncate(OperationContext* opCtx) {
+    _checkFormatVersionIfNeeded(opCtx);
     WiredTigerCursor startWrap(_uri, _tableId, true, opCtx);
     WT_CURSOR* start = startWrap.get();
     int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return start->next(start); });
@@ -1598,23 +1835,33 @@ Status WiredTigerRecordStore::truncate(OperationContext* opCtx) {
     return Status::OK();
 }
 
-Status WiredTigerRecordStore::compact(OperationContext* opCtx) {
+Status WiredTigerRecordStore::compact(OperationContext* opCtx,
+                                      boost::optional<Seconds> timeLimit) {
     dassert(opCtx->lockState()->isWriteLocked());
 
     WiredTigerSessionCache* cache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
     if (!cache->isEphemeral()) {
         WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
         opCtx->recoveryUnit()->abandonSnapshot();
-        int ret = s->compact(s, getURI().c_str(), "timeout=0");
+        int ret = s->compact(
+            s, getURI().c_str(), WiredTigerUtil::buildCompactConfig(timeLimit).c_str());
         if (MONGO_unlikely(WTCompactRecordStoreEBUSY.shouldFail())) {
             ret = EBUSY;
         }
+        if (timeLimit && MONGO_unlikely(WTCompactRecordStoreETIMEDOUT.shouldFail())) {
+            ret = ETIMEDOUT;
+        }
 
         if (ret == EBUSY) {
             return Status(ErrorCodes::Interrupted,
                           str::stream() << "Compaction interrupted on " << getURI().c_str()
                                         << " due to cache eviction pressure");
         }
+        if (ret == ETIMEDOUT && timeLimit) {
+            return Status(ErrorCodes::ExceededTimeLimit,
+                          str::stream() << "Compaction of " << getURI().c_str()
+                                        << " did not finish within " << *timeLimit);
+        }
         invariantWTOK(ret);
     }
     return Status::OK();
@@ -1778,12 +2025,17 @@ void WiredTigerRecordStore::_initNextIdIfNeeded(OperationContext* opCtx) {
 }
 
 RecordId WiredTigerRecordStore::_nextId(OperationContext* opCtx) {
+    return _reserveIds(opCtx, 1);
+}
+
+RecordId WiredTigerRecordStore::_reserveIds(OperationContext* opCtx, int64_t nIds) {
     // Clustered record stores do not generate unique ObjectId's for RecordId's as the expectation
     // is for the caller to set the RecordId using the server generated ObjectId.
     invariant(_keyFormat == KeyFormat::Long);
     invariant(!_isOplog);
+    invariant(nIds > 0);
     _initNextIdIfNeeded(opCtx);
-    RecordId out = RecordId(_nextIdNum.fetchAndAdd(1));
+    RecordId out = RecordId(_nextIdNum.fetchAndAdd(nIds));
     invariant(out.isValid());
     return out;
 }
@@ -1995,6 +2247,7 @@ WiredTigerRecordStoreCursorBase::WiredTigerRecordStoreCursorBase(OperationContex
                                                                  const WiredTigerRecordStore& rs,
                                                                  bool forward)
     : _rs(rs), _opCtx(opCtx), _forward(forward) {
+    _rs._checkFormatVersionIfNeeded(opCtx);
     if (_rs._isOplog) {
         _oplogVisibleTs = WiredTigerRecoveryUnit::get(opCtx)->getOplogVisibilityTs();
     }
@@ -2061,9 +2314,38 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
     metricsCollector.incrementOneDocRead(value.size);
 
     _lastReturnedId = id;
+    _readAheadIfNeeded(id);
     return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
 }
 
+void WiredTigerRecordStoreCursorBase::setReadAhead(bool readAhead) {
+    // In-memory tables have nothing to read from disk.
+    auto readAheadService = _rs._kvEngine ? _rs._kvEngine->getReadAhead() : nullptr;
+    if (!readAhead || !readAheadService || _rs._isEphemeral) {
+        _readAheadRecords = 0;
+        return;
+    }
+
+    _readAheadRecords = gWiredTigerCursorReadAheadRecords.load();
+    _recordsUntilReadAhead = 0;
+    if (!_readAheadInFlight) {
+        _readAheadInFlight = std::make_shared<AtomicWord<bool>>(false);
+    }
+}
+
+void WiredTigerRecordStoreCursorBase::_readAheadIfNeeded(const RecordId& id) {
+    if (_readAheadRecords == 0 || --_recordsUntilReadAhead > 0) {
+        return;
+    }
+
+    // Read the next window once half of the previous one has been consumed, so that the reads stay
+    // ahead of the cursor. If the previous read is still running, try again on the next record.
+    if (_rs._kvEngine->getReadAhead()->schedule(
+            _rs.getURI(), _rs.keyFormat(), id, _forward, _readAheadRecords, _readAheadInFlight)) {
+        _recordsUntilReadAhead = std::max<int64_t>(_readAheadRecords / 2, 1);
+    }
+}
+
 boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordId& id) {
     invariant(_hasRestored);
     if (_forward && _oplogVisibleTs && id.getLong() > *_oplogVisibleTs) {
@@ -82,6 +82,12 @@ public:
      */
     static StatusWith<std::string> parseOptionsField(const BSONObj options);
 
+    /**
+     * Returns whether the 'wiredTiger' collection options 'options' ask for the records to be
+     * compressed with trained dictionaries. See WiredTigerDictionaryCompression.
+     */
+    static bool usesDictionaryCompression(const BSONObj& options);
+
     /**
      * Creates a configuration string suitable for 'config' parameter in WT_SESSION::create().
      * It is possible for 'ns' to be an empty string, in the case of internal-only temporary tables.
@@ -181,7 +187,7 @@ public:
 
     virtual Timestamp getPinnedOplog() const final;
 
-    virtual Status compact(OperationContext* opCtx) final;
+    virtual Status compact(OperationContext* opCtx, boost::optional<Seconds> timeLimit) final;
 
     virtual void validate(OperationContext* opCtx,
                           ValidateResults* results,
@@ -288,6 +294,11 @@ private:
                           size_t nRecords);
 
     RecordId _nextId(OperationContext* opCtx);
+
+    /**
+     * Reserves 'nIds' consecutive RecordIds and returns the first of them.
+     */
+    RecordId _reserveIds(OperationContext* opCtx, int64_t nIds);
     RecordData _getData(const WiredTigerCursor& cursor) const;
 
 
@@ -298,6 +309,15 @@ private:
      */
     void _initNextIdIfNeeded(OperationContext* opCtx);
 
+    /**
+     * Checks the format version recorded in the table's application metadata if that has not been
+     * done yet, and throws if it is not supported. This is called before any operation that reads
+     * or writes the table, so that constructing a record store does not need to read the
+     * WiredTiger metadata, and opening the catalog at startup does not need to do so for every
+     * collection. The oplog and the catalog are still checked when constructed.
+     */
+    void _checkFormatVersionIfNeeded(OperationContext* opCtx) const;
+
     /**
      * Adjusts the record count and data size metadata for this record store, respectively. These
      * functions consult the SizeRecoveryState to determine whether or not to actually change the
@@ -351,6 +371,9 @@ private:
     mutable Mutex _initNextIdMutex = MONGO_MAKE_LATCH("WiredTigerRecordStore::_initNextIdMutex");
     AtomicWord<long long> _nextIdNum{0};
 
+    // Whether _checkFormatVersionIfNeeded() has checked the table's format version.
+    mutable AtomicWord<bool> _formatVersionChecked{false};
+
     WiredTigerSizeStorer* _sizeStorer;  // not owned, can be NULL
     std::shared_ptr<WiredTigerSizeStorer::SizeInfo> _sizeInfo;
     bool _tracksSizeAdjustments;
@@ -388,6 +411,8 @@ public:
 
     boost::optional<Record> next();
 
+    void setReadAhead(bool readAhead);
+
     boost::optional<Record> seekExact(const RecordId& id);
 
     boost::optional<Record> seekNear(const RecordId& start);
@@ -424,6 +449,19 @@ protected:
 private:
     bool isVisible(const RecordId& id);
 
+    /**
+     * Schedules reading the records following 'id' into the cache once this cursor has returned
+     * enough of the records read ahead last time.
+     */
+    void _readAheadIfNeeded(const RecordId& id);
+
+    // The number of records to read ahead of this cursor, or 0 if read-ahead is disabled.
+    int64_t _readAheadRecords = 0;
+    // The number of records left to return before the next read-ahead is scheduled.
+    int64_t _recordsUntilReadAhead = 0;
+    // Set while a read-ahead scheduled by this cursor has not completed.
+    std::shared_ptr<AtomicWord<bool>> _readAheadInFlight;
+
     /**
      * This value is used for visibility calculations on what oplog entries can be returned to a
      * client. This value *must* be initialized/updated *before* a WiredTiger snapshot is
@@ -67,7 +67,10 @@ public:
 
     void getOplogStonesStats(BSONObjBuilder& builder) const {
         builder.append("totalTimeProcessingMicros", _totalTimeProcessing.load());
-        builder.append("processingMethod", _processBySampling.load() ? "sampling" : "scanning");
+        builder.append("processingMethod",
+                       _processFromPersistedStones.load()
+                           ? "persisted"
+                           : _processBySampling.load() ? "sampling" : "scanning");
         if (auto oplogMinRetentionHours = storageGlobalParams.oplogMinRetentionHours.load()) {
             builder.append("oplogMinRetentionHours", oplogMinRetentionHours);
         }
@@ -94,6 +97,10 @@ public:
     // Resize oplog size
     void adjust(int64_t maxSize);
 
+    // Returns the oplog stones, the stone being filled and the newest record accounted for in
+    // them, in the format stored by the size storer and reloaded at startup.
+    BSONObj toBSON() const;
+
     // The start point of where to truncate next. Used by the background reclaim thread to
     // efficiently truncate records with WiredTiger by skipping over tombstones, etc.
     RecordId firstRecord;
@@ -121,18 +128,28 @@ public:
         return _processBySampling.load();
     }
 
+    bool processedFromPersistedStones() const {
+        return _processFromPersistedStones.load();
+    }
+
 private:
     class InsertChange;
     class TruncateChange;
 
     void _calculateStones(OperationContext* opCtx, size_t size);
     void _calculateStonesByScanning(OperationContext* opCtx);
+    bool _loadPersistedStones(OperationContext* opCtx);
     void _calculateStonesBySampling(OperationContext* opCtx,
                                     int64_t estRecordsPerStone,
                                     int64_t estBytesPerStone);
 
     void _pokeReclaimThreadIfNeeded();
 
+    // Adds 'record' to the stone being filled, and creates a new stone if it is full enough.
+    void _addRecordToCurrentStone_inlock(const Record& record);
+
+    void _advanceLastAccountedRecord(const RecordId& recordId);
+
     static const uint64_t kRandomSamplesPerStone = 10;
 
     WiredTigerRecordStore* _rs;
@@ -153,6 +170,12 @@ private:
     AtomicWord<int64_t> _totalTimeProcessing;  // Amount of time spent scanning and/or sampling the
                                                // oplog during start up, if any.
     AtomicWord<bool> _processBySampling;       // Whether the oplog was sampled or scanned.
+    AtomicWord<bool> _processFromPersistedStones;  // Whether the stones were reloaded from the
+                                                   // size storer.
+
+    // RecordId of the newest record accounted for in the stones or the stone being filled. At
+    // startup, only the records after it are scanned when the stones are reloaded.
+    AtomicWord<int64_t> _lastAccountedRecord;
 
     // Protects against concurrent access to the deque of oplog stones.
     mutable Mutex _mutex = MONGO_MAKE_LATCH("OplogStones::_mutex");
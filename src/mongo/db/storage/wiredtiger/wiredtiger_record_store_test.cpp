@@ -151,6 +151,44 @@ TEST(WiredTigerRecordStoreTest, Isolation1) {
     }
 }
 
+TEST(WiredTigerRecordStoreTest, InsertRecordsAssignsConsecutiveRecordIdsToABatch) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    auto client2 = harnessHelper->serviceContext()->makeClient("c2");
+    auto opCtx2 = harnessHelper->newOperationContext(client2.get());
+
+    WriteUnitOfWork uow(opCtx.get());
+    WriteUnitOfWork uow2(opCtx2.get());
+
+    std::vector<Record> records;
+    std::vector<Timestamp> timestamps;
+    for (int i = 0; i < 10; i++) {
+        records.push_back({RecordId(), RecordData("a", 2)});
+        timestamps.push_back(Timestamp());
+    }
+
+    // An insert in between the two batches does not interleave with either of them.
+    ASSERT_OK(rs->insertRecords(opCtx.get(), &records, timestamps));
+    ASSERT_OK(rs->insertRecord(opCtx2.get(), "b", 2, Timestamp()).getStatus());
+    auto firstBatch = records;
+    for (auto& record : records) {
+        record.id = RecordId();
+    }
+    ASSERT_OK(rs->insertRecords(opCtx.get(), &records, timestamps));
+
+    for (const auto& batch : {firstBatch, records}) {
+        for (size_t i = 1; i < batch.size(); i++) {
+            ASSERT_EQ(batch[i - 1].id.getLong() + 1, batch[i].id.getLong());
+        }
+    }
+    ASSERT_LT(firstBatch.back().id, records.front().id);
+
+    uow2.commit();
+    uow.commit();
+}
+
 TEST(WiredTigerRecordStoreTest, Isolation2) {
     const auto harnessHelper(newRecordStoreHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
@@ -916,6 +954,56 @@ TEST(WiredTigerRecordStoreTest, OplogStones_Duplicates) {
     }
 }
 
+// Reopen an oplog whose stones were stored by the size storer and verify that the stones are
+// reloaded rather than recalculated, and that the records inserted since are accounted for.
+TEST(WiredTigerRecordStoreTest, OplogStones_ReloadPersistedStones) {
+    std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+    auto wtHarnessHelper = dynamic_cast<WiredTigerHarnessHelper*>(harnessHelper.get());
+    const bool enableWtLogging = false;
+    WiredTigerSizeStorer sizeStorer(wtHarnessHelper->conn(),
+                                    WiredTigerKVEngine::kTableUriPrefix + "sizeStorer",
+                                    enableWtLogging);
+    ON_BLOCK_EXIT([&] { sizeStorer.flush(false); });
+
+    {
+        std::unique_ptr<RecordStore> rs(wtHarnessHelper->newOplogRecordStoreNoInit(&sizeStorer));
+        WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        wtrs->postConstructorInit(opCtx.get());
+        WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+        oplogStones->setMinBytesPerStone(100);
+
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 1), 100), RecordId(1, 1));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 2), 100), RecordId(1, 2));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 3), 50), RecordId(1, 3));
+        ASSERT_EQ(2U, oplogStones->numStones());
+        sizeStorer.flush(true);
+
+        // This record is not accounted for by the stored stones.
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 4), 20), RecordId(1, 4));
+    }
+
+    std::unique_ptr<RecordStore> rs(wtHarnessHelper->newOplogRecordStoreNoInit(&sizeStorer));
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+
+    // Force the oplog visibility timestamp to be up-to-date to the last record.
+    auto wtKvEngine = dynamic_cast<WiredTigerKVEngine*>(harnessHelper->getEngine());
+    wtKvEngine->getOplogManager()->setOplogReadTimestamp(Timestamp(1, 4));
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        wtrs->postConstructorInit(opCtx.get());
+    }
+
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+    ASSERT(oplogStones->processedFromPersistedStones());
+    ASSERT_FALSE(oplogStones->processedBySampling());
+    ASSERT_EQ(2U, oplogStones->numStones());
+    ASSERT_EQ(2, oplogStones->currentRecords());
+    ASSERT_EQ(70, oplogStones->currentBytes());
+}
+
 TEST(WiredTigerRecordStoreTest, GetLatestOplogTest) {
     unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newOplogRecordStore());
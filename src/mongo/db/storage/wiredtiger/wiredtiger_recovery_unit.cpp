@@ -356,8 +356,9 @@ void WiredTigerRecoveryUnit::refreshSnapshot() {
     // current transaction.  This overlap will prevent WT from cleaning up history required to serve
     // the read timestamp.
 
-    // Currently, this code only works for kNoOverlap or kNoTimestamp.
+    // Currently, this code only works for kNoOverlap, kProvided or kNoTimestamp.
     invariant(_timestampReadSource == ReadSource::kNoOverlap ||
+              _timestampReadSource == ReadSource::kProvided ||
               _timestampReadSource == ReadSource::kNoTimestamp);
     invariant(_isActive());
     invariant(!_inUnitOfWork());
@@ -33,9 +33,15 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include <algorithm>
 #include <memory>
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 #include "mongo/base/error_codes.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/global_settings.h"
 #include "mongo/db/repl/repl_settings.h"
@@ -45,7 +51,10 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/logv2/log.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/fail_point.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -200,11 +209,43 @@ uint64_t WiredTigerSession::genTableId() {
 
 // -----------------------
 
+namespace {
+size_t numSessionCachePartitions() {
+    return std::max(ProcessInfo::getNumCores(), 1U);
+}
+
+/**
+ * Returns the CPU the calling thread is running on where the platform can tell, or a value
+ * derived from the thread's id otherwise, so that a thread keeps using the same partition.
+ */
+size_t currentCpuHint() {
+#if defined(__linux__)
+    int cpu = sched_getcpu();
+    if (cpu >= 0) {
+        return cpu;
+    }
+#endif
+    return std::hash<stdx::thread::id>()(stdx::this_thread::get_id());
+}
+
+// Number of callers of waitUntilDurable which waited for a journal flush, and number of flushes
+// performed for them. Their ratio is the average size of a group commit batch.
+Counter64 groupCommitWaiters;
+Counter64 groupCommitFlushes;
+ServerStatusMetricField<Counter64> displayGroupCommitWaiters("storage.groupCommit.waiters",
+                                                             &groupCommitWaiters);
+ServerStatusMetricField<Counter64> displayGroupCommitFlushes("storage.groupCommit.flushes",
+                                                             &groupCommitFlushes);
+
+MONGO_FAIL_POINT_DEFINE(hangDuringGroupCommitFlush);
+}  // namespace
+
 WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
     : _engine(engine),
       _conn(engine->getConnection()),
       _clockSource(_engine->getClockSource()),
       _shuttingDown(0),
+      _partitions(numSessionCachePartitions()),
       _prepareCommitOrAbortCounter(0) {}
 
 WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn, ClockSource* cs)
@@ -212,6 +253,7 @@ WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn, ClockSource*
       _conn(conn),
       _clockSource(cs),
       _shuttingDown(0),
+      _partitions(numSessionCachePartitions()),
       _prepareCommitOrAbortCounter(0) {}
 
 WiredTigerSessionCache::~WiredTigerSessionCache() {
@@ -325,20 +367,85 @@ void WiredTigerSessionCache::waitUntilDurable(OperationContext* opCtx,
         token = journalListener->getToken(opCtx);
     }
 
-    uint32_t start = _lastSyncTime.load();
-    // Do the remainder in a critical section that ensures only a single thread at a time
-    // will attempt to synchronize.
-    stdx::unique_lock<Latch> lk(_lastSyncMutex);
-    uint32_t current = _lastSyncTime.loadRelaxed();  // synchronized with writes through mutex
-    if (current != start) {
-        // Someone else synced already since we read lastSyncTime, so we're done!
-        return;
+    _groupCommit(opCtx);
+
+    if (token) {
+        journalListener->onDurable(token.get());
     }
-    _lastSyncTime.store(current + 1);
+}
 
-    // Nobody has synched yet, so we have to sync ourselves.
+void WiredTigerSessionCache::_groupCommit(OperationContext* opCtx) {
+    stdx::unique_lock<Latch> lk(_groupCommitMutex);
 
-    // Initialize on first use.
+    // Everything this caller committed happened before it joined the batch, so any flush which
+    // starts after this point makes it durable.
+    const uint64_t batch = _openBatch;
+    if (++_openBatchWaiters >= _lastBatchWaiters) {
+        _groupCommitBatchCond.notify_one();
+    }
+    groupCommitWaiters.increment();
+
+    while (_lastFlushedBatch < batch) {
+        if (!_flushInProgress) {
+            _flushBatch(lk);
+            continue;
+        }
+
+        // Wait for the flush in progress, which may or may not cover our batch. Once it
+        // completes, either our batch is durable or one of its callers leads the next flush.
+        auto flushCompleted = [&] { return !_flushInProgress || _lastFlushedBatch >= batch; };
+        if (opCtx) {
+            opCtx->waitForConditionOrInterrupt(_flushCompletedCond, lk, flushCompleted);
+        } else {
+            _flushCompletedCond.wait(lk, flushCompleted);
+        }
+    }
+}
+
+void WiredTigerSessionCache::_flushBatch(stdx::unique_lock<Latch>& lk) {
+    _flushInProgress = true;
+
+    // When the last batch was shared by several callers, writers are arriving concurrently, so
+    // hold the batch open long enough for as many of them to join this one. The window is bounded
+    // by a fraction of the flush latency, so a lone writer never waits longer than it would have
+    // waited for a flush that had just started.
+    if (_lastBatchWaiters > 1) {
+        const auto window = std::min(
+            Microseconds(gWiredTigerGroupCommitMaxWindowMicros.load()), _averageFlushLatency / 2);
+        if (window > Microseconds(0)) {
+            _groupCommitBatchCond.wait_for(lk, window.toSystemDuration(), [&] {
+                return _openBatchWaiters >= _lastBatchWaiters;
+            });
+        }
+    }
+
+    const uint64_t batch = _openBatch++;
+    const size_t waiters = std::exchange(_openBatchWaiters, 0);
+    lk.unlock();
+
+    hangDuringGroupCommitFlush.pauseWhileSet();
+
+    Timer timer;
+    _flush();
+    const Microseconds latency(timer.micros());
+    groupCommitFlushes.increment();
+    LOGV2_DEBUG(5903300,
+                4,
+                "Group commit flushed a batch",
+                "waiters"_attr = waiters,
+                "latency"_attr = latency);
+
+    lk.lock();
+    _averageFlushLatency = (_averageFlushLatency * 7 + latency) / 8;
+    _lastFlushedBatch = batch;
+    _lastBatchWaiters = waiters;
+    _flushInProgress = false;
+    _flushCompletedCond.notify_all();
+}
+
+void WiredTigerSessionCache::_flush() {
+    // Initialize on first use. Only one flush runs at a time, so this needs no further
+    // synchronization.
     if (!_waitUntilDurableSession) {
         invariantWTOK(
             _conn->open_session(_conn, nullptr, "isolation=snapshot", &_waitUntilDurableSession));
@@ -352,10 +459,6 @@ void WiredTigerSessionCache::waitUntilDurable(OperationContext* opCtx,
         invariantWTOK(_waitUntilDurableSession->checkpoint(_waitUntilDurableSession, nullptr));
         LOGV2_DEBUG(22420, 4, "created checkpoint");
     }
-
-    if (token) {
-        journalListener->onDurable(token.get());
-    }
 }
 
 void WiredTigerSessionCache::waitUntilPreparedUnitOfWorkCommitsOrAborts(OperationContext* opCtx,
@@ -377,25 +480,69 @@ void WiredTigerSessionCache::notifyPreparedUnitOfWorkHasCommittedOrAborted() {
 
 
 void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
-    stdx::lock_guard<Latch> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors(uri);
-    }
+    _forEachIdleSession([&](WiredTigerSession* session) { session->closeAllCursors(uri); });
 }
 
 void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<Latch> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeCursorsForQueuedDrops(_engine);
+    _forEachIdleSession(
+        [&](WiredTigerSession* session) { session->closeCursorsForQueuedDrops(_engine); });
+}
+
+template <typename Func>
+void WiredTigerSessionCache::_forEachIdleSession(Func&& func) {
+    // Registers as a releaser so that shuttingDown() waits for the sessions taken out below.
+    const int shuttingDown = _shuttingDown.fetchAndAdd(1);
+    ON_BLOCK_EXIT([this] { _shuttingDown.fetchAndSubtract(1); });
+
+    if (shuttingDown & kShuttingDownMask)
+        return;
+
+    for (auto&& partition : _partitions) {
+        // Take the idle sessions out of the partition so that closing their cursors, which calls
+        // into WiredTiger, does not happen under the spinlock. Meanwhile getSession() simply
+        // finds fewer idle sessions in this partition.
+        SessionCache sessions;
+        {
+            scoped_spinlock lock(partition.lock);
+            sessions.swap(partition.sessions);
+            _idleSessionsCount.fetchAndSubtract(sessions.size());
+        }
+
+        for (auto&& session : sessions) {
+            func(session);
+        }
+
+        // Return the sessions unless closeAll() moved to a new epoch while they were out.
+        SessionCache stale;
+        {
+            scoped_spinlock lock(partition.lock);
+            const uint64_t currentEpoch = _epoch.load();
+            for (auto&& session : sessions) {
+                if (session->_getEpoch() == currentEpoch) {
+                    partition.sessions.push_back(session);
+                    _idleSessionsCount.fetchAndAdd(1);
+                } else {
+                    stale.push_back(session);
+                }
+            }
+        }
+
+        for (auto&& session : stale) {
+            delete session;
+        }
     }
 }
 
 size_t WiredTigerSessionCache::getIdleSessionsCount() {
-    stdx::lock_guard<Latch> lock(_cacheLock);
-    return _sessions.size();
+    return _idleSessionsCount.load();
+}
+
+size_t WiredTigerSessionCache::getOpenBatchWaiters_forTest() {
+    stdx::lock_guard<Latch> lk(_groupCommitMutex);
+    return _openBatchWaiters;
 }
 
 void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
@@ -407,36 +554,44 @@ void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
     auto cutoffTime = _clockSource->now() - Milliseconds(idleTimeMillis);
     SessionCache sessionsToClose;
 
-    {
-        stdx::lock_guard<Latch> lock(_cacheLock);
+    for (auto&& partition : _partitions) {
+        scoped_spinlock lock(partition.lock);
         // Discard all sessions that became idle before the cutoff time
-        for (auto it = _sessions.begin(); it != _sessions.end();) {
+        for (auto it = partition.sessions.begin(); it != partition.sessions.end();) {
             auto session = *it;
             invariant(session->getIdleExpireTime() != Date_t::min());
             if (session->getIdleExpireTime() < cutoffTime) {
-                it = _sessions.erase(it);
+                it = partition.sessions.erase(it);
                 sessionsToClose.push_back(session);
+                _idleSessionsCount.fetchAndSubtract(1);
             } else {
                 ++it;
             }
         }
     }
 
-    // Closing expired idle sessions is expensive, so do it outside of the cache mutex. This helps
-    // to avoid periodic operation latency spikes as seen in SERVER-52879.
+    // Closing expired idle sessions is expensive, so do it outside of the partition locks. This
+    // helps to avoid periodic operation latency spikes as seen in SERVER-52879.
     for (auto session : sessionsToClose) {
         delete session;
     }
 }
 
 void WiredTigerSessionCache::closeAll() {
-    // Increment the epoch as we are now closing all sessions with this epoch.
-    SessionCache swap;
+    // Increment the epoch as we are now closing all sessions with this epoch. From here on, no
+    // session of an earlier epoch is returned to the cache, so draining every partition once is
+    // enough to close all of them.
+    _epoch.fetchAndAdd(1);
 
-    {
-        stdx::lock_guard<Latch> lock(_cacheLock);
-        _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
+    SessionCache swap;
+    for (auto&& partition : _partitions) {
+        SessionCache sessions;
+        {
+            scoped_spinlock lock(partition.lock);
+            partition.sessions.swap(sessions);
+            _idleSessionsCount.fetchAndSubtract(sessions.size());
+        }
+        swap.insert(swap.end(), sessions.begin(), sessions.end());
     }
 
     for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
@@ -448,25 +603,50 @@ bool WiredTigerSessionCache::isEphemeral() {
     return _engine && _engine->isEphemeral();
 }
 
+WiredTigerSession* WiredTigerSessionCache::_popIdleSession(Partition& partition) {
+    scoped_spinlock lock(partition.lock);
+    if (partition.sessions.empty()) {
+        return nullptr;
+    }
+
+    // Get the most recently used session so that if we discard sessions, we're discarding older
+    // ones
+    WiredTigerSession* cachedSession = partition.sessions.back();
+    partition.sessions.pop_back();
+    _idleSessionsCount.fetchAndSubtract(1);
+    return cachedSession;
+}
+
 UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // We should never be able to get here after _shuttingDown is set, because no new
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
-    {
-        stdx::lock_guard<Latch> lock(_cacheLock);
-        if (!_sessions.empty()) {
-            // Get the most recently used session so that if we discard sessions, we're
-            // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
+    // Look at our own partition first, then at the others, starting with the next one so that
+    // threads on different CPUs do not all go through the same partitions in the same order.
+    const size_t numPartitions = _partitions.size();
+    const size_t home = currentCpuHint() % numPartitions;
+    for (size_t i = 0; i < numPartitions; ++i) {
+        if (i > 0 && _idleSessionsCount.load() <= 0) {
+            break;
+        }
+
+        auto& partition = _partitions[(home + i) % numPartitions];
+        while (WiredTigerSession* cachedSession = _popIdleSession(partition)) {
+            // closeAll() bumps the epoch before draining the partitions, so we may still see a
+            // session it is about to close.
+            if (cachedSession->_getEpoch() != _epoch.load()) {
+                delete cachedSession;
+                continue;
+            }
+
             // Reset the idle time
             cachedSession->setIdleExpireTime(Date_t::min());
             return UniqueWiredTigerSession(cachedSession);
         }
     }
 
-    // Outside of the cache partition lock, but on release will be put back on the cache
+    // Outside of the partition locks, but on release will be put back on the cache
     return UniqueWiredTigerSession(
         new WiredTigerSession(_conn, this, _epoch.load(), _cursorEpoch.load()));
 }
@@ -521,10 +701,12 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     session->setIdleExpireTime(_clockSource->now());
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<Latch> lock(_cacheLock);
+        auto& partition = _partitions[currentCpuHint() % _partitions.size()];
+        scoped_spinlock lock(partition.lock);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
-            _sessions.push_back(session);
+            partition.sessions.push_back(session);
+            _idleSessionsCount.fetchAndAdd(1);
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -31,6 +31,7 @@
 
 #include <list>
 #include <string>
+#include <vector>
 
 #include <wiredtiger.h>
 
@@ -38,7 +39,10 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_snapshot_manager.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/new.h"
 #include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/duration.h"
 
 namespace mongo {
 
@@ -209,6 +213,11 @@ private:
 /**
  *  This cache implements a shared pool of WiredTiger sessions with the goal to amortize the
  *  cost of session creation and destruction over multiple uses.
+ *
+ *  Idle sessions are kept in one partition per CPU, each protected by its own spin lock, so that
+ *  threads running on different cores do not contend with each other when getting and releasing
+ *  sessions. A thread takes sessions from, and returns them to, the partition of the CPU it is
+ *  running on, and only looks at other partitions when its own is empty.
  */
 class WiredTigerSessionCache {
 public:
@@ -262,6 +271,12 @@ public:
      */
     size_t getIdleSessionsCount();
 
+    /**
+     * Returns the number of waitUntilDurable() callers in the group commit batch that no flush has
+     * started for yet.
+     */
+    size_t getOpenBatchWaiters_forTest();
+
     /**
      * Closes all cached sessions whose idle expiration time has been reached.
      */
@@ -301,9 +316,11 @@ public:
     /**
      * Waits until all commits that happened before this call are made durable.
      *
-     * Specifying Fsync::kJournal will flush only the (oplog) journal to disk. Callers are
-     * serialized by a mutex and will return early if it is discovered that another thread started
-     * and completed a flush while they slept.
+     * Specifying Fsync::kJournal will flush only the (oplog) journal to disk. Concurrent callers
+     * are grouped into batches which share a single flush: one caller of each batch performs the
+     * flush while the others wait for it to complete. When batches have several callers, the
+     * flush is held back for a window derived from the observed flush latency so that more
+     * callers can join it.
      *
      * Specifying Fsync::kCheckpointStableTimestamp will take a checkpoint up to and including the
      * stable timestamp.
@@ -379,19 +396,41 @@ private:
     AtomicWord<unsigned> _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    Mutex _cacheLock = MONGO_MAKE_LATCH("WiredTigerSessionCache::_cacheLock");
     typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
 
-    // Bumped when all open sessions need to be closed
+    // The idle sessions released on one CPU. Aligned to a cache line so that partitions used by
+    // different cores never share one.
+    struct alignas(stdx::hardware_destructive_interference_size) Partition {
+        SpinLock lock;
+        SessionCache sessions;
+    };
+    std::vector<Partition> _partitions;
+
+    // Total number of idle sessions across all partitions, so that getSession() does not need to
+    // look at the other partitions when the whole cache is empty.
+    AtomicWord<long long> _idleSessionsCount{0};
+
+    // Bumped when all open sessions need to be closed. Sessions opened in an earlier epoch are
+    // never returned to the cache, and are discarded if found in it.
     AtomicWord<unsigned long long> _epoch;  // atomic so we can check it outside of the lock
 
     // Bumped when all open cursors need to be closed
     AtomicWord<unsigned long long> _cursorEpoch;  // atomic so we can check it outside of the lock
 
-    // Counter and critical section mutex for waitUntilDurable
-    AtomicWord<unsigned> _lastSyncTime;
-    Mutex _lastSyncMutex = MONGO_MAKE_LATCH("WiredTigerSessionCache::_lastSyncMutex");
+    // Group commit state for waitUntilDurable. Callers join the open batch, which is made durable
+    // by the next flush to start. A batch is closed when its flush starts.
+    Mutex _groupCommitMutex = MONGO_MAKE_LATCH("WiredTigerSessionCache::_groupCommitMutex");
+    // Signaled when a caller joins the open batch, to end the batch window early.
+    stdx::condition_variable _groupCommitBatchCond;
+    uint64_t _openBatch = 1;
+    uint64_t _lastFlushedBatch = 0;
+    size_t _openBatchWaiters = 0;
+    size_t _lastBatchWaiters = 0;
+    bool _flushInProgress = false;
+    // Signaled when the flush in progress completes and '_lastFlushedBatch' advances.
+    stdx::condition_variable _flushCompletedCond;
+    // Moving average of the time taken by a flush.
+    Microseconds _averageFlushLatency{0};
 
     // Mutex and cond var for waiting on prepare commit or abort.
     Mutex _prepareCommittedOrAbortedMutex =
@@ -418,6 +457,36 @@ private:
      * session and releasing it, the session is directly released. This method is thread safe.
      */
     void releaseSession(WiredTigerSession* session);
+
+    /**
+     * Joins the open group commit batch and returns once a flush covering it has completed,
+     * performing the flush itself if no other caller is doing so.
+     */
+    void _groupCommit(OperationContext* opCtx);
+
+    /**
+     * Closes the open batch and flushes it. Called with '_groupCommitMutex' held through 'lk', and
+     * returns with it held.
+     */
+    void _flushBatch(stdx::unique_lock<Latch>& lk);
+
+    /**
+     * Flushes the journal, or takes a checkpoint if journaling is disabled.
+     */
+    void _flush();
+
+    /**
+     * Takes the most recently released session out of 'partition', or returns nullptr if it is
+     * empty.
+     */
+    WiredTigerSession* _popIdleSession(Partition& partition);
+
+    /**
+     * Calls 'func' on every idle session. The sessions are taken out of their partition while
+     * 'func' runs so that it is not called under the partition spinlock.
+     */
+    template <typename Func>
+    void _forEachIdleSession(Func&& func);
 };
 
 /**
@@ -31,13 +31,16 @@
 
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "mongo/base/string_data.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_cursor.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/fail_point.h"
 #include "mongo/util/system_clock_source.h"
 
 namespace mongo {
@@ -114,4 +117,112 @@ TEST(WiredTigerSessionCacheTest, CheckSessionCacheCleanup) {
     ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
 }
 
+TEST(WiredTigerSessionCacheTest, SessionsReleasedOnAnyThreadAreReused) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    // Every thread holds at most one session at a time, and returns it to the partition of
+    // whichever CPU it happens to be running on.
+    const size_t kThreads = 8;
+    std::vector<stdx::thread> threads;
+    for (size_t i = 0; i < kThreads; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < 1000; ++j) {
+                UniqueWiredTigerSession session = sessionCache->getSession();
+                ASSERT(session->getSession());
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    const auto idleSessions = sessionCache->getIdleSessionsCount();
+    ASSERT_GTE(idleSessions, 1U);
+
+    // Sessions held by this thread come out of whichever partitions have any.
+    std::vector<UniqueWiredTigerSession> sessions;
+    for (size_t i = 0; i < idleSessions; ++i) {
+        sessions.push_back(sessionCache->getSession());
+    }
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+    sessions.clear();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), idleSessions);
+}
+
+TEST(WiredTigerSessionCacheTest, SessionsFromBeforeCloseAllAreNotCached) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    {
+        UniqueWiredTigerSession cached = sessionCache->getSession();
+    }
+    UniqueWiredTigerSession outstanding = sessionCache->getSession();
+    {
+        UniqueWiredTigerSession another = sessionCache->getSession();
+    }
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 1U);
+
+    sessionCache->closeAll();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+
+    // A session obtained before closeAll() is closed instead of being returned to the cache.
+    outstanding.reset();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+
+    {
+        UniqueWiredTigerSession session = sessionCache->getSession();
+    }
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 1U);
+}
+
+TEST(WiredTigerSessionCacheTest, ConcurrentWaitUntilDurableCallersAllReturn) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    // Callers join group commit batches while other callers' flushes are in progress, and must
+    // all be released by some flush covering their batch.
+    const size_t kThreads = 16;
+    std::vector<stdx::thread> threads;
+    for (size_t i = 0; i < kThreads; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < 20; ++j) {
+                sessionCache->waitUntilDurable(nullptr,
+                                               WiredTigerSessionCache::Fsync::kJournal,
+                                               WiredTigerSessionCache::UseJournalListener::kSkip);
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+}
+
+TEST(WiredTigerSessionCacheTest, WaitUntilDurableCallerArrivingDuringFlushReturns) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+    auto waitUntilDurable = [&] {
+        sessionCache->waitUntilDurable(nullptr,
+                                       WiredTigerSessionCache::Fsync::kJournal,
+                                       WiredTigerSessionCache::UseJournalListener::kSkip);
+    };
+
+    // Hold the first caller's flush in progress.
+    auto failPoint = globalFailPointRegistry().find("hangDuringGroupCommitFlush");
+    auto timesEntered = failPoint->setMode(FailPoint::alwaysOn);
+    stdx::thread first(waitUntilDurable);
+    failPoint->waitForTimesEntered(timesEntered + 1);
+
+    // The second caller joins the next batch, which the flush in progress does not cover. Once
+    // that flush completes, it must lead the next flush itself rather than wait for another one.
+    stdx::thread second(waitUntilDurable);
+    while (sessionCache->getOpenBatchWaiters_forTest() == 0) {
+        sleepmillis(1);
+    }
+    failPoint->setMode(FailPoint::off);
+
+    first.join();
+    second.join();
+}
+
 }  // namespace mongo
@@ -47,6 +47,39 @@
 
 namespace mongo {
 
+BSONObj WiredTigerSizeStorer::SizeInfo::getOplogStones() const {
+    stdx::lock_guard<Latch> lk(_oplogStonesMutex);
+    return _oplogStones;
+}
+
+void WiredTigerSizeStorer::SizeInfo::setOplogStonesSource(std::function<BSONObj()> source) {
+    stdx::lock_guard<Latch> lk(_oplogStonesMutex);
+    _oplogStonesSource = std::move(source);
+}
+
+void WiredTigerSizeStorer::SizeInfo::clearOplogStones() {
+    stdx::lock_guard<Latch> lk(_oplogStonesMutex);
+    _oplogStonesSource = nullptr;
+    _oplogStones = BSONObj();
+}
+
+BSONObj WiredTigerSizeStorer::SizeInfo::_refreshOplogStones() {
+    std::function<BSONObj()> source;
+    {
+        stdx::lock_guard<Latch> lk(_oplogStonesMutex);
+        source = _oplogStonesSource;
+    }
+
+    // Call the source without holding the mutex, as it acquires the locks of the oplog stones.
+    BSONObj oplogStones = source ? source() : BSONObj();
+
+    stdx::lock_guard<Latch> lk(_oplogStonesMutex);
+    if (!oplogStones.isEmpty()) {
+        _oplogStones = oplogStones.getOwned();
+    }
+    return _oplogStones;
+}
+
 WiredTigerSizeStorer::WiredTigerSizeStorer(WT_CONNECTION* conn,
                                            const std::string& storageUri,
                                            bool readOnly)
@@ -126,8 +159,12 @@ std::shared_ptr<WiredTigerSizeStorer::SizeInfo> WiredTigerSizeStorer::load(Strin
                 "WiredTigerSizeStorer::load {uri} -> {data}",
                 "uri"_attr = uri,
                 "data"_attr = redact(data));
-    return std::make_shared<SizeInfo>(data["numRecords"].safeNumberLong(),
-                                      data["dataSize"].safeNumberLong());
+    auto sizeInfo = std::make_shared<SizeInfo>(data["numRecords"].safeNumberLong(),
+                                               data["dataSize"].safeNumberLong());
+    if (auto oplogStones = data["oplogStones"]; oplogStones.type() == Object) {
+        sizeInfo->_oplogStones = oplogStones.Obj().getOwned();
+    }
+    return sizeInfo;
 }
 
 void WiredTigerSizeStorer::flush(bool syncToDisk) {
@@ -163,8 +200,13 @@ void WiredTigerSizeStorer::flush(bool syncToDisk) {
             // still be written back. So, the required order is to clear the dirty flag first.
             SizeInfo& sizeInfo = *it->second;
             sizeInfo._dirty.store(false);
-            BSONObj data = BSON("numRecords" << sizeInfo.numRecords.load() << "dataSize"
-                                             << sizeInfo.dataSize.load());
+            BSONObjBuilder dataBuilder;
+            dataBuilder.append("numRecords", sizeInfo.numRecords.load());
+            dataBuilder.append("dataSize", sizeInfo.dataSize.load());
+            if (auto oplogStones = sizeInfo._refreshOplogStones(); !oplogStones.isEmpty()) {
+                dataBuilder.append("oplogStones", oplogStones);
+            }
+            BSONObj data = dataBuilder.obj();
 
             auto& uri = it->first;
             LOGV2_DEBUG(22425,
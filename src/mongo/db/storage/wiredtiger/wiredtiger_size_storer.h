@@ -29,11 +29,13 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 
 #include <wiredtiger.h>
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
@@ -45,6 +47,7 @@ namespace mongo {
  * The WiredTigerSizeStorer class serves as a write buffer to durably store size information for
  * MongoDB collections. The size storer uses a separate WiredTiger table as key-value store, where
  * the URI serves as key and the value is a BSON document with `numRecords` and `dataSize` fields.
+ * For the oplog, the value also holds the oplog truncate markers in an `oplogStones` field.
  * This buffering is neccessary to allow concurrent updates of size information without causing
  * write conflicts. The dirty size information is periodically stored written back to the table,
  * including on clean shutdown and/or catalog reload. Crashes or replica-set fail-overs may result
@@ -71,9 +74,34 @@ public:
         AtomicWord<long long> numRecords;
         AtomicWord<long long> dataSize;
 
+        /**
+         * Returns the oplog truncate markers last stored with this SizeInfo, or an empty object if
+         * there are none.
+         */
+        BSONObj getOplogStones() const;
+
+        /**
+         * Sets the function called by every flush to get the oplog truncate markers to store. An
+         * empty object returned by 'source' leaves the previously stored markers in place.
+         */
+        void setOplogStonesSource(std::function<BSONObj()> source);
+
+        /**
+         * Drops the oplog truncate markers, so that the next flush stores the sizes only.
+         */
+        void clearOplogStones();
+
     private:
         friend WiredTigerSizeStorer;
+
+        BSONObj _refreshOplogStones();
+
         AtomicWord<bool> _dirty;
+
+        mutable Mutex _oplogStonesMutex =
+            MONGO_MAKE_LATCH("WiredTigerSizeStorer::SizeInfo::_oplogStonesMutex");
+        BSONObj _oplogStones;
+        std::function<BSONObj()> _oplogStonesSource;
     };
 
     WiredTigerSizeStorer(WT_CONNECTION* conn,
@@ -64,6 +64,54 @@ TEST(WiredTigerRecordStoreTest, StorageSizeStatisticsDisabled) {
     ASSERT_THROWS(rs->storageSize(opCtx.get()), AssertionException);
 }
 
+TEST(WiredTigerRecordStoreTest, UnsupportedFormatVersionRejectedOnFirstAccess) {
+    WiredTigerHarnessHelper harnessHelper;
+    const std::string ident = "unsupportedFormatVersion";
+    const std::string uri = WiredTigerKVEngine::kTableUriPrefix + ident;
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+        WiredTigerRecoveryUnit* ru = checked_cast<WiredTigerRecoveryUnit*>(opCtx->recoveryUnit());
+        WT_SESSION* s = ru->getSession()->getSession();
+        invariantWTOK(s->create(
+            s, uri.c_str(), "key_format=q,value_format=u,app_metadata=(formatVersion=2)"));
+    }
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+    WiredTigerRecordStore::Params params;
+    params.ns = "a.b"_sd;
+    params.ident = ident;
+    params.engineName = kWiredTigerEngineName;
+    params.isCapped = false;
+    params.keyFormat = KeyFormat::Long;
+    params.overwrite = true;
+    params.isEphemeral = false;
+    params.cappedCallback = nullptr;
+    params.sizeStorer = nullptr;
+    params.isReadOnly = false;
+    params.tracksSizeAdjustments = true;
+    params.forceUpdateWithFullDocument = false;
+
+    // Opening the record store does not check the format version of its table.
+    auto rs = std::make_unique<StandardWiredTigerRecordStore>(nullptr, opCtx.get(), params);
+    rs->postConstructorInit(opCtx.get());
+
+    // Every access rejects the unsupported format, not only the first one.
+    RecordData data;
+    ASSERT_THROWS_CODE(rs->findRecord(opCtx.get(), RecordId(1), &data),
+                       DBException,
+                       ErrorCodes::UnsupportedFormat);
+    ASSERT_THROWS_CODE(rs->getCursor(opCtx.get(), /*forward=*/true),
+                       DBException,
+                       ErrorCodes::UnsupportedFormat);
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_THROWS_CODE(rs->insertRecord(opCtx.get(), "a", 2, Timestamp()),
+                           DBException,
+                           ErrorCodes::UnsupportedFormat);
+    }
+}
+
 TEST(WiredTigerRecordStoreTest, SizeStorer1) {
     unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
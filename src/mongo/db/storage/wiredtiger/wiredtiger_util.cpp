@@ -475,6 +475,14 @@ int64_t WiredTigerUtil::getIdentReuseSize(WT_SESSION* s, const std::string& uri)
     return result.getValue();
 }
 
+std::string WiredTigerUtil::buildCompactConfig(boost::optional<Seconds> timeLimit) {
+    if (!timeLimit) {
+        return "timeout=0";
+    }
+    auto timeoutSecs = std::max<long long>(durationCount<Seconds>(*timeLimit), 1);
+    return str::stream() << "timeout=" << timeoutSecs;
+}
+
 size_t WiredTigerUtil::getCacheSizeMB(double requestedCacheSizeGB) {
     double cacheSizeMB;
     const double kMaxSizeCacheMB = 10 * 1000 * 1000;
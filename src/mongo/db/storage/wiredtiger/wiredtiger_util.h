@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <limits>
 #include <wiredtiger.h>
 
@@ -37,6 +38,7 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/duration.h"
 
 namespace mongo {
 
@@ -250,6 +252,11 @@ public:
      */
     static int64_t getIdentReuseSize(WT_SESSION* s, const std::string& uri);
 
+    /**
+     * Returns the configuration string for WT_SESSION::compact. WiredTiger treats a timeout of zero
+     * as unlimited, so a 'timeLimit' below one second is rounded up to one second.
+     */
+    static std::string buildCompactConfig(boost::optional<Seconds> timeLimit);
 
     /**
      * Return amount of memory to use for the WiredTiger cache based on either the startup
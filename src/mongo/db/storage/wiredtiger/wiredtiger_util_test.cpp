@@ -348,4 +348,12 @@ TEST(WiredTigerUtilTest, GetStatisticsValueValidKey) {
     ASSERT_EQUALS(0U, result.getValue());
 }
 
+TEST(WiredTigerUtilTest, BuildCompactConfig) {
+    // Without a time limit, compaction runs until it is done.
+    ASSERT_EQUALS("timeout=0", WiredTigerUtil::buildCompactConfig(boost::none));
+    ASSERT_EQUALS("timeout=5", WiredTigerUtil::buildCompactConfig(Seconds(5)));
+    // A timeout of 0 would disable it, so time limits are at least one second.
+    ASSERT_EQUALS("timeout=1", WiredTigerUtil::buildCompactConfig(Seconds(0)));
+}
+
 }  // namespace mongo
@@ -221,8 +221,16 @@ mongo::BSONArray MockRemoteDBServer::query(MockRemoteDBServer::InstanceID id,
 
     auto ns = nsOrUuid.uuid() ? _uuidToNs[*nsOrUuid.uuid()] : nsOrUuid.nss()->ns();
     const vector<BSONObj>& coll = _dataMgr[ns];
+    const BSONObj min = query.obj.getObjectField("$min");
+    const BSONObj max = query.obj.getObjectField("$max");
     BSONArrayBuilder result;
     for (vector<BSONObj>::const_iterator iter = coll.begin(); iter != coll.end(); ++iter) {
+        if (!min.isEmpty() && iter->extractFields(min).woCompare(min) < 0) {
+            continue;
+        }
+        if (!max.isEmpty() && iter->extractFields(max).woCompare(max) >= 0) {
+            continue;
+        }
         result.append(project(projectionExecutor.get(), *iter));
     }
 
@@ -164,6 +164,11 @@ public:
     //
     rpc::UniqueReply runCommand(InstanceID id, const OpMsgRequest& request);
 
+    /**
+     * Returns the documents of the collection in insertion order. The filter of 'query' is
+     * ignored, but its 'min' and 'max' index bounds are applied to the fields they name, which
+     * assumes the documents were inserted in the order of that index.
+     */
     mongo::BSONArray query(InstanceID id,
                            const NamespaceStringOrUUID& nsOrUuid,
                            mongo::Query query = mongo::Query(),
@@ -34,6 +34,7 @@
 #include <limits>
 #include <queue>
 
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/chrono.h"
 #include "mongo/stdx/condition_variable.h"
@@ -46,6 +47,10 @@ namespace mongo {
  * A custom sizing function can optionally be given.  By default the getSize function
  * returns 1 for each item, resulting in size equaling the number of items queued.
  *
+ * The size and count of the queue are tracked in atomics so that monitoring and emptiness checks
+ * do not contend with the producer and consumer on the queue lock. They are only modified while
+ * holding the lock, so they are always consistent with the queue contents at that point.
+ *
  * Note that use of this class is deprecated.  This class only works with a single consumer and
  * a single producer.
  */
@@ -95,12 +100,9 @@ public:
         const auto startedEmpty = _queue.empty();
         _clearing = false;
 
-        auto pushOne = [this](const T& obj) {
-            size_t tSize = _getSize(obj);
-            _queue.push(obj);
-            _currentSize += tSize;
-        };
-        std::for_each(begin, end, pushOne);
+        std::for_each(begin, end, [this](const T& obj) { _queue.push(obj); });
+        _currentSize.fetchAndAdd(size);
+        _currentCount.store(_queue.size());
 
         if (startedEmpty) {
             _cvNoLongerEmpty.notify_one();
@@ -108,16 +110,14 @@ public:
     }
 
     bool empty() const {
-        stdx::lock_guard<Latch> lk(_lock);
-        return _queue.empty();
+        return _currentCount.load() == 0;
     }
 
     /**
      * The size as measured by the size function. Default to counting each item
      */
     size_t size() const {
-        stdx::lock_guard<Latch> lk(_lock);
-        return _currentSize;
+        return _currentSize.load();
     }
 
     /**
@@ -131,15 +131,15 @@ public:
      * The number/count of items in the queue ( _queue.size() )
      */
     size_t count() const {
-        stdx::lock_guard<Latch> lk(_lock);
-        return _queue.size();
+        return _currentCount.load();
     }
 
     void clear() {
         stdx::lock_guard<Latch> lk(_lock);
         _clearing = true;
         _queue = std::queue<T>();
-        _currentSize = 0;
+        _currentSize.store(0);
+        _currentCount.store(0);
         _cvNoLongerFull.notify_one();
         _cvNoLongerEmpty.notify_one();
     }
@@ -150,8 +150,7 @@ public:
             return false;
 
         t = _queue.front();
-        _queue.pop();
-        _currentSize -= _getSize(t);
+        _popFront_inlock(t);
         _cvNoLongerFull.notify_one();
 
         return true;
@@ -167,8 +166,7 @@ public:
         }
 
         T t = _queue.front();
-        _queue.pop();
-        _currentSize -= _getSize(t);
+        _popFront_inlock(t);
         _cvNoLongerFull.notify_one();
 
         return t;
@@ -194,8 +192,7 @@ public:
             return false;
         }
         t = _queue.front();
-        _queue.pop();
-        _currentSize -= _getSize(t);
+        _popFront_inlock(t);
         _cvNoLongerFull.notify_one();
         return true;
     }
@@ -247,15 +244,25 @@ private:
      * Returns when enough space is available.
      */
     void _waitForSpace_inlock(size_t size, stdx::unique_lock<Latch>& lk) {
-        while (_currentSize + size > _maxSize) {
+        while (_currentSize.load() + size > _maxSize) {
             _cvNoLongerFull.wait(lk);
         }
     }
 
+    /**
+     * Removes 't', which must be the front of the queue, and releases its space.
+     */
+    void _popFront_inlock(const T& t) {
+        _queue.pop();
+        _currentSize.fetchAndSubtract(_getSize(t));
+        _currentCount.store(_queue.size());
+    }
+
     mutable Mutex _lock = MONGO_MAKE_LATCH(HierarchicalAcquisitionLevel(0), "BlockingQueue::_lock");
     std::queue<T> _queue;
     const size_t _maxSize;
-    size_t _currentSize = 0;
+    AtomicWord<size_t> _currentSize{0};
+    AtomicWord<size_t> _currentCount{0};
     GetSizeFn _getSize;
     bool _clearing = false;
 
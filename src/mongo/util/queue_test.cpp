@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2021-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/queue.h"
+
+namespace mongo {
+namespace {
+
+TEST(BlockingQueueTest, SizeAndCountTrackPushesAndPops) {
+    BlockingQueue<int> queue(100, [](const int& i) { return static_cast<size_t>(i); });
+    ASSERT_TRUE(queue.empty());
+    ASSERT_EQ(0U, queue.size());
+    ASSERT_EQ(0U, queue.count());
+
+    std::vector<int> values{3, 4};
+    queue.pushAllBlocking(values.begin(), values.end());
+    ASSERT_FALSE(queue.empty());
+    ASSERT_EQ(7U, queue.size());
+    ASSERT_EQ(2U, queue.count());
+
+    int value;
+    ASSERT_TRUE(queue.peek(value));
+    ASSERT_EQ(3, value);
+    ASSERT_EQ(7U, queue.size());
+    ASSERT_EQ(2U, queue.count());
+
+    ASSERT_TRUE(queue.tryPop(value));
+    ASSERT_EQ(3, value);
+    ASSERT_EQ(4U, queue.size());
+    ASSERT_EQ(1U, queue.count());
+
+    ASSERT_EQ(4, queue.blockingPop());
+    ASSERT_TRUE(queue.empty());
+    ASSERT_EQ(0U, queue.size());
+    ASSERT_EQ(0U, queue.count());
+    ASSERT_FALSE(queue.tryPop(value));
+}
+
+TEST(BlockingQueueTest, ClearResetsSizeAndCount) {
+    BlockingQueue<int> queue(100, [](const int& i) { return static_cast<size_t>(i); });
+    std::vector<int> values{1, 2, 3};
+    queue.pushAllBlocking(values.begin(), values.end());
+    ASSERT_EQ(6U, queue.size());
+    ASSERT_EQ(3U, queue.count());
+
+    queue.clear();
+    ASSERT_TRUE(queue.empty());
+    ASSERT_EQ(0U, queue.size());
+    ASSERT_EQ(0U, queue.count());
+
+    // The queue is still usable after being cleared.
+    queue.pushAllBlocking(values.begin(), values.begin() + 1);
+    ASSERT_EQ(1U, queue.size());
+    ASSERT_EQ(1U, queue.count());
+}
+
+TEST(BlockingQueueTest, SizeAndCountStayConsistentWithConcurrentProducerAndConsumer) {
+    const size_t maxSize = 10;
+    const int numBatches = 1000;
+    const std::vector<int> batch{1, 2, 3, 4};
+    BlockingQueue<int> queue(maxSize, [](const int& i) { return static_cast<size_t>(i); });
+
+    // The producer blocks whenever a batch does not fit, so the queue never exceeds its limit.
+    stdx::thread producer([&] {
+        for (int i = 0; i < numBatches; i++) {
+            queue.pushAllBlocking(batch.begin(), batch.end());
+        }
+    });
+
+    int sum = 0;
+    for (size_t i = 0; i < numBatches * batch.size(); i++) {
+        ASSERT_LTE(queue.size(), maxSize);
+        ASSERT_LTE(queue.count(), batch.size());
+        sum += queue.blockingPop();
+    }
+    producer.join();
+
+    ASSERT_EQ(numBatches * 10, sum);
+    ASSERT_TRUE(queue.empty());
+    ASSERT_EQ(0U, queue.size());
+    ASSERT_EQ(0U, queue.count());
+}
+
+}  // namespace
+}  // namespace mongo